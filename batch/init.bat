@@ -40,10 +40,19 @@ usr 0
 break on $(SAFEMODE)
 
 # wifi is up and connected
+# 'wifi connect' doesn't wait for the connection, this label runs from the loop, when connected.
+# At boot that is after the final label and rdy.bat, followed by boot-up.
 wifi-up:
 timer stop tiRecon
 break on $(SAFEMODE)
 
+# boot was successful: after the first wifi-up or a minute after rdy.bat without wifi
+boot-up:
+timer del tiUp
+test -f .safemode && rm .safemode   # no safemode needed at next boot
+test ! -f $(userscript).bak && cp $(userscript) $(userscript).bak
+break on $(SAFEMODE)
+
 # wifi is down
 wifi-down:
 timer start tiRecon
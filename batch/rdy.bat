@@ -23,8 +23,7 @@ echo "Enter $(ESC_BOLD)?$(ESC_RESET) to get help. Have a nice day :-)"
 ma:
 prompt "$(USER)@serial:/> "
 log info "System is ready!"
-rm .safemode   # system start was successful, no safemode needed at next boot
-test ! -f $(userscript).bak && cp $(userscript) $(userscript).bak
+timer add 1m "exec init boot-up" tiUp once   # boot-up without wifi, if wifi-up doesn't come
 
 #
 # Client console setup
@@ -0,0 +1,90 @@
+#!/bin/bash
+# build_html.sh - Converts the web assets in html/ into PROGMEM blobs for the captive portal.
+#
+# Usage:
+#   ./build_html.sh
+#
+# Description:
+#   - Every file in html/ becomes an entry of g_htmlAssets[] in src/CxHtmlAssets.h.
+#   - Static assets are stored gzip compressed (-9, without name and time stamp, so the output is
+#     reproducible) with an ETag of the content (POSIX cksum). They are sent with
+#     'Content-Encoding: gzip' and answered with 304, if the client has the same ETag.
+#   - Assets containing '{{' are templates. They are stored uncompressed and rendered at request time,
+#     the placeholders '{{name}}' are replaced by dynamic values (see CxStreamTemplate).
+#   - The generated header is committed, since the Arduino build does not run this script.
+#
+# Requirements:
+#   - Bash shell, gzip, od, cksum
+#
+# Example:
+#   make html
+
+set -e
+
+HTML_DIR="html"
+OUT_FILE="src/CxHtmlAssets.h"
+
+mime_type() {
+  case "$1" in
+    *.html) echo "text/html" ;;
+    *.js)   echo "application/javascript" ;;
+    *.css)  echo "text/css" ;;
+    *.json) echo "application/json" ;;
+    *)      echo "text/plain" ;;
+  esac
+}
+
+# prints the bytes of stdin as C array initializer
+hex_dump() {
+  od -An -v -tx1 | sed -E 's/ ([0-9a-f]{2})/0x\1,/g; s/^/   /'
+}
+
+{
+  echo "// generated by build_html.sh from the files in $HTML_DIR/, do not edit."
+  echo
+  echo "#ifndef CxHtmlAssets_h"
+  echo "#define CxHtmlAssets_h"
+  echo
+  echo "struct CxHtmlAsset {"
+  echo "   const char* szPath;"
+  echo "   const char* szMime;"
+  echo "   const uint8_t* pData;   // PROGMEM"
+  echo "   uint32_t nLength;"
+  echo "   const char* szETag;     // nullptr for templates"
+  echo "   bool bGzip;"
+  echo "};"
+  echo
+
+  entries=""
+  for file in "$HTML_DIR"/*; do
+    [[ -f "$file" ]] || continue
+    name=$(basename "$file")
+    id=$(echo "$name" | sed -E 's/[^A-Za-z0-9]/_/g')
+    mime=$(mime_type "$name")
+
+    if grep -q "{{" "$file"; then
+      # template: uncompressed, rendered at request time
+      length=$(wc -c < "$file" | tr -d ' ')
+      echo "static const uint8_t html_$id[] PROGMEM = {"
+      hex_dump < "$file"
+      echo "};"
+      entries="$entries   {\"/$name\", \"$mime\", html_$id, $length, nullptr, false},\n"
+    else
+      length=$(gzip -9 -n -c "$file" | wc -c | tr -d ' ')
+      etag=$(printf '%08x' "$(cksum < "$file" | cut -d ' ' -f 1)")
+      echo "static const uint8_t html_$id[] PROGMEM = {"
+      gzip -9 -n -c "$file" | hex_dump
+      echo "};"
+      entries="$entries   {\"/$name\", \"$mime\", html_$id, $length, \"\\\\\"$etag\\\\\"\", true},\n"
+    fi
+    echo
+  done
+
+  echo "static const CxHtmlAsset g_htmlAssets[] = {"
+  printf "$entries"
+  echo "};"
+  echo
+  echo "#endif /* CxHtmlAssets_h */"
+} > "$OUT_FILE"
+
+echo "$OUT_FILE generated."
@@ -0,0 +1,410 @@
+/**
+ * @file CxCapabilityApi.hpp
+ * @brief HTTP/JSON command API for the ESP console
+ *
+ * This file defines `CxCapabilityApi`, a small HTTP/1.1 server running commands of the console for
+ * automation. Several commands can be sent with one request, the connection is kept alive for the
+ * next requests. The result is returned as json with the captured output (without ANSI escape
+ * sequences), the exit code ($?), the output variable ($>) and the execution time of each command.
+ * The response is streamed with chunked encoding, large outputs are never buffered. The output
+ * variable ($>) of the console is restored after the request.
+ *
+ * Requests:
+ *   POST /cmd   body with one command per line
+ *   GET  /cmd?c=<command>[&c=<command>...]   (url encoded)
+ *
+ * Response:
+ * ```json
+ * {"results":[{"cmd":"heap","output":"...","exit":0,"out":"23456","ms":1.234}]}
+ * ```
+ *
+ * Example:
+ * ```sh
+ * curl -d $'heap\nuptime' http://<host>:8080/cmd
+ * curl 'http://<host>:8080/cmd?c=ip'
+ * ```
+ *
+ * @date created by ocfu on 17.10.26
+ * @copyright © 2026 ocfu
+ */
+
+#ifndef CxCapabilityApi_hpp
+#define CxCapabilityApi_hpp
+
+#include "CxCapability.hpp"
+#include "CxESPConsole.hpp"
+
+#include "../tools/CxEscFilter.hpp"
+#include "../tools/CxJsonStream.hpp"
+#include "../tools/CxStreamTemplate.hpp"
+
+#include <inttypes.h>
+#include <vector>
+
+class CxCapabilityApi : public CxCapability {
+   CxESPConsoleMaster& __console = CxESPConsoleMaster::getInstance();
+
+   static constexpr uint8_t  _nMAX_CLIENTS = 3;
+   static constexpr uint16_t _nMAX_REQUEST = 2048;     ///< max. size of a request (header and body)
+   static constexpr uint32_t _nKEEPALIVE = 15000;      ///< idle connections are closed after (ms)
+
+#ifndef ESP_CONSOLE_NOWIFI
+   struct Client {
+      WiFiClient client;
+      String     strRequest;
+      uint32_t   nLast;
+   };
+
+   WiFiServer* _pServer = nullptr;
+   std::vector<Client> _vClients;
+#endif
+
+   uint16_t _nPort = 8080;
+
+   /// statistics
+   uint32_t _nConnections = 0;
+   uint32_t _nRequests = 0;
+   uint32_t _nCommands = 0;
+
+public:
+   explicit CxCapabilityApi()
+   : CxCapability("api", getCmds()) {}
+   static constexpr const char* getName() { return "api"; }
+   static const std::vector<const char*>& getCmds() {
+      static std::vector<const char*> commands = { "api" };
+      return commands;
+   }
+   static std::unique_ptr<CxCapability> construct(const char* param) {
+      return std::make_unique<CxCapabilityApi>();
+   }
+
+   ~CxCapabilityApi() {
+      end();
+   }
+
+   void setup() override {
+      CxCapability::setup();
+
+      setIoStream(*__console.getStream());
+      __bLocked = false;
+
+      _CONSOLE_INFO(F("====  Cap: %s  ===="), getName());
+
+      __console.executeBatch("init", getName());
+   }
+
+   void loop() override {
+#ifndef ESP_CONSOLE_NOWIFI
+      if (!_pServer) return;
+
+      // accept new connections
+      WiFiClient client = _pServer->available();
+      if (client) {
+         if (_vClients.size() < _nMAX_CLIENTS) {
+            client.setNoDelay(true);
+            _vClients.push_back({client, "", (uint32_t)millis()});
+            _nConnections++;
+         } else {
+            _sendError(client, 503, "too many connections", false);
+            client.stop();
+         }
+      }
+
+      for (auto it = _vClients.begin(); it != _vClients.end();) {
+         if (!_loopClient(*it)) {
+            it->client.stop();
+            it = _vClients.erase(it);
+         } else {
+            ++it;
+         }
+      }
+#endif
+   }
+
+   uint8_t execute(const char *szCmd, uint8_t nClient) override {
+
+      // validate the call
+      if (!szCmd) return EXIT_FAILURE;
+
+      // get the arguments into the token buffer
+      CxStrToken tkArgs(szCmd, " ");
+
+      // we have a command, find the action to take
+      String cmd = TKTOCHAR(tkArgs, 0);
+
+      // removes heading and trailing white spaces
+      cmd.trim();
+
+      uint8_t nExitValue = EXIT_FAILURE;
+
+      if (cmd == "?") {
+         nExitValue = printCommands();
+      } else if (cmd == "api") {
+         String strSubCmd = TKTOCHAR(tkArgs, 1);
+         nExitValue = EXIT_SUCCESS;
+         if (strSubCmd == "start") {
+            if (!begin((uint16_t)TKTOINT(tkArgs, 2, _nPort))) nExitValue = EXIT_FAILURE;
+         } else if (strSubCmd == "stop") {
+            end();
+         } else if (strSubCmd == "") {
+            printInfo();
+         } else {
+            __console.man(cmd.c_str());
+            nExitValue = EXIT_FAILURE;
+         }
+      } else {
+         return EXIT_NOT_HANDLED;
+      }
+      g_Stack.update();
+      return nExitValue;
+   }
+
+   bool begin(uint16_t nPort) {
+#ifndef ESP_CONSOLE_NOWIFI
+      end();
+      if (!nPort) return false;
+      _nPort = nPort;
+      _pServer = new WiFiServer(_nPort);
+      if (!_pServer) return false;
+      _pServer->begin();
+      _CONSOLE_INFO(F("api listening on port %d"), _nPort);
+      return true;
+#else
+      return false;
+#endif
+   }
+
+   void end() {
+#ifndef ESP_CONSOLE_NOWIFI
+      for (auto& client : _vClients) client.client.stop();
+      _vClients.clear();
+      if (_pServer) {
+         _pServer->stop();
+         delete _pServer;
+         _pServer = nullptr;
+         _CONSOLE_INFO(F("api stopped"));
+      }
+#endif
+   }
+
+   void printInfo() {
+#ifndef ESP_CONSOLE_NOWIFI
+      printf(F(ESC_ATTR_BOLD "Port:        " ESC_ATTR_RESET "%d (%s)\n"), _nPort, _pServer ? "listening" : "stopped");
+      printf(F(ESC_ATTR_BOLD "Clients:     " ESC_ATTR_RESET "%" PRIu32 "\n"), (uint32_t)_vClients.size());
+#endif
+      printf(F(ESC_ATTR_BOLD "Connections: " ESC_ATTR_RESET "%" PRIu32 "\n"), _nConnections);
+      printf(F(ESC_ATTR_BOLD "Requests:    " ESC_ATTR_RESET "%" PRIu32 "\n"), _nRequests);
+      printf(F(ESC_ATTR_BOLD "Commands:    " ESC_ATTR_RESET "%" PRIu32 "\n"), _nCommands);
+      __console.setOutputVariable(_nRequests);
+   }
+
+   static void loadCap() {
+      CAPREG(CxCapabilityApi);
+      CAPLOAD(CxCapabilityApi);
+   };
+
+private:
+#ifndef ESP_CONSOLE_NOWIFI
+   /// reads and handles the requests of a client, false if the connection shall be closed
+   bool _loopClient(Client& c) {
+      if (!c.client.connected() && !c.client.available()) return false;
+
+      // read in blocks, at most up to the max. size of a request
+      char buf[128];
+      while (c.client.available() && c.strRequest.length() < _nMAX_REQUEST) {
+         size_t nRoom = _nMAX_REQUEST - c.strRequest.length();
+         int n = c.client.read((uint8_t*)buf, std::min(sizeof(buf), nRoom));
+         if (n <= 0) break;
+         c.strRequest.concat(buf, (unsigned int)n);
+         c.nLast = (uint32_t)millis();
+      }
+
+      if ((uint32_t)millis() - c.nLast > _nKEEPALIVE) return false;
+
+      // handle all complete requests (pipelined)
+      while (true) {
+         int nHeaderEnd = c.strRequest.indexOf("\r\n\r\n");
+         if (nHeaderEnd < 0) {
+            if (c.strRequest.length() >= _nMAX_REQUEST) {
+               _sendError(c.client, 413, "request too large", false);
+               return false;
+            }
+            return true;
+         }
+
+         String strHeader = c.strRequest.substring(0, nHeaderEnd);
+         String strLower = strHeader;
+         strLower.toLowerCase();
+
+         uint32_t nContentLength = 0;
+         int nPos = strLower.indexOf("\r\ncontent-length:");
+         if (nPos >= 0) nContentLength = (uint32_t)strHeader.substring(nPos + 17).toInt();
+
+         uint32_t nBodyStart = (uint32_t)nHeaderEnd + 4;
+         if (nBodyStart + nContentLength > _nMAX_REQUEST) {
+            _sendError(c.client, 413, "request too large", false);
+            return false;
+         }
+         if (c.strRequest.length() < nBodyStart + nContentLength) return true; // body incomplete
+
+         String strBody = c.strRequest.substring(nBodyStart, nBodyStart + nContentLength);
+         c.strRequest.remove(0, nBodyStart + nContentLength);
+
+         // request line: <method> <path> <version>
+         CxStrToken tkLine(strHeader.substring(0, strHeader.indexOf("\r\n")).c_str(), " ");
+         String strMethod = TKTOCHAR(tkLine, 0);
+         String strPath = TKTOCHAR(tkLine, 1);
+         String strVersion = TKTOCHAR(tkLine, 2);
+
+         bool bKeepAlive;
+         if (strVersion == "HTTP/1.1") {
+            bKeepAlive = (strLower.indexOf("\r\nconnection: close") < 0);
+         } else {
+            bKeepAlive = (strLower.indexOf("\r\nconnection: keep-alive") >= 0);
+         }
+
+         _nRequests++;
+         _handleRequest(c.client, strMethod, strPath, strBody, bKeepAlive);
+
+         if (!bKeepAlive) return false;
+      }
+   }
+
+   void _handleRequest(WiFiClient& client, const String& strMethod, const String& strPath, const String& strBody, bool bKeepAlive) {
+      std::vector<String> vCmds;
+
+      int nQuery = strPath.indexOf('?');
+      String strRoute = (nQuery < 0) ? strPath : strPath.substring(0, nQuery);
+
+      if (strRoute != "/cmd") {
+         _sendError(client, 404, "not found", bKeepAlive);
+         return;
+      }
+
+      if (strMethod == "POST") {
+         // one command per line
+         int nStart = 0;
+         while (nStart < (int)strBody.length()) {
+            int nEnd = strBody.indexOf('\n', nStart);
+            if (nEnd < 0) nEnd = strBody.length();
+            String strCmd = strBody.substring(nStart, nEnd);
+            strCmd.trim();
+            if (strCmd.length()) vCmds.push_back(strCmd);
+            nStart = nEnd + 1;
+         }
+      } else if (strMethod == "GET") {
+         // c=<command>&c=<command>...
+         String strQuery = (nQuery < 0) ? "" : strPath.substring(nQuery + 1);
+         int nStart = 0;
+         while (nStart < (int)strQuery.length()) {
+            int nEnd = strQuery.indexOf('&', nStart);
+            if (nEnd < 0) nEnd = strQuery.length();
+            String strParam = strQuery.substring(nStart, nEnd);
+            if (strParam.startsWith("c=")) {
+               String strCmd;
+               if (!_urlDecode(strParam.substring(2), strCmd)) {
+                  _sendError(client, 400, "bad url encoding", bKeepAlive);
+                  return;
+               }
+               strCmd.trim();
+               if (strCmd.length()) vCmds.push_back(strCmd);
+            }
+            nStart = nEnd + 1;
+         }
+      } else {
+         _sendError(client, 405, "method not allowed", bKeepAlive);
+         return;
+      }
+
+      if (vCmds.empty()) {
+         _sendError(client, 400, "no command", bKeepAlive);
+         return;
+      }
+
+      client.print(F("HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nTransfer-Encoding: chunked\r\n"));
+      client.print(bKeepAlive ? F("Connection: keep-alive\r\n\r\n") : F("Connection: close\r\n\r\n"));
+
+      // the commands of the request don't change the output variable of the console
+      const char* szSavedOut = __console.getVariable(">");
+      bool bSavedOut = (szSavedOut != nullptr);
+      String strSavedOut = bSavedOut ? szSavedOut : "";
+
+      {
+         CxChunkedPrint out([&client](const char* buf, size_t len) {
+            client.printf("%" PRIX32 "\r\n", (uint32_t)len);
+            client.write((const uint8_t*)buf, len);
+            client.print(F("\r\n"));
+         });
+
+         out.print(F("{\"results\":["));
+         bool bFirst = true;
+         for (const auto& strCmd : vCmds) {
+            if (!bFirst) out.print(',');
+            bFirst = false;
+
+            out.print(F("{\"cmd\":\""));
+            CxStreamTemplate::printJsonString(out, strCmd.c_str());
+            out.print(F("\",\"output\":\""));
+
+            CxJsonStringStream json(out);
+            CxEscFilterStream plain(&json);
+            plain.setEnabled(true);
+            __console.removeVariable(">");
+            uint32_t nStart = (uint32_t)micros();
+            __console.processCmd(plain, strCmd.c_str(), 1);
+            uint32_t nTime = (uint32_t)micros() - nStart;
+            _nCommands++;
+
+            out.printf("\",\"exit\":%" PRIu32 ",\"out\":", __console.getExitValue());
+            const char* szOut = __console.getVariable(">");
+            if (szOut) {
+               out.print('"');
+               CxStreamTemplate::printJsonString(out, szOut);
+               out.print('"');
+            } else {
+               out.print(F("null"));
+            }
+            out.printf(",\"ms\":%.3f}", nTime / 1000.0f);
+         }
+         out.print(F("]}"));
+      }
+      client.print(F("0\r\n\r\n"));
+
+      if (bSavedOut) {
+         __console.setOutputVariable(strSavedOut.c_str());
+      } else {
+         __console.removeVariable(">");
+      }
+   }
+
+   void _sendError(WiFiClient& client, int nCode, const char* szMsg, bool bKeepAlive) {
+      char szBody[64];
+      snprintf(szBody, sizeof(szBody), "{\"error\":\"%s\"}", szMsg);
+      client.printf("HTTP/1.1 %d %s\r\nContent-Type: application/json\r\nContent-Length: %" PRIu32 "\r\nConnection: %s\r\n\r\n", nCode, szMsg, (uint32_t)strlen(szBody), bKeepAlive ? "keep-alive" : "close");
+      client.print(szBody);
+   }
+
+   /// decodes a url encoded parameter, an invalid %xx is taken as is, false for an encoded NUL
+   static bool _urlDecode(const String& str, String& strResult) {
+      strResult = "";
+      strResult.reserve(str.length());
+      for (uint32_t i = 0; i < str.length(); i++) {
+         char c = str[i];
+         if (c == '+') {
+            strResult += ' ';
+         } else if (c == '%' && i + 2 < str.length() && isxdigit((unsigned char)str[i + 1]) && isxdigit((unsigned char)str[i + 2])) {
+            char szHex[3] = {str[i + 1], str[i + 2], '\0'};
+            char cDecoded = (char)strtol(szHex, nullptr, 16);
+            if (!cDecoded) return false;
+            strResult += cDecoded;
+            i += 2;
+         } else {
+            strResult += c;
+         }
+      }
+      return true;
+   }
+#endif /* ESP_CONSOLE_NOWIFI */
+};
+
+#endif /* CxCapabilityApi_hpp */
@@ -50,6 +50,7 @@
 
 #include "CxCapability.hpp"
 #include "CxESPConsole.hpp"
+#include "../tools/CxServiceManager.hpp"
 
 /**
  * @class CxCapabilityBasic
@@ -68,7 +69,7 @@ public:
    : CxCapability("basic", getCmds()) {}
    static constexpr const char* getName() { return "basic"; }
    static const std::vector<const char*>& getCmds() {
-      static std::vector<const char*> commands = { "?", "reboot", "cls", "info", "uptime", "time", "date", "heap", "hostname", "ip", "ssid", "exit", "users", "usr", "cap", "net", "ps", "stack", "delay", "echo", "wlcm", "prompt", "loopdelay", "timer", "ntp" };
+      static std::vector<const char*> commands = { "?", "reboot", "cls", "info", "uptime", "time", "date", "heap", "hostname", "ip", "ssid", "exit", "users", "usr", "cap", "net", "ps", "stack", "delay", "echo", "wlcm", "prompt", "loopdelay", "timer", "ntp", "svc", "fmt", "term" };
       return commands;
    }
    static std::unique_ptr<CxCapability> construct(const char* param) {
@@ -90,8 +91,10 @@ public:
 
    }
    
-   /// Loop method, currently no recurring tasks to handle.
+   /// Loop method, commits changes of the EEPROM shadow after a delay and starts the services.
    void loop() override {
+      ::eepromLoop();
+      CxServiceManager::getInstance().loop();
    }
    
    /// Execute a command
@@ -227,6 +230,14 @@ public:
             } else if (strSubCmd == "up") {
                println((int32_t)__console.getUpTimeSeconds());
                __console.setOutputVariable((int32_t)__console.getUpTimeSeconds());
+            } else if (strSubCmd == "boot") {
+               // info boot [set]
+               const char* szOpt = TKTOCHAR(tkArgs, 2);
+               if (szOpt && strcmp(szOpt, "set") == 0) {
+                  setBootVariables();
+               } else {
+                  g_Boot.print(getIoStream());
+               }
             }
          } else {
             printInfo();
@@ -279,6 +290,56 @@ public:
             }
          }
          
+      } else if (cmd == "fmt") {
+         // fmt [text|json|kv] [<command>]: output format of tables, for the session or the given command only
+         const char* szFmt = TKTOCHAR(tkArgs, 1);
+         CxTablePrinter::e_format fmt = __console.getTableFormat();
+         if (!szFmt) {
+            println(CxTablePrinter::getFormatName(fmt));
+            __console.setOutputVariable(CxTablePrinter::getFormatName(fmt));
+            nExitValue = EXIT_SUCCESS;
+         } else {
+            CxTablePrinter::e_format set;
+            if (!CxTablePrinter::parseFormat(szFmt, set)) {
+               println(F("usage: fmt [text|json|kv] [<command>]"));
+            } else if (tkArgs.count() > 2) {
+               __console.setTableFormat(set);
+               nExitValue = __console.processCmd(getIoStream(), TKTOCHARAFTER(tkArgs, 2), nClient);
+               __console.setTableFormat(fmt);
+            } else {
+               __console.setTableFormat(set);
+               nExitValue = EXIT_SUCCESS;
+            }
+         }
+      } else if (cmd == "term") {
+         // term [on|off|auto]: the session is a terminal (ESC sequences, prompt, echo) or gets plain text
+         CxESPConsole& con = __console.getConsole(nClient);
+         String strMode = TKTOCHAR(tkArgs, 1);
+         if (strMode == "on") {
+            con.setTerminal(true);
+            nExitValue = EXIT_SUCCESS;
+         } else if (strMode == "off") {
+            con.setTerminal(false);
+            nExitValue = EXIT_SUCCESS;
+         } else if (strMode == "auto") {
+            con.probeTerminal();
+            nExitValue = EXIT_SUCCESS;
+         } else if (strMode.length() == 0) {
+            printf(F(ESC_ATTR_BOLD "Terminal: " ESC_ATTR_RESET "%s%s\n"), con.isSessionTerminal() ? "yes" : "no", con.isTermProbe() ? " (probing)" : "");
+            printf(F(ESC_ATTR_BOLD "Removed:  " ESC_ATTR_RESET "%u bytes\n"), con.getEscDropped());
+            CxOutputQueue& queue = con.getOutputQueue();
+            printf(F(ESC_ATTR_BOLD "Queue:    " ESC_ATTR_RESET "%u / %u bytes\n"), queue.getQueued(), queue.getSize());
+            printf(F(ESC_ATTR_BOLD "Deferred: " ESC_ATTR_RESET "%" PRIu32 " bytes\n"), queue.getDeferred());
+            printf(F(ESC_ATTR_BOLD "Dropped:  " ESC_ATTR_RESET "%" PRIu32 " bytes (log)\n"), queue.getDropped());
+            printf(F(ESC_ATTR_BOLD "Blocked:  " ESC_ATTR_RESET "%" PRIu32 " ms (max. %" PRIu32 " ms)\n"), queue.getBlockedMs(), queue.getMaxBlockedMs());
+            __console.setOutputVariable(con.isSessionTerminal() ? "1" : "0");
+            nExitValue = EXIT_SUCCESS;
+         } else {
+            println(F("usage: term [on|off|auto]"));
+         }
+      } else if (cmd == "svc") {
+         CxServiceManager::getInstance().print(getIoStream());
+         nExitValue = EXIT_SUCCESS;
       } else if (cmd == "time") {
          if(__console.getStream()) __console.setOutputVariable(__console.printTime(*__console.getStream(), true));
          println();
@@ -338,6 +399,8 @@ public:
 #ifndef ESP_CONSOLE_NOWIFI
          _CONSOLE_INFO(F("exit wifi client"));
          //console._abortClient();
+         // an attached session (e.g. websocket) is closed by its server, not by a command of the api
+         if (nClient && __console.getStream() == __console.getConsole(nClient).getStream()) __console.requestDetach();
 #else
          printf(F("exit has no function!"));
 #endif
@@ -523,7 +586,7 @@ public:
          }
          else if (strSubCmd == "list") {
             // list all timers
-            __console.printTimers(getIoStream());
+            __console.printTimers(getIoStream(), __console.getTableFormat());
             nExitValue = EXIT_SUCCESS;
          } else {
             __console.man(cmd.c_str());
@@ -538,6 +601,8 @@ public:
       
    void reboot() {
       __console.warn(F("reboot..."));
+      ::eepromCommit();
+      __console.flush(); // send the queued output
 #ifdef ARDUINO
       delay(1000); // let some time to handle last network messages
 #ifndef ESP_CONSOLE_NOWIFI
@@ -605,7 +670,35 @@ public:
       print(F("    "));g_Stack.print(getIoStream());
    }
    
+   /**
+    * @brief Sets a variable BOOT_<phase> with the duration (us) for each boot phase
+    * @details Characters not allowed in variable names are replaced by '_', e.g. BOOT_setup_fs, BOOT_init_final.
+    */
+   void setBootVariables() {
+      uint32_t nEnd = 0;
+      for (uint8_t i = 0; i < g_Boot.count(); i++) {
+         const CxESPBootProfiler::Phase& phase = g_Boot.get(i);
+         char szName[CxESPBootProfiler::_nMAX_NAME + 6];
+         snprintf(szName, sizeof(szName), "BOOT_%s", phase.szName);
+         for (char* p = szName; *p; p++) {
+            if (!isalnum((unsigned char)*p)) *p = '_';
+         }
+         __console.addVariable(szName, phase.nDuration);
+         if (phase.nDepth == 0 && phase.nStart + phase.nDuration > nEnd) nEnd = phase.nStart + phase.nDuration;
+      }
+      __console.addVariable("BOOT_TOTAL", nEnd);
+      __console.setOutputVariable(nEnd);
+   }
+   
    void printHeap() {
+      if (__console.getTableFormat() != CxTablePrinter::e_format::text) {
+         CxTablePrinter table(getIoStream(), __console.getTableFormat());
+         table.printHeader({F("Size"), F("Used"), F("Free"), F("Low"), F("Fragm"), F("Peak")}, {});
+         table.printRow({String(g_Heap.size()), String(g_Heap.used()), String(g_Heap.available()), String(g_Heap.low()), String(g_Heap.fragmentation()), String(g_Heap.peak())});
+         table.printFooter();
+         __console.setOutputVariable((uint32_t)g_Heap.available());
+         return;
+      }
       print(F(ESC_ATTR_BOLD " Heap Size: " ESC_ATTR_RESET));printHeapSize();print(F(" bytes"));
       print(F(ESC_ATTR_BOLD " Used: " ESC_ATTR_RESET));printHeapUsed();print(F(" bytes"));
       print(F(ESC_ATTR_BOLD " Free: " ESC_ATTR_RESET));printHeapAvailable();print(F(" bytes"));
@@ -66,6 +66,9 @@
 #include "ArduinoJson.h"
 
 #include "../capabilities/CxCapabilityBasic.hpp"
+#include "../tools/CxServiceManager.hpp"
+#include "../tools/CxWiFiStation.hpp"
+#include "../tools/CxWiFiScan.hpp"
 
 #include "../tools/CxGpioTracker.hpp"
 #include "../tools/CxLed.hpp"
@@ -93,34 +96,11 @@ const byte DNS_PORT = 53;
 
 #endif /* ARDUINO */
 
-#if !defined(CxCapabilityFS_hpp)
+/// precompressed assets of the captive portal, generated by build_html.sh
+#include "CxHtmlAssets.h"
+#include "../tools/CxStreamTemplate.hpp"
 
-// HTML page for the AP without CSS style to save some bin size
-const char htmlPageTemplate[] PROGMEM = R"rawliteral(
-<!DOCTYPE html>
-<html lang="en">
-<head>
-  <meta charset="UTF-8">
-  <meta name="viewport" content="width=device-width, initial-scale=1.0">
-  <title>WiFi Setup</title>
-</head>
-<body>
-  <div class="container">
-    <h1>WiFi Setup</h1>
-    <form action="/connect" method="POST">
-      <label for="ssid">WiFi Network:</label>
-      <select id="ssid" name="ssid" required>
-        {{options}}
-      </select>
-      <label for="password">Password:</label>
-      <input type="password" id="password" name="password" required>
-      <button type="submit">Connect</button>
-    </form>
-  </div>
-</body>
-</html>
-)rawliteral";
-#else
+#if defined(CxCapabilityFS_hpp)
 
 #ifdef ARDUINO
 #include <FS.h>
@@ -141,7 +121,7 @@ struct FSInfo {
 #endif /* ESP32*/
 #endif /* ARDUINO */
 
-#endif /* !defined(CxCapabilityFS_hpp)  */
+#endif /* defined(CxCapabilityFS_hpp)  */
 
 /// global objects for OTA and LED
 CxOta Ota1;
@@ -171,6 +151,13 @@ class CxCapabilityExt : public CxCapability {
    
    bool _bWifiConnected = false;
    
+   /// pending connection started by startWiFi()
+   CxWiFiStation& _wifiStation = CxWiFiStation::getInstance();
+   bool _bWifiConnecting = false;
+   bool _bWifiFallbackAP = false;  ///< back to AP mode, if the connect fails (started by the captive portal)
+   bool _bBootUp = false;          ///< boot-up of init.bat has run after the first wifi-up
+   String _strWifiSSID;
+   
    std::map<String, String> _mapProcessJsonDataItems;
    
 public:
@@ -187,6 +174,8 @@ public:
    
    /// Destructor to end the capability and stop OTA and Wifi
    ~CxCapabilityExt() {
+      CxServiceManager::getInstance().removeService("wifi");
+      CxServiceManager::getInstance().removeService("ntp");
       Ota1.end();
       stopWiFi();
    }
@@ -249,6 +238,15 @@ public:
       });
       
       Ota1.begin(__console.getHostName(), szOtaPassword);
+      
+#ifndef ESP_CONSOLE_NOWIFI
+      /// wifi is started by the command 'wifi connect', the time sync is started, when wifi is up
+      CxServiceManager& svc = CxServiceManager::getInstance();
+      svc.addService("wifi", {}, [this]() {return __console.isConnected();});
+      svc.addService("ntp", {"wifi"}, [this]() {return __console.isSynced();},
+                     [this]() {__console.startSync();},
+                     [this]() {return __console.getNtpServer() && *__console.getNtpServer();});
+#endif
    }
    
    /// Loop method to update sensor data, handle OTA updates, and manage LED status and web server requests.
@@ -261,6 +259,10 @@ public:
 #endif
 #endif
 
+      /// complete a pending wifi connection and scan
+      CxWiFiScan::getInstance().loop();
+      _loopWiFi();
+      
       /// update led indications, if any
       ledAction();
       
@@ -393,7 +395,18 @@ public:
             nExitValue = EXIT_SUCCESS;
          }
       } else if (cmd == "eeprom") {
-         if (a) {
+         if (a && strcmp(a, "commit") == 0) {
+            nExitValue = ::eepromCommit() ? EXIT_SUCCESS : EXIT_FAILURE;
+         } else if (a && strcmp(a, "info") == 0) {
+            printf(F(ESC_ATTR_BOLD "Sector erases: " ESC_ATTR_RESET "%u (since boot)\n"), ::getEEPROMErases());
+            if (::isEEPROMDirty()) {
+               printf(F(ESC_ATTR_BOLD "Pending:       " ESC_ATTR_RESET "0x%03X..0x%03X\n"), ::getEEPROMDirtyFrom(), ::getEEPROMDirtyTo() - 1);
+            } else {
+               println(F(ESC_ATTR_BOLD "Pending:       " ESC_ATTR_RESET "-"));
+            }
+            __console.setOutputVariable(::getEEPROMErases());
+            nExitValue = EXIT_SUCCESS;
+         } else if (a) {
             ::printEEPROM(getIoStream(), TKTOINT(tkArgs, 1, 0), TKTOINT(tkArgs, 2, 128));
             nExitValue = EXIT_SUCCESS;
          } else {
@@ -441,7 +454,47 @@ public:
          } else if (strCmd == "disconnect") {
             stopWiFi();
          } else if (strCmd == "scan") {
-            ::scanWiFi(getIoStream());
+            // results are printed from the cache, a new scan runs in the background
+            CxWiFiScan& scan = CxWiFiScan::getInstance();
+            if (b && strcmp(b, "age") == 0) {
+               if (TKTOCHAR(tkArgs, 3)) {
+                  scan.setMaxAge(TKTOINT(tkArgs, 3, 60) * 1000);
+               } else {
+                  print(F(ESC_ATTR_BOLD "Max. age: " ESC_ATTR_RESET)); print(scan.getMaxAge() / 1000); println(F(" s"));
+               }
+            } else {
+               if (b && strcmp(b, "refresh") == 0) {
+                  scan.start();
+               } else {
+                  scan.refresh();
+               }
+               scan.print(getIoStream());
+               __console.setOutputVariable((uint32_t)scan.getNetworks().size());
+            }
+         } else if (strCmd == "stat") {
+            _wifiStation.printInfo(getIoStream());
+            __console.setOutputVariable(_wifiStation.getLast());
+         } else if (strCmd == "fast") {
+            if (b && strcmp(b, "clear") == 0) {
+               _wifiStation.clearCache();
+            } else if (b) {
+               _wifiStation.setFast((bool)TKTOINT(tkArgs, 2, 1));
+            } else {
+               print(F(ESC_ATTR_BOLD "Fast connect: " ESC_ATTR_RESET)); println(_wifiStation.isFast() ? "on" : "off");
+            }
+         } else if (strCmd == "static") {
+#ifdef ARDUINO
+            IPAddress ip, gw, mask, dns;
+            if (b && strcmp(b, "dhcp") == 0) {
+               _wifiStation.setStaticIP(0, 0, 0, 0);
+            } else if (ip.fromString(b ? b : "") && gw.fromString(TKTOCHAR(tkArgs, 3) ? TKTOCHAR(tkArgs, 3) : "") && mask.fromString(TKTOCHAR(tkArgs, 4) ? TKTOCHAR(tkArgs, 4) : "")) {
+               if (!TKTOCHAR(tkArgs, 5) || !dns.fromString(TKTOCHAR(tkArgs, 5))) dns = gw;
+               _wifiStation.setStaticIP((uint32_t)ip, (uint32_t)gw, (uint32_t)mask, (uint32_t)dns);
+            } else {
+               println(F("usage: wifi static <ip> <gateway> <mask> [<dns>] | dhcp"));
+               nExitValue = EXIT_FAILURE;
+            }
+#endif
          } else if (strCmd == "otapw") {
             if (b) {
                ::writeOtaPassword(TKTOCHAR(tkArgs, 2));
@@ -515,7 +568,7 @@ public:
          String strEnv = ".gpio";
          
          if (strSubCmd == "state") {
-            CxTablePrinter table(getIoStream());
+            CxTablePrinter table(getIoStream(), __console.getTableFormat());
 #ifndef MINIMAL_COMMAND_SET
             table.printHeader({F("Pin"), F("Mode"), F("inv"), F("State"), F("PWM"), F("Value")}, {3, 10, 3, 5, 8, 6});
 #else
@@ -797,7 +850,7 @@ public:
                p->enableISR();
                nExitValue = EXIT_SUCCESS;
             } else {
-               CxTablePrinter table(getIoStream());
+               CxTablePrinter table(getIoStream(), __console.getTableFormat());
                table.printHeader({F("ID"), F("Counter"), F("Debounce")}, {3, 10, 8});
                for (int i = 0; i < 3; i++) {
                   table.printRow({String(i).c_str(), String(g_anEdgeCounter[i]).c_str(), String(g_anDebounceDelay[i]).c_str()});
@@ -1116,7 +1169,7 @@ public:
             _mapProcessJsonDataItems[TKTOCHAR(tkArgs, 2)] = TKTOCHAR(tkArgs, 3);
             nExitValue = EXIT_SUCCESS;
          } else if (strType == "list") {
-            CxTablePrinter table(getIoStream());
+            CxTablePrinter table(getIoStream(), __console.getTableFormat());
             table.printHeader({F("Json Path"), F("Command")}, {20, 40});
             for (const auto& pair : _mapProcessJsonDataItems) {
                table.printRow({pair.first, pair.second.c_str()});
@@ -1459,8 +1512,6 @@ public:
    }
 
    void startWiFi(const char* ssid = nullptr, const char* pw = nullptr) {
-      bool bUp = false;
-      
 #ifndef ESP_CONSOLE_NOWIFI
       _stopAP();
       
@@ -1468,90 +1519,106 @@ public:
          stopWiFi();
       }
       
-      if (!bUp) {
-         //
-         // Set the ssid, password and hostname from the console settings or from the arguments.
-         // If set by the arguments, it will replace settings stored in the eprom.
-         //
-         // All can be set in the console with the commands
-         //   wifi ssid <ssid>
-         //   wifi password <password>
-         //   wifi hostname <hostname>
-         // These settings will be stored in the EEPROM.
-         //
-         
-         static char szSSID[20];
-         static char szPassword[25];
-         static char szHostname[80];
-         
-         if (ssid) ::writeSSID(ssid);
+      //
+      // Set the ssid, password and hostname from the console settings or from the arguments.
+      // If set by the arguments, they replace the settings stored in the eeprom, when connected.
+      //
+      // All can be set in the console with the commands
+      //   wifi ssid <ssid>
+      //   wifi password <password>
+      //   wifi hostname <hostname>
+      // These settings will be stored in the EEPROM.
+      //
+      
+      static char szSSID[20];
+      static char szPassword[25];
+      static char szHostname[80];
+      
+      if (ssid) {
+         strncpy(szSSID, ssid, sizeof(szSSID) - 1);
+         szSSID[sizeof(szSSID) - 1] = '\0';
+      } else {
          ::readSSID(szSSID, sizeof(szSSID));
-         
-         if (pw) ::writePassword(pw);
+      }
+      
+      if (pw) {
+         strncpy(szPassword, pw, sizeof(szPassword) - 1);
+         szPassword[sizeof(szPassword) - 1] = '\0';
+      } else {
          ::readPassword(szPassword, sizeof(szPassword));
-         
-         ::readHostName(szHostname, sizeof(szHostname));
-         
+      }
+      
+      ::readHostName(szHostname, sizeof(szHostname));
+      
 #ifdef ARDUINO
-         WiFi.persistent(false); // Disable persistent WiFi settings, preventing flash wear and keep control of saved settings
-         WiFi.mode(WIFI_STA);
-         WiFi.begin(szSSID, szPassword);
-         WiFi.setAutoReconnect(true);
-         WiFi.hostname(szHostname);
-         
-         printf(F(ESC_ATTR_BOLD "WiFi: connecting to %s" ESC_ATTR_RESET), szSSID);
-         print(F(ESC_ATTR_BLINK "..." ESC_ATTR_RESET));
-         
-         Led1.blinkConnect();
-         
-         // try to connect to the network for max. 10 seconds
-         CxTimer10s timerTO; // set timeout
-         
-         while (WiFi.status() != WL_CONNECTED && !timerTO.isDue()) {
-            Led1.action();
-            delay(1);
+      WiFi.persistent(false); // Disable persistent WiFi settings, preventing flash wear and keep control of saved settings
+      WiFi.mode(WIFI_STA);
+      WiFi.hostname(szHostname);
+      _wifiStation.begin(szSSID, szPassword, ssid || pw);
+      WiFi.setAutoReconnect(true);
+      
+      printf(F(ESC_ATTR_BOLD "WiFi: connecting to %s" ESC_ATTR_RESET), szSSID);
+      print(F(ESC_ATTR_BLINK "..." ESC_ATTR_RESET));
+      
+      Led1.blinkConnect();
+      
+      // the connection is completed in the loop, the cached access point is tried first
+      _strWifiSSID = szSSID;
+      _bWifiConnecting = true;
+#endif /* Arduino */
+#endif /* ESP_CONSOLE_NOWIFI */
+   }
+   
+   /// completes a connection started by startWiFi() without blocking the loop
+   void _loopWiFi() {
+#if defined(ARDUINO) && !defined(ESP_CONSOLE_NOWIFI)
+      _wifiStation.loop();
+      if (!_bWifiConnecting || _wifiStation.isConnecting()) return;
+      
+      bool bConnected = (_wifiStation.getState() == CxWiFiStation::e_state::connected);
+      _bWifiConnecting = false;
+      
+      // stop blinking "..." and let the message on the screen
+      print(ESC_CLEAR_LINE "\r");
+      printf(F(ESC_ATTR_BOLD "WiFi: connecting to %s..." ESC_ATTR_RESET), _strWifiSSID.c_str());
+      
+      Led1.off();
+      
+      if (!bConnected) {
+         _bWifiConnected = true;
+         println(F(ESC_ATTR_BOLD ESC_TEXT_BRIGHT_RED "not connected!" ESC_ATTR_RESET));
+         __console.error("WiFi not connected.");
+         Led1.blinkError();
+         if (_bWifiFallbackAP) {
+            _bWifiFallbackAP = false;
+            _beginAP();
          }
-         
-         // stop blinking "..." and let the message on the screen
-         print(ESC_CLEAR_LINE "\r");
-         printf(F(ESC_ATTR_BOLD "WiFi: connecting to %s..." ESC_ATTR_RESET), szSSID);
-         
-         Led1.off();
-         
-         if (WiFi.status() != WL_CONNECTED) {
-            _bWifiConnected = true;
-            println(F(ESC_ATTR_BOLD ESC_TEXT_BRIGHT_RED "not connected!" ESC_ATTR_RESET));
-            __console.error("WiFi not connected.");
-            Led1.blinkError();
-         } else {
-            println(F(ESC_TEXT_BRIGHT_GREEN "connected!" ESC_ATTR_RESET));
-            _CONSOLE_INFO("WiFi connected.");
-            Led1.flashOk();
-            if (WiFi.getHostname() != szHostname) {
+      } else {
+         _bWifiFallbackAP = false;
+         println(F(ESC_TEXT_BRIGHT_GREEN "connected!" ESC_ATTR_RESET));
+         _CONSOLE_INFO("WiFi connected.");
+         Led1.flashOk();
 #ifdef ESP32
-               __console.setHostName(WiFi.getHostname().c_str());
+         __console.setHostName(WiFi.getHostname());
 #else
-               __console.setHostName(WiFi.hostname().c_str());
+         __console.setHostName(WiFi.hostname().c_str());
 #endif
-            }
-            
-            bUp = true;
-         }
-         
-#endif /* Arduino */
-         
-      }
-      
-      if (bUp) {
          __console.executeBatch("init", "wifi-up");
+         // the boot was successful, when wifi-up has run the first time: the safemode file is removed not before
+         if (!_bBootUp && !__console.isSafeMode()) {
+            _bBootUp = true;
+            __console.executeBatch("init", "boot-up");
+         }
          checkWifi();
       }
+#endif
    }
    
    void stopWiFi() {
       _CONSOLE_INFO(F("WiFi disconnect and switch off."));
       println(F("WiFi disconnect and switch off."));
 #ifdef ARDUINO
+      _wifiStation.end();
       WiFi.disconnect();
       WiFi.softAPdisconnect();
       WiFi.mode(WIFI_OFF);
@@ -1562,82 +1629,67 @@ public:
    }
    
 private:
-   /// handle the root request from the web client to provide a captive portal for wifi connection.
-   static void _handleRoot() {
+   /// sends an asset of the captive portal. Static assets are sent gzip compressed or with 304, if the client has it already.
+   static void _sendAsset(const CxHtmlAsset& asset) {
 #ifdef ARDUINO
-      String htmlPage;
-
-#if defined(CxCapabilityFS_hpp) && !defined(ESP_CONSOLE_NOWIFI)
-      File file = LittleFS.open("/ap.html", "r");
-      if (!file) {
-         webServer.send(404, "text/plain", "HTML file not found");
-         return;
-      }
-      
-      htmlPage = file.readString();
-      file.close();
-#else
-      htmlPage = htmlPageTemplate;
-#endif /* CxCapabilityFS_hpp */
-      
-      // Scan for available Wi-Fi networks
-      int n = WiFi.scanNetworks();
-      String options = "";
-      
-      if (n == 0) {
-         options = "<option value=\"\">No networks found</option>";
+      if (asset.bGzip) {
+         if (webServer.header("If-None-Match") == asset.szETag) {
+            webServer.send(304);
+            return;
+         }
+         webServer.sendHeader("ETag", asset.szETag);
+         webServer.sendHeader("Cache-Control", "no-cache"); // revalidate with the etag
+         webServer.sendHeader("Content-Encoding", "gzip");
+         webServer.send_P(200, asset.szMime, (PGM_P)asset.pData, asset.nLength);
       } else {
-         for (int i = 0; i < n; ++i) {
-            // Get network name (SSID) and signal strength
-            String ssid = WiFi.SSID(i);
-            int rssi = WiFi.RSSI(i);
-            options += "<option value=\"" + ssid + "\">" + ssid + " (Signal: " + String(rssi) + " dBm)</option>";
+         webServer.sendHeader("Cache-Control", "no-store");
+         webServer.setContentLength(CONTENT_LENGTH_UNKNOWN);
+         webServer.send(200, asset.szMime, "");
+         {
+            CxChunkedPrint out([](const char* buf, size_t len) {webServer.sendContent(buf, len);});
+            CxStreamTemplate::render(asset.pData, asset.nLength, out, _printTemplateValue);
          }
+         webServer.sendContent("");
       }
-      
-      // Replace placeholder with actual network options
-      htmlPage.replace("{{options}}", options);
-      
-      webServer.send(200, "text/html", htmlPage);
 #endif /* ARDUINO */
    }
 
+   /// dynamic values of the captive portal
+   static void _printTemplateValue(const char* szName, Print& out) {
+      CxWiFiScan& scan = CxWiFiScan::getInstance();
+      if (strcmp(szName, "hostname") == 0) {
+         CxStreamTemplate::printJsonString(out, CxESPConsoleMaster::getInstance().getHostName());
+      } else if (strcmp(szName, "scanning") == 0) {
+         // a new scan runs in the background, if the networks are outdated
+         scan.refresh();
+         out.print(scan.isScanning() ? "true" : "false");
+      } else if (strcmp(szName, "networks") == 0) {
+         bool bFirst = true;
+         for (const auto& network : scan.getNetworks()) {
+            if (!bFirst) out.print(',');
+            bFirst = false;
+            out.print(F("{\"s\":\""));
+            CxStreamTemplate::printJsonString(out, network.strSSID.c_str());
+            out.printf("\",\"r\":%d,\"o\":%d}", network.nRSSI, network.bOpen);
+         }
+      }
+   }
+
    /// Handle the connect request from the captive portal to connect to a WiFi network.
-   static void _handleConnect() {
+   void _handleConnect() {
 #ifdef ARDUINO
       
       if (webServer.hasArg("ssid") && webServer.hasArg("password")) {
          String ssid = webServer.arg("ssid");
          String password = webServer.arg("password");
          
-         CxESPConsoleMaster& con = CxESPConsoleMaster::getInstance();
-
-         
          webServer.send(200, "text/plain", "Attempting to connect to WiFi...");
-         con.info(F("SSID: %s, Password: %s"), ssid.c_str(), password.c_str());
-         
-         // Attempt WiFi connection
-         WiFi.begin(ssid.c_str(), password.c_str());
-         
-         // Wait a bit to connect
-         CxTimer10s timerTO; // set timeout
+         _CONSOLE_INFO(F("SSID: %s"), ssid.c_str());
          
-         while (WiFi.status() != WL_CONNECTED && !timerTO.isDue()) {
-            delay(1);
-         }
-         
-         if (WiFi.status() == WL_CONNECTED) {
-            con.info("Connected successfully!");
-            webServer.send(200, "text/plain", "Connected to WiFi!");
-            
-            // switch to STA mode, saves credentials and stop web and dns server.
-            String cmd = "wifi connect ";
-            cmd += ssid + " " + password;
-            con.processCmd(cmd.c_str());
-         } else {
-            con.error("Connection failed.");
-            webServer.send(200, "text/plain", "Failed to connect. Check credentials.");
-         }
+         // switch to STA mode and stop web and dns server. The connection is completed in the loop, the
+         // credentials are saved, when connected. If it fails, the AP mode is started again.
+         startWiFi(ssid.c_str(), password.c_str());
+         _bWifiFallbackAP = true;
       } else {
          webServer.send(400, "text/plain", "Missing SSID or Password");
       }
@@ -1665,8 +1717,17 @@ private:
          dnsServer.start(DNS_PORT, "*", WiFi.softAPIP());
          
          // Define routes
-         webServer.on("/", _handleRoot);
-         webServer.on("/connect", HTTP_POST, _handleConnect);
+         for (const auto& asset : g_htmlAssets) {
+            webServer.on(asset.szPath, HTTP_GET, [&asset]() {_sendAsset(asset);});
+         }
+         webServer.on("/", HTTP_GET, []() {
+            for (const auto& asset : g_htmlAssets) {
+               if (strcmp(asset.szPath, "/ap.html") == 0) _sendAsset(asset);
+            }
+         });
+         static const char* headerKeys[] = {"If-None-Match"};
+         webServer.collectHeaders(headerKeys, 1);
+         webServer.on("/connect", HTTP_POST, [this]() {_handleConnect();});
          webServer.onNotFound([]() {
             webServer.sendHeader("Location", "/", true); // Redirect to root
             webServer.send(302, "text/plain", "Redirecting to Captive Portal");
@@ -1678,6 +1739,9 @@ private:
          printf(F("ESP started in AP mode. SSID: %s, PW: %s, IP: %s\n"), __console.getHostName(), "12345678", WiFi.softAPIP().toString().c_str());
          
          __console.setAPMode(true);
+         
+         // have the networks ready for the captive portal
+         CxWiFiScan::getInstance().start();
          __console.executeBatch("init", "ap-up");
 
       } else {
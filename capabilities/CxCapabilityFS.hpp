@@ -20,8 +20,15 @@
 
 #include "../capabilities/CxCapabilityExt.hpp"
 #include "../tools/CxPersistentImpl.hpp"
+#include "../tools/CxHash.hpp"
+#include "../tools/CxKvStore.hpp"
+#include "../tools/CxFileTransfer.hpp"
+#include "../tools/CxFsIndex.hpp"
+#include "../tools/CxFileJob.hpp"
+#include "../tools/CxLogFile.hpp"
 
 #include "esphw.h"
+#include <inttypes.h>
 
 #ifndef ESP_CONSOLE_NOWIFI
 #ifdef ARDUINO
@@ -56,6 +63,21 @@ class CxCapabilityFS : public CxCapability {
    uint8_t _nBatchDepth = 0;
    
    CxTimer60s _timer60sLogServer;
+   
+   /// bulk file operation running in the background
+   std::unique_ptr<CxFileJob> _pJob;
+   
+   /// file transfer running in the background
+   std::unique_ptr<CxFileTransfer> _pXfer;
+   
+   /// cached metadata of the file system
+   CxFsIndex _index;
+   
+   /// local log file
+   CxLogFile _logFile;
+   
+   /// max. buffer size for bulk file operations
+   static constexpr size_t _nMAX_BLOCK_BUF = 4096;
 
 protected:
    CxESPConsoleMaster& __console = CxESPConsoleMaster::getInstance();
@@ -65,7 +87,7 @@ public:
    explicit CxCapabilityFS() : CxCapability("fs", getCmds()) {}
    static constexpr const char* getName() { return "fs"; }
    static const std::vector<const char*>& getCmds() {
-      static std::vector<const char*> commands = { "du", "df", "size", "ls", "cat", "cp", "rm", "touch", "mount", "umount", "format", "fs", "log", "exec", "mv", "man", "test" };
+      static std::vector<const char*> commands = { "du", "df", "size", "ls", "cat", "cp", "rm", "touch", "mount", "umount", "format", "fs", "log", "exec", "mv", "man", "test", "find", "kv" };
       return commands;
    }
    static std::unique_ptr<CxCapability> construct(const char* param) {
@@ -77,6 +99,12 @@ public:
       
       // remove log functions
       ESPConsole.clearFuncPrintLog2Server();
+      _logFile.end();
+      
+      ESPConsole.clearFuncFsChanged();
+      ::clearConfigStore();
+      CxPersistentImpl::getInstance().setFuncChanged(nullptr);
+      CxKvStore::getInstance().setFuncChanged(nullptr);
    }
    
    void setup() override {
@@ -96,17 +124,50 @@ public:
       }
 
       // implement specific fs functions
-      ESPConsole.setFuncPrintLog2Server([this](const char *sz) { this->_print2logServer(sz); });
+      ESPConsole.setFuncPrintLog2Server([this](const char *sz) { this->_logFile.add(sz); this->_print2logServer(sz); });
       ESPConsole.setFuncExecuteBatch([this](const char *sz, const char* label) { this->executeBatch(sz, label); });
       ESPConsole.setFuncMan([this](const char *sz, const char* param) { this->man(sz, param); });
+      
+      // keep the file system index coherent with the files written by others
+      auto funcChanged = [this](const char* szPath) { this->_index.update(szPath); };
+      ESPConsole.setFuncFsChanged(funcChanged);
+      _logFile.setFuncChanged(funcChanged);
+      CxPersistentImpl::getInstance().setFuncChanged(funcChanged);
+      CxKvStore::getInstance().setFuncChanged(funcChanged);
+      
+      // restore the log file settings
+      CxKvStore& kv = CxKvStore::getInstance();
+      _logFile.setMaxSize(kv.getInt("log.size", _logFile.getMaxSize()));
+      _logFile.setCount(kv.getInt("log.count", _logFile.getCount()));
+      if (kv.getBool("log.file", false) && !_logFile.begin()) __console.error(F("log file not available"));
  
-      CxPersistentImpl::getInstance().setImplementation(ESPConsole);
- 
+      // the configuration is kept in the key-value store, the former stores are imported once
+      _importConfig();
+      _setConfigStore();
+      kv.setImplementation(ESPConsole);
+      
       __console.executeBatch("init", getName());
 
    }
    
    void loop() override {
+      // continue a file transfer
+      _loopFile();
+      
+      // write the log lines kept in RAM, when the flush period has elapsed
+      _logFile.loop();
+      
+      // process the next block of a background file operation
+      if (_pJob && !_pJob->isDone()) {
+         if (!_pJob->step()) {
+            _index.invalidate();
+            if (_pJob->isError()) {
+               __console.error(F("background file operation failed after %" PRIu32 " files"), _pJob->getFiles());
+            } else {
+               _CONSOLE_INFO(F("background file operation done: %" PRIu32 " files, %" PRIu32 " bytes, %" PRIu32 " ms (%" PRIu32 " kB/s)"), _pJob->getFiles(), _pJob->getBytes(), _pJob->getTime(), _pJob->getRate());
+            }
+         }
+      }
    }
    
    uint8_t execute(const char *szCmd, uint8_t nClient) override {
@@ -140,9 +201,38 @@ public:
        } else if (cmd == "la") {
           nExitValue = ls (true, true);
        } else if (cmd == "cat") {nExitValue = cat(a);
-       } else if (cmd == "cp") {nExitValue = cp(a, b);
-       } else if (cmd == "rm") {nExitValue = rm(a);
+       } else if (cmd == "cp" || cmd == "rm") {
+          // cp [-r] <src> <dst> [&], rm [-r] <file> [&]
+          bool bRecursive = false;
+          bool bBackground = false;
+          std::vector<const char*> vArgs;
+          for (uint8_t i = 1; i < tkArgs.count(); i++) {
+             const char* sz = TKTOCHAR(tkArgs, i);
+             if (strcmp(sz, "-r") == 0) {
+                bRecursive = true;
+             } else if (strcmp(sz, "&") == 0) {
+                bBackground = true;
+             } else {
+                vArgs.push_back(sz);
+             }
+          }
+          vArgs.resize(2, nullptr);
+          if (cmd == "cp") {
+             nExitValue = cp(vArgs[0], vArgs[1], bRecursive, bBackground);
+          } else {
+             nExitValue = rm(vArgs[0], bRecursive, bBackground);
+          }
        } else if (cmd == "mv") {nExitValue = mv(a, b);
+       } else if (cmd == "find") {
+          // find [<path>] [-name <pattern>]
+          const char* szPath = (a && strcmp(a, "-name") != 0) ? a : "/";
+          const char* szPattern = nullptr;
+          for (uint8_t i = 1; i + 1 < tkArgs.count(); i++) {
+             if (strcmp(TKTOCHAR(tkArgs, i), "-name") == 0) szPattern = TKTOCHAR(tkArgs, i + 1);
+          }
+          nExitValue = find(szPath, szPattern);
+       } else if (cmd == "kv") {
+          nExitValue = kv(a, b, TKTOCHARAFTER(tkArgs, 3));
        } else if (cmd == "touch") {
           nExitValue = touch(a);
        } else if (cmd == "mount") {
@@ -158,8 +248,20 @@ public:
           return nExitValue; // MARK: ??? return, why?
        }
        else if (cmd == "fs") {
-          nExitValue = printFsInfo();
-          println();
+          String strSubCmd = TKTOCHAR(tkArgs, 1);
+          if (strSubCmd == "bench") {
+             nExitValue = bench(TKTOINT(tkArgs, 2, 64));
+          } else if (strSubCmd == "job") {
+             nExitValue = printJob(TKTOCHAR(tkArgs, 2));
+          } else if (strSubCmd == "index") {
+             // fs index [refresh]
+             if (b && strcmp(b, "refresh") == 0) _index.clear();
+             printf(F(ESC_ATTR_BOLD "Entries: " ESC_ATTR_RESET "%" PRIu32 ESC_ATTR_BOLD " Builds: " ESC_ATTR_RESET "%" PRIu32 ESC_ATTR_BOLD " Hits: " ESC_ATTR_RESET "%" PRIu32 ESC_ATTR_BOLD " Max. age: " ESC_ATTR_RESET "%" PRIu32 " ms\n"), (uint32_t)_index.getEntries().size(), _index.getBuilds(), _index.getHits(), _index.getMaxAge());
+             nExitValue = EXIT_SUCCESS;
+          } else {
+             nExitValue = printFsInfo();
+             println();
+          }
        } else if (cmd == "$UPLOAD$") {
           nExitValue = _handleFile();
        } else if (cmd == "$DOWNLOAD$") {
@@ -190,6 +292,35 @@ public:
              if (!_bLogServerAvailable) {println(F("log server not available!"));nExitValue = EXIT_FAILURE;}
           } else if (strSubCmd == "off") {
              enableLog(false);
+          } else if (strSubCmd == "file") {
+             // log file on|off|size <bytes>|count <n>|flush
+             String strOpt = TKTOCHAR(tkArgs, 2);
+             // the settings are kept in the key-value store and restored at boot
+             CxKvStore& kv = CxKvStore::getInstance();
+             if (strOpt == "on") {
+                if (!_logFile.isEnabled() && !_logFile.begin()) nExitValue = EXIT_FAILURE;
+                else kv.setBool("log.file", true);
+             } else if (strOpt == "off") {
+                _logFile.end();
+                kv.setBool("log.file", false);
+             } else if (strOpt == "size") {
+                _logFile.setMaxSize(TKTOINT(tkArgs, 3, _logFile.getMaxSize()));
+                kv.setInt("log.size", _logFile.getMaxSize());
+             } else if (strOpt == "count") {
+                _logFile.setCount(TKTOINT(tkArgs, 3, _logFile.getCount()));
+                kv.setInt("log.count", _logFile.getCount());
+             } else if (strOpt == "flush") {
+                _logFile.flush();
+             } else {
+                printf(F(ESC_ATTR_BOLD "Log file:        " ESC_ATTR_RESET "%s.0 (%s)\n"), _logFile.getPath(), _logFile.isEnabled() ? "on" : "off");
+                printf(F(ESC_ATTR_BOLD "Size:            " ESC_ATTR_RESET "%" PRIu32 " of %" PRIu32 " bytes, %u files\n"), (uint32_t)_logFile.getFileSize(), _logFile.getMaxSize(), _logFile.getCount());
+                printf(F(ESC_ATTR_BOLD "Pending:         " ESC_ATTR_RESET "%" PRIu32 " bytes\n"), (uint32_t)_logFile.getPending());
+                printf(F(ESC_ATTR_BOLD "Flash writes:    " ESC_ATTR_RESET "%" PRIu32 " (%" PRIu32 "/h)\n"), _logFile.getWrites(), _logFile.getWritesPerHour());
+                __console.setOutputVariable(_logFile.getWritesPerHour());
+             }
+          } else if (strSubCmd == "tail") {
+             // log tail [<lines>]
+             _logFile.tail(getIoStream(), TKTOINT(tkArgs, 2, 10));
           } else {
              printf(F(ESC_ATTR_BOLD "Log enabled:     " ESC_ATTR_RESET "%d\n"), isLogEnabled());
              printf(F(ESC_ATTR_BOLD "Log level:       " ESC_ATTR_RESET "%d"), __console.getLogLevel());printf(F(ESC_ATTR_BOLD " Usr: " ESC_ATTR_RESET "%d\n"), __console.getUsrLogLevel());
@@ -246,15 +377,21 @@ public:
    bool isLogEnabled() {return _bLogEnabled;}
 
    bool hasFS() {
+      // the cached info is valid as long as the file system is mounted
+      if (_index.hasInfo()) return true;
+      
       bool bResult = false;
 #ifdef ARDUINO
       FSInfo fsinfo;
 #ifdef ESP32
       fsinfo.totalBytes = LittleFS.totalBytes();
+      fsinfo.usedBytes = LittleFS.usedBytes();
+      fsinfo.blockSize = 4096;
       bResult = (fsinfo.totalBytes > 0);
 #else
       bResult = LittleFS.info(fsinfo);
 #endif
+      if (bResult) _index.setInfo(fsinfo);
 #endif
       return bResult;
    }
@@ -287,14 +424,11 @@ public:
       if (hasFS()) {
          if (szFn) {
 #ifdef ARDUINO
-            if (LittleFS.exists(szFn)) {
-               File file = LittleFS.open(szFn, "r");
-               if (file) {
-                  printf(F("%d %s"), file.size(), file.name());
-                  __console.setOutputVariable((uint32_t)file.size());
-                  file.close();
-                  return EXIT_SUCCESS;
-               }
+            const CxFsIndex::Entry* pEntry = _index.find(szFn);
+            if (pEntry) {
+               printf(F("%" PRIu32 " %s"), pEntry->nSize, szFn);
+               __console.setOutputVariable(pEntry->nSize);
+               return EXIT_SUCCESS;
             } else {
                _printNoSuchFileOrDir("du", szFn);
             }
@@ -357,48 +491,26 @@ public:
          
 #ifdef ARDUINO
          uint32_t total = 0;
-#ifdef ESP32
-         // TODO: recursively https://unsinnsbasis.de/littlefs-esp32/
-         File root = LittleFS.open("/");
-         if (root) {
-            File file = root.openNextFile();
-            while (file) {
-               if (file.isDirectory()) {
-                  printf(F("DIR     %s/\n"), file.name());
-               } else {
-                  const char* fn = file.name();
-                  
-                  // skip hidden files
-                  if (!bAll && fn && fn[0] == '.') continue;
-                  
-                  if (bAll) {
-                     printf(F("%7d "), file.size());
-                     __console.printFileDateTime(getIoStream(), file.getCreationTime(), file.getLastWrite());
-                  }
-                  printf(F(" %s\n"), file.name());
-               }
-               file = root.openNextFile();
-            }
-         }
-#else // no ESP32
-         Dir dir = LittleFS.openDir("");
-         while (dir.next()) {
-            File file = dir.openFile("r");
-            const char* fn = file.name();
+         for (const auto& entry : _index.getEntries()) {
+            // entries of the root directory only
+            const char* fn = entry.first.c_str() + 1;
+            if (strchr(fn, '/')) continue;
             
             // skip hidden files
-            if (!bAll && fn && fn[0] == '.') continue;
+            if (!bAll && fn[0] == '.') continue;
             
             // print file size and date/time
             if (bLong) {
-               printf(F("%7d "), file.size());
-               __console.printFileDateTime(getIoStream(), file.getCreationTime(), file.getLastWrite());
+               if (entry.second.bDir) {
+                  print(F("    DIR "));
+               } else {
+                  printf(F("%7d "), entry.second.nSize);
+               }
+               __console.printFileDateTime(getIoStream(), entry.second.tCreation, entry.second.tWrite);
             }
-            printf(F(" %s\n"), file.name());
-            total += file.size();
-            file.close();
+            printf(F(" %s%s\n"), fn, entry.second.bDir ? "/" : "");
+            total += entry.second.nSize;
          }
-#endif // end ESP32
          if (bLong) {
             printf(F("%7d (%d bytes free)\n"), total, totalBytes - usedBytes);
          }
@@ -420,8 +532,12 @@ public:
          // Open file for reading
          File file = LittleFS.open(szFn, "r");
          if (file) {
-            while (file.available()) {
-               print((char)file.read());
+            // block wise, the console stream is the limiting factor, a small block is sufficient
+            uint8_t buf[256];
+            size_t n;
+            while ((n = file.read(buf, sizeof(buf))) > 0) {
+               getIoStream().write(buf, n);
+               yield();
             }
             println();
          } else {
@@ -449,16 +565,24 @@ public:
       return EXIT_FAILURE;
    }
    
-   uint8_t rm(const char* szFn) {
+   uint8_t rm(const char* szFn, bool bRecursive = false, bool bBackground = false) {
       if (! szFn) {
-         println(F("usage: rm <file>"));
+         println(F("usage: rm [-r] <file> [&]"));
          return EXIT_FAILURE;
       }
       if (hasFS()) {
 #ifdef ARDUINO
+         if (bRecursive) {
+            if (!_index.exists(szFn)) {
+               _printNoSuchFileOrDir("rm", szFn);
+               return EXIT_FAILURE;
+            }
+            return _startJob(CxFileJob::e_op::remove, szFn, nullptr, bBackground);
+         }
          if (!LittleFS.remove(szFn)) {
             _printNoSuchFileOrDir("rm", szFn);
          } else {
+            _index.remove(szFn);
             return EXIT_SUCCESS;
          }
 #else
@@ -469,33 +593,28 @@ public:
       return EXIT_FAILURE;
    }
    
-   uint8_t cp(const char *szSrc, const char *szDst) {
+   uint8_t cp(const char *szSrc, const char *szDst, bool bRecursive = false, bool bBackground = false) {
       if (! szSrc || ! szDst) {
-         println(F("usage: cp <src_file> <tgt_file>"));
+         println(F("usage: cp [-r] <src_file> <tgt_file> [&]"));
          return EXIT_FAILURE;
       }
       if (hasFS()) {
 #ifdef ARDUINO
-         if (LittleFS.exists(szSrc)) {
-            static char buf[64];
+         const CxFsIndex::Entry* pEntry = _index.find(szSrc);
+         if (pEntry) {
+            if (pEntry->bDir && !bRecursive) {
+               printf(F("cp: %s is a directory (not copied)\n"), szSrc);
+               return EXIT_FAILURE;
+            }
+            if (CxFileJob::isWithin(szDst, szSrc)) {
+               printf(F("cp: cannot copy %s into itself (%s)\n"), szSrc, szDst);
+               return EXIT_FAILURE;
+            }
             
             // FIXME: cp need y/n query if dst exist, unless -f is given as parameter
-            if (LittleFS.exists(szDst)) LittleFS.remove(szDst);
+            if (!bRecursive && _index.exists(szDst)) LittleFS.remove(szDst);
             
-            File fileSrc = LittleFS.open(szSrc, "r");
-            
-            if (fileSrc) {
-               File fileDst = LittleFS.open(szDst, "w");
-               if (fileDst) {
-                  while (fileSrc.available() > 0) {
-                     uint8_t n = fileSrc.readBytes(buf, sizeof(buf));
-                     fileDst.write((uint8_t*)buf, n);
-                  }
-                  fileDst.close();
-               }
-               fileSrc.close();
-               return EXIT_SUCCESS;
-            }
+            return _startJob(CxFileJob::e_op::copy, szSrc, szDst, bBackground);
          } else {
             _printNoSuchFileOrDir("cp", szSrc);
          }
@@ -514,16 +633,26 @@ public:
       }
       if (hasFS()) {
 #ifdef ARDUINO
-         if (LittleFS.exists(szSrc)) {
-            static char buf[64];
-            
+         if (_index.exists(szSrc)) {
+            if (CxFileJob::isWithin(szDst, szSrc)) {
+               printf(F("mv: cannot move %s into itself (%s)\n"), szSrc, szDst);
+               return EXIT_FAILURE;
+            }
             // FIXME: cp need y/n query if dst exist, unless -f is given as parameter
-            if (LittleFS.exists(szDst)) LittleFS.remove(szDst);
-            if (!LittleFS.rename(szSrc, szDst)) {
-               println(F("Failed to rename file"));
-            } else {
+            if (_index.exists(szDst)) LittleFS.remove(szDst);
+            if (LittleFS.rename(szSrc, szDst)) {
+               _index.remove(szSrc);
+               _index.update(szDst);
+               return EXIT_SUCCESS;
+            }
+            // rename not possible, copy and remove the source
+            CxFileJob job(CxFileJob::e_op::copy, szSrc, szDst, _getBlockBufSize());
+            bool bResult = job.run() && CxFileJob(CxFileJob::e_op::remove, szSrc, nullptr, 0).run();
+            _index.invalidate();
+            if (bResult) {
                return EXIT_SUCCESS;
             }
+            println(F("Failed to rename file"));
          } else {
             _printNoSuchFileOrDir("mv", szSrc);
          }
@@ -543,12 +672,13 @@ public:
       if (hasFS()) {
 #ifdef ARDUINO
          const char* mode = "a";
-         if (!LittleFS.exists(szFn)) {
+         if (!_index.exists(szFn)) {
             mode = "w";
          }
          File file = LittleFS.open(szFn, mode);
          if (file) {
             file.close();
+            _index.update(szFn);
             return EXIT_SUCCESS;
          }
 #else
@@ -559,6 +689,282 @@ public:
       return EXIT_FAILURE;
    }
    
+   /**
+    * @brief Runs a bulk file operation in the foreground or starts it in the background
+    */
+   uint8_t _startJob(CxFileJob::e_op eOp, const char* szSrc, const char* szDst, bool bBackground) {
+      if (bBackground) {
+         if (_pJob && !_pJob->isDone()) {
+            println(F("another file operation is running in the background"));
+            return EXIT_FAILURE;
+         }
+         _pJob = std::make_unique<CxFileJob>(eOp, szSrc, szDst, _getBlockBufSize());
+         _index.invalidate();
+         return _pJob->isError() ? EXIT_FAILURE : EXIT_SUCCESS;
+      }
+      
+      CxFileJob job(eOp, szSrc, szDst, _getBlockBufSize());
+      // show the progress of larger operations only
+      bool bProgress = (job.getTotal() > 16 * _getBlockBufSize());
+      uint8_t nPercent = 0;
+      bool bResult = job.run([this, &nPercent, bProgress, szSrc](uint32_t nDone, uint32_t nTotal) {
+         if (bProgress && nTotal && (nDone * 100 / nTotal) != nPercent) {
+            nPercent = nDone * 100 / nTotal;
+            __console.printProgressBar(nDone, nTotal, szSrc);
+         }
+      });
+      if (bProgress) println();
+      _index.invalidate();
+      return bResult ? EXIT_SUCCESS : EXIT_FAILURE;
+   }
+   
+   /// buffer size for bulk file operations, the block size of the file system (limited)
+   size_t _getBlockBufSize() {
+      FSInfo fsinfo;
+      fsinfo.blockSize = 0;
+      _getFSInfo(fsinfo);
+      if (fsinfo.blockSize < 256) return 256;
+      return std::min((size_t)fsinfo.blockSize, (size_t)_nMAX_BLOCK_BUF);
+   }
+   
+   /**
+    * @brief Prints the paths below a directory, optionally filtered by a name pattern
+    * @param szPath Start directory (or file)
+    * @param szPattern Glob pattern for the name ('*', '?'), nullptr for all
+    */
+   uint8_t find(const char* szPath, const char* szPattern = nullptr) {
+      if (!hasFS()) {
+         _printNoFS();
+         return EXIT_FAILURE;
+      }
+      String strPath = CxFsIndex::normalize(szPath);
+      if (!_index.exists(strPath.c_str())) {
+         _printNoSuchFileOrDir("find", szPath);
+         return EXIT_FAILURE;
+      }
+      String strPrefix = strPath;
+      if (!strPrefix.endsWith("/")) strPrefix += '/';
+      
+      uint32_t nCount = 0;
+      for (const auto& entry : _index.getEntries()) {
+         if (entry.first != strPath && !entry.first.startsWith(strPrefix)) continue;
+         if (szPattern) {
+            const char* szName = strrchr(entry.first.c_str(), '/') + 1;
+            if (!CxFsIndex::matchGlob(szPattern, szName)) continue;
+         }
+         println(entry.first.c_str());
+         nCount++;
+      }
+      __console.setOutputVariable(nCount);
+      return EXIT_SUCCESS;
+   }
+   
+   /**
+    * @brief Prints the status of the background file operation
+    * @param szCmd "stop" to cancel the operation
+    */
+   uint8_t printJob(const char* szCmd = nullptr) {
+      if (!_pJob) {
+         println(F("no background file operation"));
+         return EXIT_FAILURE;
+      }
+      if (szCmd && strcmp(szCmd, "stop") == 0) {
+         _pJob->cancel();
+      }
+      printf(F(ESC_ATTR_BOLD "Operation: " ESC_ATTR_RESET "%s (%s)\n"), _pJob->getOp() == CxFileJob::e_op::copy ? "copy" : "remove", _pJob->isDone() ? (_pJob->isError() ? "failed" : "done") : "running");
+      printf(F(ESC_ATTR_BOLD "Progress:  " ESC_ATTR_RESET "%" PRIu32 " of %" PRIu32 " bytes, %" PRIu32 " files\n"), _pJob->getBytes(), _pJob->getTotal(), _pJob->getFiles());
+      printf(F(ESC_ATTR_BOLD "Time:      " ESC_ATTR_RESET "%" PRIu32 " ms (%" PRIu32 " kB/s)\n"), _pJob->getTime(), _pJob->getRate());
+      __console.setOutputVariable(_pJob->getRate());
+      return EXIT_SUCCESS;
+   }
+   
+   /**
+    * @brief Accesses the binary key-value store
+    * @param szCmd list, get, set, del, compact (without: status)
+    * @param szKey key
+    * @param szValue value for set, numbers and true/false are stored typed
+    */
+   uint8_t kv(const char* szCmd, const char* szKey, const char* szValue) {
+      CxKvStore& kv = CxKvStore::getInstance();
+      if (!kv.isReady()) {
+         println(F("key-value store not available"));
+         return EXIT_FAILURE;
+      }
+
+      if (!szCmd) {
+         printf(F(ESC_ATTR_BOLD "Keys:        " ESC_ATTR_RESET "%" PRIu32 "\n"), (uint32_t)kv.getKeys());
+         printf(F(ESC_ATTR_BOLD "Size:        " ESC_ATTR_RESET "%" PRIu32 " bytes (%" PRIu32 " live)%s\n"), kv.getFileSize(), kv.getLiveSize(), kv.isTorn() ? ", torn tail" : "");
+         printf(F(ESC_ATTR_BOLD "Writes:      " ESC_ATTR_RESET "%" PRIu32 ESC_ATTR_BOLD " Compactions: " ESC_ATTR_RESET "%" PRIu32 "\n"), kv.getWrites(), kv.getCompactions());
+         return EXIT_SUCCESS;
+      } else if (strcmp(szCmd, "list") == 0) {
+         kv.forEach([this, &kv](const char* szKey, uint8_t nType) {
+            printf(F("%-32s %-5s %s\n"), szKey, CxKvStore::getTypeName(nType), kv.getStr(szKey, "").c_str());
+         });
+         return EXIT_SUCCESS;
+      } else if (strcmp(szCmd, "compact") == 0) {
+         return kv.compact() ? EXIT_SUCCESS : EXIT_FAILURE;
+      } else if (!szKey) {
+         return EXIT_FAILURE;
+      } else if (strcmp(szCmd, "get") == 0) {
+         if (!kv.exists(szKey)) return EXIT_FAILURE;
+         String strValue = kv.getStr(szKey, "");
+         println(strValue.c_str());
+         __console.setOutputVariable(strValue.c_str());
+         return EXIT_SUCCESS;
+      } else if (strcmp(szCmd, "del") == 0) {
+         return kv.remove(szKey) ? EXIT_SUCCESS : EXIT_FAILURE;
+      } else if (strcmp(szCmd, "set") == 0 && szValue) {
+         char* pEnd = nullptr;
+         bool bResult;
+         long nValue = strtol(szValue, &pEnd, 10);
+         if (strcmp(szValue, "true") == 0 || strcmp(szValue, "false") == 0) {
+            bResult = kv.setBool(szKey, szValue[0] == 't');
+         } else if (*szValue && *pEnd == '\0') {
+            bResult = kv.setInt(szKey, (int32_t)nValue);
+         } else {
+            float fValue = strtof(szValue, &pEnd);
+            bResult = (*szValue && *pEnd == '\0') ? kv.setFloat(szKey, fValue) : kv.setStr(szKey, szValue);
+         }
+         return bResult ? EXIT_SUCCESS : EXIT_FAILURE;
+      }
+      return EXIT_FAILURE;
+   }
+
+   /**
+    * @brief Compares the throughput of the block wise file operations with small buffer/byte wise access
+    * @param nKB Size of the test file in kB
+    */
+   uint8_t bench(uint32_t nKB) {
+#ifdef ARDUINO
+      const char* szSrc = "/.bench_src";
+      const char* szDst = "/.bench_dst";
+      uint32_t nSize = nKB * 1024;
+      size_t nBufSize = _getBlockBufSize();
+      
+      if (!hasFS() || nSize == 0 || nSize * 2 > getDf() * 0.9) {
+         println(F("not enough space for the benchmark"));
+         return EXIT_FAILURE;
+      }
+      
+      std::unique_ptr<uint8_t[]> buf(new (std::nothrow) uint8_t[nBufSize]);
+      if (!buf) return EXIT_FAILURE;
+      memset(buf.get(), 0x55, nBufSize);
+      
+      auto rate = [nSize](uint32_t nStart) {uint32_t nTime = millis() - nStart; return nTime ? nSize / nTime : nSize;};
+      uint32_t nStart;
+      
+      // write the test file
+      nStart = millis();
+      File file = LittleFS.open(szSrc, "w");
+      if (!file) return EXIT_FAILURE;
+      for (uint32_t n = 0; n < nSize; n += nBufSize) {
+         file.write(buf.get(), std::min((uint32_t)nBufSize, nSize - n));
+         yield();
+      }
+      file.close();
+      printf(F("write (%" PRIu32 " B):    %" PRIu32 " kB/s\n"), (uint32_t)nBufSize, rate(nStart));
+      
+      // copy through a 64 byte buffer (as before)
+      nStart = millis();
+      File fileSrc = LittleFS.open(szSrc, "r");
+      File fileDst = LittleFS.open(szDst, "w");
+      while (fileSrc.available() > 0) {
+         uint8_t n = fileSrc.readBytes((char*)buf.get(), 64);
+         fileDst.write(buf.get(), n);
+      }
+      fileDst.close();
+      fileSrc.close();
+      printf(F("cp (64 B):       %" PRIu32 " kB/s\n"), rate(nStart));
+      LittleFS.remove(szDst);
+      
+      // bulk copy
+      nStart = millis();
+      CxFileJob(CxFileJob::e_op::copy, szSrc, szDst, nBufSize).run();
+      uint32_t nRate = rate(nStart);
+      printf(F("cp (%" PRIu32 " B):     %" PRIu32 " kB/s\n"), (uint32_t)nBufSize, nRate);
+      LittleFS.remove(szDst);
+      
+      // read byte by byte (as cat before)
+      nStart = millis();
+      file = LittleFS.open(szSrc, "r");
+      while (file.available()) file.read();
+      file.close();
+      printf(F("read (1 B):      %" PRIu32 " kB/s\n"), rate(nStart));
+      
+      // read block wise
+      nStart = millis();
+      file = LittleFS.open(szSrc, "r");
+      while (file.read(buf.get(), nBufSize) > 0) yield();
+      file.close();
+      printf(F("read (%" PRIu32 " B):   %" PRIu32 " kB/s\n"), (uint32_t)nBufSize, rate(nStart));
+      
+      LittleFS.remove(szSrc);
+      _index.update(szSrc); // used bytes
+      __console.setOutputVariable(nRate);
+      return EXIT_SUCCESS;
+#else
+      return EXIT_FAILURE;
+#endif
+   }
+   
+   /**
+    * @brief Imports the former configuration into the key-value store, once
+    * @details The strings and settings of the EEPROM and the settings file (settings.json) are imported. Keys already
+    * in the store are kept. The settings file is removed, if all of its settings were imported.
+    */
+   void _importConfig() {
+      CxKvStore& kv = CxKvStore::getInstance();
+      if (!kv.isReady() || kv.getBool("cfg.imported", false)) return;
+      
+      // EEPROM, read before the store is set (erased EEPROM reads 0xFF)
+      auto importStr = [&kv](const char* szKey, const char* sz) {
+         if (sz[0] && (uint8_t)sz[0] != 0xFF && !kv.exists(szKey)) kv.setStr(szKey, sz);
+      };
+      char buf[81];
+      if (::readSSID(buf, sizeof(buf))) importStr(CONFIG_KEY_SSID, buf);
+      if (::readPassword(buf, sizeof(buf))) importStr(CONFIG_KEY_PASSWORD, buf);
+      if (::readHostName(buf, sizeof(buf))) importStr(CONFIG_KEY_HOSTNAME, buf);
+      if (::readOtaPassword(buf, sizeof(buf))) importStr(CONFIG_KEY_OTAPW, buf);
+      Settings_t settings;
+      ::readSettings(settings);
+      if (settings._loopDelay < 1000 && !kv.exists(CONFIG_KEY_LOOPDELAY)) kv.setInt(CONFIG_KEY_LOOPDELAY, (int32_t)settings._loopDelay);
+      
+      // settings file
+      uint32_t nImported = 0;
+      uint32_t nFailed = 0;
+      CxPersistentImpl& settingsFile = CxPersistentImpl::getInstance();
+      settingsFile.forEach([&kv, &nImported, &nFailed](const char* szGroup, const char* szName, JsonVariant var) {
+         if (kv.importSetting(szGroup, szName, var)) nImported++; else nFailed++;
+      });
+      if (nFailed) {
+         __console.warn(F("%" PRIu32 " settings not imported into the key-value store, settings file kept"), nFailed);
+      } else {
+         settingsFile.removeFile();
+      }
+      kv.setBool("cfg.imported", true);
+      __console.info(F("configuration imported into the key-value store (%" PRIu32 " settings)"), nImported);
+   }
+   
+   /// the configuration of the EEPROM is read from the key-value store (see esphw.h)
+   void _setConfigStore() {
+      CxKvStore& kv = CxKvStore::getInstance();
+      ::setConfigStore(
+         [&kv](const char* szKey, char* szValue, uint32_t lenmax) {
+            if (!lenmax || kv.getType(szKey) != CxKvStore::typeStr) return false;
+            String str = kv.getStr(szKey, "");
+            strncpy(szValue, str.c_str(), lenmax - 1);
+            szValue[lenmax - 1] = '\0';
+            return true;
+         },
+         [&kv](const char* szKey, const char* szValue) {return kv.setStr(szKey, szValue);},
+         [&kv](const char* szKey, int32_t& nValue) {
+            if (kv.getType(szKey) != CxKvStore::typeInt) return false;
+            nValue = kv.getInt(szKey, 0);
+            return true;
+         },
+         [&kv](const char* szKey, int32_t nValue) {return kv.setInt(szKey, nValue);});
+   }
+   
    uint8_t mount() {
       if (!hasFS()) {
 #ifdef ARDUINO
@@ -566,12 +972,15 @@ public:
             __console.error("LittleFS mount failed");
             return EXIT_FAILURE;
          } else {
+            _index.clear();
+            CxKvStore::getInstance().begin();
             return EXIT_SUCCESS;
          }
 #else
 #endif
       } else {
          //println(F("LittleFS already mounted!"));
+         if (!CxKvStore::getInstance().isReady()) CxKvStore::getInstance().begin();
          return EXIT_SUCCESS;
       }
       return EXIT_FAILURE;
@@ -580,7 +989,9 @@ public:
    uint8_t umount() {
       if (hasFS()) {
 #ifdef ARDUINO
+         CxKvStore::getInstance().end();
          LittleFS.end();
+         _index.clear();
 #else
 #endif
          return EXIT_SUCCESS;
@@ -609,7 +1020,7 @@ public:
       
    bool fileExists(const char* szFn) {
 #ifdef ARDUINO
-      return LittleFS.exists(szFn);
+      return _index.exists(szFn);
 #else
       return false;
 #endif
@@ -619,136 +1030,60 @@ public:
 private:
    void _getFSInfo(FSInfo& fsinfo) {
 #ifdef ARDUINO
+      if (_index.getInfo(fsinfo)) return;
 #ifdef ESP32
       fsinfo.totalBytes = LITTLEFS.totalBytes();
       fsinfo.usedBytes = LITTLEFS.usedBytes();
+      fsinfo.blockSize = 4096;
 #else
       LittleFS.info(fsinfo);
 #endif
+      _index.setInfo(fsinfo);
 #endif
    }
    
+   /**
+    * @brief Starts a file transfer ($UPLOAD$, $DOWNLOAD$) on the connection of the remote command
+    * @details The connection is taken over by the transfer, which is continued in the loop (see CxFileTransfer).
+    */
    uint8_t _handleFile() {
-#ifdef ARDUINO
-      static char buffer[64];
-      String header = "";
-      String filename = "";
-      size_t expectedSize = 0;
-      size_t receivedSize = 0;
-      File file;
-      bool bError = false;
-      
-      WiFiClient* client = static_cast<WiFiClient*>(&getIoStream()); // tricky
-      
-      // read header
-      while (client->connected() && header.indexOf("\n") == -1) {
-         if (client->available()) {
-            char c = client->read();
-            header += c;
-         }
-      }
-      
-      //__CONSOLE_DEBUG(F("receive header: %s"), header.c_str());
-      
-      // analyse header
-      if (header.startsWith("GET ")) {
-         // Handle GET <filename>
-         String filename = header.substring(4);
-         filename.trim();
-         return _sendFile(client, filename.c_str());
-      } else if (header.startsWith("FILE:")) {
-         // receive file
-         int fileStart = header.indexOf("FILE:") + 5;
-         int sizeStart = header.indexOf("SIZE:") + 5;
-         int sizeEnd = header.indexOf("\n");
-         
-         filename = header.substring(fileStart, header.indexOf(" ", fileStart));
-         expectedSize = header.substring(sizeStart, sizeEnd).toInt();
-         
-         if (expectedSize > getDf() * 0.9) {
-            __console.error(F("not enough space available for the file!"));
-            return EXIT_FAILURE;
-         }
-         
-         _CONSOLE_INFO(F("receive file: %s (size: %d Bytes)"), filename.c_str(), expectedSize);
-         
-         // file open
-         file = LittleFS.open(filename, "w");
-         if (!file) {
-            __console.error(F("error: create file %s"), filename.c_str());
-            return EXIT_FAILURE;
-         }
-      } else {
-         __console.error(F("error: invalid header received during file transfer"));
+#if defined(ARDUINO) && !defined(ESP_CONSOLE_NOWIFI)
+      if (_pXfer && !_pXfer->isDone()) {
+         print(F("ERROR:busy\n"));
          return EXIT_FAILURE;
       }
-      
-      // receive file data
-      CxTimer timerTO(5000); // set timeout
-      
-      while (client->connected() && receivedSize < expectedSize) {
-         size_t bytesToRead = client->available();
-         if (bytesToRead > 0) {
-            size_t bytesRead = client->readBytes(buffer, min(bytesToRead, sizeof(buffer)));
-            file.write((uint8_t *)buffer, bytesRead);
-            receivedSize += bytesRead;
-            //printProgress(receivedSize, expectedSize, filename.c_str(), "bytes");
-            __console.printProgressBar((uint32_t)receivedSize, (uint32_t)expectedSize, filename.c_str());
-            timerTO.restart(); // reset timeout
-         } else if (timerTO.isDue()) { // timeout
-            __console.error(F("timeout receiving a file"));
-            bError = true;
-            break;
-         }
-         delay(1);
+      WiFiClient* client = __console.takeRemoteClient();
+      if (!client) {
+         __console.error(F("error: file transfer requires a remote command connection"));
+         return EXIT_FAILURE;
       }
-      file.close();
-      
-      // Empfang überprüfen
-      if (receivedSize == expectedSize) {
-         _CONSOLE_INFO(F("file transfer finished."));
-         return EXIT_SUCCESS;
-      } else {
-         __console.error(F("received size of data (%d bytes) not same as expected file size (%d bytes)!"), receivedSize, expectedSize);
+      _pXfer.reset(new (std::nothrow) CxFileTransfer(*client, (uint32_t)(getDf() * 0.9)));
+      if (!_pXfer) {
+         client->stop();
+         return EXIT_FAILURE;
       }
-#endif
+      return EXIT_SUCCESS;
+#else
       return EXIT_FAILURE;
+#endif
    }
    
-   uint8_t _sendFile(WiFiClient* client, const char* filename) {
-#ifdef ARDUINO
-      // without the log capability, it would print to __ioStream, which is the client stream for the file transfer!
-      //_CONSOLE_DEBUG(F("download file: %s"), filename);
+   /// continues a running file transfer, logs the result at the end
+   void _loopFile() {
+      if (!_pXfer || _pXfer->step()) return;
       
-      File file = LittleFS.open(filename, "r");
-      if (!file) {
-         client->println("ERROR: File not found");
-         //console.warn("File not found: %s", filename);
-         return EXIT_FAILURE;
+      if (_pXfer->isUpload()) {
+         _index.update(_pXfer->getFile());
+         if (_pXfer->getTempFile()[0]) _index.update(_pXfer->getTempFile());
       }
-      
-      size_t fileSize = file.size();
-      client->printf("SIZE: %d\n", fileSize);
-      //_CONSOLE_INFO("Sending file: %s (%d bytes)\n", filename, fileSize);
-
-      static char buffer[64];
-      size_t bytesRead;
-
-      g_Stack.update();
-
-      // Send file data
-      while ((bytesRead = file.readBytes(buffer, sizeof(buffer))) > 0) {
-         client->write((uint8_t *)buffer, bytesRead);
+      if (_pXfer->isError()) {
+         __console.error(F("file transfer of %s failed (%s) at %" PRIu32 " of %" PRIu32 " bytes"), _pXfer->getFile(), _pXfer->getError(), _pXfer->getBytes(), _pXfer->getSize());
+      } else {
+         _CONSOLE_INFO(F("file %s %s: %" PRIu32 " bytes (%" PRIu32 " resumed) in %" PRIu32 " ms, %" PRIu32 " kB/s"), _pXfer->getFile(), _pXfer->isUpload() ? "received" : "sent", _pXfer->getSize(), _pXfer->getResumed(), _pXfer->getTime(), _pXfer->getRate());
       }
-      
-      file.close();
-      //_CONSOLE_INFO("File transfer complete.");
-#endif
-      return EXIT_SUCCESS;
+      _pXfer.reset();
    }
    
-   
-   
    void _printNoFS() {
       println(F("file system not mounted!"));
    }
@@ -832,7 +1167,7 @@ private:
       uint8_t nExitValue = EXIT_FAILURE;
 
 #ifdef ARDUINO
-      if (!LittleFS.exists(strBatchFile.c_str())) {
+      if (!_index.exists(strBatchFile.c_str())) {
          __console.error(F("Batch file '%s' not found"), strBatchFile.c_str());
          return EXIT_FAILURE;
       }
@@ -843,6 +1178,7 @@ private:
          return EXIT_FAILURE;
       }
       
+      CxESPBootPhase phase(path, label);
       bool processCommands = true; // Start processing commands immediately
       _bBreakBatch = false;
       _nBatchDepth++;  // executeBatch will be called recursively, note the depth
@@ -999,7 +1335,9 @@ private:
       // implement condition evaluation utility
       // test <expression> <cmd>
       // expressions:
-      // -e <file>     True if file exists
+      // -e <file>     True if file or directory exists
+      // -f <file>     True if file exists and is a regular file
+      // -d <file>     True if file exists and is a directory
       // -z <string>   True if the length of string is zero
       // -n <string>   True if the length of string is nonzero
       // s1 = s2       True if s1 == s2
@@ -1017,9 +1355,13 @@ private:
       if (strcmp(vExpression[0], "!") == 0 && vExpression.size() > 1) {
          std::vector<const char*> subExpression(vExpression.begin() + 1, vExpression.end());
          return !test(subExpression);
-      } else if ((strcmp(vExpression[0], "-e") == 0 || strcmp(vExpression[0], "-f") == 0) && vExpression.size() == 2) {
+      } else if (strcmp(vExpression[0], "-e") == 0 && vExpression.size() == 2) {
          // check if file exists
          return fileExists(vExpression[1]);
+      } else if ((strcmp(vExpression[0], "-f") == 0 || strcmp(vExpression[0], "-d") == 0) && vExpression.size() == 2) {
+         // check if file exists and is of the type
+         const CxFsIndex::Entry* pEntry = _index.find(vExpression[1]);
+         return pEntry && (pEntry->bDir == (vExpression[0][1] == 'd'));
       } else if (strcmp(vExpression[0], "-z") == 0 && vExpression.size() == 2) {
          // check if string is empty
          return strlen(vExpression[1]) == 0;
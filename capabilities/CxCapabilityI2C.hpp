@@ -378,7 +378,7 @@ public:
     * @brief Lists all devices in the map.
     */
    void printDevices() {
-      CxTablePrinter table(getIoStream());
+      CxTablePrinter table(getIoStream(), __console.getTableFormat());
       
       table.printHeader({F("Addr"), F("Type"), F("Category")}, {4, 10, 20});
       
@@ -21,11 +21,13 @@
 
 
 #include "../tools/CxMqttManager.hpp"
+#include "../tools/CxServiceManager.hpp"
 
 class CxCapabilityMqtt : public CxCapability {
    CxESPConsoleMaster& __console = CxESPConsoleMaster::getInstance();
    
    bool _bMqttServerOnline = false;
+   bool _bMqttRequested = false;    ///< mqtt connect was requested, the service manager connects when wifi is up
    
    CxTimer    _timerHeartbeat;
    CxTimer60s _timer60sMqttServer;
@@ -48,6 +50,7 @@ public:
    }
    
    ~CxCapabilityMqtt() {
+      CxServiceManager::getInstance().removeService("mqtt");
       if (_pmqttTopicCmd) delete _pmqttTopicCmd;
       _pmqttTopicCmd = nullptr;
    }
@@ -70,6 +73,13 @@ public:
 
       
       _timerHeartbeat.start(true); // 1st due immidiately
+      
+      /// mqtt service, when requested: connected as soon as wifi is up, again after the retry period of the
+      /// service manager, if not connected. Each attempt postpones the reconnect of the mqtt manager.
+      CxServiceManager::getInstance().addService("mqtt", {"wifi"},
+         [this]() {return isConnectedMqtt();},
+         [this]() {_connectMqtt();},
+         [this]() {return _bMqttRequested;});
 
    }
    
@@ -200,6 +210,9 @@ public:
                nExitValue = EXIT_FAILURE;
             }
          }
+         else if (__console.getTableFormat() != CxTablePrinter::e_format::text) {
+            printStatus();
+         }
          else {
             printf(F(ESC_ATTR_BOLD " Server:       " ESC_ATTR_RESET "%s (%s)\n"), __mqttManager.getServer(), _bMqttServerOnline? ESC_TEXT_GREEN "online" ESC_ATTR_RESET: ESC_TEXT_BRIGHT_RED "offline" ESC_ATTR_RESET);
             printf(F(ESC_ATTR_BOLD " Port:         " ESC_ATTR_RESET "%d\n"), __mqttManager.getPort());
@@ -222,6 +235,25 @@ public:
       return nExitValue;
    }
       
+   /// status as one record (json or kv format), the keys as in the text output
+   void printStatus() {
+      CxTablePrinter table(getIoStream(), __console.getTableFormat());
+      table.printHeader({{F("Server"), 0}, {F("Online"), 0}, {F("Port"), 0}, {F("QoS"), 0}, {F("Root path"), 0},
+                         {F("Name"), 0}, {F("Will"), 0}, {F("Will topic"), 0}, {F("Heartbeat"), 0}, {F("Connects"), 0}});
+      table.cell(__mqttManager.getServer());
+      table.cell(_bMqttServerOnline);
+      table.cell((unsigned long)__mqttManager.getPort());
+      table.cell((unsigned long)__mqttManager.getQoS());
+      table.cell(__mqttManager.getRootPath());
+      table.cell(__mqttManager.getName());
+      table.cell(__mqttManager.isWill());
+      table.cell(__mqttManager.getWillTopic());
+      table.cell((unsigned long)_timerHeartbeat.getPeriod());
+      table.cell((unsigned long)__mqttManager.getConnectCntr());
+      table.endRow();
+      table.printFooter();
+   }
+   
    bool subscribe(const char* topic, CxMqttManager::tCallback callback) {
       return __mqttManager.subscribe(topic, callback);
    }
@@ -256,6 +288,14 @@ public:
       
       if (server) __mqttManager.setServer(server);
       if (port > 0) __mqttManager.setPort(port);
+      
+      // connected by the service manager from the loop, when wifi is up (see setup())
+      _bMqttRequested = true;
+      if (!__console.isConnected()) _CONSOLE_INFO(F("mqtt service waits for wifi"));
+      return true;
+   }
+   
+   bool _connectMqtt() {
       if (__console.isHostAvailable(__mqttManager.getServer(), __mqttManager.getPort())) {
          _CONSOLE_INFO(F("start mqtt service"));
          _CONSOLE_INFO(F("connecting mqtt server %s on port %d"), __mqttManager.getServer(), __mqttManager.getPort());
@@ -291,6 +331,7 @@ public:
       
       __mqttManager.end();
       _bMqttServerOnline = false;
+      _bMqttRequested = false;
       return EXIT_SUCCESS;
    }
    
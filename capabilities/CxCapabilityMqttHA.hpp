@@ -73,6 +73,13 @@ private:
 
 
    bool _bHAEnabled = false;
+   bool _bHAStarted = false;        ///< the discovery was started by the service manager
+   
+   /// file with the hashes of the published discovery configs
+   static constexpr const char* _szHASH_FILE = "/.hahash";
+   
+   /// HA birth message, HA lost the retained discovery configs (e.g. restarted without persistent broker)
+   std::unique_ptr<CxMqttTopic> _pmqttTopicHAStatus;
 
    /// maps of Home Assistant diagnostics and sensors
    std::vector<std::unique_ptr<CxMqttHASensor>> _vHASensor;
@@ -100,6 +107,7 @@ public:
    
    /// Destructor to end the capability and clear the sensor objects.
    ~CxCapabilityMqttHA() {
+      CxServiceManager::getInstance().removeService("ha");
       enableHA(false);
       _vHASensor.clear();
       _vHAButton.clear();
@@ -116,24 +124,54 @@ public:
       _CONSOLE_INFO(F("====  Cap: %s  ===="), getName());
       
       
-      // increase the PubSubClient buffer size as for HA the payload could be pretty long, especially for discovery topics.
-      __mqttManager.setBufferSize(1024);
+      // discovery payloads are streamed into the network client, the PubSubClient buffer only needs to fit
+      // the incoming messages (e.g. commands) and the small state messages.
+      __mqttManager.setBufferSize(256);
       
       __console.executeBatch("init", getName());
       
+      /// hashes of the configs published before, unchanged configs don't need to be published again
+      loadDiscoveryHashes();
+      
+      /// republish all configs, when HA comes online
+      _pmqttTopicHAStatus = std::make_unique<CxMqttTopic>("/homeassistant/status", [this](const char* topic, uint8_t* payload, unsigned int len) {
+         if (_bHAEnabled && len >= 6 && strncmp((char*)payload, "online", 6) == 0) {
+            _CONSOLE_INFO(F("HA is online, refresh discovery"));
+            _mqttHAdev.regItems(true, true);
+         }
+      });
+      
       /// enable MQTT HA
       if (isEnabled()) enableHA(true);
+      
+      /// HA is started with the discovery, when mqtt is (re)connected. Unchanged configs are skipped (hashes),
+      /// the discovery is published by the loop within its budget. HA is ready, when it is completed.
+      CxServiceManager::getInstance().addService("ha", {"mqtt"},
+         [this]() {return _bHAStarted && __mqttManager.isConnected() && !_mqttHAdev.isDiscoveryPending();},
+         [this]() {_bHAStarted = true; _mqttHAdev.regItems(true);},
+         [this]() {return _bHAEnabled;});
 
    }
    
    /// Loop method to update sensor data and diagnostics
    void loop() override {
+      /// continue a pending discovery
+      _mqttHAdev.loopDiscovery();
+      
+      /// persist the hashes of the published configs, when the discovery is completed
+      if (!_mqttHAdev.isDiscoveryPending() && _mqttHAdev.isDiscoveryHashChanged()) {
+         saveDiscoveryHashes();
+      }
+      
       /// update sensor data
       for (auto& pHASensor : _vHASensor) {
          if (pHASensor->isDue()) {
             pHASensor->publishState(pHASensor->getSensor()->getFloatValue(), 2);
          }
       }
+      
+      /// publish the aggregated states
+      _mqttHAdev.loopState();
    }
    
    uint8_t execute(const char *szCmd, uint8_t nClient) override {
@@ -164,6 +202,31 @@ public:
             nExitValue = enableHA(_bHAEnabled);
          } else if (strSubCmd == "list") {
             _mqttHAdev.printList(getIoStream());
+         } else if (strSubCmd == "refresh") {
+            // republish all discovery configs, also the unchanged ones
+            if (_bHAEnabled) {
+               _mqttHAdev.regItems(true, true);
+            } else {
+               nExitValue = EXIT_FAILURE;
+            }
+         } else if (strSubCmd == "aggregate") {
+            // ha aggregate [0|1] [<window ms>]
+            int32_t nAggregate = TKTOINT(tkArgs, 2, -1);
+            if (nAggregate < 0) {
+               __console.setOutputVariable(_mqttHAdev.isStateAggregation());
+            } else if (nAggregate != _mqttHAdev.isStateAggregation() || tkArgs.count() > 3) {
+               _mqttHAdev.setStateAggregation(nAggregate > 0, TKTOINT(tkArgs, 3, _mqttHAdev.getStateWindow()));
+               // the state topic and templates of the entities have changed
+               if (_bHAEnabled) _mqttHAdev.regItems(true);
+            }
+         } else if (strSubCmd == "budget") {
+            // ha budget <bytes per loop>
+            int32_t nBudget = TKTOINT(tkArgs, 2, -1);
+            if (nBudget > 0) {
+               _mqttHAdev.setDiscoveryBudget((uint32_t)nBudget);
+            } else {
+               __console.setOutputVariable(_mqttHAdev.getDiscoveryBudget());
+            }
          } else if (strSubCmd == "sensor") {
             if (strSub2Cmd == "add") {
                nExitValue = addSensor(TKTOCHAR(tkArgs, 3), TKTOINT(tkArgs, 4, 60000));
@@ -214,9 +277,7 @@ public:
                   const char* szValue = __console.getVariable(pHADiag->getVariable());
                   if (szValue) {
                      pHADiag->publishState(szValue);
-                     DynamicJsonDocument doc(256);
-                     doc[F("variable")] = pHADiag->getVariable();
-                     pHADiag->publishAttributes(doc);
+                     pHADiag->publishAttributes("variable", pHADiag->getVariable());
                   } else {
                      pHADiag->publishAvailability(false);
                   }
@@ -231,6 +292,12 @@ public:
          }
          else {
             printf(F(ESC_ATTR_BOLD " Enabled:      " ESC_ATTR_RESET "%d\n"), _bHAEnabled);
+            printf(F(ESC_ATTR_BOLD " MQTT buffer:  " ESC_ATTR_RESET "%d bytes\n"), __mqttManager.getBufferSize());
+            printf(F(ESC_ATTR_BOLD " Disc. heap:   " ESC_ATTR_RESET "%" PRIu32 " bytes (peak)\n"), (uint32_t)_mqttHAdev.getDiscoveryHeapPeak());
+            printf(F(ESC_ATTR_BOLD " Disc. skip:   " ESC_ATTR_RESET "%" PRIu32 " (unchanged)\n"), _mqttHAdev.getDiscoverySkipped());
+            printf(F(ESC_ATTR_BOLD " Streamed:     " ESC_ATTR_RESET "%" PRIu32 "\n"), __mqttManager.getStreamedCntr());
+            printf(F(ESC_ATTR_BOLD " Aggregate:    " ESC_ATTR_RESET "%d (%" PRIu32 " ms)\n"), _mqttHAdev.isStateAggregation(), _mqttHAdev.getStateWindow());
+            printf(F(ESC_ATTR_BOLD " States:       " ESC_ATTR_RESET "%" PRIu32 " msg/min, %" PRIu32 " bytes/min heap\n"), _mqttHAdev.getStateMsgsPerMin(), _mqttHAdev.getStateHeapPerMin());
             __console.man(getName());
          }
       } else {
@@ -241,6 +308,44 @@ public:
    }
       
    bool isEnabled() {return _bHAEnabled;}
+   
+   /// Loads the hashes of the published discovery configs from the file system
+   void loadDiscoveryHashes() {
+#ifdef ARDUINO
+      if (__console.hasFS() && LittleFS.exists(_szHASH_FILE)) {
+         File file = LittleFS.open(_szHASH_FILE, "r");
+         if (file) {
+            size_t n = _mqttHAdev.loadDiscoveryHashes(file);
+            file.close();
+            _CONSOLE_DEBUG(F("%d discovery hashes loaded"), n);
+         }
+      }
+#endif
+   }
+   
+   /// Saves the hashes of the published discovery configs to the file system
+   /// If they can't be saved, they are kept in RAM only (no retry in every loop). The next discovery tries again,
+   /// after a reboot the configs are published again.
+   void saveDiscoveryHashes() {
+#ifdef ARDUINO
+      if (!__console.hasFS()) {
+         _mqttHAdev.setDiscoveryHashChanged(false);
+         return;
+      }
+      File file = LittleFS.open(_szHASH_FILE, "w");
+      if (file) {
+         size_t n = _mqttHAdev.saveDiscoveryHashes(file);
+         file.close();
+         __console.fsChanged(_szHASH_FILE);
+         _CONSOLE_DEBUG(F("%d discovery hashes saved"), n);
+      } else {
+         _mqttHAdev.setDiscoveryHashChanged(false);
+         __console.error(F("can't write %s"), _szHASH_FILE);
+      }
+#else
+      _mqttHAdev.setDiscoveryHashChanged(false);
+#endif
+   }
    void setEnabled(bool set) {_bHAEnabled = set;}
    
    /**
@@ -441,7 +441,7 @@ public:
 
    uint8_t listStates() {
       // list states
-      CxTablePrinter table(*__console.getStream());
+      CxTablePrinter table(*__console.getStream(), __console.getTableFormat());
       
       table.printHeader({F("Ch"), F("On"), F("Toggle"), F("OnCode"), F("OffCode")},{3, 5, 7, 10, 10});
       
@@ -621,7 +621,7 @@ public:
 
    // Function to list all screens in the map
    uint8_t printScreens() {
-      CxTablePrinter table(getIoStream());
+      CxTablePrinter table(getIoStream(), __console.getTableFormat());
       table.printHeader({F("ID"), F("Screen Name"), F("Type"), F("Parameter")}, {3, 12, 8, 15});
       
       for (const auto& [name, screen] : _mapScreens) {
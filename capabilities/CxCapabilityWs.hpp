@@ -0,0 +1,327 @@
+/**
+ * @file CxCapabilityWs.hpp
+ * @brief WebSocket console for the ESP console
+ *
+ * This file defines `CxCapabilityWs`, a WebSocket server for interactive console sessions in the
+ * browser. The session uses the same console input and output as a telnet session (there is one
+ * remote session at a time). The output is sent in binary frames of up to 1 kB, collected during a
+ * loop. The server also serves the console page (console.html) for requests without upgrade.
+ *
+ * Example:
+ * ```sh
+ * ws start 81
+ * ```
+ * and open http://<host>:81/ in the browser.
+ *
+ * @date created by ocfu on 17.10.26
+ * @copyright © 2026 ocfu
+ */
+
+#ifndef CxCapabilityWs_hpp
+#define CxCapabilityWs_hpp
+
+#include "CxCapability.hpp"
+#include "CxESPConsole.hpp"
+#include "CxHtmlAssets.h"
+
+#include "../tools/CxWebSocket.hpp"
+
+#include <inttypes.h>
+
+class CxCapabilityWs : public CxCapability {
+   CxESPConsoleMaster& __console = CxESPConsoleMaster::getInstance();
+
+   static constexpr uint16_t _nMAX_REQUEST = 1024;     ///< max. size of the request header
+   static constexpr uint32_t _nREQUEST_TIMEOUT = 5000; ///< time for the request (ms)
+
+#ifndef ESP_CONSOLE_NOWIFI
+   WiFiServer* _pServer = nullptr;
+
+   /// connection waiting for the complete request
+   WiFiClient _pending;
+   String     _strRequest;
+   uint32_t   _nPendingStart = 0;
+
+   /// websocket session
+   WiFiClient _client;
+   CxWebSocketStream* _pWs = nullptr;
+#endif
+
+   uint16_t _nPort = 81;
+
+   /// statistics
+   uint32_t _nSessions = 0;
+   uint32_t _nPages = 0;
+   uint32_t _nFramesOut = 0;
+   uint32_t _nBytesOut = 0;
+
+public:
+   explicit CxCapabilityWs()
+   : CxCapability("ws", getCmds()) {}
+   static constexpr const char* getName() { return "ws"; }
+   static const std::vector<const char*>& getCmds() {
+      static std::vector<const char*> commands = { "ws" };
+      return commands;
+   }
+   static std::unique_ptr<CxCapability> construct(const char* param) {
+      return std::make_unique<CxCapabilityWs>();
+   }
+
+   ~CxCapabilityWs() {
+      end();
+   }
+
+   void setup() override {
+      CxCapability::setup();
+
+      setIoStream(*__console.getStream());
+      __bLocked = false;
+
+      _CONSOLE_INFO(F("====  Cap: %s  ===="), getName());
+
+      __console.executeBatch("init", getName());
+   }
+
+   void loop() override {
+#ifndef ESP_CONSOLE_NOWIFI
+      if (!_pServer) return;
+
+      WiFiClient client = _pServer->available();
+      if (client) {
+         if (_pending) {
+            _sendStatus(client, 503, "busy");
+            client.stop();
+         } else {
+            _pending = client;
+            _strRequest = "";
+            _nPendingStart = (uint32_t)millis();
+         }
+      }
+
+      if (_pending) _loopPending();
+
+      if (_pWs) {
+         if (!_pWs->connected() || !__console.isClientAttached(*_pWs)) {
+            _pWs->close(1000); // e.g. exit, no frame, if closed by the peer
+            _closeSession();
+         } else {
+            // answer pings and send the output of this loop
+            _pWs->loop();
+         }
+      }
+#endif
+   }
+
+   uint8_t execute(const char *szCmd, uint8_t nClient) override {
+
+      // validate the call
+      if (!szCmd) return EXIT_FAILURE;
+
+      // get the arguments into the token buffer
+      CxStrToken tkArgs(szCmd, " ");
+
+      // we have a command, find the action to take
+      String cmd = TKTOCHAR(tkArgs, 0);
+
+      // removes heading and trailing white spaces
+      cmd.trim();
+
+      uint8_t nExitValue = EXIT_FAILURE;
+
+      if (cmd == "?") {
+         nExitValue = printCommands();
+      } else if (cmd == "ws") {
+         String strSubCmd = TKTOCHAR(tkArgs, 1);
+         nExitValue = EXIT_SUCCESS;
+         if (strSubCmd == "start") {
+            if (!begin((uint16_t)TKTOINT(tkArgs, 2, _nPort))) nExitValue = EXIT_FAILURE;
+         } else if (strSubCmd == "stop") {
+            end();
+         } else if (strSubCmd == "") {
+            printInfo();
+         } else {
+            __console.man(cmd.c_str());
+            nExitValue = EXIT_FAILURE;
+         }
+      } else {
+         return EXIT_NOT_HANDLED;
+      }
+      g_Stack.update();
+      return nExitValue;
+   }
+
+   bool begin(uint16_t nPort) {
+#ifndef ESP_CONSOLE_NOWIFI
+      end();
+      if (!nPort) return false;
+      _nPort = nPort;
+      _pServer = new WiFiServer(_nPort);
+      if (!_pServer) return false;
+      _pServer->begin();
+      _CONSOLE_INFO(F("ws listening on port %d"), _nPort);
+      return true;
+#else
+      return false;
+#endif
+   }
+
+   void end() {
+#ifndef ESP_CONSOLE_NOWIFI
+      if (_pWs) _pWs->close(1001);
+      _closeSession();
+      _pending.stop();
+      if (_pServer) {
+         _pServer->stop();
+         delete _pServer;
+         _pServer = nullptr;
+         _CONSOLE_INFO(F("ws stopped"));
+      }
+#endif
+   }
+
+   void printInfo() {
+#ifndef ESP_CONSOLE_NOWIFI
+      printf(F(ESC_ATTR_BOLD "Port:      " ESC_ATTR_RESET "%d (%s)\n"), _nPort, _pServer ? "listening" : "stopped");
+      printf(F(ESC_ATTR_BOLD "Session:   " ESC_ATTR_RESET "%s\n"), _pWs ? "active" : "-");
+      uint32_t nFrames = _nFramesOut + (_pWs ? _pWs->getFramesOut() : 0);
+      uint32_t nBytes = _nBytesOut + (_pWs ? _pWs->getBytesOut() : 0);
+#else
+      uint32_t nFrames = _nFramesOut;
+      uint32_t nBytes = _nBytesOut;
+#endif
+      printf(F(ESC_ATTR_BOLD "Sessions:  " ESC_ATTR_RESET "%" PRIu32 "\n"), _nSessions);
+      printf(F(ESC_ATTR_BOLD "Pages:     " ESC_ATTR_RESET "%" PRIu32 "\n"), _nPages);
+      printf(F(ESC_ATTR_BOLD "Frames:    " ESC_ATTR_RESET "%" PRIu32 " (%" PRIu32 " bytes, avg. %" PRIu32 ")\n"), nFrames, nBytes, nFrames ? nBytes / nFrames : (uint32_t)0);
+      __console.setOutputVariable(_nSessions);
+   }
+
+   static void loadCap() {
+      CAPREG(CxCapabilityWs);
+      CAPLOAD(CxCapabilityWs);
+   };
+
+private:
+#ifndef ESP_CONSOLE_NOWIFI
+   /// reads the request of a new connection, upgrades it to a websocket session or serves the console page
+   void _loopPending() {
+      // read in blocks, at most up to the max. size of the request header
+      char buf[128];
+      while (_pending.available() && _strRequest.length() < _nMAX_REQUEST) {
+         size_t nRoom = _nMAX_REQUEST - _strRequest.length();
+         int n = _pending.read((uint8_t*)buf, std::min(sizeof(buf), nRoom));
+         if (n <= 0) break;
+         _strRequest.concat(buf, (unsigned int)n);
+      }
+
+      int nHeaderEnd = _strRequest.indexOf("\r\n\r\n");
+      if (nHeaderEnd < 0) {
+         if (!_pending.connected() || _strRequest.length() >= _nMAX_REQUEST || (uint32_t)millis() - _nPendingStart > _nREQUEST_TIMEOUT) {
+            _pending.stop();
+            _pending = WiFiClient();
+         }
+         return;
+      }
+
+      String strHeader = _strRequest.substring(0, nHeaderEnd);
+      String strLower = strHeader;
+      strLower.toLowerCase();
+      _strRequest = "";
+
+      CxStrToken tkLine(strHeader.substring(0, strHeader.indexOf("\r\n")).c_str(), " ");
+      String strMethod = TKTOCHAR(tkLine, 0);
+      String strPath = TKTOCHAR(tkLine, 1);
+
+      if (strMethod != "GET") {
+         _sendStatus(_pending, 405, "method not allowed");
+      } else if (strLower.indexOf("\r\nupgrade: websocket") >= 0) {
+         _upgrade(strHeader, strLower);
+      } else if (strPath == "/" || strPath == "/console.html") {
+         _sendPage(strLower);
+      } else {
+         _sendStatus(_pending, 404, "not found");
+      }
+
+      if (_pending) {
+         _pending.stop();
+         _pending = WiFiClient();
+      }
+   }
+
+   void _upgrade(const String& strHeader, const String& strLower) {
+      int nKey = strLower.indexOf("\r\nsec-websocket-key:");
+      if (nKey < 0) {
+         _sendStatus(_pending, 400, "bad request");
+         return;
+      }
+      String strKey = strHeader.substring(nKey + 20, strHeader.indexOf("\r\n", nKey + 2));
+      strKey.trim();
+
+      if (_pWs) {
+         _sendStatus(_pending, 503, "busy");
+         return;
+      }
+
+      _pending.setNoDelay(true);
+      _pending.print(F("HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\nSec-WebSocket-Accept: "));
+      _pending.print(CxWebSocketStream::getAcceptKey(strKey.c_str()));
+      _pending.print(F("\r\n\r\n"));
+
+      _client = _pending;
+      _pending = WiFiClient();
+      _pWs = new CxWebSocketStream(_client);
+      if (!_pWs) {
+         _client.stop();
+         return;
+      }
+
+      if (!__console.attachClient(*_pWs)) {
+         _pWs->print(F("console is in use\r\n"));
+         _pWs->close(1013); // try again later
+         _closeSession();
+         return;
+      }
+      _nSessions++;
+      _pWs->flush();
+   }
+
+   void _closeSession() {
+      if (!_pWs) return;
+      __console.detachClient(*_pWs);
+      _pWs->flush();
+      _nFramesOut += _pWs->getFramesOut();
+      _nBytesOut += _pWs->getBytesOut();
+      delete _pWs;
+      _pWs = nullptr;
+      _client.stop();
+      _client = WiFiClient();
+   }
+
+   void _sendPage(const String& strLower) {
+      for (const auto& asset : g_htmlAssets) {
+         if (strcmp(asset.szPath, "/console.html") != 0 || !asset.bGzip) continue;
+
+         _nPages++;
+         if (strLower.indexOf(String(F("\r\nif-none-match: ")) + asset.szETag) >= 0) {
+            _sendStatus(_pending, 304, "not modified");
+            return;
+         }
+         _pending.printf("HTTP/1.1 200 OK\r\nContent-Type: %s\r\nContent-Encoding: gzip\r\nContent-Length: %" PRIu32 "\r\nETag: %s\r\nCache-Control: no-cache\r\nConnection: close\r\n\r\n", asset.szMime, asset.nLength, asset.szETag);
+
+         uint8_t buf[256];
+         for (uint32_t nPos = 0; nPos < asset.nLength; nPos += sizeof(buf)) {
+            uint32_t n = std::min((uint32_t)sizeof(buf), asset.nLength - nPos);
+            memcpy_P(buf, asset.pData + nPos, n);
+            _pending.write(buf, n);
+         }
+         return;
+      }
+      _sendStatus(_pending, 404, "not found");
+   }
+
+   void _sendStatus(WiFiClient& client, int nCode, const char* szMsg) {
+      client.printf("HTTP/1.1 %d %s\r\nContent-Length: 0\r\nConnection: close\r\n\r\n", nCode, szMsg);
+   }
+#endif /* ESP_CONSOLE_NOWIFI */
+};
+
+#endif /* CxCapabilityWs_hpp */
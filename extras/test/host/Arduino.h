@@ -0,0 +1,238 @@
+//
+//  Arduino.h
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+//  Minimal Arduino core for the host tests (extras/test). It covers the parts of the core, which are used by
+//  the header-only tools under test: String, Print, Stream, Client, Serial, millis() and the PROGMEM macros.
+//  millis() is the real time plus an offset, which the tests can advance (hostAdvance()) to simulate time.
+//
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifndef ARDUINO
+#define ARDUINO 10819
+#endif
+
+typedef uint8_t byte;
+
+// ---- time
+
+inline uint32_t& hostClockOffset() {
+   static uint32_t nOffset = 0;
+   return nOffset;
+}
+
+/// advances the simulated time
+inline void hostAdvance(uint32_t nMs) {hostClockOffset() += nMs;}
+
+inline uint32_t hostRealMillis() {
+   static const auto tStart = std::chrono::steady_clock::now();
+   return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - tStart).count();
+}
+
+inline unsigned long millis() {return hostRealMillis() + hostClockOffset();}
+inline unsigned long micros() {return millis() * 1000UL;}
+inline void yield() {}
+inline void delay(unsigned long nMs) {hostAdvance((uint32_t)nMs);}
+
+// ---- flash strings
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+#define FPSTR(p) (reinterpret_cast<const __FlashStringHelper*>(p))
+#define PROGMEM
+#define PGM_P const char*
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#define memcpy_P memcpy
+#define strlen_P strlen
+#define strcmp_P strcmp
+#define vsnprintf_P vsnprintf
+#define snprintf_P snprintf
+
+// ---- String
+
+class String : public std::string {
+public:
+   String() {}
+   String(const char* sz) : std::string(sz ? sz : "") {}
+   String(const std::string& str) : std::string(str) {}
+   String(const __FlashStringHelper* f) : std::string(reinterpret_cast<const char*>(f)) {}
+   String(char c) : std::string(1, c) {}
+   String(int n) : std::string(std::to_string(n)) {}
+   String(unsigned int n) : std::string(std::to_string(n)) {}
+   String(long n) : std::string(std::to_string(n)) {}
+   String(unsigned long n) : std::string(std::to_string(n)) {}
+   String(unsigned int n, unsigned char nBase) {
+      char sz[16];
+      snprintf(sz, sizeof(sz), nBase == 16 ? "%x" : "%u", n);
+      assign(sz);
+   }
+   String(double f, unsigned int nDecimals = 2) {
+      char sz[32];
+      snprintf(sz, sizeof(sz), "%.*f", (int)nDecimals, f);
+      assign(sz);
+   }
+
+   bool reserve(size_t n) {std::string::reserve(n); return true;}
+   unsigned int length() const {return (unsigned int)size();}
+
+   String& operator+=(const char* sz) {if (sz) append(sz); return *this;}
+   String& operator+=(const std::string& str) {append(str); return *this;}
+   String& operator+=(char c) {push_back(c); return *this;}
+   String& operator+=(const __FlashStringHelper* f) {return *this += reinterpret_cast<const char*>(f);}
+   String& operator+=(int n) {append(std::to_string(n)); return *this;}
+   String& operator+=(unsigned int n) {append(std::to_string(n)); return *this;}
+   String& operator+=(long n) {append(std::to_string(n)); return *this;}
+   String& operator+=(unsigned long n) {append(std::to_string(n)); return *this;}
+   bool concat(const char* sz) {*this += sz; return true;}
+   bool concat(char c) {*this += c; return true;}
+   bool concat(const char* sz, unsigned int nLength) {append(sz, nLength); return true;}
+
+   int indexOf(char c, unsigned int nFrom = 0) const {size_t i = find(c, nFrom); return i == npos ? -1 : (int)i;}
+   int indexOf(const char* sz, unsigned int nFrom = 0) const {size_t i = find(sz, nFrom); return i == npos ? -1 : (int)i;}
+   int indexOf(const String& str, unsigned int nFrom = 0) const {return indexOf(str.c_str(), nFrom);}
+   int lastIndexOf(char c) const {size_t i = rfind(c); return i == npos ? -1 : (int)i;}
+   String substring(unsigned int nFrom) const {return nFrom < size() ? String(substr(nFrom)) : String();}
+   String substring(unsigned int nFrom, unsigned int nTo) const {return (nFrom < size() && nTo > nFrom) ? String(substr(nFrom, nTo - nFrom)) : String();}
+   bool startsWith(const char* sz) const {return compare(0, strlen(sz), sz) == 0;}
+   bool startsWith(const String& str) const {return startsWith(str.c_str());}
+   bool endsWith(const char* sz) const {size_t n = strlen(sz); return size() >= n && compare(size() - n, n, sz) == 0;}
+   bool equals(const char* sz) const {return *this == sz;}
+   void remove(unsigned int nFrom) {if (nFrom < size()) erase(nFrom);}
+   void remove(unsigned int nFrom, unsigned int nCount) {if (nFrom < size()) erase(nFrom, nCount);}
+   void toLowerCase() {for (auto& c : *this) c = (char)tolower((unsigned char)c);}
+   void toUpperCase() {for (auto& c : *this) c = (char)toupper((unsigned char)c);}
+   void trim() {
+      size_t a = find_first_not_of(" \t\r\n");
+      size_t b = find_last_not_of(" \t\r\n");
+      if (a == npos) clear(); else assign(substr(a, b - a + 1));
+   }
+   long toInt() const {return strtol(c_str(), nullptr, 10);}
+   float toFloat() const {return strtof(c_str(), nullptr);}
+};
+
+inline String operator+(const String& a, const char* b) {String s(a); s += b; return s;}
+inline String operator+(const String& a, const String& b) {String s(a); s += b; return s;}
+inline String operator+(const String& a, char c) {String s(a); s += c; return s;}
+
+// ---- Print, Stream, Client
+
+class Print {
+public:
+   virtual ~Print() {}
+   virtual size_t write(uint8_t c) = 0;
+   virtual size_t write(const uint8_t* buffer, size_t size) {
+      size_t n = 0;
+      while (size--) {
+         if (!write(*buffer++)) break;
+         n++;
+      }
+      return n;
+   }
+   size_t write(const char* sz) {return sz ? write((const uint8_t*)sz, strlen(sz)) : 0;}
+   size_t write(const char* buffer, size_t size) {return write((const uint8_t*)buffer, size);}
+   // as the ESP8266 core, avoids the ambiguity of write(0)
+   size_t write(int t) {return write((uint8_t)t);}
+   size_t write(unsigned int t) {return write((uint8_t)t);}
+   size_t write(char c) {return write((uint8_t)c);}
+   virtual int availableForWrite() {return 0;}
+   virtual void flush() {}
+
+   size_t print(const char* sz) {return write(sz);}
+   size_t print(const String& str) {return write((const uint8_t*)str.c_str(), str.length());}
+   size_t print(const __FlashStringHelper* f) {return write(reinterpret_cast<const char*>(f));}
+   size_t print(char c) {return write((uint8_t)c);}
+   size_t print(int n) {return printf("%d", n);}
+   size_t print(unsigned int n) {return printf("%u", n);}
+   size_t print(long n) {return printf("%ld", n);}
+   size_t print(unsigned long n) {return printf("%lu", n);}
+   size_t print(double f, int nDecimals = 2) {return printf("%.*f", nDecimals, f);}
+   size_t println() {return write("\r\n");}
+   template <typename T> size_t println(const T& value) {size_t n = print(value); return n + println();}
+
+   size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+      char sz[256];
+      va_list args;
+      va_start(args, fmt);
+      int n = vsnprintf(sz, sizeof(sz), fmt, args);
+      va_end(args);
+      if (n < 0) return 0;
+      if ((size_t)n < sizeof(sz)) return write((const uint8_t*)sz, n);
+      std::unique_ptr<char[]> p(new char[n + 1]);
+      va_start(args, fmt);
+      vsnprintf(p.get(), n + 1, fmt, args);
+      va_end(args);
+      return write((const uint8_t*)p.get(), n);
+   }
+   size_t printf(const __FlashStringHelper* fmt, ...) {
+      char sz[256];
+      va_list args;
+      va_start(args, fmt);
+      int n = vsnprintf(sz, sizeof(sz), reinterpret_cast<const char*>(fmt), args);
+      va_end(args);
+      return (n > 0) ? write((const uint8_t*)sz, std::min((size_t)n, sizeof(sz) - 1)) : 0;
+   }
+};
+
+class Stream : public Print {
+protected:
+   unsigned long _nTimeout = 1000;
+public:
+   virtual int available() = 0;
+   virtual int read() = 0;
+   virtual int peek() = 0;
+   void setTimeout(unsigned long nTimeout) {_nTimeout = nTimeout;}
+   size_t readBytes(char* buffer, size_t size) {
+      size_t n = 0;
+      while (n < size) {
+         int c = read();
+         if (c < 0) break;
+         buffer[n++] = (char)c;
+      }
+      return n;
+   }
+   size_t readBytes(uint8_t* buffer, size_t size) {return readBytes((char*)buffer, size);}
+};
+
+class Client : public Stream {
+public:
+   virtual int connect(const char* szHost, uint16_t nPort) = 0;
+   virtual int read(uint8_t* buffer, size_t size) = 0;
+   virtual uint8_t connected() = 0;
+   virtual void stop() = 0;
+   virtual operator bool() = 0;
+   using Stream::read;
+   using Print::write;
+};
+
+/// Serial writes to stdout, there is no input
+class HostSerial : public Stream {
+public:
+   virtual size_t write(uint8_t c) override {return fputc(c, stdout) == EOF ? 0 : 1;}
+   virtual size_t write(const uint8_t* buffer, size_t size) override {return fwrite(buffer, 1, size, stdout);}
+   using Print::write;
+   virtual int available() override {return 0;}
+   virtual int read() override {return -1;}
+   virtual int peek() override {return -1;}
+};
+
+inline HostSerial Serial;
+
+#endif /* HOST_ARDUINO_H */
@@ -0,0 +1,449 @@
+//
+//  ArduinoJson.h
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+//  Minimal ArduinoJson 6 for the host tests (extras/test): the part of the API the HA manager uses to build and
+//  serialize documents (members, nested objects/arrays, measure/serialize compact and pretty). As the library
+//  a DynamicJsonDocument allocates its capacity once from the heap, the nodes (16 bytes, as on the ESP) and the
+//  copied strings are taken from this pool, a full pool drops the value (overflowed()).
+//
+
+#ifndef HOST_ARDUINOJSON_H
+#define HOST_ARDUINOJSON_H
+
+#include "Arduino.h"
+
+#include <type_traits>
+
+class JsonDocument;
+
+namespace hostjson {
+
+enum : uint8_t {T_NULL, T_OBJECT, T_ARRAY, T_STRING, T_INT, T_FLOAT, T_BOOL};
+
+/// node of the tree, the links are offsets in the pool (0: none)
+struct Slot {
+   uint16_t nKey;
+   uint16_t nNext;
+   uint16_t nChild;     ///< first member/element or the string
+   uint8_t  nType;
+   union {
+      int64_t i;
+      double  f;
+      bool    b;
+   };
+};
+
+}
+
+class MemberProxy;
+class ElementProxy;
+
+/// object reference (nested object of a document)
+class JsonObject {
+protected:
+   JsonDocument* _pDoc;
+   hostjson::Slot* _pSlot;
+public:
+   JsonObject(JsonDocument* pDoc = nullptr, hostjson::Slot* pSlot = nullptr) : _pDoc(pDoc), _pSlot(pSlot) {}
+   MemberProxy operator[](const char* szKey);
+   MemberProxy operator[](const __FlashStringHelper* szKey);
+   MemberProxy operator[](const String& strKey);
+   bool isNull() const {return !_pSlot;}
+};
+
+/// array reference (nested array of a document)
+class JsonArray {
+   JsonDocument* _pDoc;
+   hostjson::Slot* _pSlot;
+public:
+   JsonArray(JsonDocument* pDoc = nullptr, hostjson::Slot* pSlot = nullptr) : _pDoc(pDoc), _pSlot(pSlot) {}
+   JsonObject createNestedObject();
+   JsonArray createNestedArray();
+   template <class T> bool add(const T& value);
+   ElementProxy operator[](size_t nIndex);
+   bool isNull() const {return !_pSlot;}
+};
+
+/// element of an array, created (with the elements before) when a value is assigned
+class ElementProxy {
+   JsonDocument* _pDoc;
+   hostjson::Slot* _pParent;
+   size_t _nIndex;
+public:
+   ElementProxy(JsonDocument* pDoc, hostjson::Slot* pParent, size_t nIndex) : _pDoc(pDoc), _pParent(pParent), _nIndex(nIndex) {}
+   template <class T> ElementProxy& operator=(const T& value);
+   ElementProxy& operator=(const ElementProxy&) = delete;
+};
+
+/// member of an object, created when a value is assigned
+class MemberProxy {
+   JsonDocument* _pDoc;
+   hostjson::Slot* _pParent;
+   const char* _szKey;
+public:
+   MemberProxy(JsonDocument* pDoc, hostjson::Slot* pParent, const char* szKey) : _pDoc(pDoc), _pParent(pParent), _szKey(szKey) {}
+   template <class T> MemberProxy& operator=(const T& value);
+   MemberProxy& operator=(const MemberProxy&) = delete;
+   MemberProxy operator[](const char* szKey);
+   MemberProxy operator[](const __FlashStringHelper* szKey) {return (*this)[reinterpret_cast<const char*>(szKey)];}
+   bool operator==(const char* sz) const;
+   bool operator!=(const char* sz) const {return !(*this == sz);}
+   const char* asString() const;
+   template <class T> T as() const;
+};
+
+class JsonDocument {
+   friend class JsonObject;
+   friend class JsonArray;
+   friend class MemberProxy;
+   friend class ElementProxy;
+class ElementProxy;
+
+   size_t _nCapacity;
+   size_t _nUsed;
+   bool   _bOverflowed;
+   hostjson::Slot _root;
+
+protected:
+   char*  _p;
+
+   JsonDocument(char* p, size_t nCapacity) : _nCapacity(nCapacity), _p(p) {clear();}
+
+   hostjson::Slot* _slot(uint16_t n) const {return n ? (hostjson::Slot*)(_p + n) : nullptr;}
+   const char* _str(uint16_t n) const {return n ? _p + n : "";}
+   uint16_t _offset(const void* p) const {return (uint16_t)((const char*)p - _p);}
+
+   void* _alloc(size_t n, size_t nAlign) {
+      size_t nStart = (_nUsed + nAlign - 1) & ~(nAlign - 1);
+      if (!_p || nStart + n > _nCapacity || nStart + n > 0xffff) {
+         _bOverflowed = true;
+         return nullptr;
+      }
+      _nUsed = nStart + n;
+      return _p + nStart;
+   }
+
+   uint16_t _allocStr(const char* sz) {
+      size_t n = strlen(sz) + 1;
+      char* p = (char*)_alloc(n, 1);
+      if (!p) return 0;
+      memcpy(p, sz, n);
+      return _offset(p);
+   }
+
+   hostjson::Slot* _allocSlot() {
+      hostjson::Slot* p = (hostjson::Slot*)_alloc(sizeof(hostjson::Slot), alignof(hostjson::Slot));
+      if (p) memset(p, 0, sizeof(*p));
+      return p;
+   }
+
+   /// appends a child to an object/array
+   hostjson::Slot* _append(hostjson::Slot* pParent) {
+      hostjson::Slot* p = _allocSlot();
+      if (!p) return nullptr;
+      if (!pParent->nChild) {
+         pParent->nChild = _offset(p);
+      } else {
+         hostjson::Slot* pLast = _slot(pParent->nChild);
+         while (pLast->nNext) pLast = _slot(pLast->nNext);
+         pLast->nNext = _offset(p);
+      }
+      return p;
+   }
+
+   /// member of an object, optionally created
+   hostjson::Slot* _member(hostjson::Slot* pParent, const char* szKey, bool bCreate) {
+      if (!pParent || !szKey) return nullptr;
+      if (pParent->nType != hostjson::T_OBJECT) {
+         if (!bCreate || pParent->nType != hostjson::T_NULL) return nullptr;
+         pParent->nType = hostjson::T_OBJECT;
+      }
+      for (hostjson::Slot* p = _slot(pParent->nChild); p; p = _slot(p->nNext)) {
+         if (strcmp(_str(p->nKey), szKey) == 0) return p;
+      }
+      if (!bCreate) return nullptr;
+      uint16_t nKey = _allocStr(szKey);
+      if (!nKey) return nullptr;
+      hostjson::Slot* p = _append(pParent);
+      if (p) p->nKey = nKey;
+      return p;
+   }
+
+   hostjson::Slot* _element(hostjson::Slot* pParent) {
+      if (!pParent) return nullptr;
+      if (pParent->nType == hostjson::T_NULL) pParent->nType = hostjson::T_ARRAY;
+      return (pParent->nType == hostjson::T_ARRAY) ? _append(pParent) : nullptr;
+   }
+
+   hostjson::Slot* _element(hostjson::Slot* pParent, size_t nIndex) {
+      if (!pParent) return nullptr;
+      if (pParent->nType == hostjson::T_NULL) pParent->nType = hostjson::T_ARRAY;
+      if (pParent->nType != hostjson::T_ARRAY) return nullptr;
+      hostjson::Slot* p = _slot(pParent->nChild);
+      for (size_t i = 0; i < nIndex && p; i++) {
+         if (!p->nNext && !_append(pParent)) return nullptr;
+         p = _slot(p->nNext);
+      }
+      return p ? p : _append(pParent);
+   }
+
+   void _setNull(hostjson::Slot* p) {p->nType = hostjson::T_NULL; p->nChild = 0;}
+   void _set(hostjson::Slot* p, const char* sz) {
+      if (!p) return;
+      if (!sz) {_setNull(p); return;}
+      uint16_t n = _allocStr(sz);
+      if (!n) return;
+      p->nType = hostjson::T_STRING;
+      p->nChild = n;
+   }
+   void _set(hostjson::Slot* p, char* sz) {_set(p, (const char*)sz);}
+   void _set(hostjson::Slot* p, const String& str) {_set(p, str.c_str());}
+   void _set(hostjson::Slot* p, const __FlashStringHelper* sz) {_set(p, reinterpret_cast<const char*>(sz));}
+   void _set(hostjson::Slot* p, bool b) {if (p) {p->nType = hostjson::T_BOOL; p->nChild = 0; p->b = b;}}
+   template <class T> typename std::enable_if<std::is_integral<T>::value>::type _set(hostjson::Slot* p, T n) {
+      if (p) {p->nType = hostjson::T_INT; p->nChild = 0; p->i = (int64_t)n;}
+   }
+   template <class T> typename std::enable_if<std::is_floating_point<T>::value>::type _set(hostjson::Slot* p, T f) {
+      if (p) {p->nType = hostjson::T_FLOAT; p->nChild = 0; p->f = (double)f;}
+   }
+   template <size_t N> void _set(hostjson::Slot* p, const char (&sz)[N]) {_set(p, (const char*)sz);}
+   template <size_t N> void _set(hostjson::Slot* p, char (&sz)[N]) {_set(p, (const char*)sz);}
+
+   // ---- serialization
+
+   template <class W> static void _putString(W& w, const char* sz) {
+      w("\"", 1);
+      for (; *sz; sz++) {
+         char c = *sz;
+         if (c == '"' || c == '\\') {
+            char sz2[2] = {'\\', c};
+            w(sz2, 2);
+         } else if ((uint8_t)c < 0x20) {
+            char szEsc[8];
+            switch (c) {
+               case '\n': w("\\n", 2); break;
+               case '\r': w("\\r", 2); break;
+               case '\t': w("\\t", 2); break;
+               default: w(szEsc, (size_t)snprintf(szEsc, sizeof(szEsc), "\\u%04x", (uint8_t)c)); break;
+            }
+         } else {
+            w(&c, 1);
+         }
+      }
+      w("\"", 1);
+   }
+
+   template <class W> static void _indent(W& w, int nLevel) {
+      w("\r\n", 2);
+      for (int i = 0; i < nLevel; i++) w("  ", 2);
+   }
+
+   template <class W> void _write(W& w, const hostjson::Slot* p, int nLevel, bool bPretty) const {
+      char sz[32];
+      switch (p->nType) {
+         case hostjson::T_OBJECT:
+         case hostjson::T_ARRAY: {
+            bool bObject = (p->nType == hostjson::T_OBJECT);
+            w(bObject ? "{" : "[", 1);
+            bool bFirst = true;
+            for (const hostjson::Slot* c = _slot(p->nChild); c; c = _slot(c->nNext)) {
+               if (!bFirst) w(",", 1);
+               bFirst = false;
+               if (bPretty) _indent(w, nLevel + 1);
+               if (bObject) {
+                  _putString(w, _str(c->nKey));
+                  w(bPretty ? ": " : ":", bPretty ? 2 : 1);
+               }
+               _write(w, c, nLevel + 1, bPretty);
+            }
+            if (bPretty && !bFirst) _indent(w, nLevel);
+            w(bObject ? "}" : "]", 1);
+            break;
+         }
+         case hostjson::T_STRING: _putString(w, _str(p->nChild)); break;
+         case hostjson::T_INT: w(sz, (size_t)snprintf(sz, sizeof(sz), "%lld", (long long)p->i)); break;
+         case hostjson::T_FLOAT:
+            if (std::isnan(p->f) || std::isinf(p->f)) w("null", 4);
+            else w(sz, (size_t)snprintf(sz, sizeof(sz), "%.9g", p->f));
+            break;
+         case hostjson::T_BOOL: p->b ? w("true", 4) : w("false", 5); break;
+         default: w("null", 4); break;
+      }
+   }
+
+public:
+   template <class W> void write(W& w, bool bPretty) const {_write(w, &_root, 0, bPretty);}
+
+   void clear() {
+      _nUsed = 8; // offset 0 is 'none'
+      _bOverflowed = false;
+      memset(&_root, 0, sizeof(_root));
+   }
+   size_t capacity() const {return _nCapacity;}
+   size_t memoryUsage() const {return _nUsed - 8;}
+   bool overflowed() const {return _bOverflowed;}
+
+   MemberProxy operator[](const char* szKey) {return MemberProxy(this, &_root, szKey);}
+   MemberProxy operator[](const __FlashStringHelper* szKey) {return (*this)[reinterpret_cast<const char*>(szKey)];}
+   MemberProxy operator[](const String& strKey) {return (*this)[strKey.c_str()];}
+
+   bool containsKey(const char* szKey) {return _member(&_root, szKey, false) != nullptr;}
+   /// removes a member, as the library the pool space is not reused
+   void remove(const char* szKey) {
+      if (_root.nType != hostjson::T_OBJECT) return;
+      uint16_t* pLink = &_root.nChild;
+      for (hostjson::Slot* p = _slot(*pLink); p; pLink = &p->nNext, p = _slot(*pLink)) {
+         if (strcmp(_str(p->nKey), szKey) == 0) {
+            *pLink = p->nNext;
+            return;
+         }
+      }
+   }
+   void remove(const __FlashStringHelper* szKey) {remove(reinterpret_cast<const char*>(szKey));}
+   bool containsKey(const __FlashStringHelper* szKey) {return containsKey(reinterpret_cast<const char*>(szKey));}
+
+   JsonObject createNestedObject(const char* szKey) {
+      hostjson::Slot* p = _member(&_root, szKey, true);
+      if (p) {_setNull(p); p->nType = hostjson::T_OBJECT;}
+      return JsonObject(this, p);
+   }
+   JsonObject createNestedObject(const __FlashStringHelper* szKey) {return createNestedObject(reinterpret_cast<const char*>(szKey));}
+   JsonArray createNestedArray(const char* szKey) {
+      hostjson::Slot* p = _member(&_root, szKey, true);
+      if (p) {_setNull(p); p->nType = hostjson::T_ARRAY;}
+      return JsonArray(this, p);
+   }
+   JsonArray createNestedArray(const __FlashStringHelper* szKey) {return createNestedArray(reinterpret_cast<const char*>(szKey));}
+   JsonObject as() {if (_root.nType == hostjson::T_NULL) _root.nType = hostjson::T_OBJECT; return JsonObject(this, &_root);}
+};
+
+class DynamicJsonDocument : public JsonDocument {
+public:
+   explicit DynamicJsonDocument(size_t nCapacity) : JsonDocument(new char[nCapacity], nCapacity) {}
+   ~DynamicJsonDocument() {delete[] _p;}
+   DynamicJsonDocument(const DynamicJsonDocument&) = delete;
+   DynamicJsonDocument& operator=(const DynamicJsonDocument&) = delete;
+};
+
+// ---- references
+
+inline MemberProxy JsonObject::operator[](const char* szKey) {return MemberProxy(_pDoc, _pSlot, szKey);}
+inline MemberProxy JsonObject::operator[](const __FlashStringHelper* szKey) {return (*this)[reinterpret_cast<const char*>(szKey)];}
+inline MemberProxy JsonObject::operator[](const String& strKey) {return (*this)[strKey.c_str()];}
+
+inline JsonObject JsonArray::createNestedObject() {
+   hostjson::Slot* p = _pDoc ? _pDoc->_element(_pSlot) : nullptr;
+   if (p) p->nType = hostjson::T_OBJECT;
+   return JsonObject(_pDoc, p);
+}
+inline JsonArray JsonArray::createNestedArray() {
+   hostjson::Slot* p = _pDoc ? _pDoc->_element(_pSlot) : nullptr;
+   if (p) p->nType = hostjson::T_ARRAY;
+   return JsonArray(_pDoc, p);
+}
+template <class T> bool JsonArray::add(const T& value) {
+   hostjson::Slot* p = _pDoc ? _pDoc->_element(_pSlot) : nullptr;
+   if (p) _pDoc->_set(p, value);
+   return p != nullptr;
+}
+
+inline ElementProxy JsonArray::operator[](size_t nIndex) {return ElementProxy(_pDoc, _pSlot, nIndex);}
+template <class T> ElementProxy& ElementProxy::operator=(const T& value) {
+   if (_pDoc) _pDoc->_set(_pDoc->_element(_pParent, _nIndex), value);
+   return *this;
+}
+
+template <class T> MemberProxy& MemberProxy::operator=(const T& value) {
+   if (_pDoc) _pDoc->_set(_pDoc->_member(_pParent, _szKey, true), value);
+   return *this;
+}
+inline MemberProxy MemberProxy::operator[](const char* szKey) {
+   return MemberProxy(_pDoc, _pDoc ? _pDoc->_member(_pParent, _szKey, true) : nullptr, szKey);
+}
+inline const char* MemberProxy::asString() const {
+   hostjson::Slot* p = _pDoc ? _pDoc->_member(_pParent, _szKey, false) : nullptr;
+   return (p && p->nType == hostjson::T_STRING) ? _pDoc->_str(p->nChild) : nullptr;
+}
+template <class T> T MemberProxy::as() const {
+   hostjson::Slot* p = _pDoc ? _pDoc->_member(_pParent, _szKey, false) : nullptr;
+   if (!p) return T();
+   if (p->nType == hostjson::T_INT) return (T)p->i;
+   if (p->nType == hostjson::T_FLOAT) return (T)p->f;
+   if (p->nType == hostjson::T_BOOL) return (T)p->b;
+   return T();
+}
+inline bool MemberProxy::operator==(const char* sz) const {
+   const char* szValue = asString();
+   return szValue && sz && strcmp(szValue, sz) == 0;
+}
+
+// ---- serialization
+
+namespace hostjson {
+
+struct Counter {
+   size_t n = 0;
+   void operator()(const char*, size_t nLen) {n += nLen;}
+};
+
+struct PrintWriter {
+   Print& p;
+   size_t n = 0;
+   void operator()(const char* sz, size_t nLen) {n += p.write((const uint8_t*)sz, nLen);}
+};
+
+struct BufferWriter {
+   char* p;
+   size_t nSize;
+   size_t n = 0;
+   void operator()(const char* sz, size_t nLen) {
+      for (size_t i = 0; i < nLen && n + 1 < nSize; i++) p[n++] = sz[i];
+   }
+};
+
+struct StringWriter {
+   String& str;
+   void operator()(const char* sz, size_t nLen) {str.append(sz, nLen);}
+};
+
+}
+
+inline size_t measureJson(const JsonDocument& doc) {hostjson::Counter w; doc.write(w, false); return w.n;}
+inline size_t measureJsonPretty(const JsonDocument& doc) {hostjson::Counter w; doc.write(w, true); return w.n;}
+
+inline size_t serializeJson(const JsonDocument& doc, Print& p) {hostjson::PrintWriter w{p}; doc.write(w, false); return w.n;}
+inline size_t serializeJsonPretty(const JsonDocument& doc, Print& p) {hostjson::PrintWriter w{p}; doc.write(w, true); return w.n;}
+
+inline size_t serializeJson(const JsonDocument& doc, char* p, size_t nSize) {
+   if (!p || !nSize) return 0;
+   hostjson::BufferWriter w{p, nSize};
+   doc.write(w, false);
+   p[w.n] = '\0';
+   return w.n;
+}
+inline size_t serializeJsonPretty(const JsonDocument& doc, char* p, size_t nSize) {
+   if (!p || !nSize) return 0;
+   hostjson::BufferWriter w{p, nSize};
+   doc.write(w, true);
+   p[w.n] = '\0';
+   return w.n;
+}
+
+inline size_t serializeJson(const JsonDocument& doc, String& str) {
+   size_t n = str.length();
+   hostjson::StringWriter w{str};
+   doc.write(w, false);
+   return str.length() - n;
+}
+inline size_t serializeJsonPretty(const JsonDocument& doc, String& str) {
+   size_t n = str.length();
+   hostjson::StringWriter w{str};
+   doc.write(w, true);
+   return str.length() - n;
+}
+
+#endif /* HOST_ARDUINOJSON_H */
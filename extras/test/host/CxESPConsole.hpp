@@ -0,0 +1,124 @@
+//
+//  CxESPConsole.hpp
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+//  Console stand-in for the host tests of the managers (extras/test), it takes the place of src/CxESPConsole.hpp:
+//  the log goes to stdout (info) or is dropped (debug), tables are printed as text unless the test sets a format.
+//  g_Heap reports the heap of the host tests (HostHeap.h). The commands are run by the test (cbProcessCmd), the
+//  variables are kept in a map as by the console. Include it before HostTest.h, the ESC sequences of defines.h are kept.
+//
+
+#ifndef CxESPConsole_hpp
+#define CxESPConsole_hpp
+
+#include "Arduino.h"
+#include "HostHeap.h"
+#include "defines.h"
+#include "esphw.h"
+
+#include "CxStrToken.hpp"
+#include "CxTimer.hpp"
+#include "CxTablePrinter.hpp"
+
+#include <map>
+
+class CxESPHeapTracker {
+public:
+   size_t available(bool bForceUpdate = false) {return hostHeap().available();}
+};
+
+inline CxESPHeapTracker g_Heap;
+
+class CxESPStackTracker {
+public:
+   void update() {}
+};
+
+inline CxESPStackTracker g_Stack;
+
+class CxCapability;
+
+class CxESPBootPhase {
+public:
+   CxESPBootPhase(const char* szName, const char* szSuffix = nullptr) {}
+};
+
+class CxESPConsoleMaster {
+   bool _bLog = true;
+   CxTablePrinter::e_format _eTableFormat = CxTablePrinter::e_format::text;
+   std::map<String, String> _mapVariables;
+public:
+   static CxESPConsoleMaster& getInstance() {
+      static CxESPConsoleMaster instance;
+      return instance;
+   }
+   /// log to stdout, off for measurements
+   void setLog(bool set) {_bLog = set;}
+   void info(const __FlashStringHelper* fmt, ...) {
+      if (!_bLog) return;
+      va_list args;
+      va_start(args, fmt);
+      vprintf(reinterpret_cast<const char*>(fmt), args);
+      va_end(args);
+      printf("\n");
+   }
+   /// errors are always printed, the tests count them
+   uint32_t nErrors = 0;
+   void error(const __FlashStringHelper* fmt, ...) {
+      nErrors++;
+      va_list args;
+      va_start(args, fmt);
+      printf("  error: ");
+      vprintf(reinterpret_cast<const char*>(fmt), args);
+      va_end(args);
+      printf("\n");
+   }
+   Stream* getStream() {return &Serial;}
+   /// table format of the session (fmt), text by default
+   void setTableFormat(CxTablePrinter::e_format fmt) {_eTableFormat = fmt;}
+   CxTablePrinter::e_format getTableFormat() {return _eTableFormat;}
+   bool hasFS() {return true;}
+
+   /// runs a command of a capability, prints to the stream and returns the exit value ($?)
+   std::function<uint8_t(Stream&, const char*)> cbProcessCmd;
+   uint8_t processCmd(Stream& stream, const char* szCmd, uint8_t nClient) {
+      uint8_t nExit = cbProcessCmd ? cbProcessCmd(stream, szCmd) : EXIT_FAILURE;
+      _mapVariables["?"] = String((unsigned int)nExit);
+      return nExit;
+   }
+   uint32_t getExitValue() {
+      auto it = _mapVariables.find("?");
+      return (it != _mapVariables.end()) ? (uint32_t)it->second.toInt() : 99;
+   }
+   void setOutputVariable(const char* set) {_mapVariables[">"] = set;}
+   void setOutputVariable(uint32_t set) {_mapVariables[">"] = String((unsigned int)set);}
+   const char* getVariable(const char* szName) {
+      auto it = _mapVariables.find(szName);
+      return (it != _mapVariables.end()) ? it->second.c_str() : nullptr;
+   }
+   void removeVariable(const char* szName) {_mapVariables.erase(szName);}
+   void executeBatch(const char* sz, const char* label) {}
+   void man(const char* sz, const char* param = nullptr) {}
+   bool regCap(const char* name, std::unique_ptr<CxCapability> (*constructor)(const char*)) {return true;}
+   CxCapability* createCapInstance(const char* name, const char* param) {return nullptr;}
+
+   static String makeNameIdStr(const char* sz) {
+      String id;
+      while (sz && *sz) {
+         char c = *sz++;
+         if (isalnum(c) || c == '_') {
+            id += (char)tolower(c);
+         } else if (c == ' ' || c == '-' || c == '.') {
+            id += '_';
+         }
+      }
+      return id;
+   }
+};
+
+inline CxESPConsoleMaster& ESPConsole = CxESPConsoleMaster::getInstance();
+
+#endif /* CxESPConsole_hpp */
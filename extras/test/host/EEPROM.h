@@ -0,0 +1,32 @@
+//
+//  EEPROM.h
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+//  EEPROM in RAM for the host tests (extras/test). hostEEPROM() gives the bytes, e.g. to check what was
+//  written.
+//
+
+#ifndef HOST_EEPROM_H
+#define HOST_EEPROM_H
+
+#include "Arduino.h"
+
+class EEPROMClass {
+   uint8_t _aData[4096] = {};
+   uint32_t _nWrites = 0;
+public:
+   void begin(size_t) {}
+   void end() {}
+   bool commit() {return true;}
+   uint8_t read(int nAddr) {return _aData[nAddr];}
+   void write(int nAddr, uint8_t c) {_aData[nAddr] = c; _nWrites++;}
+   uint8_t* getDataPtr() {return _aData;}
+   uint32_t getWrites() const {return _nWrites;}
+};
+
+inline EEPROMClass EEPROM;
+
+#endif /* HOST_EEPROM_H */
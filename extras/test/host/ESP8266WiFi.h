@@ -0,0 +1,157 @@
+//
+//  ESP8266WiFi.h
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+//  WiFi station stand-in for the host tests (extras/test). The test sets up the access points in range
+//  (WiFi.vAPs) and the time a connect takes. A connect to a given bssid and channel (fast connect) takes
+//  nDirectMs, a connect with scan nScanMs and uses the strongest access point of the ssid. A connect to a
+//  bssid, which is not in range (moved, other channel), or with a wrong password never succeeds, like the
+//  SDK retrying silently. drop() loses the connection, with auto reconnect the SDK connects again with scan.
+//  The state advances with millis(), see hostAdvance().
+//
+
+#ifndef HOST_ESP8266WIFI_H
+#define HOST_ESP8266WIFI_H
+
+#include "Arduino.h"
+#include "WiFiClient.h"
+
+enum wl_status_t {WL_IDLE_STATUS = 0, WL_NO_SSID_AVAIL = 1, WL_CONNECTED = 3, WL_CONNECT_FAILED = 4, WL_DISCONNECTED = 6};
+enum WiFiMode_t {WIFI_OFF = 0, WIFI_STA = 1, WIFI_AP = 2, WIFI_AP_STA = 3};
+
+#define WIFI_SCAN_RUNNING (-1)
+#define WIFI_SCAN_FAILED (-2)
+#define ENC_TYPE_NONE 7
+#define ENC_TYPE_CCMP 4
+
+class IPAddress {
+   uint32_t _nAddr = 0;
+public:
+   IPAddress() {}
+   IPAddress(uint32_t nAddr) : _nAddr(nAddr) {}
+   IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _nAddr(a | (b << 8) | (c << 16) | ((uint32_t)d << 24)) {}
+   operator uint32_t() const {return _nAddr;}
+   bool fromString(const char* sz) {
+      unsigned a, b, c, d;
+      if (sscanf(sz, "%u.%u.%u.%u", &a, &b, &c, &d) != 4) return false;
+      *this = IPAddress((uint8_t)a, (uint8_t)b, (uint8_t)c, (uint8_t)d);
+      return true;
+   }
+   String toString() const {
+      char sz[16];
+      snprintf(sz, sizeof(sz), "%u.%u.%u.%u", _nAddr & 0xFF, (_nAddr >> 8) & 0xFF, (_nAddr >> 16) & 0xFF, _nAddr >> 24);
+      return String(sz);
+   }
+};
+
+class HostWiFi {
+public:
+   struct AP {
+      String   strSSID;
+      String   strPassword;
+      uint8_t  bssid[6];
+      uint8_t  nChannel;
+      int8_t   nRSSI;
+   };
+
+   // ---- set up by the test
+   std::vector<AP> vAPs;                ///< access points in range
+   uint32_t nDirectMs = 300;            ///< connect to a given bssid and channel
+   uint32_t nScanMs = 2500;             ///< connect with scan
+
+   // ---- recorded for the test
+   uint32_t nBegins = 0;
+   uint32_t nScanBegins = 0;            ///< begin() without bssid
+   IPAddress ipStatic;                  ///< last config(), 0 for DHCP
+
+private:
+   int      _nAP = -1;                  ///< access point connecting to or connected, -1 none
+   uint32_t _nDue = 0;                  ///< time the connect completes
+   bool     _bConnected = false;
+   bool     _bAutoReconnect = false;
+   String   _strSSID;
+   String   _strPassword;
+   bool     _bScanning = false;
+
+   int _strongest(const String& strSSID) {
+      int nBest = -1;
+      for (size_t i = 0; i < vAPs.size(); i++) {
+         if (vAPs[i].strSSID == strSSID && (nBest < 0 || vAPs[i].nRSSI > vAPs[nBest].nRSSI)) nBest = (int)i;
+      }
+      return nBest;
+   }
+
+public:
+   void persistent(bool) {}
+   void mode(WiFiMode_t) {}
+   void hostname(const char*) {}
+   void setAutoReconnect(bool set) {_bAutoReconnect = set;}
+   bool config(IPAddress ip, IPAddress, IPAddress, IPAddress = IPAddress()) {ipStatic = ip; return true;}
+
+   void begin(const char* szSSID, const char* szPassword, int32_t nChannel = 0, const uint8_t* bssid = nullptr) {
+      nBegins++;
+      _strSSID = szSSID;
+      _strPassword = szPassword;
+      _bConnected = false;
+      _nAP = -1;
+      if (bssid) {
+         for (size_t i = 0; i < vAPs.size(); i++) {
+            if (vAPs[i].strSSID == _strSSID && vAPs[i].nChannel == nChannel && memcmp(vAPs[i].bssid, bssid, 6) == 0) _nAP = (int)i;
+         }
+         _nDue = (uint32_t)millis() + nDirectMs;
+      } else {
+         nScanBegins++;
+         _nAP = _strongest(_strSSID);
+         _nDue = (uint32_t)millis() + nScanMs;
+      }
+      if (_nAP >= 0 && vAPs[_nAP].strPassword != _strPassword) _nAP = -1;
+   }
+
+   void disconnect(bool = false) {
+      _bConnected = false;
+      _nAP = -1;
+   }
+
+   /// the connection gets lost (e.g. access point off), with auto reconnect the SDK connects again with scan
+   void drop() {
+      _bConnected = false;
+      _nAP = -1;
+      if (_bAutoReconnect) {
+         _nAP = _strongest(_strSSID);
+         if (_nAP >= 0 && vAPs[_nAP].strPassword != _strPassword) _nAP = -1;
+         _nDue = (uint32_t)millis() + nScanMs;
+      }
+   }
+
+   wl_status_t status() {
+      if (!_bConnected && _nAP >= 0 && (int32_t)((uint32_t)millis() - _nDue) >= 0) _bConnected = true;
+      return _bConnected ? WL_CONNECTED : WL_DISCONNECTED;
+   }
+
+   uint8_t* BSSID() {return (_bConnected && _nAP >= 0) ? vAPs[_nAP].bssid : nullptr;}
+   int32_t channel() {return (_bConnected && _nAP >= 0) ? vAPs[_nAP].nChannel : 0;}
+
+   // ---- scan, completes at the next scanComplete()
+   int8_t scanNetworks(bool bAsync = false) {
+      _bScanning = bAsync;
+      return bAsync ? WIFI_SCAN_RUNNING : (int8_t)vAPs.size();
+   }
+   int8_t scanComplete() {
+      if (!_bScanning) return WIFI_SCAN_FAILED;
+      _bScanning = false;
+      return (int8_t)vAPs.size();
+   }
+   void scanDelete() {}
+   String SSID(uint8_t i) {return vAPs[i].strSSID;}
+   int32_t RSSI(uint8_t i) {return vAPs[i].nRSSI;}
+   int32_t channel(uint8_t i) {return vAPs[i].nChannel;}
+   uint8_t* BSSID(uint8_t i) {return vAPs[i].bssid;}
+   uint8_t encryptionType(uint8_t i) {return vAPs[i].strPassword.length() ? ENC_TYPE_CCMP : ENC_TYPE_NONE;}
+};
+
+inline HostWiFi WiFi;
+
+#endif /* HOST_ESP8266WIFI_H */
@@ -0,0 +1,259 @@
+//
+//  FS.h
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+//  In-memory file system for the host tests (extras/test), with the File/FS interface of the ESP8266 core.
+//  A power loss can be simulated: after hostFs().nWriteBudget bytes (torn write) or hostFs().nOpBudget
+//  modifying operations (write, remove, rename, open for writing) further operations fail, until
+//  hostFs().reboot() is called. Files keep the bytes written before the power loss, like an append to a
+//  LittleFS file synced block-wise. With bNoReplace rename() fails, if the destination exists (as some file
+//  systems), which exercises the fallbacks of the callers. Directories are created by mkdir(), openDir()
+//  lists the files and directories in a directory as the ESP8266 core (Dir).
+//
+
+#ifndef HOST_FS_H
+#define HOST_FS_H
+
+#include "Arduino.h"
+#include <map>
+#include <set>
+
+struct HostFs {
+   std::map<std::string, std::string> mapFiles;
+   std::set<std::string> setDirs;
+   long nWriteBudget = -1;     ///< bytes, which can be written until the power loss (-1: no power loss)
+   long nOpBudget = -1;        ///< modifying operations until the power loss (-1: no power loss)
+   bool bPowerLost = false;
+   bool bNoReplace = false;    ///< rename() doesn't replace an existing file
+   uint32_t nWrites = 0;       ///< write calls
+   uint32_t nOpens = 0;
+
+   /// consumes an operation of the budget, false after the power loss
+   bool op() {
+      if (bPowerLost) return false;
+      if (nOpBudget < 0) return true;
+      if (nOpBudget == 0) {
+         bPowerLost = true;
+         return false;
+      }
+      nOpBudget--;
+      return true;
+   }
+
+   /// consumes the write budget, returns the bytes which can be written
+   size_t take(size_t n) {
+      if (!op()) return 0;
+      if (nWriteBudget < 0) return n;
+      if ((long)n > nWriteBudget) {
+         n = (size_t)nWriteBudget;
+         bPowerLost = true;
+      }
+      nWriteBudget -= (long)n;
+      return n;
+   }
+
+   void reboot() {
+      bPowerLost = false;
+      nWriteBudget = -1;
+      nOpBudget = -1;
+   }
+
+   void format() {
+      mapFiles.clear();
+      setDirs.clear();
+      bNoReplace = false;
+      reboot();
+   }
+};
+
+inline HostFs& hostFs() {
+   static HostFs fs;
+   return fs;
+}
+
+class File : public Stream {
+   struct Impl {
+      std::string strPath;
+      size_t nPos = 0;
+      bool bWrite = false;
+      bool bOpen = true;
+   };
+   std::shared_ptr<Impl> _p;
+
+   std::string* _data() const {
+      if (!_p || !_p->bOpen) return nullptr;
+      auto it = hostFs().mapFiles.find(_p->strPath);
+      return (it != hostFs().mapFiles.end()) ? &it->second : nullptr;
+   }
+
+public:
+   File() {}
+   File(const std::string& strPath, size_t nPos, bool bWrite) : _p(std::make_shared<Impl>()) {
+      _p->strPath = strPath;
+      _p->nPos = nPos;
+      _p->bWrite = bWrite;
+   }
+
+   operator bool() const {return _p && _p->bOpen;}
+   bool isDirectory() const {return _p && hostFs().setDirs.count(_p->strPath);}
+   const char* name() const {return _p ? _p->strPath.c_str() : "";}
+   size_t size() const {std::string* p = _data(); return p ? p->size() : 0;}
+   size_t position() const {return _p ? _p->nPos : 0;}
+   bool seek(uint32_t nPos) {
+      std::string* p = _data();
+      if (!p || nPos > p->size()) return false;
+      _p->nPos = nPos;
+      return true;
+   }
+   void close() {if (_p) _p->bOpen = false;}
+   time_t getLastWrite() {return 0;}
+   time_t getCreationTime() {return 0;}
+
+   virtual size_t write(uint8_t c) override {return write(&c, 1);}
+   virtual size_t write(const uint8_t* buffer, size_t size) override {
+      std::string* p = _data();
+      if (!p || !_p->bWrite) return 0;
+      hostFs().nWrites++;
+      size = hostFs().take(size);
+      if (_p->nPos > p->size()) p->resize(_p->nPos);
+      p->replace(_p->nPos, std::min(size, p->size() - _p->nPos), (const char*)buffer, size);
+      _p->nPos += size;
+      return size;
+   }
+   using Print::write;
+
+   virtual int available() override {std::string* p = _data(); return p ? (int)(p->size() - _p->nPos) : 0;}
+   virtual int read() override {
+      std::string* p = _data();
+      if (!p || _p->nPos >= p->size()) return -1;
+      return (uint8_t)(*p)[_p->nPos++];
+   }
+   size_t read(uint8_t* buffer, size_t size) {
+      std::string* p = _data();
+      if (!p || _p->nPos >= p->size()) return 0;
+      size = std::min(size, p->size() - _p->nPos);
+      memcpy(buffer, p->data() + _p->nPos, size);
+      _p->nPos += size;
+      return size;
+   }
+   virtual int peek() override {
+      std::string* p = _data();
+      return (p && _p->nPos < p->size()) ? (uint8_t)(*p)[_p->nPos] : -1;
+   }
+};
+
+struct FSInfo {
+   size_t totalBytes;
+   size_t usedBytes;
+   size_t blockSize;
+   size_t pageSize;
+   size_t maxOpenFiles;
+   size_t maxPathLength;
+};
+
+/// entries of a directory (ESP8266 core), read at openDir()
+class Dir {
+   struct Entry {
+      std::string strName;
+      bool bDir;
+   };
+   std::string _strPath;
+   std::vector<Entry> _vEntries;
+   size_t _i = 0;
+
+   const std::string* _data() const {
+      auto it = hostFs().mapFiles.find(_strPath + _vEntries[_i - 1].strName);
+      return (it != hostFs().mapFiles.end()) ? &it->second : nullptr;
+   }
+
+public:
+   Dir() {}
+   explicit Dir(const std::string& strDir) {
+      _strPath = strDir;
+      if (_strPath.empty() || _strPath.back() != '/') _strPath += '/';
+      std::set<std::string> setNames;
+      auto add = [&](const std::string& strPath, bool bDir) {
+         if (strPath.compare(0, _strPath.size(), _strPath) != 0 || strPath.size() == _strPath.size()) return;
+         std::string strName = strPath.substr(_strPath.size());
+         size_t nSlash = strName.find('/');
+         if (nSlash != std::string::npos) {
+            strName.resize(nSlash);  // beneath a sub directory
+            bDir = true;
+         }
+         if (setNames.insert(strName).second) _vEntries.push_back({strName, bDir});
+      };
+      for (const auto& dir : hostFs().setDirs) add(dir, true);
+      for (const auto& file : hostFs().mapFiles) add(file.first, false);
+   }
+
+   bool next() {return ++_i <= _vEntries.size();}
+   String fileName() const {return String(_vEntries[_i - 1].strName.c_str());}
+   bool isDirectory() const {return _vEntries[_i - 1].bDir;}
+   bool isFile() const {return !isDirectory();}
+   size_t fileSize() const {const std::string* p = _data(); return p ? p->size() : 0;}
+   time_t fileTime() const {return 0;}
+   time_t fileCreationTime() const {return 0;}
+};
+
+class FS {
+public:
+   bool begin() {return true;}
+   void end() {}
+
+   File open(const char* szPath, const char* szMode = "r") {
+      HostFs& fs = hostFs();
+      if (fs.bPowerLost) return File();
+      std::string strPath = szPath;
+      fs.nOpens++;
+      if (szMode[0] == 'r') {
+         if (fs.setDirs.count(strPath)) return File(strPath, 0, false);
+         if (!fs.mapFiles.count(strPath)) return File();
+         return File(strPath, 0, szMode[1] == '+');
+      }
+      if (!fs.op()) return File();
+      if (szMode[0] == 'w' || !fs.mapFiles.count(strPath)) fs.mapFiles[strPath].clear();
+      return File(strPath, szMode[0] == 'a' ? fs.mapFiles[strPath].size() : 0, true);
+   }
+   File open(const String& strPath, const char* szMode = "r") {return open(strPath.c_str(), szMode);}
+
+   bool exists(const char* szPath) {return hostFs().mapFiles.count(szPath) || hostFs().setDirs.count(szPath);}
+   bool exists(const String& strPath) {return exists(strPath.c_str());}
+
+   bool remove(const char* szPath) {
+      if (!hostFs().op()) return false;
+      return hostFs().mapFiles.erase(szPath) > 0;
+   }
+   bool remove(const String& strPath) {return remove(strPath.c_str());}
+
+   /// replaces an existing file atomically (LittleFS), unless bNoReplace
+   bool rename(const char* szFrom, const char* szTo) {
+      HostFs& fs = hostFs();
+      if (!fs.op()) return false;
+      auto it = fs.mapFiles.find(szFrom);
+      if (it == fs.mapFiles.end()) return false;
+      if (fs.bNoReplace && fs.mapFiles.count(szTo)) return false;
+      std::string strData = std::move(it->second);
+      fs.mapFiles.erase(it);
+      fs.mapFiles[szTo] = std::move(strData);
+      return true;
+   }
+   bool rename(const String& strFrom, const String& strTo) {return rename(strFrom.c_str(), strTo.c_str());}
+
+   Dir openDir(const char* szPath) {return Dir(szPath);}
+   Dir openDir(const String& strPath) {return Dir(strPath.c_str());}
+
+   bool mkdir(const char* szPath) {hostFs().setDirs.insert(szPath); return true;}
+   bool rmdir(const char* szPath) {return hostFs().setDirs.erase(szPath) > 0;}
+};
+
+inline FS& hostLittleFS() {
+   static FS fs;
+   return fs;
+}
+
+#define LittleFS hostLittleFS()
+
+#endif /* HOST_FS_H */
@@ -0,0 +1,64 @@
+//
+//  HostHeap.h
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+//  Heap of the host tests (extras/test): the global operator new/delete count the allocations and the bytes in
+//  use, the tests measure the peak of a section with hostHeap().resetPeak(). The heap size seen by the tools
+//  (g_Heap.available()) is HOST_HEAP_SIZE less the bytes in use. Included once per test (replaces operator new).
+//
+
+#ifndef HOST_HEAP_H
+#define HOST_HEAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#define HOST_HEAP_SIZE 40000
+
+// the counting operator new/delete pair is malloc/free, gcc doesn't see this across the inlined allocators
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+struct HostHeap {
+   size_t   nUsed = 0;      ///< bytes in use
+   size_t   nPeak = 0;      ///< max. bytes in use since resetPeak()
+   uint32_t nAllocs = 0;    ///< number of allocations
+
+   void resetPeak() {nPeak = nUsed;}
+   size_t available() const {return HOST_HEAP_SIZE > nUsed ? HOST_HEAP_SIZE - nUsed : 0;}
+};
+
+inline HostHeap& hostHeap() {
+   static HostHeap heap;
+   return heap;
+}
+
+// the size of a block is kept in front of it
+static constexpr size_t HOST_HEAP_HEADER = alignof(std::max_align_t);
+
+void* operator new(size_t n) {
+   char* p = (char*)malloc(n + HOST_HEAP_HEADER);
+   if (!p) throw std::bad_alloc();
+   *(size_t*)p = n;
+   HostHeap& heap = hostHeap();
+   heap.nUsed += n;
+   heap.nAllocs++;
+   if (heap.nUsed > heap.nPeak) heap.nPeak = heap.nUsed;
+   return p + HOST_HEAP_HEADER;
+}
+void* operator new[](size_t n) {return operator new(n);}
+void operator delete(void* p) noexcept {
+   if (!p) return;
+   char* pBlock = (char*)p - HOST_HEAP_HEADER;
+   hostHeap().nUsed -= *(size_t*)pBlock;
+   free(pBlock);
+}
+void operator delete[](void* p) noexcept {operator delete(p);}
+void operator delete(void* p, size_t) noexcept {operator delete(p);}
+void operator delete[](void* p, size_t) noexcept {operator delete(p);}
+
+#endif /* HOST_HEAP_H */
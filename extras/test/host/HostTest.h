@@ -0,0 +1,39 @@
+//
+//  HostTest.h
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+//  Common part of the host tests (extras/test): the CHECK macro counting the failed checks, the result of
+//  the test and the ESC attributes for the tools printing tables (plain, the host output is compared as
+//  text). A test defines its own attributes before including this header, if it needs them.
+//
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include "Arduino.h"
+
+#ifndef ESC_ATTR_BOLD
+#define ESC_ATTR_BOLD ""
+#endif
+#ifndef ESC_ATTR_RESET
+#define ESC_ATTR_RESET ""
+#endif
+
+/// number of failed checks of the test
+inline int& hostFailed() {
+   static int nFailed = 0;
+   return nFailed;
+}
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); hostFailed()++; } } while (0)
+
+/// prints the result, returns the exit code of the test
+inline int hostResult() {
+   printf("%s\n", hostFailed() ? "FAILED" : "OK");
+   return hostFailed() ? 1 : 0;
+}
+
+#endif /* HOST_TEST_H */
@@ -0,0 +1,2 @@
+// LittleFS.h - see FS.h (host tests)
+#include "FS.h"
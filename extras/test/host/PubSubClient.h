@@ -0,0 +1,109 @@
+//
+//  PubSubClient.h
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+//  PubSubClient stand-in for the host tests (extras/test): no network, connect() always succeeds. As the
+//  library the client allocates its buffer from the heap (setBufferSize) and a publish() fails, if the message
+//  does not fit the buffer. The messages are passed to hostMqtt().cbPublish, streamed messages (beginPublish,
+//  write, endPublish) are collected in the client buffer's stead in a string reserved up front.
+//
+
+#ifndef HOST_PUBSUBCLIENT_H
+#define HOST_PUBSUBCLIENT_H
+
+#include "Arduino.h"
+
+#define MQTT_MAX_PACKET_SIZE 256
+
+/// broker of the host tests
+struct HostMqtt {
+   bool     bConnected = true;      ///< connect() succeeds
+   uint32_t nMessages = 0;          ///< published messages
+   uint32_t nStreamed = 0;          ///< of these streamed
+   size_t   nBytes = 0;             ///< payload bytes published
+   std::string strStream;           ///< payload of the actual streamed message
+   /// called for every message (topic, payload, length, retained), optional
+   std::function<void(const char*, const char*, size_t, bool)> cbPublish;
+};
+
+inline HostMqtt& hostMqtt() {
+   static HostMqtt mqtt;
+   return mqtt;
+}
+
+class PubSubClient : public Print {
+   uint8_t* _pBuffer = nullptr;
+   uint16_t _nBufferSize = 0;
+   bool _bConnected = false;
+   std::string _strTopic;
+   bool _bRetained = false;
+
+public:
+   explicit PubSubClient(Client&) {setBufferSize(MQTT_MAX_PACKET_SIZE); _strTopic.reserve(256);}
+   ~PubSubClient() {delete[] _pBuffer;}
+
+   /// the library reallocates the buffer, here from the heap seen by the tests (operator new)
+   bool setBufferSize(uint16_t nSize) {
+      if (!nSize) return false;
+      if (nSize != _nBufferSize) {
+         delete[] _pBuffer;
+         _pBuffer = new uint8_t[nSize];
+         _nBufferSize = nSize;
+      }
+      return true;
+   }
+   uint16_t getBufferSize() {return _nBufferSize;}
+
+   PubSubClient& setServer(const char*, uint16_t) {return *this;}
+   PubSubClient& setCallback(std::function<void(const char*, uint8_t*, unsigned int)>) {return *this;}
+
+   bool connect(const char*) {_bConnected = hostMqtt().bConnected; return _bConnected;}
+   bool connect(const char* szId, const char*, const char*, const char*, uint8_t, bool, const char*) {return connect(szId);}
+   void disconnect() {_bConnected = false;}
+   bool connected() {return _bConnected && hostMqtt().bConnected;}
+   bool loop() {return connected();}
+   bool subscribe(const char*, uint8_t = 0) {return connected();}
+   bool unsubscribe(const char*) {return connected();}
+
+   bool publish(const char* szTopic, const char* szPayload, bool bRetained = false) {
+      size_t nLength = szPayload ? strlen(szPayload) : 0;
+      // fixed header, topic length field, topic and payload are built in the buffer
+      if (!connected() || 5 + 2 + strlen(szTopic) + nLength > _nBufferSize) return false;
+      memcpy(_pBuffer + 7, szPayload, nLength);
+      _deliver(szTopic, (const char*)_pBuffer + 7, nLength, bRetained, false);
+      return true;
+   }
+
+   bool beginPublish(const char* szTopic, unsigned int nLength, bool bRetained) {
+      if (!connected()) return false;
+      _strTopic = szTopic;
+      _bRetained = bRetained;
+      hostMqtt().strStream.clear();
+      return true;
+   }
+   size_t write(uint8_t c) override {return write(&c, 1);}
+   size_t write(const uint8_t* buffer, size_t size) override {
+      if (!connected()) return 0;
+      hostMqtt().strStream.append((const char*)buffer, size);
+      return size;
+   }
+   int endPublish() {
+      if (!connected()) return 0;
+      _deliver(_strTopic.c_str(), hostMqtt().strStream.data(), hostMqtt().strStream.size(), _bRetained, true);
+      return 1;
+   }
+
+private:
+   void _deliver(const char* szTopic, const char* pPayload, size_t nLength, bool bRetained, bool bStreamed) {
+      HostMqtt& mqtt = hostMqtt();
+      mqtt.nMessages++;
+      if (bStreamed) mqtt.nStreamed++;
+      mqtt.nBytes += nLength;
+      if (mqtt.cbPublish) mqtt.cbPublish(szTopic, pPayload, nLength, bRetained);
+   }
+};
+
+#endif /* HOST_PUBSUBCLIENT_H */
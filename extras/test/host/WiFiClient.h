@@ -0,0 +1,171 @@
+//
+//  WiFiClient.h
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+//  WiFiClient and WiFiServer on POSIX sockets for the host tests (extras/test). Reading never blocks, writing
+//  blocks until the data is in the socket buffer, like the ESP8266 core. availableForWrite() reports the free
+//  space of the socket send buffer.
+//
+
+#ifndef HOST_WIFICLIENT_H
+#define HOST_WIFICLIENT_H
+
+#include "Arduino.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/sockios.h>
+#endif
+
+class WiFiClient : public Client {
+   struct Sock {
+      int fd = -1;
+      bool bEof = false;
+      ~Sock() {if (fd >= 0) ::close(fd);}
+   };
+   std::shared_ptr<Sock> _p;
+
+   void _checkEof() {
+      if (!_p || _p->fd < 0 || _p->bEof) return;
+      char c;
+      ssize_t n = ::recv(_p->fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+      if (n == 0) _p->bEof = true;
+   }
+
+public:
+   WiFiClient() {}
+   explicit WiFiClient(int fd) : _p(std::make_shared<Sock>()) {_p->fd = fd;}
+
+   virtual int connect(const char* szHost, uint16_t nPort) override {
+      addrinfo hints = {};
+      hints.ai_family = AF_INET;
+      hints.ai_socktype = SOCK_STREAM;
+      addrinfo* pResult = nullptr;
+      char szPort[8];
+      snprintf(szPort, sizeof(szPort), "%u", nPort);
+      if (getaddrinfo(szHost, szPort, &hints, &pResult) != 0) return 0;
+      int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+      int nResult = ::connect(fd, pResult->ai_addr, pResult->ai_addrlen);
+      freeaddrinfo(pResult);
+      if (nResult != 0) {
+         ::close(fd);
+         return 0;
+      }
+      _p = std::make_shared<Sock>();
+      _p->fd = fd;
+      return 1;
+   }
+
+   virtual size_t write(uint8_t c) override {return write(&c, 1);}
+   virtual size_t write(const uint8_t* buffer, size_t size) override {
+      if (!_p || _p->fd < 0) return 0;
+      size_t nDone = 0;
+      while (nDone < size) {
+         ssize_t n = ::send(_p->fd, buffer + nDone, size - nDone, MSG_NOSIGNAL);
+         if (n <= 0) break;
+         nDone += (size_t)n;
+      }
+      return nDone;
+   }
+   using Print::write;
+
+   virtual int availableForWrite() override {
+#ifdef __linux__
+      if (!_p || _p->fd < 0) return 0;
+      int nBuf = 0, nQueued = 0;
+      socklen_t nLen = sizeof(nBuf);
+      getsockopt(_p->fd, SOL_SOCKET, SO_SNDBUF, &nBuf, &nLen);
+      ioctl(_p->fd, SIOCOUTQ, &nQueued);
+      return std::max(0, nBuf / 2 - nQueued); // the kernel doubles SO_SNDBUF for its bookkeeping
+#else
+      return 0;
+#endif
+   }
+
+   virtual int available() override {
+      if (!_p || _p->fd < 0) return 0;
+      int n = 0;
+      ioctl(_p->fd, FIONREAD, &n);
+      if (!n) _checkEof();
+      return n;
+   }
+   virtual int read() override {
+      uint8_t c;
+      return (read(&c, 1) == 1) ? c : -1;
+   }
+   virtual int read(uint8_t* buffer, size_t size) override {
+      if (!_p || _p->fd < 0) return -1;
+      ssize_t n = ::recv(_p->fd, buffer, size, MSG_DONTWAIT);
+      if (n == 0) _p->bEof = true;
+      return (n > 0) ? (int)n : -1;
+   }
+   virtual int peek() override {
+      if (!_p || _p->fd < 0) return -1;
+      uint8_t c;
+      return (::recv(_p->fd, &c, 1, MSG_PEEK | MSG_DONTWAIT) == 1) ? c : -1;
+   }
+   virtual uint8_t connected() override {
+      if (!_p || _p->fd < 0) return 0;
+      _checkEof();
+      return !_p->bEof;
+   }
+   virtual void stop() override {
+      if (_p && _p->fd >= 0) {
+         ::close(_p->fd);
+         _p->fd = -1;
+      }
+   }
+   virtual operator bool() override {return _p && _p->fd >= 0;}
+   void setNoDelay(bool set) {
+      int n = set;
+      if (_p && _p->fd >= 0) setsockopt(_p->fd, IPPROTO_TCP, TCP_NODELAY, &n, sizeof(n));
+   }
+   void abort() {stop();}
+};
+
+class WiFiServer {
+   int _fd = -1;
+   uint16_t _nPort;
+
+public:
+   explicit WiFiServer(uint16_t nPort) : _nPort(nPort) {}
+   ~WiFiServer() {stop();}
+
+   /// listens on localhost, port 0 binds an ephemeral port (see port())
+   void begin() {
+      _fd = ::socket(AF_INET, SOCK_STREAM, 0);
+      int n = 1;
+      setsockopt(_fd, SOL_SOCKET, SO_REUSEADDR, &n, sizeof(n));
+      sockaddr_in addr = {};
+      addr.sin_family = AF_INET;
+      addr.sin_port = htons(_nPort);
+      addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      ::bind(_fd, (sockaddr*)&addr, sizeof(addr));
+      ::listen(_fd, 4);
+      fcntl(_fd, F_SETFL, O_NONBLOCK);
+      socklen_t nLen = sizeof(addr);
+      getsockname(_fd, (sockaddr*)&addr, &nLen);
+      _nPort = ntohs(addr.sin_port);
+   }
+   WiFiClient available() {
+      int fd = (_fd >= 0) ? ::accept(_fd, nullptr, nullptr) : -1;
+      return (fd >= 0) ? WiFiClient(fd) : WiFiClient();
+   }
+   void stop() {
+      if (_fd >= 0) ::close(_fd);
+      _fd = -1;
+   }
+   uint16_t port() const {return _nPort;}
+};
+
+#endif /* HOST_WIFICLIENT_H */
@@ -0,0 +1,55 @@
+#!/bin/bash
+# run.sh - Builds and runs the host tests of the header-only tools.
+#
+# Usage:
+#   ./extras/test/run.sh [NAME...]
+#
+# Description:
+#   - Every extras/test/test_<name>.cpp is compiled with the host Arduino core in extras/test/host
+#     (String, Print, Stream, in-memory LittleFS, WiFiClient on sockets, stand-ins of ArduinoJson,
+#     PubSubClient and the console for the managers) and the common CHECK macro (host/HostTest.h) and
+#     run. Without arguments all tests are run, otherwise the named ones (e.g. xfer).
+#   - The tests print their measurements (throughput, stalls, allocations). These are host numbers,
+#     they show the behavior (blocking, buffering), not the speed on the device.
+#   - The binaries are built in extras/test/build (not committed).
+#
+# Requirements:
+#   - Bash shell, g++ (C++17), python3 (tests using the host tools in extras/tools)
+#
+# Example:
+#   make test
+
+set -e
+
+TEST_DIR="$(cd "$(dirname "$0")" && pwd)"
+ROOT_DIR="$(cd "$TEST_DIR/../.." && pwd)"
+BUILD_DIR="$TEST_DIR/build"
+CXXFLAGS="-std=c++17 -g -O1 -Wall -Wno-unused-function -Wno-reorder -I$TEST_DIR/host -I$ROOT_DIR/tools -I$ROOT_DIR/src"
+
+mkdir -p "$BUILD_DIR"
+
+if [[ $# -gt 0 ]]; then
+  tests=""
+  for name in "$@"; do tests="$tests $TEST_DIR/test_$name.cpp"; done
+else
+  tests=$(ls "$TEST_DIR"/test_*.cpp)
+fi
+
+failed=0
+for src in $tests; do
+  name=$(basename "$src" .cpp)
+  echo "=== $name"
+  if ! g++ $CXXFLAGS "$src" -o "$BUILD_DIR/$name" -lpthread; then
+    failed=$((failed + 1))
+    continue
+  fi
+  if ! "$BUILD_DIR/$name"; then
+    failed=$((failed + 1))
+  fi
+done
+
+if [[ $failed -gt 0 ]]; then
+  echo "$failed test(s) failed"
+  exit 1
+fi
+echo "all tests passed"
@@ -0,0 +1,251 @@
+//
+//  test_api.cpp
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+//  Host test of the HTTP/JSON command API (CxCapabilityApi) over localhost connections: requests on a kept
+//  alive connection, pipelined requests in one write, a request arriving in parts, the chunked response of a
+//  large output and the connection closed for 'Connection: close', HTTP/1.0 and a too large request. The
+//  commands are run by the console stand-in (cbProcessCmd).
+//
+
+#include "CxESPConsole.hpp"
+#include "HostTest.h"
+#include "WiFiClient.h"
+#include "../../capabilities/CxCapabilityApi.hpp"
+
+// CxCapability.cpp is not built for the host
+size_t CxCapability::write(uint8_t c) {return getIoStream().write(c);}
+size_t CxCapability::write(const uint8_t* buffer, size_t size) {return getIoStream().write(buffer, size);}
+
+static constexpr uint16_t nPORT = 18081;
+static CxESPConsoleMaster& console = CxESPConsoleMaster::getInstance();
+
+/// response of the api, the chunked body decoded
+struct Response {
+   int nCode = 0;
+   std::string strHeader;
+   std::string strBody;
+   uint32_t nChunks = 0;
+};
+
+/// connection of the test to the api
+struct Conn {
+   WiFiClient client;
+   std::string strIn;   ///< received, not yet parsed
+
+   bool connect() {return client.connect("127.0.0.1", nPORT);}
+   void send(const std::string& str) {client.write((const uint8_t*)str.data(), str.size());}
+};
+
+/// parses a complete response at the begin of str and removes it, false if incomplete
+static bool parseResponse(std::string& str, Response& r) {
+   size_t nHeaderEnd = str.find("\r\n\r\n");
+   if (nHeaderEnd == std::string::npos) return false;
+   r = Response();
+   r.strHeader = str.substr(0, nHeaderEnd);
+   r.nCode = atoi(r.strHeader.c_str() + 9);
+   size_t nPos = nHeaderEnd + 4;
+   if (r.strHeader.find("Transfer-Encoding: chunked") != std::string::npos) {
+      while (true) {
+         size_t nLineEnd = str.find("\r\n", nPos);
+         if (nLineEnd == std::string::npos) return false;
+         size_t nSize = strtoul(str.c_str() + nPos, nullptr, 16);
+         nPos = nLineEnd + 2;
+         if (str.size() < nPos + nSize + 2) return false;
+         r.strBody.append(str, nPos, nSize);
+         nPos += nSize + 2;
+         if (!nSize) break;
+         r.nChunks++;
+      }
+   } else {
+      size_t nCl = r.strHeader.find("Content-Length: ");
+      size_t nLength = (nCl != std::string::npos) ? strtoul(r.strHeader.c_str() + nCl + 16, nullptr, 10) : 0;
+      if (str.size() < nPos + nLength) return false;
+      r.strBody = str.substr(nPos, nLength);
+      nPos += nLength;
+   }
+   str.erase(0, nPos);
+   return true;
+}
+
+/// steps the api until the next response is received, false on timeout
+static bool readResponse(CxCapabilityApi& api, Conn& conn, Response& r) {
+   uint32_t nStart = (uint32_t)millis();
+   while (!parseResponse(conn.strIn, r)) {
+      if ((uint32_t)millis() - nStart > 2000) return false;
+      api.loop();
+      char buf[256];
+      int n = conn.client.read((uint8_t*)buf, sizeof(buf));
+      if (n > 0) conn.strIn.append(buf, n);
+   }
+   return true;
+}
+
+/// steps the api, true if it closes the connection within a second
+static bool isClosed(CxCapabilityApi& api, Conn& conn) {
+   uint32_t nStart = (uint32_t)millis();
+   while ((uint32_t)millis() - nStart < 1000) {
+      api.loop();
+      char buf[256];
+      int n = conn.client.read((uint8_t*)buf, sizeof(buf));
+      if (n > 0) conn.strIn.append(buf, n);
+      if (n <= 0 && !conn.client.connected()) return true;
+   }
+   return false;
+}
+
+static bool contains(const std::string& str, const char* sz) {return str.find(sz) != std::string::npos;}
+
+/// commands of the test: echo <text>, big <lines>, fail, out <value>
+static uint8_t processCmd(Stream& stream, const char* szCmd) {
+   CxStrToken tkArgs(szCmd, " ");
+   String strCmd = TKTOCHAR(tkArgs, 0);
+   if (strCmd == "echo") {
+      stream.print(TKTOCHARAFTER(tkArgs, 1));
+   } else if (strCmd == "big") {
+      int32_t nLines = TKTOINT(tkArgs, 1, 0);
+      for (int32_t i = 0; i < nLines; i++) stream.printf(ESC_ATTR_BOLD "line %04d \"quoted\"" ESC_ATTR_RESET "\n", (int)i);
+   } else if (strCmd == "out") {
+      console.setOutputVariable(TKTOCHAR(tkArgs, 1));
+   } else {
+      return EXIT_FAILURE;
+   }
+   return EXIT_SUCCESS;
+}
+
+static void testKeepAlive(CxCapabilityApi& api) {
+   printf("keep-alive\n");
+   Conn conn;
+   CHECK(conn.connect());
+   Response r;
+
+   console.setOutputVariable("saved");
+   conn.send("GET /cmd?c=echo%20hi&c=out+42 HTTP/1.1\r\nHost: esp\r\n\r\n");
+   CHECK(readResponse(api, conn, r));
+   CHECK(r.nCode == 200);
+   CHECK(contains(r.strHeader, "Connection: keep-alive"));
+   CHECK(contains(r.strBody, "{\"results\":[{\"cmd\":\"echo hi\",\"output\":\"hi\",\"exit\":0,\"out\":null,\"ms\":"));
+   CHECK(contains(r.strBody, "{\"cmd\":\"out 42\",\"output\":\"\",\"exit\":0,\"out\":\"42\",\"ms\":"));
+   CHECK(r.strBody.substr(r.strBody.size() - 3) == "}]}");
+   CHECK(strcmp(console.getVariable(">"), "saved") == 0);
+
+   // the next requests on the same connection
+   conn.send("POST /cmd HTTP/1.1\r\nContent-Length: 9\r\n\r\nfail\necho");
+   CHECK(readResponse(api, conn, r));
+   CHECK(r.nCode == 200);
+   CHECK(contains(r.strBody, "{\"cmd\":\"fail\",\"output\":\"\",\"exit\":1,"));
+   CHECK(contains(r.strBody, "{\"cmd\":\"echo\",\"output\":\"\",\"exit\":0,"));
+   CHECK(!isClosed(api, conn));
+
+   conn.send("GET /cmd?c=echo%20last HTTP/1.1\r\nConnection: close\r\n\r\n");
+   CHECK(readResponse(api, conn, r));
+   CHECK(r.nCode == 200);
+   CHECK(contains(r.strHeader, "Connection: close"));
+   CHECK(isClosed(api, conn));
+}
+
+static void testPipelined(CxCapabilityApi& api) {
+   printf("pipelined\n");
+   Conn conn;
+   CHECK(conn.connect());
+   Response r;
+
+   // three requests in one write, answered in order
+   conn.send("GET /cmd?c=echo%20one HTTP/1.1\r\n\r\n"
+             "POST /cmd HTTP/1.1\r\nContent-Length: 8\r\n\r\necho two"
+             "GET /other HTTP/1.1\r\n\r\n");
+   CHECK(readResponse(api, conn, r));
+   CHECK(r.nCode == 200 && contains(r.strBody, "\"output\":\"one\""));
+   CHECK(readResponse(api, conn, r));
+   CHECK(r.nCode == 200 && contains(r.strBody, "\"output\":\"two\""));
+   CHECK(readResponse(api, conn, r));
+   CHECK(r.nCode == 404 && r.strBody == "{\"error\":\"not found\"}");
+
+   // a request in parts is answered, when the body is complete
+   conn.send("POST /cmd HTTP/1.1\r\nContent-");
+   CHECK(!readResponse(api, conn, r));
+   conn.send("Length: 10\r\n\r\necho ");
+   CHECK(!readResponse(api, conn, r));
+   conn.send("three");
+   CHECK(readResponse(api, conn, r));
+   CHECK(r.nCode == 200 && contains(r.strBody, "\"output\":\"three\""));
+   CHECK(!isClosed(api, conn));
+   conn.client.stop();
+}
+
+static void testChunked(CxCapabilityApi& api) {
+   printf("chunked\n");
+   static const int nLINES = 200;
+   Conn conn;
+   CHECK(conn.connect());
+   Response r;
+
+   // the heap of the api, the response is received into reserved memory and parsed afterwards
+   std::string strRequest = "GET /cmd?c=big%20200 HTTP/1.1\r\n\r\n";
+   conn.strIn.reserve(16384);
+   uint32_t nHeap = (uint32_t)hostHeap().nUsed;
+   hostHeap().resetPeak();
+   conn.send(strRequest);
+   uint32_t nStart = (uint32_t)millis();
+   while (conn.strIn.size() < 5 || conn.strIn.compare(conn.strIn.size() - 5, 5, "0\r\n\r\n") != 0) {
+      if ((uint32_t)millis() - nStart > 2000) break;
+      api.loop();
+      char buf[256];
+      int n = conn.client.read((uint8_t*)buf, sizeof(buf));
+      if (n > 0) conn.strIn.append(buf, n);
+   }
+   uint32_t nPeak = (uint32_t)(hostHeap().nPeak - nHeap);
+   CHECK(parseResponse(conn.strIn, r));
+   CHECK(r.nCode == 200);
+
+   // the output without escape sequences, the quotes and line ends escaped
+   std::string strOutput;
+   char szLine[64];
+   for (int i = 0; i < nLINES; i++) {
+      snprintf(szLine, sizeof(szLine), "line %04d \\\"quoted\\\"\\n", i);
+      strOutput += szLine;
+   }
+   CHECK(contains(r.strBody, ("\"output\":\"" + strOutput + "\",\"exit\":0,").c_str()));
+   CHECK(!contains(r.strBody, "\x1b"));
+   CHECK(r.nChunks > 1);
+   printf("  %d lines: %zu bytes in %u chunks, peak heap %u bytes\n", nLINES, r.strBody.size(), r.nChunks, nPeak);
+   CHECK(nPeak < 1024); // the output is streamed, not buffered
+   conn.client.stop();
+}
+
+static void testClose(CxCapabilityApi& api) {
+   printf("close\n");
+   Response r;
+
+   Conn conn;
+   CHECK(conn.connect());
+   conn.send("GET /cmd?c=echo%20old HTTP/1.0\r\n\r\n");
+   CHECK(readResponse(api, conn, r));
+   CHECK(r.nCode == 200 && contains(r.strHeader, "Connection: close"));
+   CHECK(isClosed(api, conn));
+
+   Conn conn2;
+   CHECK(conn2.connect());
+   conn2.send("POST /cmd HTTP/1.1\r\nContent-Length: 5000\r\n\r\necho");
+   CHECK(readResponse(api, conn2, r));
+   CHECK(r.nCode == 413 && r.strBody == "{\"error\":\"request too large\"}");
+   CHECK(isClosed(api, conn2));
+}
+
+int main() {
+   setvbuf(stdout, nullptr, _IOLBF, 0);
+   console.setLog(false);
+   console.cbProcessCmd = processCmd;
+
+   CxCapabilityApi api;
+   CHECK(api.begin(nPORT));
+   testKeepAlive(api);
+   testPipelined(api);
+   testChunked(api);
+   testClose(api);
+   api.end();
+   return hostResult();
+}
@@ -0,0 +1,116 @@
+//
+//  test_escfilter.cpp
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+//  Host test of CxEscFilterStream and CxEscFilterStream::strip() with the output of a typical session:
+//  colored log lines, a table with bold header, prompt redraws and a progress bar redrawn in place. The
+//  output must not contain ESC sequences or a carriage return without line feed, the result must not
+//  depend on how the output is split into writes. The report shows the bytes removed for a plain peer.
+//
+
+#include "HostTest.h"
+#include "CxEscFilter.hpp"
+
+/// collects the output
+class OutStream : public Stream {
+public:
+   std::string str;
+   size_t write(uint8_t c) override {str += (char)c; return 1;}
+   size_t write(const uint8_t* buffer, size_t size) override {str.append((const char*)buffer, size); return size;}
+   int available() override {return 0;}
+   int read() override {return -1;}
+   int peek() override {return -1;}
+};
+
+/// output of a session as the console writes it to a terminal
+static std::string session() {
+   std::string str;
+   const char* szPrompt = "\033[2K\033[1m\ruser@esp-living:/> \033[0m";
+   for (int i = 0; i < 20; i++) {
+      str += szPrompt;
+      str += "\033[2K\r\033[1m\033[32m12:00:";
+      str += std::to_string(10 + i);
+      str += " [I] \033[0mMQTT: published sensor/temperature 21.5\r\n";
+   }
+   str += "\033[1m------+--------------------\r\n Id   | Name               \r\n------+--------------------\r\n\033[0m";
+   for (int i = 0; i < 10; i++) str += " " + std::to_string(i) + "    \033[1m | \033[0mrelay " + std::to_string(i) + "            \r\n";
+   for (int i = 0; i <= 100; i += 5) {
+      str += "\r\033[1m[" + std::string(i / 5, '#') + std::string(20 - i / 5, ' ') + "]\033[0m " + std::to_string(i) + "%";
+   }
+   str += "\r\n";
+   str += szPrompt;
+   return str;
+}
+
+/// no ESC, a carriage return only before a line feed
+static bool isPlain(const std::string& str) {
+   for (size_t i = 0; i < str.size(); i++) {
+      if (str[i] == 0x1B) return false;
+      if (str[i] == '\r' && (i + 1 >= str.size() || str[i + 1] != '\n')) return false;
+   }
+   return true;
+}
+
+static std::string filter(const std::string& strIn, size_t nChunk, uint32_t* pDropped = nullptr) {
+   OutStream out;
+   CxEscFilterStream esc(&out);
+   esc.setEnabled(true);
+   for (size_t i = 0; i < strIn.size(); i += nChunk) {
+      size_t n = std::min(nChunk, strIn.size() - i);
+      if (n == 1) {
+         esc.write((uint8_t)strIn[i]);
+      } else {
+         esc.write((const uint8_t*)strIn.data() + i, n);
+      }
+   }
+   if (pDropped) *pDropped = esc.getDropped();
+   return out.str;
+}
+
+static void testSession() {
+   std::string strIn = session();
+   uint32_t nDropped = 0;
+   std::string strOut = filter(strIn, strIn.size(), &nDropped);
+   CHECK(isPlain(strOut));
+   CHECK(strOut.size() + nDropped == strIn.size());
+   CHECK(strOut.find("12:00:10 [I] MQTT: published sensor/temperature 21.5\r\n") != std::string::npos);
+   CHECK(strOut.find("[####################] 100%\r\n") != std::string::npos);
+
+   // the same output, split at every position (sequences across writes)
+   for (size_t nChunk : {1, 2, 3, 7, 64}) CHECK(filter(strIn, nChunk) == strOut);
+
+   // disabled, the output of a terminal passes unchanged
+   OutStream out;
+   CxEscFilterStream esc(&out);
+   esc.write((const uint8_t*)strIn.data(), strIn.size());
+   CHECK(out.str == strIn);
+
+   printf("session output %u bytes, plain %u bytes, %u bytes (%.1f%%) removed\n",
+          (unsigned int)strIn.size(), (unsigned int)strOut.size(), nDropped, 100.0 * nDropped / strIn.size());
+}
+
+static void testStrip() {
+   const char* szLog = "\033[1m\033[32m12:00:10 [I] \033[0mWIFI: connected\r";
+   char buf[64];
+   CxEscFilterStream::strip(buf, szLog);
+   CHECK(strcmp(buf, "12:00:10 [I] WIFI: connected") == 0);
+
+   char sz[64];
+   strcpy(sz, szLog);
+   CxEscFilterStream::strip(sz);
+   CHECK(strcmp(sz, buf) == 0);
+   printf("log line %u bytes, stripped %u bytes\n", (unsigned int)strlen(szLog), (unsigned int)strlen(buf));
+
+   CxEscFilterStream::strip(buf, "\033[1");  // cut sequence at the end
+   CHECK(buf[0] == '\0');
+}
+
+int main() {
+   setvbuf(stdout, nullptr, _IOLBF, 0);
+   testSession();
+   testStrip();
+   return hostResult();
+}
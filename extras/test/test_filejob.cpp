@@ -0,0 +1,106 @@
+//
+//  test_filejob.cpp
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+//  Host test of CxFileJob on the in-memory file system: a directory tree is copied and removed recursively,
+//  block by block with step() as in the loop of the console. The report compares the file system calls of
+//  the block sized buffer with the 64 byte buffer used before. A copy into the source itself is rejected.
+//
+
+#include "HostTest.h"
+#include "LittleFS.h"
+#include "CxFileJob.hpp"
+
+#include <random>
+
+static std::string makeData(size_t nSize, uint32_t nSeed) {
+   std::mt19937 rng(nSeed);
+   std::string str(nSize, '\0');
+   for (auto& c : str) c = (char)rng();
+   return str;
+}
+
+static void createTree() {
+   hostFs().format();
+   LittleFS.mkdir("/www");
+   LittleFS.mkdir("/www/img");
+   hostFs().mapFiles["/www/index.html"] = makeData(5000, 1);
+   hostFs().mapFiles["/www/empty.txt"] = "";
+   hostFs().mapFiles["/www/img/logo.png"] = makeData(12345, 2);
+   hostFs().mapFiles["/other.txt"] = "other";
+}
+
+static void testCopy(size_t nBufSize, uint32_t& nWrites) {
+   createTree();
+   uint32_t nSteps = 0;
+   nWrites = hostFs().nWrites;
+   CxFileJob job(CxFileJob::e_op::copy, "/www", "/bak", nBufSize);
+   CHECK(job.getTotal() == 5000 + 12345);
+   while (job.step()) nSteps++;
+   nWrites = hostFs().nWrites - nWrites;
+   CHECK(job.isDone());
+   CHECK(!job.isError());
+   CHECK(job.getFiles() == 3);
+   CHECK(job.getBytes() == 5000 + 12345);
+   CHECK(hostFs().setDirs.count("/bak") && hostFs().setDirs.count("/bak/img"));
+   CHECK(hostFs().mapFiles["/bak/index.html"] == hostFs().mapFiles["/www/index.html"]);
+   CHECK(hostFs().mapFiles["/bak/img/logo.png"] == hostFs().mapFiles["/www/img/logo.png"]);
+   CHECK(hostFs().mapFiles.count("/bak/empty.txt") && hostFs().mapFiles["/bak/empty.txt"].empty());
+   CHECK(!hostFs().mapFiles.count("/bak/other.txt"));
+   // a step copies one block at most, the loop isn't blocked by a whole file
+   CHECK(nSteps >= (5000 + 12345) / nBufSize);
+}
+
+static void testRemove() {
+   printf("remove\n");
+   createTree();
+   CxFileJob job(CxFileJob::e_op::remove, "/www", nullptr, 0);
+   CHECK(job.run());
+   CHECK(job.getFiles() == 3);
+   CHECK(job.getBytes() == 5000 + 12345);
+   CHECK(hostFs().mapFiles.size() == 1 && hostFs().mapFiles.count("/other.txt"));
+   CHECK(hostFs().setDirs.empty());
+
+   CxFileJob missing(CxFileJob::e_op::remove, "/missing", nullptr, 0);
+   CHECK(!missing.run());
+}
+
+static void testWithin() {
+   printf("copy into itself\n");
+   CHECK(CxFileJob::isWithin("/www/bak", "/www"));
+   CHECK(CxFileJob::isWithin("/www", "/www/"));
+   CHECK(CxFileJob::isWithin("/any", "/"));
+   CHECK(!CxFileJob::isWithin("/www2", "/www"));
+   createTree();
+   CxFileJob job(CxFileJob::e_op::copy, "/www", "/www/bak", 256);
+   CHECK(job.isDone() && job.isError());
+   CHECK(!hostFs().setDirs.count("/www/bak"));
+}
+
+static void testCancel() {
+   printf("cancel\n");
+   createTree();
+   CxFileJob job(CxFileJob::e_op::copy, "/www/img/logo.png", "/logo.png", 256);
+   for (int i = 0; i < 5; i++) job.step();
+   job.cancel();
+   CHECK(job.isDone() && job.isError());
+   CHECK(!job.step());
+   CHECK(job.getBytes() < 12345);
+}
+
+int main() {
+   setvbuf(stdout, nullptr, _IOLBF, 0);
+   printf("copy\n");
+   uint32_t nWrites64 = 0, nWritesBlock = 0;
+   testCopy(64, nWrites64);
+   testCopy(4096, nWritesBlock);
+   printf("  %u bytes in 3 files: %u writes with 64 bytes, %u with 4096 bytes\n", 5000 + 12345, nWrites64, nWritesBlock);
+   CHECK(nWritesBlock < nWrites64);
+   testRemove();
+   testWithin();
+   testCancel();
+   return hostResult();
+}
@@ -0,0 +1,119 @@
+//
+//  test_framed.cpp
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+//  Host test of CxFramedSession over a localhost connection: binary output (NUL bytes) is sent with its
+//  exact length, ESC sequences are removed, and the load generator extras/tools/espframes.py pipelines
+//  requests with large outputs. The session is stepped like in the loop of the console, the report shows
+//  the output and the time of the longest loop pass.
+//
+
+#include "HostTest.h"
+#include "WiFiClient.h"
+#include "CxFramedSession.hpp"
+
+#include <chrono>
+#include <thread>
+
+static std::string toolPath() {
+   std::string str = __FILE__;
+   return str.substr(0, str.rfind("/test/")) + "/tools/espframes.py";
+}
+
+/// commands of the test: "out <n>" prints n bytes, "bin" prints binary output with a color attribute
+static uint32_t execute(Stream& out, const char* szCmd) {
+   if (strncmp(szCmd, "out ", 4) == 0) {
+      int n = atoi(szCmd + 4);
+      std::string str(n, 'x');
+      for (int i = 63; i < n; i += 64) str[i] = '\n';
+      out.write((const uint8_t*)str.data(), str.size());
+      return 0;
+   }
+   if (strcmp(szCmd, "bin") == 0) {
+      out.write((const uint8_t*)"\x1b[1ma\0b\x1b[0m", 11);
+      return 0;
+   }
+   return 1;
+}
+
+/// accepts the connection and the magic line, as the console does
+static WiFiClient accept(WiFiServer& server) {
+   WiFiClient conn;
+   auto tStart = std::chrono::steady_clock::now();
+   while (!(conn = server.available())) {
+      if (std::chrono::steady_clock::now() - tStart > std::chrono::seconds(10)) return conn;
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+   }
+   std::string strLine;
+   while (conn.connected()) {
+      int c = conn.read();
+      if (c == '\n') break;
+      if (c >= 0) strLine += (char)c;
+   }
+   CHECK(strLine == CxFramedSession::szMAGIC);
+   return conn;
+}
+
+static void testBinary(WiFiServer& server) {
+   std::thread peer([&server]() {
+      WiFiClient client;
+      client.connect("127.0.0.1", server.port());
+      client.print("#!frames\n");
+      client.print("7 bin\n");
+      std::string str;
+      auto tStart = std::chrono::steady_clock::now();
+      while (str.size() < 22 && std::chrono::steady_clock::now() - tStart < std::chrono::seconds(5)) {
+         int c = client.read();
+         if (c >= 0) str += (char)c;
+      }
+      CHECK(str == std::string("#!frames ok\r\n7 0 3\na\0b", 22));
+      client.stop();
+   });
+   WiFiClient conn = accept(server);
+   CxFramedSession session(execute);
+   session.begin(conn);
+   while (session.loop()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+   peer.join();
+   CHECK(session.getCommands() == 1);
+}
+
+static void testLoad(WiFiServer& server) {
+   const int nCount = 400;
+   std::string strCmd = "python3 " + toolPath() + " -p " + std::to_string(server.port()) + " -n " + std::to_string(nCount) + " -w 32 127.0.0.1 'out 4000' 'out 10' 'out 9000'";
+   bool bOk = false;
+   std::thread peer([strCmd, &bOk]() {bOk = system(strCmd.c_str()) == 0;});
+
+   WiFiClient conn = accept(server);
+   CxFramedSession session(execute);
+   session.begin(conn);
+   uint32_t nMaxPass = 0;
+   uint32_t nPasses = 0;
+   while (true) {
+      auto t0 = std::chrono::steady_clock::now();
+      bool bRunning = session.loop();
+      uint32_t nPass = (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0).count();
+      nMaxPass = std::max(nMaxPass, nPass);
+      nPasses++;
+      if (!bRunning) break;
+   }
+   peer.join();
+
+   CHECK(bOk);
+   CHECK(session.getCommands() == (uint32_t)nCount);
+   // the output of a loop pass is bounded: below the limit before the last command, plus its output
+   CHECK(session.getMaxLoopBytes() < CxFramedSession::_nMAX_LOOP_OUTPUT + CxFramedSession::_nMAX_OUTPUT + 48);
+   printf("  device: %u commands, %u bytes sent in %u loop passes, max. per pass %u bytes, %u commands, %u us\n",
+          session.getCommands(), session.getBytes(), nPasses, session.getMaxLoopBytes(), session.getMaxLoopCommands(), nMaxPass);
+}
+
+int main() {
+   setvbuf(stdout, nullptr, _IOLBF, 0);
+   WiFiServer server(0);
+   server.begin();
+   testBinary(server);
+   testLoad(server);
+   return hostResult();
+}
@@ -0,0 +1,114 @@
+//
+//  test_fsindex.cpp
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+//  Host test of CxFsIndex on the in-memory file system: the index is built once on the first query and
+//  answers the following ones (hits), it is kept coherent by update() and remove() of the writers and built
+//  again after it expired. The path helpers (normalize, join, matchGlob) are checked on their own.
+//
+
+#include "HostTest.h"
+#include "LittleFS.h"
+#include "CxFsIndex.hpp"
+
+static void writeFile(const char* szPath, size_t nSize) {
+   File file = LittleFS.open(szPath, "w");
+   std::string str(nSize, 'x');
+   file.write((const uint8_t*)str.data(), str.size());
+   file.close();
+}
+
+static void testPaths() {
+   printf("paths\n");
+   CHECK(CxFsIndex::normalize("a/b/") == "/a/b");
+   CHECK(CxFsIndex::normalize("/") == "/");
+   CHECK(CxFsIndex::normalize(nullptr) == "/");
+   CHECK(CxFsIndex::join("/a", "b.txt") == "/a/b.txt");
+   CHECK(CxFsIndex::join("/", "b.txt") == "/b.txt");
+   CHECK(CxFsIndex::join("/a", "/a/b.txt") == "/a/b.txt");  // some cores deliver the full path as name
+   CHECK(CxFsIndex::matchGlob("*.bat", "init.bat"));
+   CHECK(CxFsIndex::matchGlob("l?g.*", "log.0"));
+   CHECK(CxFsIndex::matchGlob("*", ""));
+   CHECK(!CxFsIndex::matchGlob("*.bat", "init.man"));
+   CHECK(!CxFsIndex::matchGlob("log.?", "log.10"));
+}
+
+static void testIndex() {
+   printf("index\n");
+   hostFs().format();
+   LittleFS.mkdir("/batch");
+   writeFile("/batch/init.bat", 120);
+   writeFile("/batch/rdy.bat", 80);
+   writeFile("/settings.json", 40);
+
+   CxFsIndex index;
+   uint32_t nOpens = hostFs().nOpens;
+   const CxFsIndex::Entry* pEntry = index.find("/batch/init.bat");
+   CHECK(pEntry && pEntry->nSize == 120 && !pEntry->bDir);
+   CHECK(index.exists("/batch") && index.find("/batch")->bDir);
+   CHECK(index.exists("/"));
+   CHECK(!index.exists("/missing"));
+   CHECK(index.size() == 4);
+   CHECK(index.getBuilds() == 1);
+
+   // the queries are answered from the index, the file system is not read again
+   nOpens = hostFs().nOpens;
+   for (int i = 0; i < 100; i++) CHECK(index.exists("/batch/rdy.bat"));
+   CHECK(hostFs().nOpens == nOpens);
+   CHECK(index.getBuilds() == 1);
+   CHECK(index.getHits() >= 100);
+
+   // a writer reports its change, the entry is updated (parents included)
+   writeFile("/log/log.0", 300);
+   index.update("/log/log.0");
+   pEntry = index.find("log/log.0");
+   CHECK(pEntry && pEntry->nSize == 300);
+   CHECK(index.exists("/log") && index.find("/log")->bDir);
+   writeFile("/batch/init.bat", 10);
+   index.update("/batch/init.bat");
+   CHECK(index.find("/batch/init.bat")->nSize == 10);
+
+   // a removed path is dropped with its sub entries
+   index.remove("/batch");
+   CHECK(!index.exists("/batch"));
+   CHECK(!index.exists("/batch/rdy.bat"));
+   CHECK(index.exists("/settings.json"));
+   LittleFS.remove("/settings.json");
+   index.update("/settings.json");  // update of a path, which doesn't exist anymore
+   CHECK(!index.exists("/settings.json"));
+   CHECK(index.getBuilds() == 1);
+
+   // changes done otherwise are picked up after the index expired
+   index.setMaxAge(1000);
+   writeFile("/other.txt", 5);
+   CHECK(!index.exists("/other.txt"));
+   hostAdvance(1000);
+   CHECK(index.exists("/other.txt"));
+   CHECK(index.exists("/batch/rdy.bat"));  // the remove was not done on the file system
+   CHECK(index.getBuilds() == 2);
+
+   // the fs info is kept until it expires or a path changes
+   FSInfo info = {1 << 20, 4096, 4096, 256, 5, 32};
+   FSInfo infoRead = {};
+   index.setInfo(info);
+   CHECK(index.getInfo(infoRead) && infoRead.usedBytes == 4096);
+   index.update("/other.txt");
+   CHECK(!index.getInfo(infoRead));
+   index.setInfo(info);
+   hostAdvance(1000);
+   CHECK(!index.hasInfo());
+
+   index.invalidate();
+   CHECK(index.exists("/other.txt"));
+   CHECK(index.getBuilds() == 3);
+}
+
+int main() {
+   setvbuf(stdout, nullptr, _IOLBF, 0);
+   testPaths();
+   testIndex();
+   return hostResult();
+}
@@ -0,0 +1,243 @@
+//
+//  test_kvstore.cpp
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+//  Host test of CxKvStore: values survive a restart, keys with the same hash are kept apart, and a power
+//  loss at any byte of an append or at any step of a compaction (also with the fallback for file systems,
+//  which can't replace a file by rename) never loses a value written before. The settings of the console
+//  (CxPersistentBase) are kept as keys <group>.<name>, the settings file of older versions (all values as
+//  strings) is imported and read back with the typed getters.
+//
+
+#include "HostTest.h"
+#include "LittleFS.h"
+#include "CxKvStore.hpp"
+
+#include <unordered_map>
+
+static CxKvStore& kv = CxKvStore::getInstance();
+
+/// restart after a power loss: the state in RAM is lost, the file system keeps what was written
+static void restart() {
+   hostFs().reboot();
+   kv.end();
+   kv.begin();
+}
+
+/// two keys with the same hash (FNV-1a, 32 bit), found by the birthday paradox
+static std::pair<std::string, std::string> findCollision() {
+   std::unordered_map<uint32_t, std::string> map;
+   char sz[16];
+   for (uint32_t i = 0;; i++) {
+      snprintf(sz, sizeof(sz), "k%u", i);
+      uint32_t nId = CxHash::of(sz);
+      auto it = map.find(nId);
+      if (it != map.end()) return {it->second, sz};
+      map[nId] = sz;
+   }
+}
+
+static void testBasic() {
+   hostFs().format();
+   kv.begin();
+   CHECK(kv.setInt("a", 1));
+   CHECK(kv.setStr("b", "hello"));
+   CHECK(kv.setBool("c", true));
+   CHECK(kv.setFloat("d", 1.5f));
+   uint32_t nWrites = kv.getWrites();
+   CHECK(kv.setInt("a", 1)); // unchanged, not written
+   CHECK(kv.getWrites() == nWrites);
+   CHECK(kv.remove("c"));
+   restart();
+   CHECK(kv.getInt("a", 0) == 1);
+   CHECK(kv.getStr("b", "") == "hello");
+   CHECK(!kv.exists("c"));
+   CHECK(kv.getFloat("d", 0) == 1.5f);
+   CHECK(kv.getKeys() == 3);
+}
+
+static void testCollision() {
+   auto keys = findCollision();
+   printf("  keys with the same hash: %s, %s (%08x)\n", keys.first.c_str(), keys.second.c_str(), CxHash::of(keys.first.c_str()));
+   hostFs().format();
+   kv.begin();
+   CHECK(kv.setInt(keys.first.c_str(), 1));
+   CHECK(kv.setInt(keys.second.c_str(), 2));
+   CHECK(kv.getInt(keys.first.c_str(), 0) == 1);
+   CHECK(kv.getInt(keys.second.c_str(), 0) == 2);
+   CHECK(kv.setInt(keys.first.c_str(), 3));
+   restart();
+   CHECK(kv.getKeys() == 2);
+   CHECK(kv.getInt(keys.first.c_str(), 0) == 3);
+   CHECK(kv.getInt(keys.second.c_str(), 0) == 2);
+   CHECK(kv.remove(keys.second.c_str()));
+   CHECK(kv.getInt(keys.first.c_str(), 0) == 3);
+   CHECK(!kv.exists(keys.second.c_str()));
+   CHECK(kv.compact());
+   CHECK(kv.getInt(keys.first.c_str(), 0) == 3);
+}
+
+/// power loss at every byte of an append, the old value or the new one is read after the restart
+static void testTornAppend() {
+   uint32_t nCases = 0;
+   for (long nBudget = 0; nBudget < 64; nBudget++) {
+      hostFs().format();
+      kv.begin();
+      kv.setStr("name", "old value");
+      kv.setInt("other", 42);
+      hostFs().nWriteBudget = nBudget;
+      bool bWritten = kv.setStr("name", "new value");
+      restart();
+      String str = kv.getStr("name", "");
+      CHECK(str == (bWritten ? "new value" : "old value"));
+      CHECK(kv.getInt("other", 0) == 42);
+      // the next write continues after the valid records
+      CHECK(kv.setInt("next", nBudget));
+      restart();
+      CHECK(kv.getInt("next", -1) == nBudget);
+      CHECK(!kv.isTorn());
+      nCases++;
+   }
+   printf("  torn appends: %u cases\n", nCases);
+}
+
+/// power loss at every operation of a compaction, no live value is lost
+static void testTornCompaction(bool bNoReplace) {
+   uint32_t nCases = 0, nCompleted = 0;
+   for (long nOps = 0;; nOps++) {
+      hostFs().format();
+      hostFs().bNoReplace = bNoReplace;
+      kv.begin();
+      for (int i = 0; i < 10; i++) {
+         char szKey[8];
+         snprintf(szKey, sizeof(szKey), "key%d", i);
+         kv.setInt(szKey, i);
+         kv.setInt(szKey, i * 10); // garbage
+      }
+      hostFs().nOpBudget = nOps;
+      bool bResult = kv.compact();
+      restart();
+      for (int i = 0; i < 10; i++) {
+         char szKey[8];
+         snprintf(szKey, sizeof(szKey), "key%d", i);
+         CHECK(kv.getInt(szKey, -1) == i * 10);
+      }
+      CHECK(!hostFs().mapFiles.count("/.kv.tmp"));
+      CHECK(!hostFs().mapFiles.count("/.kv.bak"));
+      nCases++;
+      if (bResult) {
+         nCompleted++;
+         break;
+      }
+   }
+   printf("  torn compactions%s: %u cases\n", bNoReplace ? " (rename without replace)" : "", nCases);
+}
+
+static void testSettings() {
+   hostFs().format();
+   kv.begin();
+   CxPersistentBase settings;
+   kv.setImplementation(settings);
+   CHECK(settings.saveSettingInt("ot", 500, "", "relay1"));
+   CHECK(settings.saveSettingStr("name", "pump", "", "relay1"));
+   CHECK(settings.saveSettingInt("top", 7));
+   restart();
+   CHECK(settings.loadSettingInt("ot", 0, "relay1") == 500);
+   CHECK(settings.loadSettingStr("name", "", "relay1") == "pump");
+   CHECK(settings.loadSettingInt("top", 0) == 7);
+   CHECK(kv.getInt("relay1.ot", 0) == 500);
+   CHECK(settings.loadSettingInt("ot", 42, "relay2") == 42);
+
+   // a key longer than the store's keys is rejected, not truncated
+   std::string strGroup(30, 'g');
+   CHECK(!settings.saveSettingInt("ot", 1, "", strGroup.c_str()));
+   CHECK(settings.loadSettingInt("ot", 3, strGroup.c_str()) == 3);
+   CHECK(kv.getKeys() == 3);
+}
+
+/// value of the settings file as parsed by ArduinoJson, older versions wrote strings only
+struct FileValue {
+   std::string str;
+   template <class T> bool is() const {return std::is_same<T, const char*>::value;}
+   template <class T> T as() const {
+      if constexpr (std::is_same<T, const char*>::value) return str.c_str(); else return T();
+   }
+};
+
+/// calls the callback for each "name":"value" of a settings file of older versions ({"group":{"name":"value"},...})
+template <class F> static void forEachSetting(const std::string& strJson, F cb) {
+   std::string strGroup, strName, str;
+   bool bName = true;
+   for (size_t i = 0; i < strJson.size(); i++) {
+      char c = strJson[i];
+      if (c == '"') {
+         size_t nEnd = strJson.find('"', i + 1);
+         str = strJson.substr(i + 1, nEnd - i - 1);
+         i = nEnd;
+         if (bName) strName = str; else cb(strGroup.c_str(), strName.c_str(), FileValue{str});
+      } else if (c == ':') {
+         bName = false;
+      } else if (c == ',') {
+         bName = true;
+      } else if (c == '{') {
+         if (!bName) strGroup = strName;
+         bName = true;
+      } else if (c == '}') {
+         strGroup.clear();
+      }
+   }
+}
+
+static void testImport() {
+   hostFs().format();
+   kv.begin();
+   CxPersistentBase settings;
+   kv.setImplementation(settings);
+   CHECK(kv.setInt("relay1.ot", 100));  // keys in the store are kept
+   // as written by saveSettingInt/Float/Bool/Str of older versions
+   const std::string strFile = R"({"relay1":{"ot":"60000","df":"true","name":"pump"},"sensor":{"ofs":"-0.500000","en":"false"},"pin":"007"})";
+   uint32_t nImported = 0;
+   forEachSetting(strFile, [&](const char* szGroup, const char* szName, const FileValue& var) {
+      if (kv.importSetting(szGroup, szName, var)) nImported++;
+   });
+   CHECK(nImported == 6);
+   restart();
+   CHECK(settings.loadSettingInt("ot", 0, "relay1") == 100);
+   CHECK(kv.getBool("relay1.df", false));
+   CHECK(settings.loadSettingStr("name", "", "relay1") == "pump");
+   CHECK(kv.getFloat("sensor.ofs", 0) == -0.5f);
+   CHECK(!kv.getBool("sensor.en", true));
+   CHECK(settings.loadSettingStr("pin", "") == "007");
+   CHECK(settings.loadSettingInt("pin", 0) == 7);
+
+   kv.remove("relay1.ot");
+   forEachSetting(strFile, [&](const char* szGroup, const char* szName, const FileValue& var) {kv.importSetting(szGroup, szName, var);});
+   CHECK(settings.loadSettingInt("ot", 0, "relay1") == 60000);
+   CHECK(kv.getType("relay1.ot") == CxKvStore::typeStr);
+
+   // a string, which is no number, reads 0 (as toInt() of older versions)
+   CHECK(kv.getInt("relay1.name", 5) == 0);
+   CHECK(!kv.getBool("relay1.name", true));
+   CHECK(!kv.importSetting("", std::string(40, 'k').c_str(), FileValue{"1"}));
+}
+
+int main() {
+   setvbuf(stdout, nullptr, _IOLBF, 0);
+   printf("basic\n");
+   testBasic();
+   printf("hash collision\n");
+   testCollision();
+   printf("torn append\n");
+   testTornAppend();
+   printf("torn compaction\n");
+   testTornCompaction(false);
+   testTornCompaction(true);
+   printf("settings\n");
+   testSettings();
+   printf("import\n");
+   testImport();
+   return hostResult();
+}
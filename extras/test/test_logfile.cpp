@@ -0,0 +1,139 @@
+//
+//  test_logfile.cpp
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+//  Host test of CxLogFile on the in-memory file system: info lines are collected in RAM and written in whole
+//  pages, a warning or the flush period writes them at once. The report compares the flash writes with a
+//  write per line (as before). The files rotate at the max. size, tail() prints the last lines of the file
+//  and the RAM, the writers' hook reports every changed file.
+//
+
+#include "LittleFS.h"
+#include "CxLogFile.hpp"
+#include "HostTest.h"
+
+#include <set>
+
+static std::string line(uint32_t n, char cLevel = 'I') {
+   char sz[64];
+   snprintf(sz, sizeof(sz), "%08u [%c] log line %u of the test", n, cLevel, n);
+   return sz;
+}
+
+static size_t countLines(const std::string& str) {
+   return std::count(str.begin(), str.end(), '\n');
+}
+
+static void testBatching() {
+   printf("batching\n");
+   hostFs().format();
+   CxLogFile log;
+   std::set<std::string> setChanged;
+   log.setFuncChanged([&](const char* sz) {setChanged.insert(sz);});
+   log.setMaxSize(1 << 20);
+   CHECK(log.begin());
+
+   static const uint32_t N = 200;
+   size_t nBytes = 0;
+   for (uint32_t i = 0; i < N; i++) {
+      log.add(line(i).c_str());
+      nBytes += line(i).size() + 1;
+   }
+   // only whole pages are written, the rest waits in RAM
+   const std::string& strFile = hostFs().mapFiles["/log.0"];
+   CHECK(strFile.size() % 256 == 0);
+   CHECK(strFile.size() + log.getPending() == nBytes);
+   CHECK(log.getWrites() == nBytes / 256);
+   printf("  %u info lines, %u bytes: %u flash writes, a write per line would be %u\n", N, (uint32_t)nBytes, log.getWrites(), N);
+   CHECK(log.getWrites() < N / 5);
+   CHECK(setChanged.count("/log.0"));
+
+   // a warning is written at once with the lines before
+   log.add(line(N, 'W').c_str());
+   CHECK(log.getPending() == 0);
+   CHECK(countLines(strFile) == N + 1);
+
+   // the flush period writes the rest
+   log.setFlushPeriod(1000);
+   log.add(line(N + 1).c_str());
+   log.loop();
+   CHECK(log.getPending() > 0);
+   hostAdvance(1000);
+   log.loop();
+   CHECK(log.getPending() == 0);
+   CHECK(countLines(strFile) == N + 2);
+   log.end();
+   CHECK(!log.isEnabled());
+}
+
+static void testRotation() {
+   printf("rotation\n");
+   hostFs().format();
+   CxLogFile log;
+   log.setPath("/log/sys");
+   log.setMaxSize(1024);
+   log.setCount(3);
+   std::set<std::string> setChanged;
+   log.setFuncChanged([&](const char* sz) {setChanged.insert(sz);});
+   CHECK(log.begin());
+   for (uint32_t i = 0; i < 200; i++) log.add(line(i, 'E').c_str());
+   CHECK(hostFs().mapFiles.count("/log/sys.0"));
+   CHECK(hostFs().mapFiles.count("/log/sys.1"));
+   CHECK(hostFs().mapFiles.count("/log/sys.2"));
+   CHECK(!hostFs().mapFiles.count("/log/sys.3"));
+   CHECK(hostFs().mapFiles["/log/sys.1"].size() >= 1024);
+   CHECK(hostFs().mapFiles["/log/sys.0"].size() < 1024);
+   CHECK(setChanged.count("/log/sys.2"));
+   // the newest line is the last one of the current file
+   const std::string& strFile = hostFs().mapFiles["/log/sys.0"];
+   CHECK(strFile.size() >= line(199).size() && strFile.rfind(line(199, 'E') + "\n") == strFile.size() - line(199).size() - 1);
+
+   // begin() continues the current file
+   CxLogFile log2;
+   log2.setPath("/log/sys");
+   CHECK(log2.begin());
+   CHECK(log2.getFileSize() == strFile.size());
+}
+
+/// collects the output of tail()
+class OutStream : public Print {
+public:
+   std::string str;
+   size_t write(uint8_t c) override {str += (char)c; return 1;}
+   size_t write(const uint8_t* buffer, size_t size) override {str.append((const char*)buffer, size); return size;}
+};
+
+static void testTail() {
+   printf("tail\n");
+   hostFs().format();
+   CxLogFile log;
+   log.setMaxSize(1 << 20);
+   CHECK(log.begin());
+   for (uint32_t i = 0; i < 100; i++) log.add(line(i).c_str());
+   CHECK(log.getPending() > 0);  // the last lines are in RAM only
+
+   OutStream out;
+   log.tail(out, 10);
+   CHECK(countLines(out.str) == 10);
+   CHECK(out.str.rfind(line(90), 0) == 0);
+   CHECK(out.str.find(line(99)) != std::string::npos);
+
+   out.str.clear();
+   log.tail(out, 2);  // from the RAM only
+   CHECK(out.str == line(98) + "\n" + line(99) + "\n");
+
+   out.str.clear();
+   log.tail(out, 1000);  // more than available
+   CHECK(countLines(out.str) == 100);
+}
+
+int main() {
+   setvbuf(stdout, nullptr, _IOLBF, 0);
+   testBatching();
+   testRotation();
+   testTail();
+   return hostResult();
+}
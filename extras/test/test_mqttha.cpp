@@ -0,0 +1,445 @@
+//
+//  test_mqttha.cpp
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+//  Host test of the HA discovery of CxMqttHADevice with the ArduinoJson and PubSubClient stand-ins (host/): the
+//  heap used to publish the discovery configs is measured by the counting operator new (HostHeap.h) for the
+//  streamed publishing and for the former way (pretty JSON in a String, published from a 1024 byte client
+//  buffer). The report shows the permanent client buffer and the peak per config.
+//  The states are published from the templates at a rate and with allocations compared to a JSON document per
+//  state, the aggregated device state in messages and allocations compared to a state topic per entity. Long topic
+//  bases are published in full or rejected, never truncated. Unchanged discovery configs are skipped by their
+//  hash, also with the hashes restored from /.hahash. ha list stays parseable in the json and kv formats.
+//
+
+#include "CxESPConsole.hpp"
+#include "HostTest.h"
+#include "CxSensorManager.hpp"
+
+/// GPIO device stand-in, the test creates the entities by name
+class CxGPIODevice {
+public:
+   const char* getFriendlyName() {return "";}
+   const char* getName() {return "";}
+};
+
+// the device deletes its items as base class, the test deletes them before
+#pragma GCC diagnostic ignored "-Wdelete-non-virtual-dtor"
+
+#include "CxMqttHAManager.hpp"
+#include "CxBufferStream.hpp"
+#include "LittleFS.h"
+
+#include <chrono>
+#include <set>
+
+uint32_t getChipId() {return 0x12ab34;}
+
+static CxMqttManager& mqtt = CxMqttManager::getInstance();
+static CxMqttHADevice& dev = CxMqttHADevice::getInstance();
+
+/// entities of a typical node
+static std::vector<CxMqttHABase*> createItems() {
+   static const std::vector<String> vOptions = {"off", "slow", "fast"};
+   return {
+      new CxMqttHASensor("Temperature", "temperature", "temperature", "°C"),
+      new CxMqttHASensor("Humidity", "humidity", "humidity", "%"),
+      new CxMqttHASensor("Pressure", "pressure", "pressure", "hPa"),
+      new CxMqttHASwitch("Relay", "relay", true),
+      new CxMqttHANumber("Brightness", "brightness", nullptr, true, nullptr, 0, 255, 1, "%"),
+      new CxMqttHAText("Message", "message", 64, true),
+      new CxMqttHASelect("Mode", "mode", true, nullptr, &vOptions),
+      new CxMqttHADiagnostic("Uptime", "uptime", "duration", "s"),
+      new CxMqttHADiagnostic("Heap", "heap", nullptr, "bytes"),
+      new CxMqttHABinarySensor("Motion", "motion", "motion"),
+   };
+}
+
+static void setupDevice() {
+   mqtt.begin("broker.local", "esp-living");
+   dev.setFriendlyName("esp-living");
+   dev.setName(dev.getFriendlyName());
+   dev.setModel("ESPConsole");
+   dev.setTopicBase("ha");
+   dev.setManufacturer("ocfu");
+   dev.setSwVersion("1.0.0");
+   dev.setHwVersion("ESP8266");
+   dev.setUrl("http://esp-living.local");
+   dev.setStrId();
+}
+
+/// heap of the former discovery: pretty JSON in a String, published from the client buffer (1024 bytes)
+static size_t discoveryFormer(const std::vector<CxMqttHABase*>& vItems, size_t& nBytes) {
+   size_t nPeak = 0;
+   nBytes = 0;
+   for (auto item : vItems) {
+      size_t nBase = hostHeap().nUsed;
+      hostHeap().resetPeak();
+      {
+         String strPayload;
+         strPayload.reserve(1024);
+         DynamicJsonDocument doc(1024);
+         item->getConfigPayload(doc);
+         serializeJsonPretty(doc, strPayload);
+         CHECK(mqtt.publish(item->getTopicHADiscovery(), strPayload.c_str(), true));
+         nBytes += strPayload.length();
+      }
+      nPeak = std::max(nPeak, hostHeap().nPeak - nBase);
+   }
+   return nPeak;
+}
+
+/// heap of the streamed discovery (regItems, loopDiscovery)
+static size_t discoveryStreamed(size_t& nBytes) {
+   dev.regItems(true, true);
+   size_t nBase = hostHeap().nUsed;
+   size_t nPeak = 0;
+   while (dev.isDiscoveryPending()) {
+      hostHeap().resetPeak();
+      dev.loopDiscovery();
+      nPeak = std::max(nPeak, hostHeap().nPeak - nBase);
+      nBase = hostHeap().nUsed;
+   }
+   nBytes = dev.getDiscoveryBytes();
+   return nPeak;
+}
+
+static void testDiscoveryHeap() {
+   printf("discovery heap\n");
+   std::vector<CxMqttHABase*> vItems = createItems();
+   setupDevice();
+   hostMqtt().strStream.reserve(2048);
+
+   // former: the client buffer had to fit the largest payload
+   mqtt.setBufferSize(256);
+   size_t nHeap = hostHeap().nUsed;
+   mqtt.setBufferSize(1024);
+   size_t nBufferStreamed = 256;
+   size_t nBufferFormer = nBufferStreamed + hostHeap().nUsed - nHeap;
+   CHECK(nBufferFormer == 1024);
+   mqtt.setBufferSize(256);
+
+   // the topics are prepared by regItems()
+   size_t nBytesStreamed = 0;
+   uint32_t nStreamed = hostMqtt().nStreamed;
+   size_t nPeakStreamed = discoveryStreamed(nBytesStreamed);
+   CHECK(hostMqtt().nStreamed - nStreamed >= vItems.size());
+   CHECK(dev.getDiscoverySkipped() == 0);
+
+   mqtt.setBufferSize(1024);
+   size_t nBytesFormer = 0;
+   nStreamed = hostMqtt().nStreamed;
+   size_t nPeakFormer = discoveryFormer(vItems, nBytesFormer);
+   CHECK(hostMqtt().nStreamed == nStreamed); // all fit the buffer
+   mqtt.setBufferSize(256);
+
+   printf("  %zu configs         former   streamed\n", vItems.size());
+   printf("  client buffer    %6zu     %6zu bytes (permanent)\n", nBufferFormer, nBufferStreamed);
+   printf("  peak per config  %6zu     %6zu bytes\n", nPeakFormer, nPeakStreamed);
+   printf("  total            %6zu     %6zu bytes\n", nBufferFormer + nPeakFormer, nBufferStreamed + nPeakStreamed);
+   printf("  payload          %6zu     %6zu bytes (pretty/compact)\n", nBytesFormer, nBytesStreamed);
+   CHECK(nPeakStreamed < nPeakFormer);
+   CHECK(nBytesStreamed < nBytesFormer);
+
+   for (auto item : vItems) delete item;
+}
+
+/// the former state publishing: a JSON document, the payload and the topics in Strings
+static void publishStateFormer(CxMqttHABase* item, double fValue) {
+   DynamicJsonDocument doc(256);
+   doc["value"] = roundToPrecision(fValue, 2);
+   doc["state"] = item->getState() ? "ON" : "OFF";
+   String strPayload;
+   serializeJson(doc, strPayload);
+   String strTopic = item->getTopicBase();
+   strTopic += "/state";
+   String strResolved = "/";
+   strResolved += mqtt.getRootPath();
+   strResolved += '/';
+   strResolved += strTopic;
+   mqtt.publish(strResolved.c_str(), strPayload.c_str(), item->isRetained());
+}
+
+static void testStateRate() {
+   printf("state rate\n");
+   static const uint32_t N = 200000;
+   std::vector<CxMqttHABase*> vItems = createItems();
+   setupDevice();
+   dev.regItems(true, true);
+   while (dev.loopDiscovery()) {}
+   CxMqttHABase* item = vItems[0];
+
+   // the first state makes the entity available, the availability is not of interest here
+   std::string strTopic, strPayload;
+   hostMqtt().cbPublish = [&](const char* szTopic, const char* p, size_t n, bool) {
+      if (strncmp(p, "online", n)) {strTopic = szTopic; strPayload.assign(p, n);}
+   };
+   item->publishState(21.5);
+   CHECK(strTopic == "esp-living/ha/temperature/state");
+   CHECK(strPayload == "{\"value\":21.50,\"state\":\"OFF\"}");
+   item->publishState("a \"quoted\" text");
+   CHECK(strPayload == "{\"value\":\"a \\\"quoted\\\" text\",\"state\":\"OFF\"}");
+   hostMqtt().cbPublish = nullptr;
+
+   auto measure = [&](std::function<void(uint32_t)> fn, uint32_t& nAllocs) {
+      uint32_t nMessages = hostMqtt().nMessages;
+      nAllocs = hostHeap().nAllocs;
+      auto tStart = std::chrono::steady_clock::now();
+      for (uint32_t i = 0; i < N; i++) fn(i);
+      double fSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+      nAllocs = hostHeap().nAllocs - nAllocs;
+      CHECK(hostMqtt().nMessages - nMessages == N);
+      return N / fSec;
+   };
+   uint32_t nAllocsTemplate = 0, nAllocsFormer = 0;
+   double fTemplate = measure([item](uint32_t i) {item->publishState(20.0 + (i % 100) * 0.1);}, nAllocsTemplate);
+   double fFormer = measure([item](uint32_t i) {publishStateFormer(item, 20.0 + (i % 100) * 0.1);}, nAllocsFormer);
+
+   printf("  %u states        template   document\n", N);
+   printf("  states/s       %10.0f %10.0f\n", fTemplate, fFormer);
+   printf("  allocs/state   %10.2f %10.2f\n", (double)nAllocsTemplate / N, (double)nAllocsFormer / N);
+   CHECK(nAllocsTemplate == 0);
+   // the rates depend on the host, they are reported only
+
+   for (auto item : vItems) delete item;
+}
+
+static void testLongTopic() {
+   printf("long topic\n");
+   CxMqttHASensor* item = new CxMqttHASensor("Long", "long");
+   setupDevice();
+   std::string strTopic;
+   hostMqtt().cbPublish = [&](const char* szTopic, const char* p, size_t n, bool) {
+      if (strncmp(p, "online", n)) strTopic = szTopic;
+   };
+
+   // the longest topic base of an entity (125 chars) with the longest sub topic
+   std::string strBase(125, 'b');
+   item->setTopicBase(strBase.c_str());
+   item->publishAttributes("key", "value");
+   CHECK(strTopic == "esp-living/" + strBase + "/attributes");
+
+   // a longer one is rejected, not published to a truncated topic
+   uint32_t nErrors = CxESPConsoleMaster::getInstance().nErrors;
+   uint32_t nMessages = hostMqtt().nMessages;
+   strBase.append(20, 'x');
+   item->setTopicBase(strBase.c_str());
+   item->publishAttributes("key", "value");
+   item->publishState(1.0);
+   CHECK(hostMqtt().nMessages == nMessages);
+   CHECK(CxESPConsoleMaster::getInstance().nErrors == nErrors + 2);
+
+   hostMqtt().cbPublish = nullptr;
+   delete item;
+}
+
+/// aggregated device state: the merged payload, the templates of the configs, the bound of the buffer and the
+/// messages and allocations compared to a state topic per entity
+static void testStateAggregation() {
+   printf("state aggregation\n");
+   static const uint32_t N = 20000;
+   std::vector<CxMqttHABase*> vItems = createItems();
+   setupDevice();
+   dev.setStateAggregation(true, 100);
+
+   // the configs pick the values from the device state, other entities keep theirs
+   std::map<std::string, std::string> mapConfigs;
+   hostMqtt().cbPublish = [&](const char* szTopic, const char* p, size_t n, bool) {
+      mapConfigs[szTopic].assign(p, n);
+   };
+   dev.regItems(true, true);
+   while (dev.loopDiscovery()) {}
+   const std::string& strConfig = mapConfigs[vItems[0]->getTopicHADiscovery() + 1];
+   CHECK(strConfig.find("\"stat_t\":\"esp-living/ha/state\"") != std::string::npos);
+   CHECK(strConfig.find("{{value_json['temperature'].value if 'temperature' in value_json else this.state}}") != std::string::npos);
+
+   // the states within the window are merged into one message in the device state topic
+   std::vector<std::string> vStates;
+   uint32_t nOther = 0;
+   hostMqtt().cbPublish = [&](const char* szTopic, const char* p, size_t n, bool) {
+      if (strcmp(szTopic, "esp-living/ha/state") == 0) vStates.emplace_back(p, n);
+      else if (strncmp(p, "online", n)) nOther++;
+   };
+   vItems[0]->publishState(21.5);
+   vItems[1]->publishState(40.0);
+   CHECK(vStates.empty());
+   dev.flushState();
+   CHECK(vStates.size() == 1);
+   CHECK(vStates.back() == "{\"temperature\":{\"value\":21.50,\"state\":\"OFF\"},\"humidity\":{\"value\":40.00,\"state\":\"OFF\"}}");
+
+   // a second state of the same entity publishes the first one
+   vItems[0]->publishState(21.5);
+   vItems[0]->publishState(22.0);
+   CHECK(vStates.size() == 2);
+   dev.flushState();
+   CHECK(vStates.size() == 3);
+   CHECK(vStates.back() == "{\"temperature\":{\"value\":22.00,\"state\":\"OFF\"}}");
+
+   // long states fill the buffer, it is published before it overflows, no state is lost
+   vStates.clear();
+   std::string strLong(200, 'x');
+   for (uint32_t i = 0; i < 5; i++) {
+      vItems[5]->publishState(strLong.c_str());
+      vItems[0]->publishState(20.0 + i);
+   }
+   dev.flushState();
+   uint32_t nMerged = 0;
+   for (const auto& str : vStates) {
+      CHECK(str.size() < 512);
+      CHECK(str.front() == '{' && str.back() == '}');
+      for (size_t nPos = 0; (nPos = str.find("\"message\":", nPos)) != std::string::npos; nPos++) nMerged++;
+   }
+   CHECK(nMerged == 5);
+   CHECK(vStates.size() > 1);
+   CHECK(nOther == 0);
+   hostMqtt().cbPublish = nullptr;
+
+   // messages and allocations of a round of states of all entities, aggregated and per entity
+   auto measure = [&](bool bAggregate, uint32_t& nAllocs, size_t& nBytes) {
+      dev.setStateAggregation(bAggregate);
+      dev.regItems(true, true);
+      while (dev.loopDiscovery()) {}
+      // the state messages only, the first states also make the entities available
+      uint32_t nMessages = 0;
+      nBytes = 0;
+      hostMqtt().cbPublish = [&nMessages, &nBytes](const char* szTopic, const char*, size_t n, bool) {
+         size_t nLen = strlen(szTopic);
+         if (nLen > 6 && strcmp(szTopic + nLen - 6, "/state") == 0) {nMessages++; nBytes += n;}
+      };
+      nAllocs = hostHeap().nAllocs;
+      for (uint32_t i = 0; i < N; i++) {
+         for (auto item : vItems) item->publishState(20.0 + (i % 100) * 0.1);
+         dev.flushState();  // end of the window
+      }
+      nAllocs = hostHeap().nAllocs - nAllocs;
+      hostMqtt().cbPublish = nullptr;
+      return nMessages;
+   };
+   uint32_t nAllocsAggregated = 0, nAllocsEntity = 0;
+   size_t nBytesAggregated = 0, nBytesEntity = 0;
+   uint32_t nAggregated = measure(true, nAllocsAggregated, nBytesAggregated);
+   uint32_t nEntity = measure(false, nAllocsEntity, nBytesEntity);
+
+   printf("  %u rounds of %zu states   aggregated  per entity\n", N, vItems.size());
+   printf("  messages/round        %10.2f  %10.2f\n", (double)nAggregated / N, (double)nEntity / N);
+   printf("  payload bytes/round   %10.2f  %10.2f\n", (double)nBytesAggregated / N, (double)nBytesEntity / N);
+   printf("  allocs/state          %10.2f  %10.2f\n", (double)nAllocsAggregated / N / vItems.size(), (double)nAllocsEntity / N / vItems.size());
+   CHECK(nAggregated == N);
+   CHECK(nEntity == N * vItems.size());
+   CHECK(nAllocsAggregated == 0);
+
+   for (auto item : vItems) delete item;
+}
+
+/// runs a discovery to its end, returns the discovery topics published
+static std::set<std::string> runDiscovery(const std::vector<CxMqttHABase*>& vItems, bool bForce) {
+   std::set<std::string> setTopics;
+   std::set<std::string> setConfigs;
+   dev.regItems(true, bForce);
+   // the discovery topics are absolute ("/homeassistant/..."), published without the leading slash
+   for (auto item : vItems) setConfigs.insert(item->getTopicHADiscovery() + 1);
+   hostMqtt().cbPublish = [&](const char* szTopic, const char* p, size_t n, bool) {
+      if (setConfigs.count(szTopic)) setTopics.insert(szTopic);
+   };
+   while (dev.loopDiscovery()) {}
+   hostMqtt().cbPublish = nullptr;
+   return setTopics;
+}
+
+/// unchanged configs are skipped by their hash, also after the hashes were restored from /.hahash
+static void testDiscoveryHashes() {
+   printf("discovery hashes\n");
+   std::vector<CxMqttHABase*> vItems = createItems();
+   setupDevice();
+   hostFs().format();
+
+   std::set<std::string> setTopics = runDiscovery(vItems, true);
+   CHECK(setTopics.size() == vItems.size());
+   CHECK(dev.getDiscoverySkipped() == 0);
+   CHECK(dev.isDiscoveryHashChanged());
+
+   // nothing changed, nothing is published again
+   setTopics = runDiscovery(vItems, false);
+   CHECK(setTopics.empty());
+   CHECK(dev.getDiscoverySkipped() == vItems.size());
+   CHECK(dev.getDiscoveryBytes() == 0);
+
+   // only the changed entity is published
+   vItems[1]->setFriendlyName("Humidity indoor");
+   setTopics = runDiscovery(vItems, false);
+   CHECK(setTopics.size() == 1);
+   CHECK(setTopics.count(vItems[1]->getTopicHADiscovery() + 1) == 1);
+   CHECK(dev.getDiscoverySkipped() == vItems.size() - 1);
+
+   // round trip of the hash file (as CxCapabilityMqttHA after a reboot)
+   File file = LittleFS.open("/.hahash", "w");
+   CHECK(dev.saveDiscoveryHashes(file) == vItems.size());
+   file.close();
+   CHECK(!dev.isDiscoveryHashChanged());
+   CHECK(hostFs().mapFiles["/.hahash"].size() == vItems.size() * 2 * sizeof(uint32_t));
+
+   CxBufferStream empty(0);
+   CHECK(dev.loadDiscoveryHashes(empty) == 0);  // as after a reboot without the file
+   file = LittleFS.open("/.hahash", "r");
+   CHECK(dev.loadDiscoveryHashes(file) == vItems.size());
+   file.close();
+   setTopics = runDiscovery(vItems, false);
+   CHECK(setTopics.empty());
+   CHECK(dev.getDiscoverySkipped() == vItems.size());
+
+   // forced, all are published regardless of the hashes
+   setTopics = runDiscovery(vItems, true);
+   CHECK(setTopics.size() == vItems.size());
+   CHECK(dev.getDiscoverySkipped() == 0);
+
+   for (auto item : vItems) delete item;
+}
+
+/// ha list: the discovery statistics follow the text table only, json and kv stay parseable
+static void testListFormat() {
+   printf("list format\n");
+   std::vector<CxMqttHABase*> vItems = createItems();
+   setupDevice();
+   CxESPConsoleMaster& console = CxESPConsoleMaster::getInstance();
+
+   CxBufferStream text(8192);
+   dev.printList(text);
+   std::string strText((const char*)text.get(), text.length());
+   CHECK(strText.find("Discovery: ") != std::string::npos);
+
+   console.setTableFormat(CxTablePrinter::e_format::json);
+   CxBufferStream json(8192);
+   dev.printList(json);
+   std::string strJson((const char*)json.get(), json.length());
+   CHECK(strJson.rfind("[{", 0) == 0);
+   CHECK(strJson.size() > 4 && strJson.compare(strJson.size() - 4, 4, "}]\r\n") == 0);
+   CHECK(strJson.find("Discovery") == std::string::npos);
+
+   console.setTableFormat(CxTablePrinter::e_format::kv);
+   CxBufferStream kv(8192);
+   dev.printList(kv);
+   std::string strKv((const char*)kv.get(), kv.length());
+   CHECK(strKv.find("Discovery") == std::string::npos);
+   // one line per entity
+   uint32_t nLines = 0;
+   for (char c : strKv) if (c == '\n') nLines++;
+   CHECK(nLines == vItems.size());
+
+   console.setTableFormat(CxTablePrinter::e_format::text);
+   for (auto item : vItems) delete item;
+}
+
+int main() {
+   setvbuf(stdout, nullptr, _IOLBF, 0);
+   CxESPConsoleMaster::getInstance().setLog(false);
+   testDiscoveryHeap();
+   testStateRate();
+   testLongTopic();
+   testStateAggregation();
+   testDiscoveryHashes();
+   testListFormat();
+   return hostResult();
+}
@@ -0,0 +1,217 @@
+//
+//  test_outqueue.cpp
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+//  Host test of CxOutputQueue behind the ESC filter, as in a console session, with a slow peer: the
+//  stream takes its send buffer at a fixed rate with pauses (e.g. retransmissions on wifi) and blocks the
+//  writer (simulated time), when the buffer is full. The session writes colored log lines and command output every loop pass. The stalls of the loop
+//  are measured for the stream reporting its free space (ESP8266), not reporting it (WiFiClient of the
+//  ESP32) with and without the space function, and without queue. Every log line must arrive complete or
+//  not at all. The space of the stream (a socket call on the device) is queried about once per loop pass.
+//  Only the bytes, which found the stream full, are counted as deferred.
+//
+
+#include "HostTest.h"
+#include "CxEscFilter.hpp"
+#include "CxOutputQueue.hpp"
+
+#include <sstream>
+
+/// simulated time, without the real time of the host
+static uint32_t now() {return hostClockOffset();}
+
+/// peer reading nRate bytes per ms from a send buffer of nBuffer bytes, except the first nPauseMs of each
+/// nPeriodMs
+class SlowStream : public Stream {
+   uint32_t _nLast = now();
+   size_t   _nUsed = 0;
+
+   void _update() {
+      for (; _nLast != now(); _nLast++) {
+         if (_nLast % nPeriodMs >= nPauseMs) _nUsed -= std::min(_nUsed, nRate);
+      }
+   }
+
+public:
+   size_t   nBuffer = 2920;
+   size_t   nRate = 100;
+   uint32_t nPeriodMs = 500;
+   uint32_t nPauseMs = 150;
+   bool   bReportsSpace = true;     ///< availableForWrite() reports the free space (ESP8266)
+   uint32_t nQueries = 0;           ///< space queries (a socket call on the device)
+   std::string str;
+
+   size_t free() {_update(); return nBuffer - _nUsed;}
+
+   /// space function like CxOutputQueue::socketSpace(): writable above the low water mark
+   int socketSpace() {nQueries++; return (free() > nBuffer / 2) ? 1024 : 0;}
+
+   size_t write(uint8_t c) override {return write(&c, 1);}
+   size_t write(const uint8_t* buffer, size_t size) override {
+      for (size_t i = 0; i < size; i++) {
+         while (!free()) hostAdvance(1); // blocks
+         _nUsed++;
+         str += (char)buffer[i];
+      }
+      return size;
+   }
+   int availableForWrite() override {nQueries++; return bReportsSpace ? (int)free() : 0;}
+   int available() override {return 0;}
+   int read() override {return -1;}
+   int peek() override {return -1;}
+};
+
+struct Result {
+   uint32_t nMaxLogStall = 0;       ///< max. ms a log line blocked the loop
+   uint32_t nMaxCmdStall = 0;       ///< max. ms command output blocked the loop
+   uint32_t nTotalStall = 0;
+   uint32_t nLines = 0;             ///< log lines received
+   uint32_t nDropped = 0;
+   uint32_t nQueries = 0;           ///< space queries of the stream
+   uint32_t nDeferred = 0;          ///< bytes, which waited for the stream
+};
+
+/// runs the loop passes of a session: a log line per pass, command output every 20th pass
+static Result run(SlowStream& stream, uint16_t nQueue, bool bSpaceFunc, uint32_t nPasses = 2000) {
+   CxOutputQueue queue(&stream, nQueue);
+   if (bSpaceFunc) queue.setFuncSpace([&stream]() {return stream.socketSpace();});
+   CxEscFilterStream esc(&queue);
+   esc.setEnabled(true);
+
+   Result result;
+   for (uint32_t i = 0; i < nPasses; i++) {
+      char sz[100];
+      snprintf(sz, sizeof(sz), "\033[1m\033[32m12:00:%02u [I] \033[0mSENS: line %05u temperature 21.5 humidity 40", i % 60, i);
+      uint32_t nStart = now();
+      {
+         CxOutputQueue::LogScope log(strlen(sz) + 2);
+         esc.print(sz);
+         esc.print("\r\n");
+      }
+      uint32_t nLog = now() - nStart;
+      result.nMaxLogStall = std::max(result.nMaxLogStall, nLog);
+
+      if (i % 20 == 0) {
+         nStart = now();
+         for (int j = 0; j < 4; j++) esc.print("\033[1m | \033[0mrelay   | on  | gpio 12 | 00:10:00\r\n");
+         result.nMaxCmdStall = std::max(result.nMaxCmdStall, now() - nStart);
+      }
+      queue.loop();
+      result.nTotalStall += now() - nStart;
+      hostAdvance(1); // rest of the loop pass
+   }
+   queue.flush();
+   result.nDropped = queue.getDropped();
+   result.nQueries = stream.nQueries;
+   result.nDeferred = queue.getDeferred();
+
+   // the log lines arrive complete or not at all
+   std::istringstream lines(stream.str);
+   std::string strLine;
+   while (std::getline(lines, strLine)) {
+      if (strLine.find("SENS") == std::string::npos) {
+         CHECK(strLine == " | relay   | on  | gpio 12 | 00:10:00\r");
+         continue;
+      }
+      unsigned int nSec, nLine;
+      char szRest[64] = {0};
+      bool bOk = sscanf(strLine.c_str(), "12:00:%02u [I] SENS: line %05u %63[^\r]", &nSec, &nLine, szRest) == 3 &&
+                 strcmp(szRest, "temperature 21.5 humidity 40") == 0 && strLine.back() == '\r';
+      CHECK(bOk);
+      if (!bOk) printf("  fragment: '%s'\n", strLine.c_str());
+      result.nLines++;
+   }
+   return result;
+}
+
+static void report(const char* szName, const Result& result, uint32_t nPasses = 2000) {
+   printf("%-30s stall log max. %4u ms, cmd max. %4u ms, loop total %5u ms; log lines %4u of %u, dropped %6u bytes, deferred %6u bytes, %5u space queries\n",
+          szName, result.nMaxLogStall, result.nMaxCmdStall, result.nTotalStall, result.nLines, nPasses, result.nDropped, result.nDeferred, result.nQueries);
+}
+
+/// only bytes, which found the stream full, are deferred, each of them once
+static void testDeferred() {
+   SlowStream stream;
+   stream.nBuffer = 50;
+   stream.nRate = 0;        // the peer doesn't read
+   stream.nPauseMs = 0;
+   CxOutputQueue queue(&stream, 512);
+   std::string str(100, 'x');
+
+   queue.write((const uint8_t*)str.data(), 30);
+   queue.loop();            // the stream takes all
+   CHECK(queue.getDeferred() == 0);
+   CHECK(queue.getQueued() == 0);
+
+   queue.write((const uint8_t*)str.data(), 100);
+   queue.loop();            // 20 bytes sent, 80 wait
+   CHECK(queue.getQueued() == 80);
+   CHECK(queue.getDeferred() == 80);
+   queue.loop();            // still full, counted once
+   CHECK(queue.getDeferred() == 80);
+
+   queue.write((const uint8_t*)str.data(), 10);
+   stream.nRate = 1000;     // the peer reads again, with a larger window
+   stream.nBuffer = 1000;
+   hostAdvance(1);
+   queue.loop();            // the 10 bytes queued behind the waiting ones go out in the same drain
+   CHECK(queue.getQueued() == 0);
+   CHECK(queue.getDeferred() == 80);
+   CHECK(stream.str.size() == 140);
+}
+
+int main() {
+   setvbuf(stdout, nullptr, _IOLBF, 0);
+   testDeferred();
+
+   // the peer takes 100 bytes/ms, the session produces ~ 85 bytes/ms: keeps up, but not with the bursts
+   {
+      SlowStream stream;
+      Result result = run(stream, 0, false);
+      report("no queue", result);
+      CHECK(result.nLines == 2000);
+   }
+   {
+      SlowStream stream;
+      Result result = run(stream, 512, false);
+      report("queue, availableForWrite()", result);
+      CHECK(result.nMaxLogStall == 0);
+      CHECK(result.nQueries < 2 * 2000); // once per loop pass, a few more for the command output
+   }
+   {
+      SlowStream stream;
+      stream.bReportsSpace = false;
+      Result result = run(stream, 512, false);
+      report("queue, no free space (esp32)", result);
+   }
+   {
+      SlowStream stream;
+      stream.bReportsSpace = false;
+      Result result = run(stream, 512, true);
+      report("queue, space function (esp32)", result);
+      CHECK(result.nMaxLogStall == 0);
+      CHECK(result.nQueries < 2 * 2000);
+   }
+
+   // a slower peer (40 bytes/ms): log lines are dropped as a whole
+   {
+      SlowStream stream;
+      stream.nRate = 40;
+      Result result = run(stream, 0, false);
+      report("slow peer, no queue", result);
+   }
+   {
+      SlowStream stream;
+      stream.nRate = 40;
+      stream.bReportsSpace = false;
+      Result result = run(stream, 512, true);
+      report("slow peer, space function", result);
+      CHECK(result.nMaxLogStall == 0);
+      CHECK(result.nDropped > 0 && result.nLines < 2000);
+   }
+
+   return hostResult();
+}
@@ -0,0 +1,291 @@
+//
+//  test_table.cpp
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+//  Host test of CxTablePrinter: NaN and infinity cells, the column limit of the vector interface, and the
+//  heap allocations per row. The allocations are counted by the global operator new, the report compares
+//  the cell interface with the former printRow(std::vector<String>).
+//  The scrape of sensor, gpio and timer like tables is measured per format: the bytes on the wire (with the
+//  ESC attributes of the device) and the time to print and to parse the output into values.
+//
+
+// the attributes of the device, the text output is measured with them
+#define ESC_ATTR_BOLD "\033[1m"
+#define ESC_ATTR_RESET "\033[0m"
+
+#include "HostTest.h"
+
+#include "CxTablePrinter.hpp"
+
+#include <new>
+#include <chrono>
+#include <functional>
+
+// the counting operator new/delete pair is malloc/free, gcc doesn't see this across the inlined allocators
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+static uint32_t g_nAllocs = 0;
+
+void* operator new(size_t n) {
+   g_nAllocs++;
+   void* p = malloc(n ? n : 1);
+   if (!p) throw std::bad_alloc();
+   return p;
+}
+void operator delete(void* p) noexcept {free(p);}
+void operator delete(void* p, size_t) noexcept {free(p);}
+
+/// collects the output, the buffer is reserved up front and doesn't allocate while printing
+class OutStream : public Stream {
+public:
+   std::string str;
+   OutStream() {str.reserve(1 << 16);}
+   size_t write(uint8_t c) override {str += (char)c; return 1;}
+   int available() override {return 0;}
+   int read() override {return -1;}
+   int peek() override {return -1;}
+};
+
+static void testNaN() {
+   OutStream out;
+   {
+      CxTablePrinter table(out, CxTablePrinter::e_format::json);
+      table.printHeader({{F("Name"), 6}, {F("Temp"), 6}, {F("Hum"), 6}});
+      table.cell(F("bme")); table.cell(NAN); table.cell(INFINITY); table.endRow();
+   }
+   CHECK(out.str == "[{\"name\":\"bme\",\"temp\":null,\"hum\":null}]\r\n");
+
+   out.str.clear();
+   {
+      CxTablePrinter table(out, CxTablePrinter::e_format::kv);
+      table.printHeader({{F("Temp"), 6}, {F("Hum"), 6}});
+      table.cell(-INFINITY); table.cell(21.456, 1); table.endRow();
+   }
+   CHECK(out.str == "temp=- hum=21.5\r\n");
+
+   out.str.clear();
+   {
+      CxTablePrinter table(out);
+      table.printHeader({{F("Temp"), 6}});
+      table.cell(NAN); table.endRow();
+   }
+   CHECK(out.str.find("-     \r\n") != std::string::npos);
+}
+
+static void testColumns() {
+   std::vector<String> vTitles;
+   std::vector<String> vValues;
+   for (int i = 0; i < 20; i++) {
+      vTitles.push_back(String("t") + String(i));
+      vValues.push_back(String(i));
+   }
+   OutStream out;
+   {
+      CxTablePrinter table(out);
+      table.printHeader(vTitles, {});
+      table.printRow(vValues);
+   }
+   CHECK(out.str.find("### table: 20 columns, max. 16") != std::string::npos);
+   CHECK(out.str.find("t15") != std::string::npos && out.str.find("t16") == std::string::npos);
+
+   out.str.clear();
+   {
+      CxTablePrinter table(out, CxTablePrinter::e_format::json);
+      table.printHeader(vTitles, {});
+      table.printRow(vValues);
+   }
+   CHECK(out.str == "[{\"t0\":0,\"t1\":1,\"t2\":2,\"t3\":3,\"t4\":4,\"t5\":5,\"t6\":6,\"t7\":7,\"t8\":8,\"t9\":9,"
+                    "\"t10\":10,\"t11\":11,\"t12\":12,\"t13\":13,\"t14\":14,\"t15\":15}]\r\n");
+}
+
+static void testAllocations() {
+   const int nRows = 100;
+   for (auto fmt : {CxTablePrinter::e_format::text, CxTablePrinter::e_format::json, CxTablePrinter::e_format::kv}) {
+      OutStream out;
+      CxTablePrinter table(out, fmt);
+      table.printHeader({{F("Id"), 3}, {F("Name"), 10}, {F("Value"), 8}, {F("Ok"), 3}});
+
+      uint32_t nStart = g_nAllocs;
+      for (int i = 0; i < nRows; i++) {
+         table.cell(i); table.cell(F("sensor name")); table.cell(i * 0.5); table.cell(i % 2 == 0); table.endRow();
+      }
+      uint32_t nCells = g_nAllocs - nStart;
+      CHECK(nCells == 0);
+
+      nStart = g_nAllocs;
+      for (int i = 0; i < nRows; i++) {
+         table.printRow({String(i), "sensor name", String(i * 0.5, 2), (i % 2 == 0) ? "yes" : "no"});
+      }
+      uint32_t nVector = g_nAllocs - nStart;
+      table.printFooter();
+      printf("%-4s: %d rows, allocations with cells %u, with printRow(vector<String>) %u\n",
+             CxTablePrinter::getFormatName(fmt), nRows, nCells, nVector);
+   }
+}
+
+/// values of a scraped table, as the monitoring gets them
+using Values = std::vector<std::string>;
+
+/// text: the rows between the rulers, the ESC sequences removed, the cells split at '|' and trimmed
+static void parseText(const std::string& str, Values& v) {
+   bool bRows = false;
+   size_t nPos = 0;
+   while (nPos < str.size()) {
+      size_t nEnd = str.find("\r\n", nPos);
+      if (nEnd == std::string::npos) nEnd = str.size();
+      std::string strLine;
+      for (size_t i = nPos; i < nEnd; i++) {
+         if (str[i] == 0x1B) {
+            while (i < nEnd && !isalpha((unsigned char)str[i])) i++;
+            continue;
+         }
+         strLine += str[i];
+      }
+      nPos = nEnd + 2;
+      // the ruler below the titles starts the rows, the one of the footer ends them
+      if (strLine.compare(0, 3, "---") == 0) {bRows = (strLine.find("-+-") != std::string::npos); continue;}
+      if (!bRows) continue;
+      size_t nCell = 0;
+      while (true) {
+         size_t nBar = strLine.find('|', nCell);
+         std::string strCell = strLine.substr(nCell, nBar == std::string::npos ? std::string::npos : nBar - nCell);
+         size_t nFirst = strCell.find_first_not_of(' ');
+         size_t nLast = strCell.find_last_not_of(' ');
+         v.push_back(nFirst == std::string::npos ? "" : strCell.substr(nFirst, nLast - nFirst + 1));
+         if (nBar == std::string::npos) break;
+         nCell = nBar + 1;
+      }
+   }
+}
+
+/// quoted string at p (json escapes), returns the position after it
+static size_t parseQuoted(const std::string& str, size_t p, std::string& strValue) {
+   strValue.clear();
+   for (p++; p < str.size() && str[p] != '"'; p++) {
+      if (str[p] == '\\') p++;
+      strValue += str[p];
+   }
+   return p + 1;
+}
+
+/// json: the values of the objects, strings unquoted
+static void parseJson(const std::string& str, Values& v) {
+   std::string strValue;
+   size_t p = 0;
+   while ((p = str.find_first_of("{,", p)) != std::string::npos) {
+      p = str.find('"', p);
+      if (p == std::string::npos) break;
+      p = parseQuoted(str, p, strValue) + 1; // key and ':'
+      if (str[p] == '"') {
+         p = parseQuoted(str, p, strValue);
+      } else {
+         size_t nEnd = str.find_first_of(",}", p);
+         strValue = str.substr(p, nEnd - p);
+         p = nEnd;
+      }
+      v.push_back(strValue);
+   }
+}
+
+/// kv: key=value pairs separated by spaces, quoted values with spaces
+static void parseKv(const std::string& str, Values& v) {
+   std::string strValue;
+   size_t p = 0;
+   while ((p = str.find('=', p)) != std::string::npos) {
+      p++;
+      if (str[p] == '"') {
+         p = parseQuoted(str, p, strValue);
+      } else {
+         size_t nEnd = str.find_first_of(" \r", p);
+         strValue = str.substr(p, nEnd - p);
+         p = nEnd;
+      }
+      v.push_back(strValue);
+   }
+}
+
+/// tables as printed by 'sensor list', 'gpio list' and 'timer list'
+static void printSensors(CxTablePrinter& table) {
+   static const char* aszNames[] = {"Temperature", "Humidity", "Pressure", "Light", "Outdoor", "Soil", "CO2", "Battery"};
+   table.printHeader({{F("Id"), 2}, {F("Name"), 11}, {F("Type"), 15}, {F("Model"), 8}, {F("Value"), 8}, {F("Unit"), 8}});
+   for (int i = 0; i < 8; i++) {
+      table.cell(i); table.cell(aszNames[i]); table.cell(F("temperature")); table.cell(F("BME280"));
+      table.cell(20.0 + i * 1.25); table.cell(F("°C")); table.endRow();
+   }
+   table.printFooter();
+}
+
+static void printGpios(CxTablePrinter& table) {
+   table.printHeader({{F("Pin"), 3}, {F("Mode"), 10}, {F("inv"), 3}, {F("State"), 5}, {F("PWM"), 8}, {F("Value"), 6}});
+   for (int i = 0; i < 10; i++) {
+      table.cell(i); table.cell((i % 2) ? F("OUTPUT") : F("INPUT_PU")); table.cell(i % 3 == 0); table.cell(i % 2);
+      table.cell(F("no")); table.cell(i * 10); table.endRow();
+   }
+   table.printFooter();
+}
+
+static void printTimers(CxTablePrinter& table) {
+   table.printHeader({{F("Id"), 10}, {F("Time"), 10}, {F("Mode"), 6}, {F("Remain"), 7}, {F("Cmd"), 60}});
+   for (int i = 0; i < 5; i++) {
+      table.cell(F("tiSensor")); table.cell(F("1m")); table.cell(F("repeat")); table.cell(F("42s"));
+      table.cell(F("sensor update; mqtt publish \"temp\" $(TEMP)")); table.endRow();
+   }
+   table.printFooter();
+}
+
+static void testScrape() {
+   printf("scrape\n");
+   static const int N = 2000;
+   struct Table {const char* szName; std::function<void(CxTablePrinter&)> fnPrint;};
+   const Table aTables[] = {{"sensor", printSensors}, {"gpio", printGpios}, {"timer", printTimers}};
+   const CxTablePrinter::e_format aFormats[] = {CxTablePrinter::e_format::text, CxTablePrinter::e_format::json, CxTablePrinter::e_format::kv};
+   using fnParse = void (*)(const std::string&, Values&);
+   const fnParse aParse[] = {parseText, parseJson, parseKv};
+
+   printf("  table   format   bytes  print us  parse us  values\n");
+   for (const Table& t : aTables) {
+      size_t nBytesText = 0;
+      Values vText;
+      for (int f = 0; f < 3; f++) {
+         OutStream out;
+         Values v;
+         auto tStart = std::chrono::steady_clock::now();
+         for (int i = 0; i < N; i++) {
+            out.str.clear();
+            CxTablePrinter table(out, aFormats[f]);
+            t.fnPrint(table);
+         }
+         auto tPrinted = std::chrono::steady_clock::now();
+         for (int i = 0; i < N; i++) {
+            v.clear();
+            aParse[f](out.str, v);
+         }
+         auto tParsed = std::chrono::steady_clock::now();
+         double fPrint = std::chrono::duration<double, std::micro>(tPrinted - tStart).count() / N;
+         double fParse = std::chrono::duration<double, std::micro>(tParsed - tPrinted).count() / N;
+         printf("  %-7s %-6s %7zu %9.2f %9.2f  %6zu\n", t.szName, CxTablePrinter::getFormatName(aFormats[f]),
+                out.str.size(), fPrint, fParse, v.size());
+         if (f == 0) {
+            nBytesText = out.str.size();
+            vText = v;
+         } else {
+            // the same values, in fewer bytes
+            CHECK(v == vText);
+            CHECK(out.str.size() < nBytesText);
+         }
+      }
+   }
+   // the times depend on the host, they are reported only
+}
+
+int main() {
+   setvbuf(stdout, nullptr, _IOLBF, 0);
+   testNaN();
+   testColumns();
+   testAllocations();
+   testScrape();
+   return hostResult();
+}
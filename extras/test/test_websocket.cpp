@@ -0,0 +1,193 @@
+//
+//  test_websocket.cpp
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+//  Host test of CxWebSocketStream with a client in memory: accept key, fragmented messages with a ping
+//  between the fragments, close handshake, unmasked frames, input larger than the input buffer and the
+//  output collected into frames. The report compares the frames sent with a frame per write.
+//
+
+#include "HostTest.h"
+#include "CxWebSocket.hpp"
+
+#include <deque>
+
+/// connection in memory: the test puts the frames of the browser, the output of the device is collected
+class MemClient : public Client {
+public:
+   std::deque<uint8_t> rx;
+   std::string tx;
+   uint32_t nWrites = 0;
+   bool bConnected = true;
+
+   int connect(const char*, uint16_t) override {return 0;}
+   size_t write(uint8_t c) override {tx += (char)c; nWrites++; return 1;}
+   size_t write(const uint8_t* buffer, size_t size) override {tx.append((const char*)buffer, size); nWrites++; return size;}
+   int available() override {return (int)rx.size();}
+   int read() override {
+      if (rx.empty()) return -1;
+      uint8_t c = rx.front();
+      rx.pop_front();
+      return c;
+   }
+   int read(uint8_t* buffer, size_t size) override {
+      size_t n = 0;
+      while (n < size && !rx.empty()) buffer[n++] = (uint8_t)read();
+      return (int)n;
+   }
+   int peek() override {return rx.empty() ? -1 : rx.front();}
+   uint8_t connected() override {return bConnected;}
+   void stop() override {bConnected = false;}
+   operator bool() override {return bConnected;}
+
+   /// frame of the browser, masked
+   void put(uint8_t nOpcode, const std::string& str, bool bFin = true, bool bMasked = true) {
+      static const uint8_t aMask[4] = {0x12, 0x34, 0x56, 0x78};
+      rx.push_back((bFin ? 0x80 : 0x00) | nOpcode);
+      uint8_t nMaskBit = bMasked ? 0x80 : 0x00;
+      if (str.size() < 126) {
+         rx.push_back(nMaskBit | (uint8_t)str.size());
+      } else {
+         rx.push_back(nMaskBit | 126);
+         rx.push_back((uint8_t)(str.size() >> 8));
+         rx.push_back((uint8_t)str.size());
+      }
+      if (bMasked) for (uint8_t m : aMask) rx.push_back(m);
+      for (size_t i = 0; i < str.size(); i++) rx.push_back((uint8_t)str[i] ^ (bMasked ? aMask[i % 4] : 0));
+   }
+
+   /// next frame of the device (unmasked), false if none
+   bool take(uint8_t& nOpcode, std::string& str) {
+      if (tx.size() < 2) return false;
+      nOpcode = (uint8_t)tx[0] & 0x0F;
+      size_t nLen = (uint8_t)tx[1] & 0x7F;
+      size_t nHeader = 2;
+      if (nLen == 126) {
+         nLen = ((size_t)(uint8_t)tx[2] << 8) | (uint8_t)tx[3];
+         nHeader = 4;
+      }
+      str = tx.substr(nHeader, nLen);
+      tx.erase(0, nHeader + nLen);
+      return true;
+   }
+};
+
+static std::string readAll(CxWebSocketStream& ws) {
+   std::string str;
+   int c;
+   while ((c = ws.read()) >= 0) str += (char)c;
+   return str;
+}
+
+static void testAcceptKey() {
+   // example of RFC 6455
+   CHECK(CxWebSocketStream::getAcceptKey("dGhlIHNhbXBsZSBub25jZQ==") == "s3pPLMBiTxaQ9kYGzzhZRbK+xOo=");
+}
+
+static void testFragmented() {
+   MemClient client;
+   CxWebSocketStream ws(client);
+
+   // "hel" + ping + "lo": the ping is answered, the continuation is still data
+   client.put(0x1, "hel", false);
+   client.put(0x9, "p1");
+   client.put(0x0, "lo", true);
+   CHECK(readAll(ws) == "hello");
+   uint8_t nOpcode = 0;
+   std::string str;
+   CHECK(client.take(nOpcode, str) && nOpcode == 0xA && str == "p1");
+   CHECK(!client.take(nOpcode, str));
+
+   // a ping with empty payload between fragments of a binary message
+   client.put(0x2, "ab", false);
+   client.put(0x9, "");
+   client.put(0x0, "cd", false);
+   client.put(0x0, "ef", true);
+   CHECK(readAll(ws) == "abcdef");
+   CHECK(client.take(nOpcode, str) && nOpcode == 0xA && str.empty());
+   CHECK(ws.connected());
+}
+
+static void testClose() {
+   MemClient client;
+   CxWebSocketStream ws(client);
+   ws.print("bye");
+   client.put(0x8, std::string("\x03\xe8", 2));
+   CHECK(ws.available() == 0);
+   CHECK(!ws.connected());
+   uint8_t nOpcode = 0;
+   std::string str;
+   CHECK(client.take(nOpcode, str) && nOpcode == 0x2 && str == "bye"); // pending output first
+   CHECK(client.take(nOpcode, str) && nOpcode == 0x8 && str == std::string("\x03\xe8", 2));
+
+   // closed by the device, e.g. exit
+   MemClient client2;
+   CxWebSocketStream ws2(client2);
+   ws2.close(1000);
+   ws2.close(1000);
+   CHECK(client2.take(nOpcode, str) && nOpcode == 0x8 && str == std::string("\x03\xe8", 2));
+   CHECK(!client2.take(nOpcode, str)); // once
+   CHECK(ws2.write('x') == 0);
+}
+
+static void testUnmasked() {
+   MemClient client;
+   CxWebSocketStream ws(client);
+   client.put(0x1, "ls", true, false);
+   CHECK(ws.read() == -1);
+   CHECK(!ws.connected());
+   uint8_t nOpcode = 0;
+   std::string str;
+   CHECK(client.take(nOpcode, str) && nOpcode == 0x8 && str == std::string("\x03\xea", 2)); // 1002
+}
+
+static void testLargeInput() {
+   MemClient client;
+   CxWebSocketStream ws(client);
+   std::string strIn(1000, 'x');
+   for (size_t i = 0; i < strIn.size(); i++) strIn[i] = (char)('a' + i % 26);
+   client.put(0x1, strIn);
+   CHECK(ws.available() == CxWebSocketStream::_nRX_SIZE); // parsed as far as there is room
+   CHECK(readAll(ws) == strIn);
+   CHECK(ws.getBytesIn() == strIn.size());
+}
+
+static void testOutput() {
+   MemClient client;
+   CxWebSocketStream ws(client);
+   const int nLines = 200;
+   size_t nBytes = 0;
+   for (int i = 0; i < nLines; i++) {
+      nBytes += ws.printf("%3d relay %d         | on  | gpio %2d\r\n", i, i, i % 17);
+      if (i % 50 == 49) ws.loop(); // the loop of the capability sends the collected output
+   }
+   ws.loop();
+   uint32_t nFrames = 0;
+   size_t nPayload = 0;
+   uint8_t nOpcode = 0;
+   std::string str;
+   while (client.take(nOpcode, str)) {
+      CHECK(nOpcode == 0x2 && str.size() <= CxWebSocketStream::_nTX_SIZE);
+      nFrames++;
+      nPayload += str.size();
+   }
+   CHECK(nPayload == nBytes);
+   CHECK(nFrames == ws.getFramesOut());
+   CHECK(nFrames < 20);
+   printf("%d lines, %u bytes: %u frames (%u socket writes), a frame per write would be %d frames\n",
+          nLines, (unsigned int)nBytes, nFrames, client.nWrites, nLines);
+}
+
+int main() {
+   setvbuf(stdout, nullptr, _IOLBF, 0);
+   testAcceptKey();
+   testFragmented();
+   testClose();
+   testUnmasked();
+   testLargeInput();
+   testOutput();
+   return hostResult();
+}
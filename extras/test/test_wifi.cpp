@@ -0,0 +1,221 @@
+//
+//  test_wifi.cpp
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+//  Host test of CxWiFiStation with the WiFi stand-in (host/ESP8266WiFi.h): fast connect to the cached
+//  access point, fallback to scan with its own timeout, credentials saved only when connected, and the
+//  connection lost and reconnected by the SDK (roaming to another access point), and the static ip
+//  configuration bound to its network. The simulated connect times are printed.
+//
+
+#include "HostTest.h"
+#include "ESP8266WiFi.h"
+
+/// console stand-in, collects the log
+class CxESPConsoleMaster {
+public:
+   std::vector<std::string> vLog;
+   static CxESPConsoleMaster& getInstance() {
+      static CxESPConsoleMaster instance;
+      return instance;
+   }
+   void info(const __FlashStringHelper* fmt, ...) {
+      char sz[128];
+      va_list args;
+      va_start(args, fmt);
+      vsnprintf(sz, sizeof(sz), reinterpret_cast<const char*>(fmt), args);
+      va_end(args);
+      vLog.push_back(sz);
+   }
+   bool logged(const char* sz) {
+      for (auto& str : vLog) if (str.find(sz) != std::string::npos) return true;
+      return false;
+   }
+};
+
+#define _CONSOLE_INFO(...) __console.info(__VA_ARGS__)
+
+#include "CxWiFiStation.hpp"
+
+// ---- eeprom of esphw.cpp (ssid at 0x7, password at 0x1B, wifi cache at 0x180)
+
+static uint8_t s_aEeprom[512];
+
+bool eepromRead(uint32_t nAddr, void* p, size_t nLen) {memcpy(p, s_aEeprom + nAddr, nLen); return true;}
+bool eepromWrite(uint32_t nAddr, const void* p, size_t nLen) {memcpy(s_aEeprom + nAddr, p, nLen); return true;}
+void readWiFiCache(WiFiCache_t& cache) {eepromGet(0x180, cache);}
+void writeWiFiCache(WiFiCache_t& cache) {cache._nMagic = WIFICACHE_MAGIC; eepromPut(0x180, cache);}
+bool writeSSID(const char* szSSID) {char buf[20] = {}; strncpy(buf, szSSID, sizeof(buf)); return eepromPut(0x7, buf);}
+bool writePassword(const char* szPassword) {char buf[25] = {}; strncpy(buf, szPassword, sizeof(buf)); return eepromPut(0x1B, buf);}
+bool readSSID(char* szSSID, uint32_t lenmax) {memset(szSSID, 0, lenmax); strncpy(szSSID, (const char*)s_aEeprom + 0x7, std::min(lenmax - 1, (uint32_t)20)); return true;}
+static std::string savedSSID() {return std::string((const char*)s_aEeprom + 0x7, strnlen((const char*)s_aEeprom + 0x7, 20));}
+static std::string savedPassword() {return std::string((const char*)s_aEeprom + 0x1B, strnlen((const char*)s_aEeprom + 0x1B, 25));}
+
+static CxWiFiStation& station = CxWiFiStation::getInstance();
+static CxESPConsoleMaster& console = CxESPConsoleMaster::getInstance();
+
+/// runs the loop in steps of 10 ms until the connect completes, returns the simulated time (ms)
+static uint32_t run(uint32_t nMaxMs = 30000) {
+   uint32_t nTime = 0;
+   while (station.isConnecting() && nTime < nMaxMs) {
+      hostAdvance(10);
+      nTime += 10;
+      station.loop();
+   }
+   return nTime;
+}
+
+static void setup() {
+   memset(s_aEeprom, 0, sizeof(s_aEeprom));
+   WiFi = HostWiFi();
+   WiFi.vAPs.push_back({"home", "secret", {0x10, 0, 0, 0, 0, 1}, 6, -50});
+   WiFi.vAPs.push_back({"home", "secret", {0x10, 0, 0, 0, 0, 2}, 11, -70});
+   WiFi.setAutoReconnect(true);
+   console.vLog.clear();
+   station.end();
+}
+
+static void testFast() {
+   setup();
+   writeSSID("home");
+   writePassword("secret");
+
+   station.begin("home", "secret");
+   uint32_t nScan = run();
+   CHECK(station.getState() == CxWiFiStation::e_state::connected);
+   CHECK(WiFi.nScanBegins == 1);
+
+   WiFiCache_t cache;
+   readWiFiCache(cache);
+   CHECK(cache.isValid() && cache._nChannel == 6 && cache._bssid[5] == 1);
+
+   station.begin("home", "secret");
+   uint32_t nFast = run();
+   CHECK(station.getState() == CxWiFiStation::e_state::connected);
+   CHECK(WiFi.nScanBegins == 1); // cached access point, no scan
+   CHECK(station.getFastHits() == 1);
+   printf("connect with scan %u ms, fast connect to the cached access point %u ms\n", nScan, nFast);
+}
+
+static void testFallback() {
+   setup();
+   station.begin("home", "secret");
+   run();
+
+   // the access point moved to another channel, the scan takes longer than the rest of the first timeout
+   WiFi.vAPs[0].nChannel = 1;
+   WiFi.nScanMs = 8000;
+   station.begin("home", "secret");
+   uint32_t nTime = run();
+   CHECK(station.getState() == CxWiFiStation::e_state::connected);
+   CHECK(station.getFastMisses() == 1);
+   CHECK(nTime > 10000); // the scan phase got the full timeout
+   WiFiCache_t cache;
+   readWiFiCache(cache);
+   CHECK(cache._nChannel == 1);
+   printf("fast connect failed, connect with scan after %u ms\n", nTime);
+}
+
+static void testCredentials() {
+   setup();
+   writeSSID("home");
+   writePassword("secret");
+
+   // wrong password from the captive portal: not saved, the saved ones are kept
+   station.begin("home", "wrong", true);
+   run();
+   CHECK(station.getState() == CxWiFiStation::e_state::failed);
+   CHECK(savedPassword() == "secret");
+   CHECK(!console.logged("credentials saved"));
+
+   // new network: saved, when connected
+   WiFi.vAPs.push_back({"office", "pass2", {0x20, 0, 0, 0, 0, 1}, 1, -60});
+   station.begin("office", "pass2", true);
+   CHECK(savedSSID() == "home"); // not yet
+   run();
+   CHECK(station.getState() == CxWiFiStation::e_state::connected);
+   CHECK(savedSSID() == "office" && savedPassword() == "pass2");
+}
+
+static void testAutoReconnect() {
+   setup();
+   station.begin("home", "secret");
+   run();
+
+   // the access point goes off, the SDK reconnects to the other one
+   WiFi.vAPs.erase(WiFi.vAPs.begin());
+   WiFi.drop();
+   station.loop();
+   CHECK(station.getState() == CxWiFiStation::e_state::lost);
+   CHECK(!station.isConnecting());
+   uint32_t nTime = 0;
+   while (station.getState() == CxWiFiStation::e_state::lost && nTime < 30000) {
+      hostAdvance(10);
+      nTime += 10;
+      station.loop();
+   }
+   CHECK(station.getState() == CxWiFiStation::e_state::connected);
+   CHECK(station.getReconnects() == 1);
+   WiFiCache_t cache;
+   readWiFiCache(cache);
+   CHECK(cache._nChannel == 11 && cache._bssid[5] == 2); // the next fast connect uses the new one
+   printf("connection lost, reconnected by the sdk after %u ms\n", nTime);
+
+   // an intended disconnect is not observed
+   station.end();
+   WiFi.disconnect();
+   station.loop();
+   CHECK(station.getState() == CxWiFiStation::e_state::idle);
+}
+
+static void testStaticIP() {
+   setup();
+   WiFi.vAPs.push_back({"office", "pass2", {0x20, 0, 0, 0, 0, 1}, 1, -60});
+   writeSSID("home");
+
+   // set before the first connect: bound to the saved network
+   station.setStaticIP(0x0a01a8c0, 0x0101a8c0, 0x00ffffff, 0);
+   station.begin("home", "secret");
+   run();
+   CHECK(station.getState() == CxWiFiStation::e_state::connected);
+   CHECK((uint32_t)WiFi.ipStatic == 0x0a01a8c0);
+
+   // new credentials of another network connect with DHCP, the configuration is kept for the first one
+   station.begin("office", "pass2", true);
+   run();
+   CHECK(station.getState() == CxWiFiStation::e_state::connected);
+   CHECK((uint32_t)WiFi.ipStatic == 0);
+   station.begin("home", "secret", true);
+   run();
+   CHECK((uint32_t)WiFi.ipStatic == 0x0a01a8c0);
+
+   // set while connected to a network: bound to this one
+   station.begin("office", "pass2");
+   run();
+   station.setStaticIP(0x1400000a, 0x0100000a, 0x00ffffff, 0);
+   station.begin("office", "pass2");
+   run();
+   CHECK((uint32_t)WiFi.ipStatic == 0x1400000a);
+   station.begin("home", "secret");
+   run();
+   CHECK((uint32_t)WiFi.ipStatic == 0);
+
+   // dhcp for all
+   station.setStaticIP(0, 0, 0, 0);
+   station.begin("office", "pass2");
+   run();
+   CHECK((uint32_t)WiFi.ipStatic == 0);
+}
+
+int main() {
+   setvbuf(stdout, nullptr, _IOLBF, 0);
+   testFast();
+   testFallback();
+   testCredentials();
+   testAutoReconnect();
+   testStaticIP();
+   return hostResult();
+}
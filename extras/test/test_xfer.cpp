@@ -0,0 +1,177 @@
+//
+//  test_xfer.cpp
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+//  Host test of CxFileTransfer with the host client extras/tools/espxfer.py over a localhost connection:
+//  upload, resumed upload, download and resumed download. A block past the announced size is rejected. The transfer is stepped like in the loop of the
+//  console, the report shows the throughput and the longest step (the time the loop is blocked).
+//
+
+#include "HostTest.h"
+#include "WiFiClient.h"
+#include "LittleFS.h"
+#include "CxFileTransfer.hpp"
+
+#include <chrono>
+#include <functional>
+#include <fstream>
+#include <random>
+#include <thread>
+
+static std::string toolPath() {
+   std::string str = __FILE__;
+   return str.substr(0, str.rfind("/test/")) + "/tools/espxfer.py";
+}
+
+static std::string readLocal(const char* szFn) {
+   std::ifstream f(szFn, std::ios::binary);
+   return std::string(std::istreambuf_iterator<char>(f), {});
+}
+
+static void writeLocal(const char* szFn, const std::string& str) {
+   std::ofstream f(szFn, std::ios::binary);
+   f.write(str.data(), str.size());
+}
+
+/// serves one transfer for the client (run in a thread), returns the longest step in us
+static uint32_t serve(WiFiServer& server, std::function<void()> fnClient, bool& bOk) {
+   std::thread client(fnClient);
+   WiFiClient conn;
+   auto tStart = std::chrono::steady_clock::now();
+   while (!(conn = server.available())) {
+      if (std::chrono::steady_clock::now() - tStart > std::chrono::seconds(10)) break;
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+   }
+   // remote command line ($UPLOAD$, $DOWNLOAD$) read by the console, before the command hands over the connection
+   std::string strLine;
+   while (conn && conn.connected()) {
+      int c = conn.read();
+      if (c == '\n') break;
+      if (c >= 0) strLine += (char)c;
+   }
+
+   uint32_t nMaxStep = 0;
+   CxFileTransfer xfer(conn, 1UL << 20);
+   while (true) {
+      auto t0 = std::chrono::steady_clock::now();
+      bool bRunning = xfer.step();
+      uint32_t nStep = (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0).count();
+      nMaxStep = std::max(nMaxStep, nStep);
+      if (!bRunning) break;
+   }
+   client.join();
+   bOk = !xfer.isError();
+   printf("  device: %s %s, %u bytes (%u resumed) in %u ms, %u kB/s, longest step %u us%s%s\n", xfer.getFile(),
+          xfer.isUpload() ? "received" : "sent", xfer.getSize(), xfer.getResumed(), xfer.getTime(), xfer.getRate(),
+          nMaxStep, xfer.isError() ? ", error: " : "", xfer.isError() ? xfer.getError() : "");
+   return nMaxStep;
+}
+
+/// serves one transfer for the client command
+static uint32_t serve(WiFiServer& server, const std::string& strCmd, bool& bOk) {
+   return serve(server, [strCmd]() {bool b = system(strCmd.c_str()) == 0; (void)b;}, bOk);
+}
+
+/// reads a line of the device, empty after a timeout
+static std::string readLine(WiFiClient& client) {
+   std::string str;
+   auto tStart = std::chrono::steady_clock::now();
+   while (std::chrono::steady_clock::now() - tStart < std::chrono::seconds(5)) {
+      int c = client.read();
+      if (c == '\n') return str;
+      if (c >= 0) {
+         str += (char)c;
+      } else {
+         std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+   }
+   return "";
+}
+
+/// a block past the announced size is rejected with NAK, the client resends it with the right length
+static void testBlockPastSize(WiFiServer& server) {
+   printf("block past the size\n");
+   std::string strData = "0123456789";
+   std::string strLong = strData + "ABCDEFGHIJ";
+   std::vector<std::string> vReplies;
+   bool bOk;
+   serve(server, [&]() {
+      WiFiClient client;
+      if (!client.connect("127.0.0.1", server.port())) return;
+      client.printf("$UPLOAD$\n");
+      client.printf("PUT:/small.bin SIZE:%zu CRC:%08x\n", strData.size(), CxCrc32::of((const uint8_t*)strData.data(), strData.size()));
+      vReplies.push_back(readLine(client));
+      client.printf("BLK:0 %zu %08x\n", strLong.size(), CxCrc32::of((const uint8_t*)strLong.data(), strLong.size()));
+      client.write((const uint8_t*)strLong.data(), strLong.size());
+      vReplies.push_back(readLine(client));
+      client.printf("BLK:0 %zu %08x\n", strData.size(), CxCrc32::of((const uint8_t*)strData.data(), strData.size()));
+      client.write((const uint8_t*)strData.data(), strData.size());
+      vReplies.push_back(readLine(client));
+      vReplies.push_back(readLine(client));
+      client.stop();
+   }, bOk);
+   CHECK(bOk);
+   CHECK(vReplies.size() == 4);
+   if (vReplies.size() == 4) {
+      CHECK(vReplies[0] == "OFFSET:0");
+      CHECK(vReplies[1] == "NAK:0");
+      CHECK(vReplies[2] == "ACK:10");
+      CHECK(vReplies[3].rfind("OK:10 ", 0) == 0);
+   }
+   CHECK(hostFs().mapFiles["/small.bin"] == strData);
+}
+
+int main() {
+   setvbuf(stdout, nullptr, _IOLBF, 0);
+   std::mt19937 rng(1);
+   std::string strData(300 * 1024 + 123, '\0');
+   for (auto& c : strData) c = (char)rng();
+   writeLocal("/tmp/xfer_src.bin", strData);
+
+   WiFiServer server(0);
+   server.begin();
+   std::string strTool = "python3 " + toolPath() + " -p " + std::to_string(server.port()) + " 127.0.0.1 ";
+   bool bOk;
+
+   printf("upload\n");
+   serve(server, strTool + "put /tmp/xfer_src.bin /data.bin", bOk);
+   CHECK(bOk);
+   CHECK(hostFs().mapFiles["/data.bin"] == strData);
+
+   printf("upload, resumed after 100 kB\n");
+   CxCrc32 crc;
+   crc.write((const uint8_t*)strData.data(), strData.size());
+   char szTmp[20];
+   snprintf(szTmp, sizeof(szTmp), "/.part_%08x", crc.get());
+   hostFs().mapFiles[szTmp] = strData.substr(0, 100 * 1024);
+   hostFs().mapFiles.erase("/data.bin");
+   serve(server, strTool + "put /tmp/xfer_src.bin /data.bin", bOk);
+   CHECK(bOk);
+   CHECK(hostFs().mapFiles["/data.bin"] == strData);
+   CHECK(!hostFs().mapFiles.count(szTmp));
+
+   printf("download\n");
+   remove("/tmp/xfer_dst.bin");
+   serve(server, strTool + "get /data.bin /tmp/xfer_dst.bin", bOk);
+   CHECK(bOk);
+   CHECK(readLocal("/tmp/xfer_dst.bin") == strData);
+
+   printf("download, resumed after 200 kB\n");
+   writeLocal("/tmp/xfer_dst.bin", strData.substr(0, 200 * 1024));
+   serve(server, strTool + "get /data.bin /tmp/xfer_dst.bin --resume", bOk);
+   CHECK(bOk);
+   CHECK(readLocal("/tmp/xfer_dst.bin") == strData);
+
+   printf("missing file\n");
+   serve(server, strTool + "get /missing.bin /tmp/xfer_dst.bin 2>/dev/null", bOk);
+   CHECK(!bOk);
+
+   testBlockPastSize(server);
+
+   remove("/tmp/xfer_src.bin");
+   remove("/tmp/xfer_dst.bin");
+   return hostResult();
+}
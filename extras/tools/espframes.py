@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+# espframes.py - Load generator for the framed remote session of the ESP console (#!frames).
+#
+# Usage:
+#   ./espframes.py [-p PORT] [-n COUNT] [-w WINDOW] HOST COMMAND...
+#
+# Description:
+#   - Opens a framed session and sends COUNT requests, the COMMANDs in turn. Up to WINDOW requests are
+#     sent before their responses are read (pipelining).
+#   - Each response is checked: the id must match the request in order, exactly <length> bytes of output
+#     must follow the header.
+#   - Reports the requests per second, the output throughput and the latency (median, max) of the
+#     responses. Exits with 1, if a response was wrong.
+#
+# Requirements:
+#   - Python 3, no further modules
+#
+# Example:
+#   ./extras/tools/espframes.py -n 500 -w 16 192.168.1.20 heap uptime "ls -l"
+
+import argparse
+import socket
+import sys
+import time
+
+
+class FrameSocket:
+    """Socket with line and exact-length reads."""
+
+    def __init__(self, sock):
+        self.sock = sock
+        self.buf = b""
+
+    def _fill(self):
+        data = self.sock.recv(65536)
+        if not data:
+            raise ConnectionError("connection closed by the device")
+        self.buf += data
+
+    def readline(self):
+        while b"\n" not in self.buf:
+            self._fill()
+        line, self.buf = self.buf.split(b"\n", 1)
+        return line.decode(errors="replace").strip()
+
+    def read(self, n):
+        while len(self.buf) < n:
+            self._fill()
+        data, self.buf = self.buf[:n], self.buf[n:]
+        return data
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Load generator for the framed session of the ESP console")
+    parser.add_argument("-p", "--port", type=int, default=8266, help="console port (default 8266)")
+    parser.add_argument("-n", "--count", type=int, default=100, help="requests to send (default 100)")
+    parser.add_argument("-w", "--window", type=int, default=8, help="requests in flight (default 8)")
+    parser.add_argument("host")
+    parser.add_argument("commands", nargs="+")
+    args = parser.parse_args()
+
+    sock = socket.create_connection((args.host, args.port), timeout=10)
+    sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+    conn = FrameSocket(sock)
+    sock.sendall(b"#!frames\n")
+    reply = conn.readline()
+    if not reply.endswith("ok"):
+        sys.exit(f"no framed session: {reply}")
+
+    start = time.monotonic()
+    sent_at = {}
+    latencies = []
+    output = 0
+    truncated = 0
+    errors = 0
+    sent = 0
+    received = 0
+
+    while received < args.count:
+        while sent < args.count and sent - received < args.window:
+            cmd = args.commands[sent % len(args.commands)]
+            sock.sendall(f"{sent} {cmd}\n".encode())
+            sent_at[sent] = time.monotonic()
+            sent += 1
+
+        fields = conn.readline().split()
+        if len(fields) < 3 or int(fields[0]) != received:
+            print(f"unexpected response header {fields} for request {received}", file=sys.stderr)
+            errors += 1
+            break
+        data = conn.read(int(fields[2]))
+        output += len(data)
+        truncated += len(fields) > 3 and fields[3] == "+"
+        latencies.append(time.monotonic() - sent_at.pop(received))
+        received += 1
+
+    seconds = time.monotonic() - start
+    sock.close()
+    latencies.sort()
+    median = latencies[len(latencies) // 2] * 1000 if latencies else 0
+    worst = latencies[-1] * 1000 if latencies else 0
+    rate = received / seconds if seconds > 0 else 0
+    print(f"{received} requests in {seconds:.2f} s, {rate:.0f} req/s, {output} bytes output "
+          f"({output / seconds / 1024 if seconds > 0 else 0:.1f} kB/s, {truncated} truncated), "
+          f"latency median {median:.2f} ms, max {worst:.2f} ms, window {args.window}")
+    sys.exit(1 if errors else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,172 @@
+#!/usr/bin/env python3
+# espxfer.py - Host client for the file transfer of the ESP console ($UPLOAD$, $DOWNLOAD$).
+#
+# Usage:
+#   ./espxfer.py [-p PORT] [-w WINDOW] HOST put LOCAL [REMOTE]
+#   ./espxfer.py [-p PORT] HOST get REMOTE [LOCAL] [--resume]
+#
+# Description:
+#   - put: sends the file in blocks of 1 kB, each with its CRC32. Up to WINDOW blocks are sent before
+#     their acknowledgement (pipelining). A NAK restarts at the offset requested by the device. An
+#     interrupted upload of the same content resumes at the offset reported by the device.
+#   - get: receives the file from the offset (--resume continues a partial local file) and verifies
+#     the CRC32 of the whole file.
+#   - The throughput (payload bytes / time from the header to the final reply) is reported at the end.
+#
+# Requirements:
+#   - Python 3, no further modules
+#
+# Example:
+#   ./extras/tools/espxfer.py 192.168.1.20 put html/console.html /console.html
+
+import argparse
+import os
+import socket
+import sys
+import time
+import zlib
+
+BLOCK_SIZE = 1024
+
+
+class LineSocket:
+    """Socket with line and exact-length reads."""
+
+    def __init__(self, sock):
+        self.sock = sock
+        self.buf = b""
+
+    def _fill(self):
+        data = self.sock.recv(4096)
+        if not data:
+            raise ConnectionError("connection closed by the device")
+        self.buf += data
+
+    def readline(self):
+        while b"\n" not in self.buf:
+            self._fill()
+        line, self.buf = self.buf.split(b"\n", 1)
+        return line.decode(errors="replace").strip()
+
+    def read(self, n):
+        while len(self.buf) < n:
+            self._fill()
+        data, self.buf = self.buf[:n], self.buf[n:]
+        return data
+
+    def read_some(self, n):
+        if not self.buf:
+            self._fill()
+        data, self.buf = self.buf[:n], self.buf[n:]
+        return data
+
+
+def connect(host, port, command):
+    sock = socket.create_connection((host, port), timeout=10)
+    sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+    sock.sendall(command.encode() + b"\n")
+    return LineSocket(sock)
+
+
+def report(direction, nbytes, resumed, seconds, extra=""):
+    rate = nbytes / seconds / 1024 if seconds > 0 else 0
+    print(f"{direction}: {nbytes} bytes ({resumed} resumed) in {seconds:.2f} s, {rate:.1f} kB/s{extra}")
+
+
+def put(args):
+    with open(args.local, "rb") as f:
+        data = f.read()
+    remote = args.remote or "/" + os.path.basename(args.local)
+    crc = zlib.crc32(data) & 0xFFFFFFFF
+
+    conn = connect(args.host, args.port, "$UPLOAD$")
+    start = time.monotonic()
+    conn.sock.sendall(f"PUT:{remote} SIZE:{len(data)} CRC:{crc:08x}\n".encode())
+
+    reply = conn.readline()
+    if not reply.startswith("OFFSET:"):
+        sys.exit(f"upload rejected: {reply}")
+    offset = int(reply[7:])
+    resumed = offset
+    sent = offset        # next block to send
+    acked = offset       # acknowledged bytes
+    naks = 0
+    blocks = 0
+
+    while True:
+        # keep the window filled
+        while sent < len(data) and sent - acked < args.window * BLOCK_SIZE:
+            blk = data[sent:sent + BLOCK_SIZE]
+            conn.sock.sendall(f"BLK:{sent} {len(blk)} {zlib.crc32(blk) & 0xFFFFFFFF:08x}\n".encode() + blk)
+            sent += len(blk)
+            blocks += 1
+
+        reply = conn.readline()
+        if reply.startswith("ACK:"):
+            acked = int(reply[4:])
+        elif reply.startswith("NAK:"):
+            naks += 1
+            acked = sent = int(reply[4:])
+        elif reply.startswith("OK:"):
+            break
+        else:
+            sys.exit(f"upload failed: {reply}")
+
+    report(f"put {remote}", len(data) - resumed, resumed, time.monotonic() - start, f", {blocks} blocks, {naks} NAK, window {args.window}")
+
+
+def get(args):
+    local = args.local or os.path.basename(args.remote)
+    offset = os.path.getsize(local) if args.resume and os.path.exists(local) else 0
+
+    conn = connect(args.host, args.port, "$DOWNLOAD$")
+    start = time.monotonic()
+    conn.sock.sendall(f"GET {args.remote} OFFSET:{offset}\n".encode())
+
+    reply = conn.readline()
+    if not reply.startswith("SIZE:"):
+        sys.exit(f"download failed: {reply}")
+    fields = dict(item.split(":", 1) for item in reply.replace("SIZE: ", "SIZE:").split())
+    size = int(fields["SIZE"])
+    crc = int(fields["CRC"], 16)
+    offset = int(fields.get("OFFSET", "0"))
+
+    with open(local, "r+b" if offset else "wb") as f:
+        f.truncate(offset)
+        f.seek(offset)
+        received = offset
+        while received < size:
+            chunk = conn.read_some(size - received)
+            f.write(chunk)
+            received += len(chunk)
+    seconds = time.monotonic() - start
+
+    with open(local, "rb") as f:
+        if zlib.crc32(f.read()) & 0xFFFFFFFF != crc:
+            sys.exit(f"CRC error in {local}")
+    report(f"get {args.remote}", size - offset, offset, seconds)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="File transfer with the ESP console")
+    parser.add_argument("-p", "--port", type=int, default=8266, help="console port (default 8266)")
+    parser.add_argument("-w", "--window", type=int, default=4, help="blocks in flight for uploads (default 4)")
+    parser.add_argument("host")
+    sub = parser.add_subparsers(dest="cmd", required=True)
+    p = sub.add_parser("put", help="upload a file")
+    p.add_argument("local")
+    p.add_argument("remote", nargs="?")
+    g = sub.add_parser("get", help="download a file")
+    g.add_argument("remote")
+    g.add_argument("local", nargs="?")
+    g.add_argument("--resume", action="store_true", help="continue a partial local file")
+    args = parser.parse_args()
+
+    try:
+        put(args) if args.cmd == "put" else get(args)
+    except (OSError, ConnectionError) as e:
+        sys.exit(f"error: {e} (an interrupted upload resumes, if started again)")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,3 @@
+var hostname = "{{hostname}}";
+var scanning = {{scanning}};
+var networks = [{{networks}}];
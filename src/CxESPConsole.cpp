@@ -11,6 +11,7 @@
 
 CxESPHeapTracker g_Heap(51000); // init as early as possible...
 CxESPStackTracker g_Stack;
+CxESPBootProfiler g_Boot;
 
 uint8_t CxESPConsole::__nUsers = 0;
 std::map<String, std::unique_ptr<CxCapability>> _mapCapInstances;  // Stores created instances
@@ -98,6 +99,7 @@ uint8_t CxESPConsole::processCmd(const char* cmd, uint8_t nClient) {
 }
 
 void CxESPConsoleMaster::begin() {
+   CxESPBootPhase phase("begin");
    info(F("==== MASTER ===="));
    
    ::readSettings(_settings);
@@ -143,6 +145,7 @@ bool CxESPConsole::hasFS() {
 void CxESPConsoleClient::begin() {
    CxESPConsole& con = CxESPConsoleMaster::getInstance();
    con.setUsrLogLevel(LOGLEVEL_OFF);
+   probeTerminal(); // plain output, until the peer reports to be a terminal
    info(F("==== CLIENT ===="));
    CxESPConsole::begin();
    if (con.isSafeMode()) {
@@ -199,12 +202,23 @@ void CxESPConsole::__handleConsoleInputs() {
          _nStateEscSequence = 0;
       } else if (_nStateEscSequence == 2 && c == 'D') { // Cursor left
          _nStateEscSequence = 0;
+      } else if (_nStateEscSequence == 2 && (isdigit(c) || c == ';')) { // parameter of the sequence
+         // wait for the final byte
+      } else if (_nStateEscSequence == 2 && c == 'n') { // device status report, the peer is a terminal
+         _nStateEscSequence = 0;
+         if (_bTermProbe) {
+            _bTermProbe = false;
+            if (!isSessionTerminal()) {
+               setTerminal(true);
+               _redrawCmd();
+            }
+         }
       }  else if (_nStateEscSequence == 2) { // Cursor down
          _nStateEscSequence = 0;
       } else if (_iCmdBufferIndex < _nCmdBufferLen - 1) { // Zeichen hinzufügen
          _pszCmdBuffer[_iCmdBufferIndex++] = c;
          _pszCmdBuffer[_iCmdBufferIndex] = '\0'; // Null-Terminierung
-         print(c); // Zeichen anzeigen
+         if (isTerminal()) print(c); // Zeichen anzeigen
       }
    }
 }
@@ -216,8 +230,13 @@ void CxESPConsole::_abortClient() {
       println("No exit on a serial connection.");
       return;
    }
+   if (!__bIsTcpClient) {
+      // other transports are closed by their server, once the session is detached (see isClientAttached())
+      CxESPConsoleMaster::getInstance().requestDetach();
+      return;
+   }
 #ifdef ARDUINO
-   WiFiClient* client = reinterpret_cast<WiFiClient*>(__ioStream);
+   WiFiClient* client = reinterpret_cast<WiFiClient*>(__outQueue.getStream());
    
    if (client && client->connected()) {
       client->abort(); // abort WiFiClient
@@ -228,6 +247,8 @@ void CxESPConsole::_abortClient() {
 
 void CxESPConsole::loop() {
    __handleConsoleInputs();
+   if (_bTermProbe && (uint32_t)millis() - _nTermProbeStart > _nTERM_PROBE_MS) _bTermProbe = false; // no report, plain peer
+   __outQueue.loop(); // send the queued output, as far as possible without blocking
    __totalCPU.measureCPULoad();
 }
 
@@ -271,18 +292,38 @@ void CxESPConsoleMaster::loop() {
             }
             
             if (commandReceived) {
+               if (strcmp(commandBuffer, CxFramedSession::szMAGIC) == 0) {
+                  if (_framed.isActive()) {
+                     client.println(F("#!busy"));
+                     client.stop();
+                     error(F("framed session already active"));
+                  } else {
+                     info(F("framed session started"));
+                     _framed.begin(client);
+                  }
+                  break;
+               }
                info(F("remote command received: %s"), commandBuffer);
-               processCmd(client, commandBuffer, 1);
-               client.stop();
-               
-               info(F("Client disconnected after command."));
+               // single commands come from scripts, send plain text
+               CxEscFilterStream plain(&client);
+               plain.setEnabled(true);
+               _pRemoteClient = &client;
+               processCmd(plain, commandBuffer, 1);
+               _pRemoteClient = nullptr;
+               if (_bRemoteClientTaken) {
+                  _bRemoteClientTaken = false;
+                  info(F("Client taken over by the command."));
+               } else {
+                  client.stop();
+                  info(F("Client disconnected after command."));
+               }
                break;
             }
          }
       }
       
-      // start an interactive console
-      if (!commandReceived && (!_activeClient || !_activeClient.connected())) {
+      // start an interactive console, unless a session is attached on another transport
+      if (!commandReceived && !_pAttachedStream && (!_activeClient || !_activeClient.connected())) {
          if (client) {
             info(F("Start interactive console"));
             _activeClient = client; // Aktiven Client aktualisieren
@@ -305,6 +346,12 @@ void CxESPConsoleMaster::loop() {
       }
       
       if (__espConsoleWiFiClient) __espConsoleWiFiClient->loop(); // Befehle in der Hauptschleife abarbeiten
+      
+      if (!_framed.loop()) {
+         info(F("framed session closed after %" PRIu32 " commands (%" PRIu32 " bytes, max. %" PRIu32 " bytes and %" PRIu32 " commands per loop)"), _framed.getCommands(), _framed.getBytes(), _framed.getMaxLoopBytes(), _framed.getMaxLoopCommands());
+      }
+   } else if (__espConsoleWiFiClient) {
+      __espConsoleWiFiClient->loop(); // attached session, the console server is not running
    }
 #endif
 #endif
@@ -321,6 +368,36 @@ void CxESPConsoleMaster::loop() {
 }
 
 
+#ifndef ESP_CONSOLE_NOWIFI
+bool CxESPConsoleMaster::attachClient(Stream& stream) {
+   if (__espConsoleWiFiClient) return false;
+   
+   info(F("Start interactive console (attached)"));
+   __espConsoleWiFiClient = new CxESPConsoleClient(stream, getAppName(), getAppVer());
+   if (!__espConsoleWiFiClient) {
+      error(F("*** error: creating the attached console failed!"));
+      return false;
+   }
+   _pAttachedStream = &stream;
+   __espConsoleWiFiClient->setHostName(getHostName());
+   __espConsoleWiFiClient->setPromptClient(getPromptClient());
+   __espConsoleWiFiClient->begin();
+   g_Heap.update();
+   return true;
+}
+
+void CxESPConsoleMaster::detachClient(Stream& stream) {
+   if (_pAttachedStream != &stream) return;
+   info(F("Attached console closed."));
+   delete __espConsoleWiFiClient;
+   __espConsoleWiFiClient = nullptr;
+   _pAttachedStream = nullptr;
+   _bDetachRequested = false;
+   g_Heap.update();
+}
+
+#endif
+
 bool CxESPConsoleMaster::isHostAvailable(const char* szHost, int nPort) {
 #ifdef ARDUINO
    if (WiFi.status() == WL_CONNECTED && nPort > 0 && szHost && szHost[0] != '\0') { //Check WiFi connection status
@@ -436,6 +513,9 @@ void CxESPConsole::printLog(uint8_t level, uint32_t flag, const char *sz) {
       return;
    }
    
-   if (getUsrLogLevel() >= level) println(sz);
+   if (getUsrLogLevel() >= level) {
+      CxOutputQueue::LogScope log(strlen(sz) + 2); // logs are dropped first (whole lines), if the output is congested
+      println(sz);
+   }
    if (getLogLevel() >= level) print2LogServer(sz);
 }
@@ -19,11 +19,15 @@
 
 #include "../tools/CxESPHeapTracker.hpp"
 #include "../tools/CxESPStackTracker.hpp"
+#include "../tools/CxESPBootProfiler.hpp"
 #include "../tools/CxESPTime.hpp"
 #include "../tools/CxStrToken.hpp"
 #include "../tools/CxTimer.hpp"
 #include "../tools/CxPersistentBase.hpp"
 #include "../tools/CxTablePrinter.hpp"
+#include "../tools/CxFramedSession.hpp"
+#include "../tools/CxEscFilter.hpp"
+#include "../tools/CxOutputQueue.hpp"
 
 #ifdef ARDUINO
 #ifndef ESP_CONSOLE_NOWIFI
@@ -66,16 +70,34 @@ class CxESPConsoleBase : public Print, public CxPersistentBase {
    std::function<void(const char*, const char*)> _funcExecuteBatch;
    std::function<void(const char*, const char*)> _funcMan;
    std::function<uint8_t(const char*)> _funcProcessData;
+   std::function<void(const char*)> _funcFsChanged;
 
 protected:
    bool __bIsWiFiClient = false;
+   bool __bIsTcpClient = false;          // the stream of the session is a WiFiClient (remote sessions can use other transports)
    bool __bIsSafeMode = false;
    
-   Stream* __ioStream;                   // Pointer to the stream object (serial or WiFiClient)
+   static constexpr uint16_t _nOUTPUT_QUEUE = 512;
+   static constexpr uint16_t _nMAX_LOG_LINE = 128;     // log lines are formatted in 100 bytes (see _log())
+   
+   CxOutputQueue __outQueue;             // output of the session, sent as the stream takes it without blocking
+   CxEscFilterStream __escFilter;        // strips ESC sequences, if the peer is not a terminal
+   Stream* __ioStream;                   // Pointer to the stream object (session output or redirected)
+   
+#ifndef ESP_CONSOLE_NOWIFI
+   /// the stream of the session is the WiFiClient. The one of the ESP32 doesn't report its free space, the
+   /// queue asks the socket instead.
+   void __setTcpClient(WiFiClient& client) {
+      __bIsTcpClient = true;
+#ifdef ESP32
+      __outQueue.setFuncSpace([&client]() {return CxOutputQueue::socketSpace(client.fd());});
+#endif
+   }
+#endif
    
 public:
-   explicit CxESPConsoleBase(Stream& stream) : __ioStream(&stream), __bIsSafeMode(false), __bIsWiFiClient(false) {}
-   CxESPConsoleBase() : __ioStream(nullptr), __bIsSafeMode(false), __bIsWiFiClient(false) {}
+   explicit CxESPConsoleBase(Stream& stream) : __outQueue(&stream, _nOUTPUT_QUEUE), __escFilter(&__outQueue), __ioStream(&__escFilter), __bIsSafeMode(false), __bIsWiFiClient(false) {}
+   CxESPConsoleBase() : __outQueue(nullptr, 0), __escFilter(nullptr), __ioStream(nullptr), __bIsSafeMode(false), __bIsWiFiClient(false) {}
    
    virtual ~CxESPConsoleBase() {}
 
@@ -124,7 +146,24 @@ public:
       }
    }
    
-   void print2LogServer(const char* sz) {if (_funcPrint2logServer) _funcPrint2logServer(sz);}
+   void print2LogServer(const char* sz) {
+      if (!_funcPrint2logServer || !sz) return;
+      // log server and log file are never terminals, log lines are stripped on the stack
+      if (strchr(sz, 0x1B) || strchr(sz, '\r')) {
+         size_t nLen = strlen(sz);
+         if (nLen < _nMAX_LOG_LINE) {
+            char buf[_nMAX_LOG_LINE];
+            CxEscFilterStream::strip(buf, sz);
+            _funcPrint2logServer(buf);
+         } else {
+            String str(sz); // longer lines are not from the logging functions, rare
+            CxEscFilterStream::strip(str.begin());
+            _funcPrint2logServer(str.c_str());
+         }
+      } else {
+         _funcPrint2logServer(sz);
+      }
+   }
    void executeBatch(const char* sz, const char* label) {if (_funcExecuteBatch) _funcExecuteBatch(sz, label);}
    void executeBatch(Stream& stream, const char* sz, const char* label) {
       if (_funcExecuteBatch) {
@@ -136,6 +175,8 @@ public:
    }
    void man(const char* sz, const char* param = nullptr) {if (_funcMan) _funcMan(sz, param);}
    uint8_t processData(const char* data) {if (_funcProcessData) return _funcProcessData(data); else return EXIT_FAILURE;}
+   /// to be called after a file was written, renamed or removed without the file system capability
+   void fsChanged(const char* szPath) {if (_funcFsChanged) _funcFsChanged(szPath);}
    
    void setFuncPrintLog2Server(std::function<void(const char*)> f) {_funcPrint2logServer = f;}
    void clearFuncPrintLog2Server() {_funcPrint2logServer = nullptr;}
@@ -146,9 +187,17 @@ public:
    void clearFuncMan() {_funcMan = nullptr;}
    void setFuncProcessData(std::function<uint8_t(const char*)> f) {_funcProcessData = f;}
    void clearFuncProcessData() {_funcProcessData = nullptr;}
+   void setFuncFsChanged(std::function<void(const char*)> f) {_funcFsChanged = f;}
+   void clearFuncFsChanged() {_funcFsChanged = nullptr;}
    
    void setEcho(bool set) {_bEchoOn = set;}
    bool isEcho() {return _bEchoOn;}
+   
+   /// the peer of the session is a terminal (ESC sequences, prompt, echo), otherwise the output is plain text
+   void setTerminal(bool set) {__escFilter.setEnabled(!set);}
+   bool isSessionTerminal() {return !__escFilter.isEnabled();}
+   uint32_t getEscDropped() {return __escFilter.getDropped();}
+   CxOutputQueue& getOutputQueue() {return __outQueue;}
 
 };
 
@@ -175,6 +224,10 @@ class CxESPConsole : public CxESPConsoleBase, public CxESPTime, public CxProcess
    int _nCmdHistoryCount = 0;           // Actual number of command lines in the buffer
    int _iCmdHistoryIndex = -1;          // Acutal index of the command line buffer
    int _nStateEscSequence = 0;          // Actual ESC sequence state during input
+   bool _bTermProbe = false;            // Terminal query sent, waiting for the report
+   uint32_t _nTermProbeStart = 0;       // Time the terminal query was sent
+   static constexpr uint32_t _nTERM_PROBE_MS = 500; // Max. time for the report of a terminal
+   CxTablePrinter::e_format _eTableFormat = CxTablePrinter::e_format::text; // Output format of tables in this session
    
    bool _bWaitingForUsrResponseYN = false;   // Indicates an active (pending) user response
    void (*_cbUsrResponse)(bool) = nullptr; // Callback for the response answer
@@ -226,6 +279,7 @@ class CxESPConsole : public CxESPConsoleBase, public CxESPTime, public CxProcess
    }
    
    void _redrawCmd() {
+      if (!isTerminal()) return;
       prompt();
       print(_pszCmdBuffer); // output the command from the buffer
       print(" \b");        // position the cursor behind the command
@@ -302,7 +356,7 @@ public:
    /// Constructor needed to differenciate between serial and wifi clients to abort the the session, if needed, properly.
    ///
 #ifndef ESP_CONSOLE_NOWIFI
-   CxESPConsole(WiFiClient& wifiClient, const char* app = "", const char* ver = "") : CxESPConsole((Stream&)wifiClient, app, ver) {__bIsWiFiClient = true;}
+   CxESPConsole(WiFiClient& wifiClient, const char* app = "", const char* ver = "") : CxESPConsole((Stream&)wifiClient, app, ver) {__bIsWiFiClient = true; __setTcpClient(wifiClient);}
 #endif
    CxESPConsole(Stream& stream, const char* app = "", const char* ver = "")
    : CxESPConsoleBase(stream), CxESPTime(), _nCmdHistorySize(4), _szAppName(app), _szAppVer(ver), _strPrompt("") {
@@ -398,6 +452,7 @@ public:
    void prompt(bool bClient = false) {
       if (!bClient && !isPromptEnabled()) return;
       if (bClient && !isClientPromptEnabled()) return;
+      if (!isTerminal() && !isProbingTerminal()) return; // no prompt for scripts, a probed peer gets it at once
       
       print(ESC_CLEAR_LINE);
       String strPrompt = _strPrompt;
@@ -433,6 +488,46 @@ public:
    const char* getPromptClient() { return _strPromptClient.c_str();}
 
    bool isWiFiClient() {return __bIsWiFiClient;}
+   
+   /// true, if the actual output goes to a terminal. The output might be redirected, e.g. while a command of
+   /// the wifi client is processed by the master.
+   bool isTerminal() {
+      if (__ioStream == &__escFilter) return isSessionTerminal();
+      if (__espConsoleWiFiClient && __ioStream == __espConsoleWiFiClient->getStream()) return __espConsoleWiFiClient->isTerminal();
+      return false;
+   }
+   
+   /// output format of tables of the session, the actual output goes to (see isTerminal())
+   CxTablePrinter::e_format getTableFormat() {
+      if (__espConsoleWiFiClient && __ioStream == __espConsoleWiFiClient->getStream()) return __espConsoleWiFiClient->_eTableFormat;
+      return _eTableFormat;
+   }
+   void setTableFormat(CxTablePrinter::e_format set) {
+      if (__espConsoleWiFiClient && __ioStream == __espConsoleWiFiClient->getStream()) {
+         __espConsoleWiFiClient->_eTableFormat = set;
+      } else {
+         _eTableFormat = set;
+      }
+   }
+   
+   /// true, while the peer of the actual output is asked to be a terminal (see probeTerminal())
+   bool isProbingTerminal() {
+      if (__ioStream == &__escFilter) return _bTermProbe;
+      if (__espConsoleWiFiClient && __ioStream == __espConsoleWiFiClient->getStream()) return __espConsoleWiFiClient->isProbingTerminal();
+      return false;
+   }
+   
+   /// switches to plain output and asks the peer for its status. The prompt is shown plain meanwhile. A
+   /// terminal answers and the session switches to the terminal mode and redraws the prompt (see
+   /// __handleConsoleInputs()). Without an answer within _nTERM_PROBE_MS, the session stays plain.
+   void probeTerminal() {
+      setTerminal(false);
+      _bTermProbe = true;
+      _nTermProbeStart = (uint32_t)millis();
+      Stream* pStream = __escFilter.getStream();
+      if (pStream) pStream->print(F(ESC_DEVICE_STATUS));
+   }
+   bool isTermProbe() {return _bTermProbe;}
 
    void setHostName(const char* sz) {
       _strHostName = sz;
@@ -454,11 +549,13 @@ public:
 
    
    void printProgress(uint32_t actual, uint32_t max, const char* header, const char* unit) {
+      if (!isTerminal() && actual < max) return; // no redraw on plain output, final state only
       uint32_t progress = (actual * 100) / max;
       printf("\r\033[K%16s: %d%% (%d / %d %s)", header, progress, actual, max, unit);
    }
    
    void printProgressBar(uint32_t actual, uint32_t max, const char* header) {
+      if (!isTerminal() && actual < max) return;
       uint32_t progress = (actual * 100) / max;
       const uint8_t barWidth = 50; // Breite des Fortschrittsbalkens
       uint8_t pos = (progress * barWidth) / 100;
@@ -638,11 +735,13 @@ public:
    }
    
    void printVariables(Stream& stream) {
-      CxTablePrinter table(stream);
-      table.printHeader({"Name", "Value"}, {10, 40});
+      CxTablePrinter table(stream, getTableFormat());
+      table.printHeader({{F("Name"), 10}, {F("Value"), 40}});
       
       for (const auto& entry : _mapSetVariables) {
-         table.printRow({entry.first.c_str(), entry.second.c_str()});
+         table.cell(entry.first);
+         table.cell(entry.second);
+         table.endRow();
       }
       
    }
@@ -710,7 +809,9 @@ public:
 
 class CxESPConsoleClient : public CxESPConsole {
 public:
-   CxESPConsoleClient(WiFiClient& wifiClient, const char* app = "", const char* ver = "") : CxESPConsole((Stream&)wifiClient, app, ver) {__bIsWiFiClient = true;setUsrLogLevel(0);}
+   CxESPConsoleClient(WiFiClient& wifiClient, const char* app = "", const char* ver = "") : CxESPConsole((Stream&)wifiClient, app, ver) {__bIsWiFiClient = true; __setTcpClient(wifiClient);setUsrLogLevel(0);}
+   /// remote session on another transport (e.g. websocket)
+   CxESPConsoleClient(Stream& stream, const char* app = "", const char* ver = "") : CxESPConsole(stream, app, ver) {__bIsWiFiClient = true;setUsrLogLevel(0);}
 
    virtual void begin() override;
    
@@ -731,6 +832,20 @@ class CxESPConsoleMaster : public CxESPConsole {
    WiFiServer* _pWiFiServer = nullptr;
    WiFiClient _activeClient;
    
+   /// framed remote session (opt-in by the first line "#!frames"), see CxFramedSession
+   CxFramedSession _framed{[this](Stream& out, const char* szCmd) {
+      processCmd(out, szCmd, 1);
+      return getExitValue();
+   }};
+   
+   /// stream of an interactive session on another transport, see attachClient()
+   Stream* _pAttachedStream = nullptr;
+   bool _bDetachRequested = false;
+   
+   /// connection of the single remote command in process, see takeRemoteClient()
+   WiFiClient* _pRemoteClient = nullptr;
+   bool _bRemoteClientTaken = false;
+   
    bool _bAPMode = false;
 #endif
    
@@ -761,6 +876,23 @@ public:
 
    virtual void begin() override;
    virtual void loop() override;
+   
+#ifndef ESP_CONSOLE_NOWIFI
+   /// starts the interactive remote session on the stream of another transport (e.g. websocket). There is only
+   /// one remote session, false if it is in use.
+   bool attachClient(Stream& stream);
+   void detachClient(Stream& stream);
+   /// false, once the session shall end (e.g. exit), the server then closes it and calls detachClient()
+   bool isClientAttached(Stream& stream) {return _pAttachedStream == &stream && !_bDetachRequested;}
+   void requestDetach() {if (_pAttachedStream) _bDetachRequested = true;}
+   
+   /// takes over the connection of the single remote command in process (e.g. a file transfer continued in the
+   /// loop), the connection is not closed after the command. nullptr, if the command is not a remote command.
+   WiFiClient* takeRemoteClient() {
+      if (_pRemoteClient) _bRemoteClientTaken = true;
+      return _pRemoteClient;
+   }
+#endif
 
    // Register constructor method (Prevent duplicates)
    bool regCap(const char* name, std::unique_ptr<CxCapability> (*constructor)(const char*)) {
@@ -810,11 +942,15 @@ public:
       auto it = _mapCapRegistry.find(name);
       if (it != _mapCapRegistry.end()) {
          size_t mem = g_Heap.available(true); // force update
+         uint8_t nPhase = g_Boot.start("new", name);
          std::unique_ptr<CxCapability> instance = it->second(name); // could be improved?
+         g_Boot.stop(nPhase);
          if (instance) {
             _mapCapInstances[name] = std::move(instance); // don't use instance any more after std::move !!
             _mapCapInstances[name]->setIoStream(*__ioStream);
+            nPhase = g_Boot.start("setup", name);
             _mapCapInstances[name]->setup();
+            g_Boot.stop(nPhase);
             size_t mem2 = g_Heap.available(true); // force update
             if (mem2 < mem) {
                print(F("Capability '" ESC_ATTR_BOLD)); print(name); print(F(ESC_ATTR_RESET "' loaded. " ESC_ATTR_BOLD)); print(mem - mem2); println(F(ESC_ATTR_RESET " bytes allocated."));
@@ -858,7 +994,7 @@ public:
    
    // Print all registered constructors
    void listCap() {
-      CxTablePrinter table(*__ioStream);
+      CxTablePrinter table(*__ioStream, getTableFormat());
       table.printHeader({F("Cap"), F("Loaded"), F("Locked"), F("Memory"), F("Commands")}, {6, 6, 6, 6, 8});
       for (const auto& entry : _mapCapRegistry) {
          table.printRow({entry.first.c_str(), _mapCapInstances.find(entry.first) != _mapCapInstances.end() ? "yes" : "no", _mapCapInstances[entry.first].get()->isLocked() ? "yes" : "no", _mapCapInstances[entry.first].get()->getMemAllocation() != INVALID_INT32 ? String(_mapCapInstances[entry.first].get()->getMemAllocation()).c_str() : "", String(_mapCapInstances[entry.first].get()->getCommandsCount()).c_str()});
@@ -867,6 +1003,20 @@ public:
    
    // process (loop) statistics
    void printPs() {
+      if (getTableFormat() != CxTablePrinter::e_format::text) {
+         CxTablePrinter table(*__ioStream, getTableFormat());
+         table.printHeader({F("Name"), F("Cmd"), F("Time"), F("Load"), F("Avg")}, {});
+         table.printRow({"sys", "*", String(__sysCPU.looptime()), String(__sysCPU.load(), 2), String(__sysCPU.avgload(), 2)});
+         table.printRow({"cons", "loop", String(looptime()), String(load(), 2), String(avgload(), 2)});
+         for (const auto& entry : _mapCapInstances) {
+            CxCapability* pCap = entry.second.get();
+            table.printRow({entry.first, "loop", String(pCap->looptime()), String(pCap->load(), 2), String(pCap->avgload(), 2)});
+         }
+         table.printRow({"total", "*", String(__totalCPU.looptime()), String(__totalCPU.load(), 2), String(__totalCPU.avgload(), 2)});
+         table.printFooter();
+         setOutputVariable(__totalCPU.looptime());
+         return;
+      }
       println(F(ESC_ATTR_BOLD "Name     Cmd  Time Load Avg" ESC_ATTR_RESET));
       printf( "%-8s ", "sys");
       print(F("*    "));
@@ -0,0 +1,172 @@
+// generated by build_html.sh from the files in html/, do not edit.
+
+#ifndef CxHtmlAssets_h
+#define CxHtmlAssets_h
+
+struct CxHtmlAsset {
+   const char* szPath;
+   const char* szMime;
+   const uint8_t* pData;   // PROGMEM
+   uint32_t nLength;
+   const char* szETag;     // nullptr for templates
+   bool bGzip;
+};
+
+static const uint8_t html_ap_html[] PROGMEM = {
+   0x1f,0x8b,0x08,0x00,0x00,0x00,0x00,0x00,0x02,0x03,0x9d,0x56,0x6d,0x73,0xe3,0x34,
+   0x10,0xfe,0xde,0x5f,0xa1,0x53,0x87,0x9b,0x04,0x6a,0x3b,0xb9,0x6b,0xa1,0xb8,0x76,
+   0x18,0xae,0xf4,0x06,0x66,0x80,0xeb,0x4c,0xc3,0x30,0x7c,0x54,0x2c,0x39,0xd6,0x9d,
+   0x2c,0x19,0x49,0xce,0x0b,0x4c,0xff,0x3b,0x2b,0x39,0x4d,0x1c,0xd7,0x6e,0x3a,0xa4,
+   0x49,0x63,0xed,0xae,0xf6,0xe5,0xd9,0xb7,0x24,0x6f,0x7e,0xfa,0x74,0x3b,0xff,0xeb,
+   0xfe,0x0e,0x15,0xb6,0x14,0xb3,0xb3,0xc4,0x7d,0x21,0x41,0xe4,0x32,0xc5,0x4c,0xe2,
+   0xd9,0x19,0x42,0x28,0x29,0x18,0xa1,0xfe,0xc9,0x1d,0x4a,0x66,0x09,0xca,0x0a,0xa2,
+   0x0d,0xb3,0x29,0xfe,0x63,0xfe,0x31,0xb8,0xc6,0x4f,0xcc,0x3d,0x5f,0x92,0x92,0xa5,
+   0x78,0xc5,0xd9,0xba,0x52,0xda,0x62,0x94,0x29,0x69,0x99,0x04,0xf9,0x35,0xa7,0xb6,
+   0x48,0x29,0x5b,0xf1,0x8c,0x05,0xfe,0x70,0x81,0xb8,0xe4,0x96,0x13,0x11,0x98,0x8c,
+   0x08,0x96,0x4e,0xc3,0x49,0x5b,0x9f,0x53,0x69,0xb9,0x15,0x6c,0xf6,0x27,0xff,0xc8,
+   0xd1,0x03,0xb3,0x75,0x95,0x44,0x0d,0xe5,0x58,0xca,0xd8,0x6d,0x97,0x06,0xaf,0x85,
+   0xa2,0x5b,0xf4,0x6f,0x97,0x0a,0xaf,0x1c,0x5c,0x0a,0x72,0x52,0x72,0xb1,0x8d,0xd1,
+   0x8f,0x1a,0x1c,0xb8,0x40,0x86,0x48,0x13,0x18,0xa6,0x79,0x7e,0xd3,0x73,0x63,0x41,
+   0xb2,0x2f,0x4b,0xad,0x6a,0x49,0x83,0x4c,0x09,0xa5,0x63,0x74,0x9e,0x5f,0xc2,0xdf,
+   0xf7,0x7d,0xc2,0x25,0xd1,0x4b,0x2e,0x63,0x34,0xe9,0x63,0x56,0x84,0x52,0x2e,0x97,
+   0x03,0x5c,0xca,0x4d,0x25,0x08,0x78,0x95,0x0b,0xb6,0xe9,0x13,0xf8,0x5c,0x1b,0xcb,
+   0xf3,0x6d,0xb0,0x43,0x35,0x46,0x19,0xfc,0x67,0xba,0x4f,0x94,0x08,0xbe,0x94,0x01,
+   0xb7,0xac,0x34,0x2f,0x89,0x15,0x8c,0x2f,0x0b,0x50,0x34,0x9d,0x4c,0x56,0xc5,0x33,
+   0x81,0xc7,0x2e,0x21,0x74,0x96,0x09,0x97,0x4c,0xf7,0x42,0x6b,0xd9,0xc6,0x06,0xde,
+   0xf2,0x4b,0x36,0x0f,0x70,0xc6,0x68,0x5d,0x80,0x8b,0xbd,0x42,0x4a,0x53,0xa6,0x03,
+   0x4d,0x28,0xaf,0x8d,0xf3,0xaf,0xda,0xbc,0x08,0xe8,0xbb,0x01,0x81,0x85,0xda,0x04,
+   0xa6,0x20,0x54,0xad,0x01,0x74,0x74,0x59,0x6d,0xd0,0x35,0x7c,0xf4,0x72,0x41,0x46,
+   0x93,0x0b,0xb4,0x7b,0x87,0xef,0xc6,0x7d,0x77,0x7d,0x99,0xc6,0xe8,0xfd,0xa4,0x4f,
+   0xf7,0x33,0x6c,0x8a,0x69,0x2f,0x26,0x4d,0x3d,0x04,0x0b,0x65,0xad,0x2a,0x87,0xfd,
+   0xf4,0x55,0x69,0xf8,0x3f,0x0c,0x44,0x2e,0x5f,0x63,0x2e,0x57,0xba,0xec,0x35,0x78,
+   0xb2,0x8a,0x1c,0x3d,0xa0,0x5c,0xb3,0xcc,0x72,0xe5,0x32,0xa5,0x44,0x5d,0xca,0xd3,
+   0x16,0x05,0x59,0x30,0xf1,0x9a,0x18,0xaf,0xfa,0x43,0x6c,0x57,0x87,0x60,0xb9,0x3d,
+   0x6d,0xd1,0x30,0x01,0x4e,0xba,0x41,0x51,0xd5,0xf6,0x35,0x96,0xa7,0x57,0x27,0xca,
+   0xe4,0x7a,0xa8,0x4a,0x5c,0xb5,0xc1,0x7d,0xa8,0x0d,0xa3,0x04,0xa7,0xe8,0x3c,0xcb,
+   0xb2,0x57,0xd4,0xe5,0x80,0xbd,0x5d,0xe5,0x40,0x57,0x7d,0x75,0x3a,0xca,0x45,0x0d,
+   0xce,0xcb,0xde,0xf0,0x7a,0x26,0xcf,0x64,0xf2,0xdd,0x22,0xef,0x1d,0x53,0x3b,0x89,
+   0xc1,0x96,0xda,0x83,0x30,0x9d,0xbc,0x8c,0x82,0x54,0x92,0xfd,0xff,0xd8,0xb3,0x5a,
+   0x1b,0xe7,0x47,0xa5,0x78,0xef,0x04,0x18,0x88,0x3f,0x2e,0xd4,0x6a,0x60,0xac,0xf4,
+   0xa2,0x70,0xf5,0xed,0xe2,0xfd,0x09,0xdd,0x49,0x74,0x58,0x0d,0x49,0xb4,0x5f,0x66,
+   0x89,0x5b,0x0d,0xfb,0xb5,0x46,0xf9,0x0a,0x65,0x82,0x18,0x93,0xe2,0xfd,0x70,0x3b,
+   0xda,0x6b,0xc5,0xf4,0x68,0x03,0xc1,0xb1,0xc5,0xac,0x10,0xa7,0x29,0x2e,0x94,0xb1,
+   0x78,0x96,0x44,0x55,0x9b,0xe5,0x1b,0x94,0xf8,0x1e,0x4b,0x71,0x04,0xba,0x25,0xd4,
+   0x32,0x46,0xb0,0x26,0x0b,0x05,0x77,0xee,0x3f,0x3d,0xcc,0xbb,0xfb,0xae,0xe9,0x30,
+   0xb8,0x98,0x62,0x63,0x38,0xc5,0x8d,0xe1,0xdf,0x99,0x5d,0x2b,0xfd,0x25,0x4e,0x22,
+   0xcf,0xef,0x6e,0x3f,0xdf,0x23,0xde,0x0d,0x7f,0x67,0xb7,0x82,0x9b,0x67,0xcd,0xfe,
+   0xae,0xa1,0xd1,0xe9,0xb3,0xed,0x98,0xa8,0xca,0x39,0x86,0x56,0x44,0xd4,0x20,0x8d,
+   0x67,0x0f,0x19,0x91,0x12,0xaa,0x23,0x0c,0xc3,0x24,0x6a,0x98,0xb3,0x2e,0x98,0xde,
+   0xd2,0xb0,0xcb,0x15,0x80,0x08,0x8e,0x82,0xdb,0xf7,0xbb,0xa7,0x01,0x97,0x9b,0x76,
+   0xb6,0xdb,0x8a,0xb5,0x2e,0xf9,0x08,0x0e,0xa7,0x26,0x8a,0xc3,0x79,0x38,0x92,0x5d,
+   0xfb,0x34,0xea,0x4c,0xbd,0x28,0x39,0xe4,0xe2,0xb6,0x81,0x3b,0x89,0x1a,0x6e,0x3b,
+   0x2f,0x91,0x4b,0xcc,0x51,0x0e,0x67,0x09,0xf1,0xd6,0x21,0x47,0xd0,0xfc,0x0c,0xa3,
+   0x42,0xb3,0x3c,0xc5,0xe7,0x5e,0x8d,0xa3,0x24,0x11,0x69,0x67,0x37,0x89,0xa0,0x68,
+   0xf6,0x07,0x93,0x69,0x5e,0x59,0x64,0x74,0x06,0x69,0xa6,0xc4,0x92,0xf0,0xb3,0x71,
+   0xc5,0xd0,0xd0,0x3b,0x62,0x2d,0xbb,0x54,0x65,0x75,0x09,0x4b,0x32,0x5c,0x32,0x7b,
+   0x27,0x98,0x7b,0xfc,0xb0,0xfd,0x85,0x8e,0x9a,0x6a,0x1a,0x87,0x6e,0x5c,0xde,0x36,
+   0x8b,0x1e,0xa5,0xc8,0x11,0x1d,0x26,0x37,0xaf,0x50,0xf0,0x14,0xc7,0x38,0x74,0x81,
+   0xc0,0x65,0x5c,0x58,0x5b,0xc5,0x51,0x84,0xd1,0x37,0x48,0xa8,0x8c,0xb8,0xec,0x86,
+   0x4f,0x1a,0x81,0x86,0xe3,0xeb,0x69,0x84,0x5b,0xaa,0x57,0x44,0xbb,0xe1,0x0b,0x57,
+   0x07,0x8d,0xf8,0x02,0x6b,0xaf,0x4d,0x9e,0xa3,0x91,0x6c,0x4a,0xd5,0x84,0x82,0xc9,
+   0xa5,0x2d,0xc6,0x4e,0x49,0xc8,0x21,0x15,0xfa,0xe7,0xf9,0x6f,0xbf,0x3a,0x4f,0xda,
+   0x56,0xf6,0xd2,0x90,0x91,0x3b,0x92,0x15,0xa3,0xbc,0x96,0xbe,0x5f,0x46,0x72,0xdc,
+   0x19,0x04,0xce,0x21,0xa8,0xca,0xb6,0x43,0x99,0x66,0xc4,0xb2,0x9d,0x4f,0x23,0xdc,
+   0xd4,0x2c,0xee,0x2c,0x72,0xa0,0x86,0xbe,0xc6,0xe1,0xa6,0x0c,0xcd,0x73,0xe6,0x31,
+   0xca,0x20,0xe2,0xe0,0x40,0xa3,0x07,0xd8,0x52,0x44,0xc4,0xc8,0x21,0x26,0x43,0xed,
+   0x89,0xf4,0x43,0x39,0x76,0xe7,0x91,0x0c,0x15,0xfa,0x01,0x42,0x41,0x8e,0xff,0x75,
+   0xd7,0xa4,0x0b,0x99,0x54,0x15,0x93,0xf4,0xb6,0xe0,0x82,0x8e,0xc0,0x4a,0x5b,0xe2,
+   0xb1,0x8b,0xd9,0x9b,0x0e,0x68,0xe8,0xed,0x5b,0x64,0x76,0xdd,0xe8,0x00,0xb4,0x73,
+   0x5e,0x32,0x55,0xdb,0x03,0x3a,0x00,0xce,0x3e,0x8b,0x9a,0x09,0x45,0xe8,0x68,0x7c,
+   0xf3,0x78,0xe1,0x7e,0xa8,0x4c,0xf6,0xda,0x8f,0x0a,0x10,0xfa,0xc0,0xcf,0x3c,0x18,
+   0x5f,0xfe,0xd7,0xfe,0xd9,0x7f,0x3e,0xc6,0x0e,0x63,0xff,0x0b,0x00,0x00,
+};
+
+static const uint8_t html_console_html[] PROGMEM = {
+   0x1f,0x8b,0x08,0x00,0x00,0x00,0x00,0x00,0x02,0x03,0xad,0x56,0xdd,0x6f,0xdb,0x36,
+   0x10,0x7f,0xcf,0x5f,0x71,0x65,0x81,0xc2,0x5e,0x2c,0xd9,0x2e,0xf6,0x90,0x39,0xb6,
+   0x87,0x2e,0xe9,0xb0,0xbd,0x6c,0x03,0x96,0x62,0xd8,0x92,0x3c,0xd0,0xe2,0xc9,0x22,
+   0x42,0x91,0x1a,0x49,0xd9,0xf1,0xda,0xfc,0xef,0x3b,0x52,0x89,0x23,0xcb,0x42,0x9b,
+   0x0e,0xb3,0x1e,0x2c,0xde,0xfd,0xee,0xfb,0x83,0x9a,0xbf,0xba,0xfc,0xf5,0xe2,0xea,
+   0xcf,0xdf,0xde,0x43,0xe1,0x4b,0xb5,0x3c,0x99,0x87,0x3f,0x50,0x5c,0xaf,0x17,0x0c,
+   0x35,0x5b,0x9e,0x00,0xc0,0xbc,0x40,0x2e,0xe2,0x5b,0x38,0x94,0xe8,0x39,0x64,0x05,
+   0xb7,0x0e,0xfd,0x82,0x7d,0xb8,0xfa,0x31,0x39,0x63,0x4f,0xcc,0x3d,0x5f,0xf3,0x12,
+   0x17,0x6c,0x23,0x71,0x5b,0x19,0xeb,0x19,0x64,0x46,0x7b,0xd4,0x84,0xdf,0x4a,0xe1,
+   0x8b,0x85,0xc0,0x8d,0xcc,0x30,0x89,0x87,0x11,0x48,0x2d,0xbd,0xe4,0x2a,0x71,0x19,
+   0x57,0xb8,0x98,0xa6,0x93,0xb6,0xbe,0xa0,0xd2,0x4b,0xaf,0x70,0x79,0x61,0xb4,0x33,
+   0x0a,0xe7,0xe3,0xe6,0x78,0x08,0x71,0x7e,0xd7,0xa5,0xd1,0x6f,0x65,0xc4,0x0e,0x3e,
+   0x76,0xa9,0xf4,0xcb,0xc9,0x9f,0x24,0xe7,0xa5,0x54,0xbb,0x19,0x94,0x46,0x1b,0x57,
+   0xf1,0x0c,0xcf,0x7b,0x90,0x2b,0x9e,0xdd,0xad,0xad,0xa9,0xb5,0x48,0x32,0xa3,0x8c,
+   0x9d,0xc1,0xeb,0x29,0x86,0xa7,0x0f,0xfc,0x84,0x10,0xdf,0x86,0xa7,0x0f,0x51,0x72,
+   0xbb,0x96,0x7a,0x06,0x93,0x3e,0xa6,0x90,0xae,0x52,0x9c,0x3c,0xca,0x15,0xde,0xf7,
+   0x01,0x02,0x3d,0x11,0xd2,0x62,0xe6,0xa5,0x21,0x2d,0x64,0xaf,0x2e,0x75,0x1f,0xb2,
+   0x40,0xb9,0x2e,0xfc,0x0c,0xa6,0x93,0xc9,0xa6,0x38,0x02,0x3c,0x74,0x09,0xaf,0x4d,
+   0xed,0xfb,0x13,0x45,0x16,0x49,0x4b,0x9f,0x09,0xb3,0x41,0x9b,0x2b,0xb3,0x4d,0xc8,
+   0x61,0x5e,0x7b,0xf3,0xd5,0xe1,0x56,0x5c,0x08,0xa9,0xd7,0x33,0x38,0xab,0x7a,0xa3,
+   0xdd,0x16,0xd2,0x63,0x12,0x2b,0x33,0x83,0xca,0x52,0xbf,0x58,0x5e,0xbd,0x20,0x96,
+   0xac,0x14,0xff,0x7f,0xd1,0xdf,0x8a,0xf0,0xfc,0xb7,0xa2,0xaf,0x8c,0x15,0x48,0x10,
+   0x6d,0x34,0x7e,0x75,0x22,0x0e,0xe3,0x9b,0x8f,0x9f,0x3b,0x7d,0x3e,0xde,0x0f,0xe6,
+   0x3c,0x74,0xfa,0x7e,0x44,0x29,0x57,0x20,0xc5,0x82,0x51,0x51,0xd9,0x72,0x3e,0xa6,
+   0xe3,0x9e,0x25,0x75,0x45,0x95,0x0e,0x4c,0xca,0x12,0x8b,0x75,0xcb,0x4c,0x59,0x29,
+   0xf4,0x34,0xaf,0x26,0xcf,0x1b,0x52,0x6e,0xb2,0xda,0x01,0xf5,0x62,0x86,0x85,0x51,
+   0xe4,0x3b,0xc1,0x8d,0xd6,0xa1,0xed,0xf4,0x3a,0x4d,0xd3,0xfd,0x80,0xce,0x5d,0x66,
+   0x65,0xe5,0x5b,0x83,0xb7,0xe1,0x16,0x42,0x33,0x2d,0x40,0x90,0x92,0x92,0x86,0x3e,
+   0x5d,0xa3,0x7f,0xaf,0x30,0xbc,0xfe,0xb0,0xfb,0x59,0x0c,0xa2,0x5b,0xc3,0xf3,0x43,
+   0x91,0x50,0xb3,0xcf,0x88,0x04,0x67,0x7b,0x44,0x1c,0xc9,0x5c,0xdf,0x8e,0xa0,0x32,
+   0xe1,0x6d,0xd2,0x01,0x08,0xcc,0x0c,0xf9,0x4e,0x1c,0x8d,0x5b,0xb8,0xc2,0x7b,0x7f,
+   0xd9,0x50,0x06,0x6d,0x55,0xe3,0x31,0xf8,0x02,0x61,0x8b,0x2b,0x67,0xb2,0x3b,0xf4,
+   0xe0,0xd0,0x52,0x67,0x37,0x7f,0x8e,0x78,0x92,0x32,0xc1,0xd7,0x38,0x82,0xdc,0x9a,
+   0x32,0x62,0xc3,0x4e,0xe3,0x2a,0xbe,0x0a,0xcc,0x79,0xad,0x7c,0x24,0xc1,0xd9,0x14,
+   0x08,0x5c,0x3b,0x14,0x87,0x8e,0x44,0xe6,0x02,0x94,0xc9,0x78,0x98,0xdb,0x34,0x9e,
+   0xdf,0xbc,0xe9,0x10,0x5e,0x2d,0x80,0x9d,0x4d,0x18,0x7c,0xdf,0xa1,0xcf,0x88,0x3c,
+   0x65,0x9d,0xd8,0xb6,0xee,0x31,0xac,0x3f,0x70,0xf5,0x7b,0xf4,0x7b,0xc0,0xb6,0x6e,
+   0x36,0x1e,0x33,0x38,0x7d,0x96,0x2f,0x8c,0xf3,0x61,0x15,0x13,0x8d,0xcd,0x02,0x27,
+   0x2a,0xa4,0xc3,0xf8,0x20,0x9b,0x5b,0x97,0xae,0xa4,0xe6,0x76,0x77,0xb5,0xab,0x90,
+   0xf4,0x32,0x6e,0x2d,0xdf,0xad,0xea,0x3c,0x47,0x4b,0x86,0x9f,0x81,0x79,0xad,0xe3,
+   0xe6,0x01,0x5e,0x55,0xa8,0xc5,0xc0,0x53,0x4e,0x87,0x9d,0x59,0x0b,0xde,0xad,0x8c,
+   0xf7,0x94,0xab,0x45,0xe8,0x84,0x94,0x5a,0xc4,0x28,0x75,0x65,0x2a,0x32,0x1c,0xce,
+   0x99,0x92,0x54,0xd7,0x9f,0xe2,0x82,0x82,0x65,0x1b,0xf3,0x48,0x4b,0xa0,0x33,0x45,
+   0x01,0xd1,0x58,0xbc,0x28,0xa4,0x12,0x83,0x7d,0x9b,0x64,0x16,0xb9,0xc7,0x50,0xd9,
+   0x5f,0xa8,0xae,0x8d,0x3b,0xc3,0x43,0x59,0x5a,0x22,0x0a,0x61,0x10,0x0d,0x07,0xe1,
+   0x00,0x74,0xa9,0x42,0xbd,0xf6,0x05,0x2c,0xe1,0xed,0x64,0x32,0x19,0x46,0x03,0x16,
+   0x4b,0xda,0x68,0x8d,0x81,0x70,0xce,0xa5,0x75,0x3e,0x1e,0x3b,0x1a,0x65,0x0e,0x83,
+   0x26,0xc0,0x61,0x27,0xbe,0xe3,0x58,0x5a,0x92,0x0f,0x27,0x07,0x09,0xa7,0xf5,0x43,
+   0x01,0x91,0xc8,0x53,0x4e,0x07,0x94,0x48,0x6a,0xe9,0xb4,0x35,0x75,0xa1,0x14,0x34,
+   0x9d,0x25,0xd7,0x82,0x9d,0x3f,0x9c,0x77,0xe4,0x33,0x65,0x1c,0x7e,0x59,0x01,0x5d,
+   0x2a,0x8f,0xb3,0x8b,0xa4,0x25,0x4c,0x4d,0x4a,0x24,0xbe,0x52,0x18,0x26,0xce,0xdb,
+   0x1a,0x8f,0x55,0x97,0xe8,0x1c,0xb5,0x7c,0x5b,0x39,0xf6,0xd5,0x39,0x24,0x3c,0x28,
+   0xa1,0xb6,0x31,0x39,0x60,0x2a,0x38,0xdd,0xfd,0x0b,0x32,0xea,0xbc,0xa5,0x4d,0x11,
+   0x7a,0xf9,0x91,0x38,0x7b,0x9a,0xc6,0xb4,0xf9,0x1f,0x34,0xf4,0x11,0x7c,0x24,0x28,
+   0xf2,0x72,0x16,0x3d,0x79,0xe8,0xa4,0xfa,0x71,0x36,0xc3,0xf8,0x85,0xc9,0xd2,0x86,
+   0x2c,0xda,0x92,0x5a,0x55,0x8d,0x22,0x23,0x6b,0x3e,0x09,0x68,0x56,0xb5,0x88,0xfb,
+   0x4a,0xea,0xc6,0x27,0xbc,0xcf,0xb0,0xa2,0x3d,0xe7,0xdd,0x5e,0x02,0xfe,0xae,0xd1,
+   0xee,0x0e,0xd4,0xb7,0xba,0x98,0xca,0x1f,0xf3,0x36,0x18,0xdf,0xdc,0x4f,0x57,0x37,
+   0xd7,0xd7,0x93,0xe4,0xbb,0xf3,0xdb,0x6f,0xae,0xdf,0x25,0x7f,0xf1,0xe4,0x9f,0xdb,
+   0xf1,0x7a,0x04,0x8c,0x1d,0xf4,0x56,0x3b,0x69,0x21,0xa9,0x46,0xdf,0xe1,0x4e,0x98,
+   0xad,0xfe,0x6c,0xd6,0x42,0xf3,0x60,0x4a,0xc8,0x98,0xa6,0xf7,0xf4,0x55,0x64,0xd9,
+   0xf0,0xf8,0xb6,0x7a,0xf4,0x8c,0x2d,0x21,0x4c,0x6d,0x50,0xbf,0xe1,0xaa,0x8e,0x73,
+   0x7c,0xa3,0xd9,0xf0,0xe8,0x92,0xa0,0xaa,0x85,0x1c,0x0c,0xbe,0x8c,0x0c,0x0e,0xec,
+   0x51,0xc3,0xb8,0x44,0xd3,0xaa,0x76,0x45,0x8b,0x78,0x24,0xd3,0xac,0xd7,0x08,0x6d,
+   0x06,0xe7,0x08,0xf1,0x6c,0x97,0xa2,0x62,0x87,0xec,0x07,0x40,0x45,0x8d,0x7a,0x18,
+   0xf9,0x3b,0x6b,0xcd,0xf6,0x43,0xc5,0xc2,0x1a,0x0c,0xea,0x97,0x30,0xe9,0x49,0x43,
+   0x5b,0x6d,0x30,0x7f,0x9d,0x24,0x04,0xbe,0x7d,0xa9,0xfe,0x4b,0xaa,0xc6,0xde,0xc2,
+   0xbc,0x1d,0xc0,0x4b,0x6c,0x9d,0x9e,0x06,0x5b,0xf0,0xe9,0xd3,0x71,0x44,0x3d,0x5d,
+   0x40,0x17,0xf3,0xf3,0x55,0x38,0x1f,0x37,0xf7,0x31,0xdd,0xd0,0xf1,0xab,0xfa,0x5f,
+   0x41,0x13,0x84,0xfc,0x66,0x0b,0x00,0x00,
+};
+
+static const uint8_t html_data_js[] PROGMEM = {
+   0x76,0x61,0x72,0x20,0x68,0x6f,0x73,0x74,0x6e,0x61,0x6d,0x65,0x20,0x3d,0x20,0x22,
+   0x7b,0x7b,0x68,0x6f,0x73,0x74,0x6e,0x61,0x6d,0x65,0x7d,0x7d,0x22,0x3b,0x0a,0x76,
+   0x61,0x72,0x20,0x73,0x63,0x61,0x6e,0x6e,0x69,0x6e,0x67,0x20,0x3d,0x20,0x7b,0x7b,
+   0x73,0x63,0x61,0x6e,0x6e,0x69,0x6e,0x67,0x7d,0x7d,0x3b,0x0a,0x76,0x61,0x72,0x20,
+   0x6e,0x65,0x74,0x77,0x6f,0x72,0x6b,0x73,0x20,0x3d,0x20,0x5b,0x7b,0x7b,0x6e,0x65,
+   0x74,0x77,0x6f,0x72,0x6b,0x73,0x7d,0x7d,0x5d,0x3b,0x0a,
+};
+
+static const CxHtmlAsset g_htmlAssets[] = {
+   {"/ap.html", "text/html", html_ap_html, 1054, "\"f8cd1a74\"", true},
+   {"/console.html", "text/html", html_console_html, 1112, "\"bef457c9\"", true},
+   {"/data.js", "application/javascript", html_data_js, 91, nullptr, false},
+};
+
+#endif /* CxHtmlAssets_h */
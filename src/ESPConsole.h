@@ -12,6 +12,8 @@
 #define ESP_CONSOLE_I2C
 #define ESP_CONSOLE_SEGDISPLAY
 #define ESP_CONSOLE_RC
+#define ESP_CONSOLE_API
+#define ESP_CONSOLE_WS
 #endif
 
 #if defined(ESP_CONSOLE_MQTTHA)
@@ -46,6 +48,14 @@
 #include "../capabilities/CxCapabilityRC.hpp"
 #endif
 
+#if defined (ESP_CONSOLE_API)
+#include "../capabilities/CxCapabilityApi.hpp"
+#endif
+
+#if defined (ESP_CONSOLE_WS)
+#include "../capabilities/CxCapabilityWs.hpp"
+#endif
+
 
 #ifndef __SKIP_GLOBALS__
 #define __SKIP_GLOBALS__
@@ -106,6 +116,12 @@ void initESPConsole(const char* app = _NAME, const char* ver = _VERSION_ID) {
 #ifdef CxCapabilityRC_hpp
    CxCapabilityRC::loadCap();
 #endif
+#ifdef CxCapabilityApi_hpp
+   CxCapabilityApi::loadCap();
+#endif
+#ifdef CxCapabilityWs_hpp
+   CxCapabilityWs::loadCap();
+#endif
 
 }
 
@@ -78,6 +78,9 @@
 #define ESC_CLEAR_LINE          "\033[2K"
 #define ESC_RESET_CURSOR        "\033[H"
 
+// device status report, a terminal answers with ESC [ 0 n
+#define ESC_DEVICE_STATUS       "\033[5n"
+
 
 // default commands
 #define USR_CMD_Q    "?"
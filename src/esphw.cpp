@@ -578,10 +578,101 @@ uint32_t getWIFIEnd() {
 #endif
 }
 
+// EEPROM shadow: the EEPROM library keeps a RAM copy after EEPROM.begin(), which is called once. Writes only
+// change this copy and extend the dirty range, one commit (= erase and write of the flash sector) writes all
+// changes after EEPROM_COMMIT_DELAY.
+static bool     __bEepromReady = false;
+static uint32_t __nEepromDirtyFrom = EEPROM_SHADOW_SIZE;  // dirty range [from, to)
+static uint32_t __nEepromDirtyTo = 0;
+static uint32_t __nEepromDirtySince = 0;
+static uint32_t __nEepromErases = 0;
+
+static bool eepromBegin() {
+#ifdef ARDUINO
+   if (!__bEepromReady) {
+      EEPROM.begin(EEPROM_SHADOW_SIZE);
+      __bEepromReady = true;
+   }
+   return true;
+#else
+   return false;
+#endif
+}
+
+bool eepromRead(uint32_t nAddr, void* p, size_t nLen) {
+   if (!p || nAddr + nLen > EEPROM_SHADOW_SIZE || !eepromBegin()) return false;
+#ifdef ARDUINO
+   uint8_t* pData = (uint8_t*)p;
+   for (size_t i = 0; i < nLen; i++) {
+      pData[i] = EEPROM.read(nAddr + i);
+   }
+#endif
+   return true;
+}
+
+bool eepromWrite(uint32_t nAddr, const void* p, size_t nLen) {
+   if (!p || nAddr + nLen > EEPROM_SHADOW_SIZE || !eepromBegin()) return false;
+#ifdef ARDUINO
+   const uint8_t* pData = (const uint8_t*)p;
+   for (size_t i = 0; i < nLen; i++) {
+      if (EEPROM.read(nAddr + i) != pData[i]) {
+         EEPROM.write(nAddr + i, pData[i]);
+         if (__nEepromDirtyTo == 0) __nEepromDirtySince = millis();
+         if (nAddr + i < __nEepromDirtyFrom) __nEepromDirtyFrom = nAddr + i;
+         if (nAddr + i + 1 > __nEepromDirtyTo) __nEepromDirtyTo = nAddr + i + 1;
+      }
+   }
+#endif
+   return true;
+}
+
+bool eepromCommit() {
+   if (!isEEPROMDirty()) return true;
+#ifdef ARDUINO
+   if (!EEPROM.commit()) return false;
+   __nEepromErases++;
+#endif
+   __nEepromDirtyFrom = EEPROM_SHADOW_SIZE;
+   __nEepromDirtyTo = 0;
+   return true;
+}
+
+void eepromLoop() {
+#ifdef ARDUINO
+   if (isEEPROMDirty() && (millis() - __nEepromDirtySince) >= EEPROM_COMMIT_DELAY) {
+      eepromCommit();
+   }
+#endif
+}
+
+bool isEEPROMDirty() {
+   return __nEepromDirtyTo > __nEepromDirtyFrom;
+}
+
+uint32_t getEEPROMDirtyFrom() {
+   return isEEPROMDirty() ? __nEepromDirtyFrom : 0;
+}
+
+uint32_t getEEPROMDirtyTo() {
+   return __nEepromDirtyTo;
+}
+
+uint32_t getEEPROMErases() {
+   return __nEepromErases;
+}
+
 void printEEPROM(Stream& stream, uint32_t nStartAddr, uint32_t nLength) {
 #ifdef ARDUINO
    uint32_t eepromSize = nStartAddr + nLength;
-   EEPROM.begin(eepromSize);
+   
+   // the shadow is read, if the range is within. Other ranges need to commit and re-initialize the EEPROM library
+   bool bShadow = (eepromSize <= EEPROM_SHADOW_SIZE);
+   if (bShadow) {
+      eepromBegin();
+   } else {
+      eepromCommit();
+      EEPROM.begin(eepromSize);
+   }
    
    stream.println("EEPROM Contents:");
    for (int i = nStartAddr; i < eepromSize; i += 8) {
@@ -605,212 +696,130 @@ void printEEPROM(Stream& stream, uint32_t nStartAddr, uint32_t nLength) {
       stream.println();  // Move to the next line
    }
    
-   EEPROM.end();
+   if (!bShadow) {
+      EEPROM.end();
+      __bEepromReady = false; // load the shadow again on the next access
+   }
 #endif
 }
 
-bool readSSID(char* szSSID, uint32_t lenmax) {
+// configuration store, the EEPROM is used without
+static ConfigReadStrFunc  __fnConfigReadStr = nullptr;
+static ConfigWriteStrFunc __fnConfigWriteStr = nullptr;
+static ConfigReadIntFunc  __fnConfigReadInt = nullptr;
+static ConfigWriteIntFunc __fnConfigWriteInt = nullptr;
+
+void setConfigStore(ConfigReadStrFunc fnReadStr, ConfigWriteStrFunc fnWriteStr, ConfigReadIntFunc fnReadInt, ConfigWriteIntFunc fnWriteInt) {
+   __fnConfigReadStr = fnReadStr;
+   __fnConfigWriteStr = fnWriteStr;
+   __fnConfigReadInt = fnReadInt;
+   __fnConfigWriteInt = fnWriteInt;
+}
+
+void clearConfigStore() {
+   setConfigStore(nullptr, nullptr, nullptr, nullptr);
+}
+
+// reads a string from the configuration store or the EEPROM (address, length of the field)
+static bool readConfigStr(const char* szKey, uint32_t nAddr, uint32_t nLen, char* sz, uint32_t lenmax) {
 #ifdef ARDUINO
-   if (lenmax < 20) {
+   if (lenmax < nLen) {
       return false;
    }
-   char buf[20];
+   if (__fnConfigReadStr && __fnConfigReadStr(szKey, sz, lenmax)) {
+      return true;
+   }
+   char buf[80];
    
    // initialize the buffer
    memset(buf, 0, sizeof(buf));
-      
-   // address for the SSID in eeprom is 0x7, length 20 bytes
-   EEPROM.begin(512);
-   EEPROM_readAnything(0x7, buf);
-   EEPROM.end();
-   strncpy(szSSID, buf, lenmax);
+   
+   eepromRead(nAddr, buf, nLen);
+   strncpy(sz, buf, lenmax);
    return true;
 #else
    return false;
 #endif
 }
 
-bool writeSSID(const char* szSSID) {
+// writes a string to the EEPROM (address, length of the field) and to the configuration store
+static bool writeConfigStr(const char* szKey, uint32_t nAddr, uint32_t nLen, const char* sz) {
 #ifdef ARDUINO
-   if (strlen(szSSID) > 20) {
+   if (strlen(sz) > nLen) {
       return false;
    }
-   // copy the SSID to a buffer (writeAnything does not work with const char)
-   char buf[20];
-   strncpy(buf, szSSID, sizeof(buf));
+   // copy the string to a buffer of the field length
+   char buf[80];
+   strncpy(buf, sz, nLen);
    
-   // address for the SSID in eeprom is 0x7, length 20 bytes
-   EEPROM.begin(512);
-   EEPROM_writeAnything(0x7, buf);
-   EEPROM.commit();
-   EEPROM.end();
-   return true;
+   bool bResult = eepromWrite(nAddr, buf, nLen);
+   if (__fnConfigWriteStr) {
+      bResult = __fnConfigWriteStr(szKey, sz) && bResult;
+   }
+   return bResult;
 #else
    return false;
 #endif
 }
 
-bool readPassword(char* szPassword, uint32_t lenmax) {
-#ifdef ARDUINO
-   if (lenmax < 25) {
-      return false;
-   }
-   char buf[25];
-   
-   // initiotialize the buffer
-   memset(buf, 0, sizeof(buf));
+// address for the SSID in eeprom is 0x7, length 20 bytes
+bool readSSID(char* szSSID, uint32_t lenmax) {
+   return readConfigStr(CONFIG_KEY_SSID, 0x7, 20, szSSID, lenmax);
+}
 
-   // address for the password in eeprom is 0x1B, length 25 bytes
-   EEPROM.begin(512);
-   EEPROM_readAnything(0x1B, buf);
-   EEPROM.end();
-   strncpy(szPassword, buf, lenmax);
-   return true;
-#else
-   return false;
-#endif
+bool writeSSID(const char* szSSID) {
+   return writeConfigStr(CONFIG_KEY_SSID, 0x7, 20, szSSID);
+}
+
+// address for the password in eeprom is 0x1B, length 25 bytes
+bool readPassword(char* szPassword, uint32_t lenmax) {
+   return readConfigStr(CONFIG_KEY_PASSWORD, 0x1B, 25, szPassword, lenmax);
 }
    
 bool writePassword(const char* szPassword) {
-#ifdef ARDUINO
-   if (strlen(szPassword) > 25) {
-      return false;
-   }
-   // copy the password to a buffer (writeAnything does not work with const char)
-   char buf[25];
-   strncpy(buf, szPassword, sizeof(buf));
-
-   // address for the password in eeprom is 0x1B, length 25 bytes
-   EEPROM.begin(512);
-   EEPROM_writeAnything(0x1B, buf);
-   EEPROM.commit();
-   EEPROM.end();
-   return true;
-#else
-   return false;
-#endif
+   return writeConfigStr(CONFIG_KEY_PASSWORD, 0x1B, 25, szPassword);
 }
 
+// address for the hostname in eeprom is 0x34, length 80 bytes
 bool readHostName(char* szHostname, uint32_t lenmax) {
-#ifdef ARDUINO
-   if (lenmax < 80) {
-      return false;
-   }
-   char buf[80];
-   
-   // initialize the buffer
-   memset(buf, 0, sizeof(buf));
-
-   // address for the hostname in eeprom is 0x34, length 80 bytes
-   EEPROM.begin(512);
-   EEPROM_readAnything(0x34, buf);
-   EEPROM.end();
-   strncpy(szHostname, buf, lenmax);
-   return true;
-#else
-   return false;
-#endif
+   return readConfigStr(CONFIG_KEY_HOSTNAME, 0x34, 80, szHostname, lenmax);
 }
 
 bool writeHostName(const char* szHostname) {
-#ifdef ARDUINO
-   if (strlen(szHostname) > 80) {
-      return false;
-   }
-   // copy the hostname to a buffer (writeAnything does not work with const char)
-   char buf[80];
-   strncpy(buf, szHostname, sizeof(buf));
-   
-   // address for the hostname in eeprom is 0x34, length 80 bytes
-   EEPROM.begin(512);
-   EEPROM_writeAnything(0x34, buf);
-   EEPROM.commit();
-   EEPROM.end();
-   return true;
-#else
-   return false;
-#endif
-}
-
-void scanWiFi(Stream& stream) {
-#ifdef ARDUINO
-#ifndef ESP_CONSOLE_NOWIFI
-   int n = WiFi.scanNetworks();
-   if (n == 0) {
-      stream.println("no networks found");
-   } else {
-      stream.print(n);
-      stream.println(" networks found");
-      for (int i = 0; i < n; ++i) {
-         stream.print(i + 1);
-         stream.print(": ");
-         stream.print(WiFi.SSID(i));
-         stream.print(" (");
-         stream.print(WiFi.RSSI(i));
-         stream.print(" dBm)");
-         stream.println((WiFi.encryptionType(i) == ENC_TYPE_NONE) ? " " : "*");
-      }
-   }
-#endif
-#endif
+   return writeConfigStr(CONFIG_KEY_HOSTNAME, 0x34, 80, szHostname);
 }
 
+// address for the ota password in eeprom is 0x8A, length 25 bytes
 bool readOtaPassword(char* szPassword, uint32_t lenmax) {
-#ifdef ARDUINO
-   if (lenmax < 25) {
-      return false;
-   }
-   char buf[25];
-   
-   // initiotialize the buffer
-   memset(buf, 0, sizeof(buf));
-   
-   // address for the password in eeprom is 0x8A, length 25 bytes
-   EEPROM.begin(512);
-   EEPROM_readAnything(0x8A, buf);
-   EEPROM.end();
-   strncpy(szPassword, buf, lenmax);
-   return true;
-#else
-   return false;
-#endif
+   return readConfigStr(CONFIG_KEY_OTAPW, 0x8A, 25, szPassword, lenmax);
 }
 
 bool writeOtaPassword(const char* szPassword) {
-#ifdef ARDUINO
-   if (strlen(szPassword) > 25) {
-      return false;
-   }
-   // copy the password to a buffer (writeAnything does not work with const char)
-   char buf[25];
-   strncpy(buf, szPassword, sizeof(buf));
-   
-   // address for the password in eeprom is 0x8A, length 25 bytes
-   EEPROM.begin(512);
-   EEPROM_writeAnything(0x8A, buf);
-   EEPROM.commit();
-   EEPROM.end();
-   return true;
-#else
-   return false;
-#endif
+   return writeConfigStr(CONFIG_KEY_OTAPW, 0x8A, 25, szPassword);
 }
 
 void readSettings(Settings_t& settings) {
-#ifdef ARDUINO
-   EEPROM.begin(512);
-   EEPROM_readAnything(0x100, settings);
-   EEPROM.end();
-#endif
+   eepromGet(0x100, settings);
+   int32_t nValue;
+   if (__fnConfigReadInt && __fnConfigReadInt(CONFIG_KEY_LOOPDELAY, nValue)) {
+      settings._loopDelay = (uint32_t)nValue;
+   }
 }
 
 void writeSettings(Settings_t& settings) {
-#ifdef ARDUINO
-   EEPROM.begin(512);
-   EEPROM_writeAnything(0x100, settings);
-   EEPROM.commit();
-   EEPROM.end();
-#endif
+   if (__fnConfigWriteInt && __fnConfigWriteInt(CONFIG_KEY_LOOPDELAY, (int32_t)settings._loopDelay)) {
+      return;
+   }
+   eepromPut(0x100, settings);
+}
+
+void readWiFiCache(WiFiCache_t& cache) {
+   eepromGet(0x180, cache);
+}
+
+void writeWiFiCache(WiFiCache_t& cache) {
+   cache._nMagic = WIFICACHE_MAGIC;
+   eepromPut(0x180, cache);
 }
 
 
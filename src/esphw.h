@@ -23,6 +23,7 @@
 #else
 #include "devenv.h"
 #endif
+#include <functional>
 
 // additional settings hosted in eeprom at 0x100
 typedef struct s_settings {
@@ -32,9 +33,68 @@ typedef struct s_settings {
    s_settings() : _loopDelay(0) {}
 } Settings_t;
 
+// last wifi connection (bssid, channel) and optional static ip configuration hosted in eeprom at 0x180
+#define WIFICACHE_MAGIC 0x57434332 // "WCC2"
+typedef struct s_wificache {
+   uint32_t _nMagic;
+   uint32_t _nSSIDHash;    // hash of the ssid the bssid and channel belong to
+   uint8_t  _bssid[6];
+   uint8_t  _nChannel;
+   uint8_t  _bStatic;      // use the static ip configuration below
+   uint32_t _nIP;
+   uint32_t _nGateway;
+   uint32_t _nMask;
+   uint32_t _nDNS;
+   uint32_t _nStaticSSIDHash; // hash of the ssid the static ip configuration belongs to
+   
+   s_wificache() {memset(this, 0, sizeof(*this));}
+   bool isValid() const {return _nMagic == WIFICACHE_MAGIC;}
+} WiFiCache_t;
+
+
+// RAM shadow of the EEPROM, changes are committed to the flash after a delay
+#define EEPROM_SHADOW_SIZE 512
+#define EEPROM_COMMIT_DELAY 1000
+
+bool eepromRead(uint32_t nAddr, void* p, size_t nLen);
+bool eepromWrite(uint32_t nAddr, const void* p, size_t nLen);
+bool eepromCommit();
+void eepromLoop();
+bool isEEPROMDirty();
+uint32_t getEEPROMDirtyFrom();
+uint32_t getEEPROMDirtyTo();
+uint32_t getEEPROMErases();
+
+template <class T> bool eepromGet(uint32_t nAddr, T& value) {
+   return eepromRead(nAddr, &value, sizeof(value));
+}
+
+template <class T> bool eepromPut(uint32_t nAddr, const T& value) {
+   return eepromWrite(nAddr, &value, sizeof(value));
+}
+
+// keys of the configuration in the configuration store
+#define CONFIG_KEY_SSID       "wifi.ssid"
+#define CONFIG_KEY_PASSWORD   "wifi.password"
+#define CONFIG_KEY_HOSTNAME   "wifi.hostname"
+#define CONFIG_KEY_OTAPW      "ota.password"
+#define CONFIG_KEY_LOOPDELAY  "sys.loopdelay"
+
+// optional store of the configuration (e.g. the key-value store on the file system). If set, the configuration
+// is read from the store, a key not in the store from the EEPROM. The strings needed at boot before the store is
+// available (ssid, password, hostname, ota password) are written to both, the settings to the store only.
+typedef std::function<bool(const char* szKey, char* szValue, uint32_t lenmax)> ConfigReadStrFunc;
+typedef std::function<bool(const char* szKey, const char* szValue)> ConfigWriteStrFunc;
+typedef std::function<bool(const char* szKey, int32_t& nValue)> ConfigReadIntFunc;
+typedef std::function<bool(const char* szKey, int32_t nValue)> ConfigWriteIntFunc;
+
+void setConfigStore(ConfigReadStrFunc fnReadStr, ConfigWriteStrFunc fnWriteStr, ConfigReadIntFunc fnReadInt, ConfigWriteIntFunc fnWriteInt);
+void clearConfigStore();
 
 void readSettings(Settings_t& settings);
 void writeSettings(Settings_t& settings);
+void readWiFiCache(WiFiCache_t& cache);
+void writeWiFiCache(WiFiCache_t& cache);
 
 size_t getStackSize();
 void reboot();
@@ -112,7 +172,6 @@ template <class T> int EEPROM_vanishData(int ee, T& value)
    return i;
 }
 
-void scanWiFi(Stream& stream);
 
 
 #endif /* esphw_h */
@@ -0,0 +1,58 @@
+//
+//  CxBufferStream.hpp
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+
+#ifndef CxBufferStream_hpp
+#define CxBufferStream_hpp
+
+#include <vector>
+
+/**
+ * @brief Output stream collecting the output in a byte buffer up to a max. size
+ * @details Used to capture the output of a command, e.g. to send it with its length. The buffer keeps its
+ * length, binary output (e.g. NUL bytes) is kept as is. Output beyond the max. size is dropped and marks
+ * the buffer as truncated. Reading from the stream returns nothing.
+ */
+class CxBufferStream : public Stream {
+   std::vector<uint8_t> _vBuf;
+   size_t _nMax;
+   bool   _bTruncated = false;
+
+public:
+   explicit CxBufferStream(size_t nMax) : _nMax(nMax) {}
+
+   virtual size_t write(uint8_t c) override {
+      if (_vBuf.size() < _nMax) {
+         _vBuf.push_back(c);
+      } else {
+         _bTruncated = true;
+      }
+      return 1;
+   }
+
+   virtual size_t write(const uint8_t* buffer, size_t size) override {
+      size_t nFree = _nMax - _vBuf.size();
+      if (size > nFree) _bTruncated = true;
+      size_t n = (size < nFree) ? size : nFree;
+      _vBuf.insert(_vBuf.end(), buffer, buffer + n);
+      return size;
+   }
+
+   using Print::write;
+
+   virtual int available() override {return 0;}
+   virtual int read() override {return -1;}
+   virtual int peek() override {return -1;}
+   virtual void flush() override {}
+
+   const uint8_t* get() {return _vBuf.data();}
+   size_t length() {return _vBuf.size();}
+   bool isTruncated() {return _bTruncated;}
+   void clear() {_vBuf.clear(); _bTruncated = false;}
+};
+
+#endif /* CxBufferStream_hpp */
@@ -0,0 +1,112 @@
+//
+//  CxESPBootProfiler.hpp
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+
+#ifndef CxESPBootProfiler_hpp
+#define CxESPBootProfiler_hpp
+
+#include <inttypes.h>
+
+class CxESPBootProfiler;
+extern CxESPBootProfiler g_Boot; // init as early as possible...
+
+/**
+ * @brief Records the phases of the boot with start time, duration (us) and heap delta
+ * @details Phases are recorded within the boot window (after the start) and as long as the table has room.
+ * Nested phases (e.g. a capability setup executing a batch label) are recorded with their depth.
+ */
+class CxESPBootProfiler {
+public:
+   static constexpr uint8_t _nMAX_PHASES = 40;
+   static constexpr uint8_t _nMAX_NAME = 20;
+   static constexpr uint8_t _nINVALID = 0xFF;
+
+   struct Phase {
+      char     szName[_nMAX_NAME];
+      uint32_t nStart;     ///< us since start
+      uint32_t nDuration;  ///< us
+      int32_t  nHeap;      ///< heap delta (bytes), negative if allocated
+      uint8_t  nDepth;
+   };
+
+private:
+   Phase    _aPhases[_nMAX_PHASES];
+   uint8_t  _nCount = 0;
+   uint8_t  _nDepth = 0;
+   uint32_t _nWindow = 60000;   ///< boot window (ms)
+
+   static int32_t _getHeap() {
+#ifdef ARDUINO
+      return (int32_t)ESP.getFreeHeap();
+#else
+      return 0;
+#endif
+   }
+
+public:
+   bool isActive() {return _nCount < _nMAX_PHASES && millis() < _nWindow;}
+
+   /**
+    * @brief Starts a phase, name and suffix are concatenated ("<name>:<suffix>")
+    * @return index of the phase to be passed to stop(), _nINVALID if not recorded
+    */
+   uint8_t start(const char* szName, const char* szSuffix = nullptr) {
+      if (!isActive()) return _nINVALID;
+      if (!_nCount) add("core", 0, (uint32_t)micros()); // time until the first phase (core, sketch)
+      if (!isActive()) return _nINVALID;
+      Phase& phase = _aPhases[_nCount];
+      snprintf(phase.szName, sizeof(phase.szName), "%s%s%s", szName ? szName : "", szSuffix ? ":" : "", szSuffix ? szSuffix : "");
+      phase.nStart = (uint32_t)micros();
+      phase.nDuration = 0;
+      phase.nHeap = _getHeap();
+      phase.nDepth = _nDepth++;
+      return _nCount++;
+   }
+
+   void stop(uint8_t nIndex) {
+      if (nIndex >= _nCount) return;
+      Phase& phase = _aPhases[nIndex];
+      phase.nDuration = (uint32_t)micros() - phase.nStart;
+      phase.nHeap = _getHeap() - phase.nHeap;
+      if (_nDepth) _nDepth--;
+   }
+
+   /// adds a completed phase, e.g. measured asynchronously (ntp sync)
+   void add(const char* szName, uint32_t nStart, uint32_t nDuration) {
+      if (!isActive()) return;
+      Phase& phase = _aPhases[_nCount++];
+      snprintf(phase.szName, sizeof(phase.szName), "%s", szName ? szName : "");
+      phase.nStart = nStart;
+      phase.nDuration = nDuration;
+      phase.nHeap = 0;
+      phase.nDepth = 0;
+   }
+
+   uint8_t count() {return _nCount;}
+   const Phase& get(uint8_t n) {return _aPhases[n];}
+   void setWindow(uint32_t set) {_nWindow = set;}
+
+   void print(Stream& stream) {
+      stream.println(F(ESC_ATTR_BOLD "   Start ms    Dur. ms    Heap  Phase" ESC_ATTR_RESET));
+      for (uint8_t i = 0; i < _nCount; i++) {
+         const Phase& phase = _aPhases[i];
+         stream.printf("%11.3f %10.3f %7" PRId32 "  %*s%s\n", phase.nStart / 1000.0f, phase.nDuration / 1000.0f, phase.nHeap, phase.nDepth * 2, "", phase.szName);
+      }
+   }
+};
+
+/**
+ * @brief Records a boot phase for its scope
+ */
+class CxESPBootPhase {
+   uint8_t _nIndex;
+public:
+   CxESPBootPhase(const char* szName, const char* szSuffix = nullptr) : _nIndex(g_Boot.start(szName, szSuffix)) {}
+   ~CxESPBootPhase() {g_Boot.stop(_nIndex);}
+};
+
+#endif /* CxESPBootProfiler_hpp */
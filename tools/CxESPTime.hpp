@@ -19,8 +19,13 @@
 #include <sys/time.h>                // struct timeval
 #include "CxTimer.hpp"
 #include "CxTablePrinter.hpp"
+#include "CxESPBootProfiler.hpp"
 #include <vector>
 
+#if defined(ARDUINO) && defined(ESP32)
+#include <esp_sntp.h>
+#endif
+
 
 /// Credits:
 /// https://werner.rothschopf.net/microcontroller/202103_arduino_esp32_ntp_en.htm
@@ -48,6 +53,7 @@ public:
             _nTimeToBoot = (uint32_t) millis();
             _tStart = _tNow - (_nTimeToBoot / 1000);   // set the start time one time, deduct the time system is running
          }
+         if (!_bSynced) g_Boot.add("ntp", _nSyncStart, (uint32_t)micros() - _nSyncStart);
          _bSynced = true;
       };
       __initTime();
@@ -152,11 +158,11 @@ public:
       }
    }
    
-   void printTimers(Stream& stream) {
-      CxTablePrinter table(stream);
-      table.printHeader({F("Id"), F("Time"), F("Mode"), F("Remain"), F("Cmd")}, {10, 10, 6, 7, 60});
-      char* szTime = new char[15];
-      char* szRemain = new char[15];
+   void printTimers(Stream& stream, CxTablePrinter::e_format fmt = CxTablePrinter::e_format::text) {
+      CxTablePrinter table(stream, fmt);
+      table.printHeader({{F("Id"), 10}, {F("Time"), 10}, {F("Mode"), 6}, {F("Remain"), 7}, {F("Cmd"), 60}});
+      char szTime[15];
+      char szRemain[15];
       for (uint8_t i = 0; i < _timers.size(); i++) {
          if (_timers[i] != nullptr) {
             if (_timers[i]->isCron()) {
@@ -173,11 +179,14 @@ public:
                   convertToHumanReadableTime(_timers[i]->getRemain(), szRemain, 15);
                }
             }
-            table.printRow({_timers[i]->getId(), szTime, _timers[i]->getModeSz(), szRemain, _timers[i]->getCmd()});
+            table.cell(_timers[i]->getId());
+            table.cell(szTime);
+            table.cell(_timers[i]->getModeSz());
+            table.cell(szRemain);
+            table.cell(_timers[i]->getCmd());
+            table.endRow();
          }
       }
-      delete[] szTime;
-      delete[] szRemain;
    }
       
    const char* printTime(Stream& stream, bool withTZ = true) {
@@ -333,6 +342,9 @@ public:
    }
    bool setTimeZone(const char* sz) {_strTz = sz?sz:""; return __initTime();}
    
+   /// (re)starts the sync with the ntp server, e.g. when wifi is up. Doesn't wait for the sync (see isSynced()).
+   bool startSync() {return __initTime();}
+   
    bool isValid() {return _bValid;}
    
    int getTimeHour() {
@@ -369,11 +381,18 @@ private:
    
    time_t _tStart = 0;
    uint32_t _nTimeToBoot = 0;
+   uint32_t _nSyncStart = 0;   ///< time the ntp sync was started (us)
 
    time_t _tNow;
    struct tm _tmLocal;
    bool _bValid = false; // true, if synchronised
    
+   /// instance notified by the sntp of the ESP32
+   static CxESPTime*& __syncInstance() {
+      static CxESPTime* p = nullptr;
+      return p;
+   }
+   
    /**
     * @brief Initializes the time and date settings.
     * @details Configures the NTP server and time zone settings.
@@ -381,6 +400,7 @@ private:
    */
    bool __initTime() {
       if (_strNtpServer.length() != 0) {
+         _nSyncStart = (uint32_t)micros();
          if (!_strTz.length()) _strTz = "UTC";
 #ifdef ARDUINO
 #ifdef ESP32
@@ -388,6 +408,12 @@ private:
          configTime(0, 0, _strNtpServer.c_str());  // 0, 0 because we will use TZ in the next line
          setenv("TZ", _strTz, 1);                  // Set environment variable with your time zone
          tzset();
+         // there is no settimeofday_cb(), the sntp notifies the sync
+         __syncInstance() = this;
+         sntp_set_time_sync_notification_cb([](struct timeval*) {
+            CxESPTime* p = __syncInstance();
+            if (p && p->_cbSynced) p->_cbSynced();
+         });
 #else
          // ESP8266
          configTime(_strTz.c_str(), _strNtpServer.c_str());    // --> for the ESP8266 only
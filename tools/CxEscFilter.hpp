@@ -0,0 +1,122 @@
+//
+//  CxEscFilter.hpp
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+
+#ifndef CxEscFilter_hpp
+#define CxEscFilter_hpp
+
+/**
+ * @brief Stream wrapper for peers which are not a terminal (scripts, log files, log server)
+ * @details ANSI escape sequences (colors, attributes, cursor and screen control) are removed from the
+ * output. A carriage return is only passed, if it is followed by a line feed, so that lines redrawn
+ * in place (prompt, progress) do not end up as garbage in the output. Reading is passed through to the
+ * wrapped stream. The filter can be disabled for terminals, then the output is passed unchanged.
+ */
+class CxEscFilterStream : public Stream {
+   Stream* _pStream;
+   bool    _bEnabled = false;
+   uint8_t _nEsc = 0;      ///< 0: text, 1: ESC received, 2: within a CSI sequence (ESC [ ...)
+   bool    _bCR = false;   ///< pending carriage return
+   uint32_t _nDropped = 0; ///< number of removed bytes
+
+public:
+   explicit CxEscFilterStream(Stream* pStream) : _pStream(pStream) {}
+
+   virtual size_t write(uint8_t c) override {
+      if (!_pStream) return 0;
+      if (!_bEnabled) return _pStream->write(c);
+      
+      if (_nEsc == 1) {
+         _nEsc = (c == '[') ? 2 : 0;
+         _nDropped++;
+         return 1;
+      } else if (_nEsc == 2) {
+         if (c >= 0x40 && c <= 0x7E) _nEsc = 0; // final byte of the sequence
+         _nDropped++;
+         return 1;
+      } else if (c == 0x1B) {
+         _nEsc = 1;
+         _nDropped++;
+         return 1;
+      }
+
+      if (_bCR) {
+         _bCR = false;
+         if (c == '\n') {
+            _pStream->write('\r');
+         } else {
+            _nDropped++;
+         }
+      }
+      if (c == '\r') {
+         _bCR = true;
+         return 1;
+      }
+      _pStream->write(c);
+      return 1;
+   }
+
+   virtual size_t write(const uint8_t* buffer, size_t size) override {
+      if (!_pStream) return 0;
+      if (!_bEnabled) return _pStream->write(buffer, size);
+      
+      // pass plain chunks through in one write
+      size_t nStart = 0;
+      for (size_t i = 0; i < size; i++) {
+         uint8_t c = buffer[i];
+         if (c == 0x1B || c == '\r' || _nEsc || _bCR) {
+            if (i > nStart) _pStream->write(buffer + nStart, i - nStart);
+            write(c);
+            nStart = i + 1;
+         }
+      }
+      if (size > nStart) _pStream->write(buffer + nStart, size - nStart);
+      return size;
+   }
+
+   virtual int available() override {return _pStream ? _pStream->available() : 0;}
+   virtual int read() override {return _pStream ? _pStream->read() : -1;}
+   virtual int peek() override {return _pStream ? _pStream->peek() : -1;}
+   virtual void flush() override {if (_pStream) _pStream->flush();}
+
+   Stream* getStream() {return _pStream;}
+   
+   void setEnabled(bool set) {
+      if (!set && _bCR && _pStream) _pStream->write('\r'); // don't lose a pending carriage return
+      _bEnabled = set;
+      _nEsc = 0;
+      _bCR = false;
+   }
+   bool isEnabled() {return _bEnabled;}
+   uint32_t getDropped() {return _nDropped;}
+
+   /// removes ESC sequences and carriage returns from a string in place
+   static void strip(char* sz) {strip(sz, sz);}
+
+   /// copies the string without ESC sequences and carriage returns, the destination can be the source or
+   /// must hold strlen(szSrc) + 1 bytes
+   static void strip(char* szDst, const char* szSrc) {
+      if (!szDst || !szSrc) return;
+      char* pDst = szDst;
+      uint8_t nEsc = 0;
+      for (const char* p = szSrc; *p; p++) {
+         char c = *p;
+         if (nEsc == 1) {
+            nEsc = (c == '[') ? 2 : 0;
+         } else if (nEsc == 2) {
+            if (c >= 0x40 && c <= 0x7E) nEsc = 0;
+         } else if (c == 0x1B) {
+            nEsc = 1;
+         } else if (c != '\r') {
+            *pDst++ = c;
+         }
+      }
+      *pDst = '\0';
+   }
+};
+
+#endif /* CxEscFilter_hpp */
@@ -0,0 +1,255 @@
+//
+//  CxFileJob.hpp
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+
+#ifndef CxFileJob_hpp
+#define CxFileJob_hpp
+
+#include "CxFsIndex.hpp"
+#include <functional>
+#include <vector>
+
+/**
+ * @brief Bulk file operation (copy, remove) with block sized buffers
+ * @details The job is processed block by block with step(), which allows to run it in the background (loop)
+ * and to yield between the blocks. Directories are processed recursively.
+ */
+class CxFileJob {
+public:
+   enum class e_op {copy, remove};
+   
+private:
+   /// pending path (pair of source and destination), bExpanded marks a directory, whose entries are already queued
+   struct _t_entry {
+      String strSrc;
+      String strDst;
+      bool bExpanded;
+   };
+   
+   e_op _eOp;
+   std::vector<_t_entry> _vecPending;
+   std::unique_ptr<uint8_t[]> _pBuf;
+   size_t _nBufSize;
+   
+#ifdef ARDUINO
+   File _fileSrc;
+   File _fileDst;
+#endif
+   bool _bOpen = false;
+   bool _bDone = false;
+   bool _bError = false;
+   
+   uint32_t _nBytes = 0;     ///< bytes copied/removed
+   uint32_t _nFiles = 0;     ///< files copied/removed
+   uint32_t _nTotal = 0;     ///< total bytes of the job
+   uint32_t _nStart = 0;
+   uint32_t _nTime = 0;
+   
+#ifdef ARDUINO
+   /// queue the entries of a directory
+   void _expand(const String& strSrc, const String& strDst) {
+#ifdef ESP32
+      File dir = LittleFS.open(strSrc.c_str());
+      File file = dir.openNextFile();
+      while (file) {
+         _vecPending.push_back({CxFsIndex::join(strSrc, file.name()), strDst.length() ? CxFsIndex::join(strDst, file.name()) : String(), false});
+         file = dir.openNextFile();
+      }
+#else
+      Dir dir = LittleFS.openDir(strSrc.c_str());
+      while (dir.next()) {
+         _vecPending.push_back({CxFsIndex::join(strSrc, dir.fileName().c_str()), strDst.length() ? CxFsIndex::join(strDst, dir.fileName().c_str()) : String(), false});
+      }
+#endif
+   }
+   
+   /// size of a file or the files in a directory (recursive)
+   static uint32_t _size(const char* szPath) {
+      uint32_t nSize = 0;
+      File file = LittleFS.open(szPath, "r");
+      if (!file) return 0;
+      if (!file.isDirectory()) {
+         nSize = file.size();
+         file.close();
+         return nSize;
+      }
+      file.close();
+#ifdef ESP32
+      File dir = LittleFS.open(szPath);
+      File entry = dir.openNextFile();
+      while (entry) {
+         nSize += entry.isDirectory() ? _size(CxFsIndex::join(szPath, entry.name()).c_str()) : entry.size();
+         entry = dir.openNextFile();
+      }
+#else
+      Dir dir = LittleFS.openDir(szPath);
+      while (dir.next()) {
+         nSize += dir.isDirectory() ? _size(CxFsIndex::join(szPath, dir.fileName().c_str()).c_str()) : dir.fileSize();
+      }
+#endif
+      return nSize;
+   }
+#endif
+   
+   void _finish(bool bError) {
+      _bError = _bError || bError;
+      _bDone = true;
+      _nTime = millis() - _nStart;
+      _vecPending.clear();
+      _pBuf.reset();
+   }
+   
+public:
+   /**
+    * @param eOp Operation
+    * @param szSrc Source file or directory
+    * @param szDst Destination (copy only)
+    * @param nBufSize Buffer size, should be the block size of the file system
+    */
+   CxFileJob(e_op eOp, const char* szSrc, const char* szDst, size_t nBufSize) : _eOp(eOp), _nBufSize(nBufSize) {
+      _nStart = millis();
+      if (!szSrc || (eOp == e_op::copy && (!szDst || isWithin(szDst, szSrc)))) {
+         _finish(true);
+         return;
+      }
+      if (eOp == e_op::copy) {
+         _pBuf.reset(new (std::nothrow) uint8_t[_nBufSize]);
+         if (!_pBuf) {
+            _finish(true);
+            return;
+         }
+      }
+#ifdef ARDUINO
+      _nTotal = _size(szSrc);
+#endif
+      _vecPending.push_back({szSrc, szDst ? szDst : "", false});
+   }
+   
+   ~CxFileJob() {cancel();}
+   
+   /// true, if the path is the directory or beneath it (a copy into itself would never end)
+   static bool isWithin(const char* szPath, const char* szDir) {
+      size_t nLen = strlen(szDir);
+      while (nLen > 1 && szDir[nLen - 1] == '/') nLen--;
+      if (strncmp(szPath, szDir, nLen) != 0) return false;
+      return szPath[nLen] == '\0' || szPath[nLen] == '/' || (nLen == 1 && szDir[0] == '/');
+   }
+   
+   /**
+    * @brief Process the next block or file system entry
+    * @return True, if the job has more work to do
+    */
+   bool step() {
+      if (_bDone) return false;
+#ifdef ARDUINO
+      if (_bOpen) {
+         size_t n = _fileSrc.read(_pBuf.get(), _nBufSize);
+         if (n > 0) {
+            if (_fileDst.write(_pBuf.get(), n) != n) {
+               cancel();
+               _bError = true;
+               return false;
+            }
+            _nBytes += n;
+         }
+         if (n < _nBufSize) {
+            _fileSrc.close();
+            _fileDst.close();
+            _bOpen = false;
+            _nFiles++;
+         }
+         return true;
+      }
+      
+      if (_vecPending.empty()) {
+         _finish(false);
+         return false;
+      }
+      
+      _t_entry entry = _vecPending.back();
+      _vecPending.pop_back();
+      
+      File file = LittleFS.open(entry.strSrc.c_str(), "r");
+      if (!file) {
+         _finish(true);
+         return false;
+      }
+      
+      if (file.isDirectory()) {
+         file.close();
+         if (_eOp == e_op::remove) {
+            if (entry.bExpanded) {
+               LittleFS.rmdir(entry.strSrc.c_str());
+            } else {
+               // remove the directory after its entries
+               entry.bExpanded = true;
+               _vecPending.push_back(entry);
+               _expand(entry.strSrc, String());
+            }
+         } else {
+            LittleFS.mkdir(entry.strDst.c_str());
+            _expand(entry.strSrc, entry.strDst);
+         }
+      } else if (_eOp == e_op::remove) {
+         _nBytes += file.size();
+         file.close();
+         if (!LittleFS.remove(entry.strSrc.c_str())) {
+            _finish(true);
+            return false;
+         }
+         _nFiles++;
+      } else {
+         _fileSrc = file;
+         _fileDst = LittleFS.open(entry.strDst.c_str(), "w");
+         if (!_fileDst) {
+            _fileSrc.close();
+            _finish(true);
+            return false;
+         }
+         _bOpen = true;
+      }
+      return true;
+#else
+      _finish(true);
+      return false;
+#endif
+   }
+   
+   /// run the job until it is done, yields between the blocks
+   bool run(std::function<void(uint32_t, uint32_t)> cbProgress = nullptr) {
+      while (step()) {
+         if (cbProgress) cbProgress(_nBytes, _nTotal);
+#ifdef ARDUINO
+         yield();
+#endif
+      }
+      return !_bError;
+   }
+   
+   void cancel() {
+#ifdef ARDUINO
+      if (_bOpen) {
+         _fileSrc.close();
+         _fileDst.close();
+         _bOpen = false;
+      }
+#endif
+      if (!_bDone) _finish(true);
+   }
+   
+   bool isDone() const {return _bDone;}
+   bool isError() const {return _bError;}
+   e_op getOp() const {return _eOp;}
+   uint32_t getBytes() const {return _nBytes;}
+   uint32_t getFiles() const {return _nFiles;}
+   uint32_t getTotal() const {return _nTotal;}
+   uint32_t getTime() const {return _bDone ? _nTime : millis() - _nStart;}
+   /// throughput in kB/s (bytes per ms)
+   uint32_t getRate() const {uint32_t nTime = getTime(); return nTime ? _nBytes / nTime : 0;}
+};
+
+#endif /* CxFileJob_hpp */
@@ -0,0 +1,396 @@
+//
+//  CxFileTransfer.hpp
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+
+#ifndef CxFileTransfer_hpp
+#define CxFileTransfer_hpp
+
+#include "CxHash.hpp"
+#include <inttypes.h>
+
+#ifdef ARDUINO
+#ifndef ESP_CONSOLE_NOWIFI
+#include <WiFiClient.h>
+#endif
+#include <FS.h>
+#ifdef ESP32
+#include "LITTLEFS.h"
+#define LittleFS LITTLEFS
+#else
+#include <LittleFS.h>
+#endif /* ESP32*/
+#endif /* ARDUINO */
+
+/**
+ * @brief File transfer ($UPLOAD$, $DOWNLOAD$) on a remote command connection, processed in the loop
+ * @details Protocol (text header lines terminated with '\n'):
+ * - Download: "GET <file> [OFFSET:<n>]" -> "SIZE: <size> CRC:<crc32> OFFSET:<n>" followed by the data from the offset.
+ * - Upload: "PUT:<file> SIZE:<size> CRC:<crc32>" -> "OFFSET:<n>" (resume point). Then the client sends blocks
+ *   "BLK:<offset> <len> <crc32>" followed by <len> (max. 1024) bytes. Each block is acknowledged with "ACK:<next offset>"
+ *   or "NAK:<expected offset>" (CRC error, lost block or a block past the announced size, the client resends from the
+ *   offset). The client may send
+ *   further blocks before it has received the acknowledgement. The data is written to a temporary file, which
+ *   replaces the file when the CRC of the whole file matches ("OK:<size> <crc32>", otherwise "ERROR:<reason>").
+ *   An interrupted upload of the same file (same CRC) resumes at the last complete block.
+ * - Upload (legacy): "FILE:<file> SIZE:<size>" followed by the data, no integrity check.
+ * CRC values are CRC-32 (zlib) in hex.
+ *
+ * The transfer is processed with step() in the loop, a few blocks per call. It never waits for data, a
+ * connection without data for 5 s is closed (an interrupted upload can be resumed).
+ */
+class CxFileTransfer {
+public:
+   static constexpr size_t   _nBLOCK_SIZE = 1024;   ///< max. block size
+   static constexpr uint32_t _nTIMEOUT = 5000;      ///< max. time without data (ms)
+   static constexpr uint8_t  _nMAX_BLOCKS = 4;      ///< max. blocks processed per step
+   
+private:
+   enum class e_state : uint8_t {header, scan, block, data, legacy, send, done};
+   
+#if defined(ARDUINO) && !defined(ESP_CONSOLE_NOWIFI)
+   WiFiClient _client;
+   File       _file;
+#endif
+   e_state  _eState = e_state::header;
+   bool     _bUpload = false;
+   bool     _bError = false;
+   const char* _szError = "";
+   std::unique_ptr<uint8_t[]> _pBuf;
+   char     _szLine[128];
+   uint8_t  _nLine = 0;
+   String   _strFn;
+   char     _szTmp[20] = "";     ///< temporary file of an upload
+   uint32_t _nFree;              ///< space available for an upload
+   uint32_t _nSize = 0;          ///< file size
+   uint32_t _nCrc = 0;           ///< CRC of the file, announced by the client of an upload
+   uint32_t _nOffset = 0;        ///< bytes transferred (uploads: verified and written)
+   uint32_t _nResumed = 0;       ///< offset the transfer was started at
+   uint32_t _nBlkOffset = 0;     ///< block of an upload in progress
+   uint32_t _nBlkLen = 0;
+   uint32_t _nBlkCrc = 0;
+   uint32_t _nBlkRead = 0;
+   bool     _bNak = false;
+   CxCrc32  _crc;
+   uint32_t _nStart = 0;
+   uint32_t _nActivity = 0;      ///< time data was received or sent the last time
+   uint32_t _nTime = 0;
+   
+   /// value of a key ("<key><value>") in a header line
+   static uint32_t _getValue(const char* szHeader, const char* szKey, int nBase = 10) {
+      const char* p = strstr(szHeader, szKey);
+      return p ? strtoul(p + strlen(szKey), nullptr, nBase) : 0;
+   }
+   
+#if defined(ARDUINO) && !defined(ESP_CONSOLE_NOWIFI)
+   /// collects a header line from the available data, true if the line is complete
+   bool _readLine() {
+      while (_client.available()) {
+         char c = _client.read();
+         if (c == '\n') {
+            _szLine[_nLine] = '\0';
+            _nLine = 0;
+            return true;
+         }
+         if (c != '\r' && (size_t)_nLine + 1 < sizeof(_szLine)) _szLine[_nLine++] = c;
+      }
+      return false;
+   }
+#endif
+   
+   /// ends the transfer, szError is the reason of a failure
+   void _finish(const char* szError = nullptr) {
+#if defined(ARDUINO) && !defined(ESP_CONSOLE_NOWIFI)
+      if (_file) _file.close();
+      _client.stop();
+#endif
+      if (szError) {
+         _bError = true;
+         _szError = szError;
+      }
+      _eState = e_state::done;
+      _nTime = millis() - _nStart;
+      _pBuf.reset();
+   }
+   
+#if defined(ARDUINO) && !defined(ESP_CONSOLE_NOWIFI)
+   /// reports the error to the client and ends the transfer
+   void _fail(const char* szError) {
+      _client.printf("ERROR:%s\n", szError);
+      _finish(szError);
+   }
+   
+   void _onHeader() {
+      if (strncmp(_szLine, "GET ", 4) == 0) {
+         char* szFn = _szLine + 4;
+         while (*szFn == ' ') szFn++;
+         char* pEnd = strchr(szFn, ' ');
+         _nResumed = pEnd ? _getValue(pEnd, "OFFSET:") : 0;
+         if (pEnd) *pEnd = '\0';
+         _strFn = szFn;
+         _file = LittleFS.open(_strFn.c_str(), "r");
+         if (!_file || _file.isDirectory()) {
+            _client.println("ERROR: File not found");
+            _finish("file not found");
+            return;
+         }
+         _nSize = _file.size();
+         if (_nResumed > _nSize) _nResumed = _nSize;
+         _eState = e_state::scan; // the CRC of the whole file is sent first
+      } else if (strncmp(_szLine, "PUT:", 4) == 0) {
+         _bUpload = true;
+         char* szFn = _szLine + 4;
+         char* pEnd = strchr(szFn, ' ');
+         if (!szFn[0] || !pEnd) {
+            _fail("invalid header");
+            return;
+         }
+         *pEnd = '\0';
+         _strFn = szFn;
+         _nSize = _getValue(pEnd + 1, "SIZE:");
+         _nCrc = _getValue(pEnd + 1, "CRC:", 16);
+         
+         // the temporary file is bound to the content, an interrupted upload of the same file can be resumed
+         snprintf(_szTmp, sizeof(_szTmp), "/.part_%08" PRIx32, _nCrc);
+         if (LittleFS.exists(_szTmp)) _file = LittleFS.open(_szTmp, "r");
+         if (_file && (_file.size() > _nSize || (_file.size() % _nBLOCK_SIZE) != 0)) _file.close();
+         if (_file) {
+            // only complete and verified blocks are written, continue the CRC of the file over them
+            _eState = e_state::scan;
+         } else {
+            _startUpload();
+         }
+      } else if (strncmp(_szLine, "FILE:", 5) == 0) {
+         _bUpload = true;
+         char* szFn = _szLine + 5;
+         char* pEnd = strchr(szFn, ' ');
+         _nSize = pEnd ? _getValue(pEnd, "SIZE:") : 0;
+         if (pEnd) *pEnd = '\0';
+         _strFn = szFn;
+         if (_nSize > _nFree) {
+            _finish("not enough space");
+            return;
+         }
+         _file = LittleFS.open(_strFn.c_str(), "w");
+         if (!_file) {
+            _finish("create file");
+            return;
+         }
+         _eState = e_state::legacy;
+         if (!_nSize) _finish();
+      } else {
+         _finish("invalid header");
+      }
+   }
+   
+   /// CRC over the file (download) or the verified part of an interrupted upload
+   void _onScan() {
+      size_t n = _file.read(_pBuf.get(), _nBLOCK_SIZE);
+      _crc.write(_pBuf.get(), n);
+      if (_bUpload) _nOffset += n;
+      if (n == _nBLOCK_SIZE) return;
+      
+      if (_bUpload) {
+         _file.close();
+         if (!_nOffset) LittleFS.remove(_szTmp);
+         _startUpload();
+      } else {
+         _file.seek(_nResumed);
+         _nOffset = _nResumed;
+         _client.printf("SIZE: %" PRIu32 " CRC:%08" PRIx32 " OFFSET:%" PRIu32 "\n", _nSize, _crc.get(), _nResumed);
+         _eState = e_state::send;
+      }
+   }
+   
+   void _startUpload() {
+      if (_nOffset > _nSize || (_nSize - _nOffset) > _nFree) {
+         _fail("not enough space");
+         return;
+      }
+      _file = LittleFS.open(_szTmp, _nOffset ? "a" : "w");
+      if (!_file) {
+         _fail("create file");
+         return;
+      }
+      _nResumed = _nOffset;
+      _client.printf("OFFSET:%" PRIu32 "\n", _nOffset);
+      _eState = e_state::block;
+      if (_nOffset == _nSize) _commit(); // completed, but interrupted before the commit
+   }
+   
+   void _onBlockHeader() {
+      // BLK:<offset> <len> <crc>
+      if (strncmp(_szLine, "BLK:", 4) != 0) {
+         _finish("protocol error"); // can be resumed
+         return;
+      }
+      char* p = _szLine + 4;
+      _nBlkOffset = strtoul(p, &p, 10);
+      _nBlkLen = strtoul(p, &p, 10);
+      _nBlkCrc = strtoul(p, &p, 16);
+      _nBlkRead = 0;
+      if (_nBlkLen > _nBLOCK_SIZE) {
+         _finish("protocol error");
+         return;
+      }
+      _eState = e_state::data;
+      if (!_nBlkLen) _onBlock();
+   }
+   
+   void _onBlock() {
+      _eState = e_state::block;
+      if (_nBlkOffset != _nOffset) {
+         // block in flight after an error, drop it until the client resends from the expected offset
+         if (!_bNak) _client.printf("NAK:%" PRIu32 "\n", _nOffset);
+         _bNak = true;
+         return;
+      }
+      // an empty block, a block past the announced size or a CRC error
+      if (_nBlkLen == 0 || _nBlkLen > _nSize - _nOffset || CxCrc32::of(_pBuf.get(), _nBlkLen) != _nBlkCrc) {
+         _client.printf("NAK:%" PRIu32 "\n", _nOffset);
+         _bNak = true;
+         return;
+      }
+      _bNak = false;
+      
+      if (_file.write(_pBuf.get(), _nBlkLen) != _nBlkLen) {
+         _fail("write");
+         return;
+      }
+      _crc.write(_pBuf.get(), _nBlkLen);
+      _nOffset += _nBlkLen;
+      _client.printf("ACK:%" PRIu32 "\n", _nOffset);
+      if (_nOffset >= _nSize) _commit();
+   }
+   
+   /// replaces the file with the verified temporary file
+   void _commit() {
+      _file.close();
+      if (_crc.get() != _nCrc) {
+         LittleFS.remove(_szTmp);
+         _client.printf("ERROR:crc %08" PRIx32 "\n", _crc.get());
+         _finish("crc error");
+         return;
+      }
+      if (!LittleFS.rename(_szTmp, _strFn.c_str())) {
+         LittleFS.remove(_strFn.c_str());
+         if (!LittleFS.rename(_szTmp, _strFn.c_str())) {
+            _fail("rename");
+            return;
+         }
+      }
+      _client.printf("OK:%" PRIu32 " %08" PRIx32 "\n", _nOffset, _crc.get());
+      _finish();
+   }
+#endif
+   
+public:
+#if defined(ARDUINO) && !defined(ESP_CONSOLE_NOWIFI)
+   /**
+    * @param client Connection, which sends the transfer header next
+    * @param nFree Space available for an upload
+    */
+   CxFileTransfer(WiFiClient& client, uint32_t nFree) : _client(client), _nFree(nFree) {
+      _nStart = _nActivity = millis();
+      _pBuf.reset(new (std::nothrow) uint8_t[_nBLOCK_SIZE]);
+      if (!_pBuf) {
+         _fail("out of memory");
+         return;
+      }
+      _client.setNoDelay(true);
+   }
+#endif
+   
+   ~CxFileTransfer() {if (_eState != e_state::done) _finish("cancelled");}
+   
+   /**
+    * @brief Processes the available data, a few blocks at most
+    * @return True, if the transfer is still running
+    */
+   bool step() {
+      if (_eState == e_state::done) return false;
+#if defined(ARDUINO) && !defined(ESP_CONSOLE_NOWIFI)
+      if (!_client.connected() && !_client.available()) {
+         _finish("connection lost");
+         return false;
+      }
+      
+      for (uint8_t i = 0; i < _nMAX_BLOCKS && _eState != e_state::done; i++) {
+         bool bProgress = false;
+         switch (_eState) {
+            case e_state::header:
+               bProgress = _readLine();
+               if (bProgress) _onHeader();
+               break;
+            case e_state::scan:
+               _onScan();
+               bProgress = true;
+               break;
+            case e_state::block:
+               bProgress = _readLine();
+               if (bProgress) _onBlockHeader();
+               break;
+            case e_state::data: {
+               size_t n = std::min((size_t)_client.available(), (size_t)(_nBlkLen - _nBlkRead));
+               if (n) _nBlkRead += _client.read(_pBuf.get() + _nBlkRead, n);
+               bProgress = (n > 0);
+               if (_nBlkRead == _nBlkLen) _onBlock();
+               break;
+            }
+            case e_state::legacy: {
+               size_t n = std::min((size_t)_client.available(), std::min(_nBLOCK_SIZE, (size_t)(_nSize - _nOffset)));
+               if (n) {
+                  n = _client.read(_pBuf.get(), n);
+                  if (_file.write(_pBuf.get(), n) != n) {
+                     _finish("write");
+                     break;
+                  }
+                  _nOffset += n;
+                  bProgress = true;
+               }
+               if (_nOffset == _nSize) _finish();
+               break;
+            }
+            case e_state::send: {
+               size_t n = _file.read(_pBuf.get(), _nBLOCK_SIZE);
+               if (n && _client.write(_pBuf.get(), n) != n) {
+                  _finish("connection lost");
+                  break;
+               }
+               _nOffset += n;
+               bProgress = true;
+               if (n < _nBLOCK_SIZE) _finish();
+               break;
+            }
+            default:
+               break;
+         }
+         if (!bProgress) break; // no data, continue in the next loop
+         _nActivity = millis();
+      }
+      
+      if (_eState != e_state::done && (millis() - _nActivity) > _nTIMEOUT) _finish("timeout");
+#else
+      _finish("not supported");
+#endif
+      return _eState != e_state::done;
+   }
+   
+   bool isDone() const {return _eState == e_state::done;}
+   bool isError() const {return _bError;}
+   bool isUpload() const {return _bUpload;}
+   const char* getError() const {return _szError;}
+   const char* getFile() const {return _strFn.c_str();}
+   const char* getTempFile() const {return _szTmp;}
+   uint32_t getSize() const {return _nSize;}
+   uint32_t getBytes() const {return _nOffset;}
+   uint32_t getResumed() const {return _nResumed;}
+   uint32_t getTime() const {return isDone() ? _nTime : millis() - _nStart;}
+   /// throughput in kB/s (bytes per ms) of the transferred part
+   uint32_t getRate() const {uint32_t nTime = getTime(); return nTime ? (_nOffset - _nResumed) / nTime : 0;}
+};
+
+#endif /* CxFileTransfer_hpp */
@@ -0,0 +1,141 @@
+//
+//  CxFramedSession.hpp
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+
+#ifndef CxFramedSession_hpp
+#define CxFramedSession_hpp
+
+#include "CxBufferStream.hpp"
+#include "CxEscFilter.hpp"
+
+#ifdef ARDUINO
+#ifndef ESP_CONSOLE_NOWIFI
+#include <WiFiClient.h>
+#endif
+#endif /* ARDUINO */
+
+#include <functional>
+
+/**
+ * @brief Framed remote session on the console port, opt-in by the first line "#!frames"
+ * @details Protocol:
+ * - request:  "<id> <command>\n"
+ * - response: "<id> <exit value> <length>[ +]\n" followed by exactly <length> bytes of output without ESC
+ *   sequences ('+': output truncated at _nMAX_OUTPUT).
+ * Requests can be pipelined, they are executed in order by the execute function. loop() runs up to
+ * _nMAX_PER_LOOP commands per call, but no further command, once _nMAX_LOOP_OUTPUT bytes were sent in
+ * the call. This bounds the time a loop pass spends writing to the socket, when the peer reads slowly.
+ */
+class CxFramedSession {
+public:
+   static constexpr const char* szMAGIC = "#!frames";
+   static constexpr uint8_t _nMAX_PER_LOOP = 16;       ///< max. commands per loop
+   static constexpr size_t  _nMAX_LINE = 256;          ///< max. length of a request line
+   static constexpr size_t  _nMAX_OUTPUT = 4096;       ///< max. output of a command
+   static constexpr size_t  _nMAX_LOOP_OUTPUT = 4096;  ///< no further command in a loop after this output
+
+   /// executes the command with its output to the stream, returns the exit value
+   using funcExecute_t = std::function<uint32_t(Stream& out, const char* szCmd)>;
+
+private:
+#if defined(ARDUINO) && !defined(ESP_CONSOLE_NOWIFI)
+   WiFiClient _client;
+#endif
+   funcExecute_t _funcExecute;
+   String   _strLine;
+   uint32_t _nCmds = 0;
+   uint32_t _nBytes = 0;            ///< bytes sent
+   uint32_t _nMaxLoopBytes = 0;     ///< max. bytes sent in a loop
+   uint32_t _nMaxLoopCmds = 0;      ///< max. commands in a loop
+
+   /// runs a request, returns the bytes sent
+   size_t _process(const String& strLine) {
+      int nSep = strLine.indexOf(' ');
+      String strId = (nSep < 0) ? strLine : strLine.substring(0, nSep);
+      String strCmd = (nSep < 0) ? "" : strLine.substring(nSep + 1);
+
+      CxBufferStream out(_nMAX_OUTPUT);
+      CxEscFilterStream plain(&out);
+      plain.setEnabled(true);
+      uint32_t nExitValue = 1; // EXIT_FAILURE
+      if (strCmd.length() && _funcExecute) nExitValue = _funcExecute(plain, strCmd.c_str());
+      _nCmds++;
+
+      char szHeader[48];
+      int nLen = snprintf(szHeader, sizeof(szHeader), "%.16s %u %u%s\n", strId.c_str(), (unsigned int)nExitValue, (unsigned int)out.length(), out.isTruncated() ? " +" : "");
+      size_t nSent = 0;
+#if defined(ARDUINO) && !defined(ESP_CONSOLE_NOWIFI)
+      nSent += _client.write((const uint8_t*)szHeader, nLen);
+      if (out.length()) nSent += _client.write(out.get(), out.length());
+#endif
+      _nBytes += nSent;
+      return nSent;
+   }
+
+public:
+   explicit CxFramedSession(funcExecute_t funcExecute) : _funcExecute(funcExecute) {}
+
+#if defined(ARDUINO) && !defined(ESP_CONSOLE_NOWIFI)
+   /// takes the connection after the magic line, confirms the session
+   void begin(WiFiClient& client) {
+      _client = client;
+      _client.setNoDelay(true);
+      _client.print(szMAGIC);
+      _client.print(F(" ok\r\n"));
+      _strLine = "";
+      _nCmds = 0;
+      _nBytes = 0;
+      _nMaxLoopBytes = 0;
+      _nMaxLoopCmds = 0;
+   }
+
+   bool isActive() {return _client && _client.connected();}
+#else
+   bool isActive() {return false;}
+#endif
+
+   /// runs the pipelined requests, false once, when the session was closed by the peer
+   bool loop() {
+#if defined(ARDUINO) && !defined(ESP_CONSOLE_NOWIFI)
+      if (!_client) return true;
+
+      if (!_client.connected() && !_client.available()) {
+         _client.stop();
+         _client = WiFiClient();
+         return false;
+      }
+
+      uint8_t n = 0;
+      size_t nLoopBytes = 0;
+      while (_client.available() && n < _nMAX_PER_LOOP && nLoopBytes < _nMAX_LOOP_OUTPUT) {
+         char c = _client.read();
+         if (c == '\n' || c == '\r') {
+            if (_strLine.length()) {
+               nLoopBytes += _process(_strLine);
+               n++;
+               yield();
+            }
+            _strLine = "";
+         } else if (_strLine.length() < _nMAX_LINE) {
+            _strLine += c;
+         }
+      }
+      if (nLoopBytes > _nMaxLoopBytes) _nMaxLoopBytes = (uint32_t)nLoopBytes;
+      if (n > _nMaxLoopCmds) _nMaxLoopCmds = n;
+      return true;
+#else
+      return true;
+#endif
+   }
+
+   uint32_t getCommands() {return _nCmds;}
+   uint32_t getBytes() {return _nBytes;}
+   uint32_t getMaxLoopBytes() {return _nMaxLoopBytes;}
+   uint32_t getMaxLoopCommands() {return _nMaxLoopCmds;}
+};
+
+#endif /* CxFramedSession_hpp */
@@ -0,0 +1,248 @@
+//
+//  CxFsIndex.hpp
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+
+#ifndef CxFsIndex_hpp
+#define CxFsIndex_hpp
+
+#include <map>
+
+#ifdef ARDUINO
+#include <FS.h>
+#ifdef ESP32
+#include "LITTLEFS.h"
+struct FSInfo {
+   size_t totalBytes;
+   size_t usedBytes;
+   size_t blockSize;
+   size_t pageSize;
+   size_t maxOpenFiles;
+   size_t maxPathLength;
+};
+#define Dir File
+#define LittleFS LITTLEFS
+#else
+#include <LittleFS.h>
+#endif /* ESP32*/
+#endif /* ARDUINO */
+
+/**
+ * @brief In-RAM index of the file system metadata (path, size, time) and the file system info
+ * @details The index is built lazily on the first query and kept coherent by the file operations of the
+ * capability. The other writers (log file, settings, key-value store and capabilities by
+ * ESPConsole.fsChanged()) report their changes by a hook, which updates the entry. Changes done otherwise
+ * (e.g. direct LittleFS access) are picked up, when the index expires.
+ */
+class CxFsIndex {
+public:
+   struct Entry {
+      uint32_t nSize;
+      time_t tCreation;
+      time_t tWrite;
+      bool bDir;
+   };
+   
+private:
+   std::map<String, Entry> _mapEntries;   ///< key: absolute path
+   bool     _bValid = false;
+   uint32_t _nBuilt = 0;                  ///< time the index was built
+   uint32_t _nMaxAge = 60000;             ///< index expires after this time (ms)
+   
+#ifdef ARDUINO
+   FSInfo   _fsinfo;
+#endif
+   bool     _bInfoValid = false;
+   uint32_t _nInfo = 0;                   ///< time the fs info was read
+   
+   uint32_t _nBuilds = 0;
+   uint32_t _nHits = 0;
+   
+#ifdef ARDUINO
+   void _set(const String& strPath, File& file) {
+      bool bDir = file.isDirectory();
+      _mapEntries[strPath] = {bDir ? 0 : (uint32_t)file.size(), file.getCreationTime(), file.getLastWrite(), bDir};
+   }
+   
+   void _scan(const String& strDir) {
+#ifdef ESP32
+      File dir = LittleFS.open(strDir.c_str());
+      if (!dir) return;
+      File file = dir.openNextFile();
+      while (file) {
+         String strPath = join(strDir, file.name());
+         _set(strPath, file);
+         bool bDir = file.isDirectory();
+         file = dir.openNextFile();
+         if (bDir) _scan(strPath);
+      }
+#else
+      Dir dir = LittleFS.openDir(strDir.c_str());
+      while (dir.next()) {
+         String strPath = join(strDir, dir.fileName().c_str());
+         bool bDir = dir.isDirectory();
+         _mapEntries[strPath] = {bDir ? 0 : (uint32_t)dir.fileSize(), dir.fileCreationTime(), dir.fileTime(), bDir};
+         if (bDir) _scan(strPath);
+      }
+#endif
+   }
+#endif
+   
+   void _ensure() {
+      if (_bValid && (millis() - _nBuilt) < _nMaxAge) {
+         _nHits++;
+         return;
+      }
+      _mapEntries.clear();
+#ifdef ARDUINO
+      _scan("/");
+#endif
+      _bValid = true;
+      _nBuilt = millis();
+      _nBuilds++;
+   }
+   
+public:
+   /// path of an entry in a directory, some cores deliver the full path as name
+   static String join(const String& strPath, const char* szName) {
+      String str = strPath;
+      if (!str.endsWith("/")) str += '/';
+      const char* p = strrchr(szName, '/');
+      str += p ? p + 1 : szName;
+      return str;
+   }
+   
+   /// absolute path without trailing '/'
+   static String normalize(const char* szPath) {
+      String str;
+      if (!szPath || szPath[0] != '/') str = '/';
+      str += szPath ? szPath : "";
+      while (str.length() > 1 && str.endsWith("/")) str.remove(str.length() - 1);
+      return str;
+   }
+   
+   /**
+    * @brief Matches a name against a glob pattern ('*' any chars, '?' one char)
+    */
+   static bool matchGlob(const char* szPattern, const char* szName) {
+      const char* pStar = nullptr;
+      const char* pBack = nullptr;
+      while (*szName) {
+         if (*szPattern == '?' || *szPattern == *szName) {
+            szPattern++;
+            szName++;
+         } else if (*szPattern == '*') {
+            pStar = szPattern++;
+            pBack = szName;
+         } else if (pStar) {
+            szPattern = pStar + 1;
+            szName = ++pBack;
+         } else {
+            return false;
+         }
+      }
+      while (*szPattern == '*') szPattern++;
+      return !*szPattern;
+   }
+   
+   /// drops the index and the fs info, both are read again on the next query
+   void clear() {
+      _mapEntries.clear();
+      _bValid = false;
+      _bInfoValid = false;
+   }
+   
+   /**
+    * @brief Entry of a path
+    * @return nullptr, if the path doesn't exist
+    */
+   const Entry* find(const char* szPath) {
+      _ensure();
+      auto it = _mapEntries.find(normalize(szPath));
+      return (it != _mapEntries.end()) ? &it->second : nullptr;
+   }
+   
+   bool exists(const char* szPath) {
+      String strPath = normalize(szPath);
+      if (strPath == "/") return true;
+      return find(strPath.c_str()) != nullptr;
+   }
+   
+   /// all entries, sorted by path
+   const std::map<String, Entry>& getEntries() {
+      _ensure();
+      return _mapEntries;
+   }
+   
+   /**
+    * @brief Reads the metadata of a (changed) path into the index
+    */
+   void update(const char* szPath) {
+      _bInfoValid = false; // used bytes have changed
+      if (!_bValid) return; // built on the next query anyway
+#ifdef ARDUINO
+      String strPath = normalize(szPath);
+      File file = LittleFS.open(strPath.c_str(), "r");
+      if (file) {
+         _set(strPath, file);
+         file.close();
+         // parent directories might have been created implicitly
+         int i;
+         String strParent = strPath;
+         while ((i = strParent.lastIndexOf('/')) > 0) {
+            strParent.remove(i);
+            if (_mapEntries.count(strParent)) break;
+            _mapEntries[strParent] = {0, 0, 0, true};
+         }
+      } else {
+         remove(strPath.c_str());
+      }
+#endif
+   }
+   
+   /**
+    * @brief Removes a path and its sub entries from the index
+    */
+   void remove(const char* szPath) {
+      _bInfoValid = false;
+      if (!_bValid) return;
+      String strPath = normalize(szPath);
+      _mapEntries.erase(strPath);
+      strPath += '/';
+      auto it = _mapEntries.lower_bound(strPath);
+      while (it != _mapEntries.end() && it->first.startsWith(strPath)) {
+         it = _mapEntries.erase(it);
+      }
+   }
+   
+   /// marks the index as outdated, e.g. after bulk operations
+   void invalidate() {_bValid = false; _bInfoValid = false;}
+   
+#ifdef ARDUINO
+   bool getInfo(FSInfo& fsinfo) {
+      if (!_bInfoValid || (millis() - _nInfo) >= _nMaxAge) return false;
+      fsinfo = _fsinfo;
+      _nHits++;
+      return true;
+   }
+   
+   void setInfo(const FSInfo& fsinfo) {
+      _fsinfo = fsinfo;
+      _bInfoValid = true;
+      _nInfo = millis();
+   }
+#endif
+   
+   bool hasInfo() {return _bInfoValid && (millis() - _nInfo) < _nMaxAge;}
+   
+   size_t size() const {return _mapEntries.size();}
+   uint32_t getBuilds() const {return _nBuilds;}
+   uint32_t getHits() const {return _nHits;}
+   void setMaxAge(uint32_t set) {_nMaxAge = set;}
+   uint32_t getMaxAge() const {return _nMaxAge;}
+};
+
+#endif /* CxFsIndex_hpp */
@@ -10,6 +10,7 @@
 
 #include "CxGpioTracker.hpp"
 #include "CxTimer.hpp"
+#include "CxTablePrinter.hpp"
 
 
 class CxGPIODevice : public CxGPIO {
@@ -86,17 +87,29 @@ public:
    
    virtual const char* getTypeSz() = 0;
    
-   virtual const std::vector<String> getHeadLine(bool bDefault = true) {
-      return {F("Id"), F("Name"), F("Type"), F("GPIO"), F("Mode"), F("Inv"), F("State"), F("Cmd")};
-   };
-   
-   virtual const std::vector<uint8_t> getWidths(bool bDefault = true) {
-      return {3, 11, 10, 4, 12, 3, 5, 20};
-   };
+   /// adds the columns of the device list, bDefault: common columns only
+   virtual void addColumns(CxTablePrinter& table, bool bDefault = true) {
+      table.addColumn(F("Id"), 3);
+      table.addColumn(F("Name"), 11);
+      table.addColumn(F("Type"), 10);
+      table.addColumn(F("GPIO"), 4);
+      table.addColumn(F("Mode"), 12);
+      table.addColumn(F("Inv"), 3);
+      table.addColumn(F("State"), 5);
+      table.addColumn(F("Cmd"), 20);
+   }
    
-   virtual const std::vector<String> getData(bool bDefault = true) {
-      return {String(getId()), getName(), getTypeSz(), String(getPin()).c_str(), getPinModeSz(), isInverted() ? "yes" : "no", getDigitalState() ? "on" : "off", getCmd()};
-   };
+   /// prints the cells of the device, matching addColumns()
+   virtual void printCells(CxTablePrinter& table, bool bDefault = true) {
+      table.cell(getId());
+      table.cell(getName());
+      table.cell(getTypeSz());
+      table.cell(getPin());
+      table.cell(getPinModeSz());
+      table.cell(isInverted());
+      table.cell(getDigitalState() ? "on" : "off");
+      table.cell(getCmd());
+   }
 
 };
 
@@ -273,7 +286,7 @@ public:
       uint8_t n = 0;
       bool bDefault = (strType.length() == 0);
       
-      CxTablePrinter table(*__console.getStream());
+      CxTablePrinter table(*__console.getStream(), __console.getTableFormat());
       
       /// iterate over all sensors and print formated sensor information
       for (const auto& [nId, pDevice] : _mapDevices) {
@@ -282,9 +295,11 @@ public:
          }
          
          if (n++ == 0) {
-            table.printHeader(pDevice->getHeadLine(bDefault), pDevice->getWidths(bDefault));
+            pDevice->addColumns(table, bDefault);
+            table.printHeader();
          }
-         table.printRow(pDevice->getData(bDefault));
+         pDevice->printCells(table, bDefault);
+         table.endRow();
       }
    }
 };
@@ -0,0 +1,180 @@
+/**
+ * @file CxHash.hpp
+ * @brief Lightweight content hashes for ESP-based projects
+ *
+ * This file defines `CxHash`, a 32 bit FNV-1a hash, which can be fed incrementally with
+ * buffers and strings. As a Print adapter it can hash the output of any print or
+ * serialize function (e.g. serializeJson) without building the content in RAM first.
+ * `CxCrc32` is the standard CRC-32 (as zlib, PNG) with the same interface, used where
+ * the checksum must match other tools (e.g. file transfers). `CxSha1` is SHA-1 as needed by
+ * protocols (e.g. the WebSocket handshake), not for security.
+ *
+ * Usage:
+ * ```cpp
+ * CxHash hash;
+ * serializeJson(doc, hash);
+ * uint32_t nHash = hash.get();
+ * ```
+ *
+ * @date created by ocfu on 17.10.26
+ * @copyright © 2026 ocfu
+ */
+
+#ifndef CxHash_hpp
+#define CxHash_hpp
+
+#include "Arduino.h"
+
+class CxHash : public Print {
+private:
+   static constexpr uint32_t _nFNV_OFFSET = 2166136261UL;
+   static constexpr uint32_t _nFNV_PRIME  = 16777619UL;
+
+   uint32_t _nHash;
+   size_t   _nLength;
+
+public:
+   explicit CxHash(uint32_t nSeed = _nFNV_OFFSET) : _nHash(nSeed), _nLength(0) {}
+
+   void reset(uint32_t nSeed = _nFNV_OFFSET) {_nHash = nSeed; _nLength = 0;}
+
+   virtual size_t write(uint8_t c) override {
+      _nHash ^= c;
+      _nHash *= _nFNV_PRIME;
+      _nLength++;
+      return 1;
+   }
+
+   virtual size_t write(const uint8_t *buffer, size_t size) override {
+      if (!buffer) return 0;
+      for (size_t i = 0; i < size; i++) {
+         _nHash ^= buffer[i];
+         _nHash *= _nFNV_PRIME;
+      }
+      _nLength += size;
+      return size;
+   }
+
+   /// hash value of all bytes written so far
+   uint32_t get() const {return _nHash;}
+
+   /// number of bytes hashed so far
+   size_t length() const {return _nLength;}
+
+   /// hash of a null-terminated string
+   static uint32_t of(const char* sz) {
+      CxHash hash;
+      if (sz) hash.write((const uint8_t*)sz, strlen(sz));
+      return hash.get();
+   }
+};
+
+class CxCrc32 : public Print {
+private:
+   uint32_t _nCrc;
+   size_t   _nLength;
+   
+   /// nibble-wise update, the 16 entry table is a compromise between speed and RAM
+   static uint32_t _update(uint32_t nCrc, uint8_t c) {
+      static const uint32_t aTable[16] = {
+         0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+         0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+      };
+      nCrc = aTable[(nCrc ^ c) & 0x0F] ^ (nCrc >> 4);
+      nCrc = aTable[(nCrc ^ (c >> 4)) & 0x0F] ^ (nCrc >> 4);
+      return nCrc;
+   }
+   
+public:
+   CxCrc32() : _nCrc(0xFFFFFFFFUL), _nLength(0) {}
+   
+   void reset() {_nCrc = 0xFFFFFFFFUL; _nLength = 0;}
+   
+   virtual size_t write(uint8_t c) override {
+      _nCrc = _update(_nCrc, c);
+      _nLength++;
+      return 1;
+   }
+   
+   virtual size_t write(const uint8_t *buffer, size_t size) override {
+      if (!buffer) return 0;
+      for (size_t i = 0; i < size; i++) {
+         _nCrc = _update(_nCrc, buffer[i]);
+      }
+      _nLength += size;
+      return size;
+   }
+   
+   /// CRC of all bytes written so far
+   uint32_t get() const {return ~_nCrc;}
+   
+   /// number of bytes so far
+   size_t length() const {return _nLength;}
+   
+   /// CRC of a buffer
+   static uint32_t of(const uint8_t* buffer, size_t size) {
+      CxCrc32 crc;
+      crc.write(buffer, size);
+      return crc.get();
+   }
+};
+
+class CxSha1 : public Print {
+private:
+   uint32_t _aState[5];
+   uint8_t  _aBlock[64];
+   uint8_t  _nBlock;
+   uint64_t _nLength;   ///< bytes
+   
+   static uint32_t _rol(uint32_t n, uint8_t nBits) {return (n << nBits) | (n >> (32 - nBits));}
+   
+   void _transform() {
+      uint32_t w[80];
+      for (uint8_t i = 0; i < 16; i++) {
+         w[i] = ((uint32_t)_aBlock[i * 4] << 24) | ((uint32_t)_aBlock[i * 4 + 1] << 16) | ((uint32_t)_aBlock[i * 4 + 2] << 8) | _aBlock[i * 4 + 3];
+      }
+      for (uint8_t i = 16; i < 80; i++) w[i] = _rol(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+      
+      uint32_t a = _aState[0], b = _aState[1], c = _aState[2], d = _aState[3], e = _aState[4];
+      for (uint8_t i = 0; i < 80; i++) {
+         uint32_t f, k;
+         if (i < 20) {f = (b & c) | (~b & d); k = 0x5A827999UL;}
+         else if (i < 40) {f = b ^ c ^ d; k = 0x6ED9EBA1UL;}
+         else if (i < 60) {f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDCUL;}
+         else {f = b ^ c ^ d; k = 0xCA62C1D6UL;}
+         uint32_t t = _rol(a, 5) + f + e + k + w[i];
+         e = d; d = c; c = _rol(b, 30); b = a; a = t;
+      }
+      _aState[0] += a; _aState[1] += b; _aState[2] += c; _aState[3] += d; _aState[4] += e;
+      _nBlock = 0;
+   }
+   
+public:
+   CxSha1() {reset();}
+   
+   void reset() {
+      _aState[0] = 0x67452301UL; _aState[1] = 0xEFCDAB89UL; _aState[2] = 0x98BADCFEUL; _aState[3] = 0x10325476UL; _aState[4] = 0xC3D2E1F0UL;
+      _nBlock = 0;
+      _nLength = 0;
+   }
+   
+   virtual size_t write(uint8_t c) override {
+      _aBlock[_nBlock++] = c;
+      _nLength++;
+      if (_nBlock == 64) _transform();
+      return 1;
+   }
+   
+   using Print::write;
+   
+   /// completes the hash, the object needs a reset() before it is used again
+   void get(uint8_t aDigest[20]) {
+      uint64_t nBits = _nLength * 8;
+      write(0x80);
+      while (_nBlock != 56) write(0x00);
+      for (int8_t i = 7; i >= 0; i--) write((uint8_t)(nBits >> (i * 8)));
+      for (uint8_t i = 0; i < 20; i++) aDigest[i] = (uint8_t)(_aState[i / 4] >> (24 - (i % 4) * 8));
+   }
+};
+
+#endif /* CxHash_hpp */
@@ -0,0 +1,53 @@
+//
+//  CxJsonStream.hpp
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+
+#ifndef CxJsonStream_hpp
+#define CxJsonStream_hpp
+
+/**
+ * @brief Output stream writing the content of a json string to a Print
+ * @details Quotes, backslashes and control characters are escaped. It is used to capture the output of
+ * commands into a json response without buffering it, with a CxEscFilterStream in front to remove the
+ * ANSI escape sequences (colors, cursor control). Reading from the stream returns nothing.
+ */
+class CxJsonStringStream : public Stream {
+   Print&  _out;
+   size_t  _nCount = 0;    ///< characters of the content (unescaped)
+
+public:
+   explicit CxJsonStringStream(Print& out) : _out(out) {}
+
+   virtual size_t write(uint8_t c) override {
+      _nCount++;
+      switch (c) {
+         case '"':  _out.print(F("\\\"")); break;
+         case '\\': _out.print(F("\\\\")); break;
+         case '\n': _out.print(F("\\n")); break;
+         case '\r': _out.print(F("\\r")); break;
+         case '\t': _out.print(F("\\t")); break;
+         default:
+            if (c < 0x20) {
+               _out.printf("\\u%04x", c);
+            } else {
+               _out.write(c);
+            }
+      }
+      return 1;
+   }
+
+   using Print::write;
+
+   virtual int available() override {return 0;}
+   virtual int read() override {return -1;}
+   virtual int peek() override {return -1;}
+   virtual void flush() override {}
+
+   size_t getCount() {return _nCount;}
+};
+
+#endif /* CxJsonStream_hpp */
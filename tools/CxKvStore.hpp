@@ -0,0 +1,537 @@
+/**
+ * @file CxKvStore.hpp
+ * @brief Log-structured binary key-value store on LittleFS
+ *
+ * This file defines `CxKvStore`, a singleton storing configuration values as compact binary
+ * records in one file. Records are only appended, an update or delete appends a new record
+ * for the key. At start the file is scanned once and an index (key id -> file offset) is built
+ * in RAM, so a lookup costs one hash and one seek.
+ *
+ * Record format (little endian):
+ * ```
+ * magic(1) type(1) key length(1) value length(2) key value crc32(4)
+ * ```
+ * The CRC covers the header, key and value. A record with a bad magic or CRC ends the scan, which
+ * happens after a power loss during a write (torn write). The valid records before are kept and the
+ * file is compacted before the next write, so the torn tail is never followed by new records.
+ * Compaction (garbage collection) writes the live records to a temporary file, which replaces the
+ * store file, and runs when the file exceeds the compaction size and more than half of it is garbage.
+ * If the file system can't replace the file, the old file is kept as backup until the new one is in
+ * place. begin() completes or discards an interrupted compaction.
+ *
+ * The index is keyed by the hash of the key. Keys with the same hash get their own entries, a lookup
+ * compares the key stored in the record.
+ *
+ * The store keeps the configuration of the console: the settings of the console (CxPersistentBase, see
+ * setImplementation()) as keys <group>.<name>, and the configuration of the EEPROM (wifi, hostname, ota
+ * password, loop delay), see CxCapabilityFS.
+ *
+ * Usage:
+ * ```cpp
+ * CxKvStore& kv = CxKvStore::getInstance();
+ * kv.begin();
+ * kv.setInt("mqtt.port", 1883);
+ * int32_t nPort = kv.getInt("mqtt.port", 1883);
+ * ```
+ *
+ * @date created by ocfu on 17.10.26
+ * @copyright © 2026 ocfu
+ */
+
+#ifndef CxKvStore_hpp
+#define CxKvStore_hpp
+
+#include "Arduino.h"
+#include "CxHash.hpp"
+#include "CxPersistentBase.hpp"
+
+#ifdef ARDUINO
+#include <FS.h>
+#ifdef ESP32
+#include "LITTLEFS.h"
+#define LittleFS LITTLEFS
+#else
+#include <LittleFS.h>
+#endif /* ESP32*/
+#endif /* ARDUINO */
+
+#include <functional>
+#include <unordered_map>
+
+class CxKvStore {
+public:
+   enum e_type : uint8_t {typeDeleted = 0, typeInt = 1, typeFloat = 2, typeBool = 3, typeStr = 4};
+
+   static constexpr uint8_t  _nMAX_KEY = 32;         ///< max. key length
+   static constexpr uint16_t _nMAX_VALUE = 128;      ///< max. value length
+
+private:
+   static constexpr uint8_t _nMAGIC = 0xC5;
+   static constexpr size_t  _nHEADER_SIZE = 5;
+   static constexpr size_t  _nCRC_SIZE = 4;
+   static constexpr size_t  _nMAX_RECORD = _nHEADER_SIZE + _nMAX_KEY + _nMAX_VALUE + _nCRC_SIZE;
+
+   /// index entry of the latest record of a key
+   struct Entry {
+      uint32_t nOffset;       ///< file offset of the record
+      uint16_t nLength;       ///< value length
+      uint8_t  nType;         ///< value type
+      uint8_t  nKeyLen;       ///< key length
+   };
+   using Index = std::unordered_multimap<uint32_t, Entry>;
+
+   String   _strFileName = "/.kv";
+   Index    _mapIndex;                 ///< key: hash of the key
+   bool     _bReady = false;
+   bool     _bTorn = false;            ///< the file has an invalid tail
+   uint32_t _nFileSize = 0;            ///< end of the valid records
+   uint32_t _nLiveSize = 0;            ///< bytes of the latest records of existing keys
+   uint32_t _nCompactSize = 4096;      ///< compact the file above this size
+
+   uint32_t _nWrites = 0;              ///< records appended
+   uint32_t _nCompactions = 0;
+
+   uint8_t  _aBuf[_nMAX_RECORD];       ///< record buffer
+
+   std::function<void(const char*)> _funcChanged;   ///< called with the path of a changed file
+
+   CxKvStore() = default;
+
+   static uint32_t _getId(const char* szKey, size_t nKeyLen) {CxHash hash; hash.write((const uint8_t*)szKey, nKeyLen); return hash.get();}
+   static size_t _getRecordSize(uint8_t nKeyLen, uint16_t nValueLen) {return _nHEADER_SIZE + nKeyLen + nValueLen + _nCRC_SIZE;}
+
+#ifdef ARDUINO
+   /// reads a record at the offset into the buffer, returns its size or 0, if invalid
+   size_t _readRecord(File& file, uint32_t nOffset) {
+      if (!file.seek(nOffset)) return 0;
+      if (file.read(_aBuf, _nHEADER_SIZE) != _nHEADER_SIZE) return 0;
+      if (_aBuf[0] != _nMAGIC) return 0;
+      uint8_t nKeyLen = _aBuf[2];
+      uint16_t nValueLen = _aBuf[3] | (_aBuf[4] << 8);
+      if (nKeyLen == 0 || nKeyLen > _nMAX_KEY || nValueLen > _nMAX_VALUE) return 0;
+
+      size_t nSize = _getRecordSize(nKeyLen, nValueLen);
+      if (file.read(_aBuf + _nHEADER_SIZE, nSize - _nHEADER_SIZE) != nSize - _nHEADER_SIZE) return 0;
+
+      uint32_t nCrc = 0;
+      memcpy(&nCrc, _aBuf + nSize - _nCRC_SIZE, _nCRC_SIZE);
+      if (nCrc != CxCrc32::of(_aBuf, nSize - _nCRC_SIZE)) return 0;
+      return nSize;
+   }
+
+   /// true, if the record at the offset has the key (records in the index are valid)
+   static bool _hasKey(File& file, uint32_t nOffset, const char* szKey, uint8_t nKeyLen) {
+      char szStored[_nMAX_KEY];
+      return file.seek(nOffset + _nHEADER_SIZE) && file.read((uint8_t*)szStored, nKeyLen) == nKeyLen && memcmp(szStored, szKey, nKeyLen) == 0;
+   }
+
+   /// index entry of the key, the candidates with the same hash are compared with the key in their record
+   Index::iterator _find(File& file, const char* szKey, uint8_t nKeyLen) {
+      auto range = _mapIndex.equal_range(_getId(szKey, nKeyLen));
+      for (auto it = range.first; it != range.second; ++it) {
+         if (it->second.nKeyLen == nKeyLen && _hasKey(file, it->second.nOffset, szKey, nKeyLen)) return it;
+      }
+      return _mapIndex.end();
+   }
+
+   /// scans a store file, builds the index and returns the end of the valid records
+   uint32_t _scan(const String& strFileName) {
+      _mapIndex.clear();
+      _nFileSize = 0;
+      _nLiveSize = 0;
+      _bTorn = false;
+
+      File file = LittleFS.open(strFileName, "r");
+      if (!file) return 0;
+      uint32_t nEnd = (uint32_t)file.size();
+
+      while (_nFileSize < nEnd) {
+         size_t nSize = _readRecord(file, _nFileSize);
+         if (!nSize) {
+            _bTorn = true;
+            break;
+         }
+         _index(file, _nFileSize, nSize);
+         _nFileSize += nSize;
+      }
+      file.close();
+      return _nFileSize;
+   }
+   void _scan() {_scan(_strFileName);}
+
+   /// updates the index with the record in the buffer at the offset, file is the store file
+   void _index(File& file, uint32_t nOffset, size_t nSize) {
+      uint8_t nType = _aBuf[1];
+      uint8_t nKeyLen = _aBuf[2];
+      uint16_t nValueLen = _aBuf[3] | (_aBuf[4] << 8);
+
+      char szKey[_nMAX_KEY];
+      memcpy(szKey, _aBuf + _nHEADER_SIZE, nKeyLen);
+
+      auto it = _find(file, szKey, nKeyLen);
+      if (it != _mapIndex.end()) {
+         _nLiveSize -= _getRecordSize(nKeyLen, it->second.nLength);
+         if (nType == typeDeleted) {
+            _mapIndex.erase(it);
+            return;
+         }
+         it->second = {nOffset, nValueLen, nType, nKeyLen};
+      } else if (nType == typeDeleted) {
+         return;
+      } else {
+         _mapIndex.insert({_getId(szKey, nKeyLen), {nOffset, nValueLen, nType, nKeyLen}});
+      }
+      _nLiveSize += nSize;
+   }
+
+   /// replaces the store file with the compacted file, the old file is kept until the new one is in place
+   bool _replace(const String& strTmp) {
+      if (LittleFS.rename(strTmp, _strFileName)) return true;
+      String strBak = _strFileName + ".bak";
+      LittleFS.remove(strBak);
+      LittleFS.rename(_strFileName, strBak);
+      if (!LittleFS.rename(strTmp, _strFileName)) {
+         LittleFS.rename(strBak, _strFileName);
+         return false;
+      }
+      LittleFS.remove(strBak);
+      return true;
+   }
+
+   /// completes or discards an interrupted compaction
+   void _recover() {
+      String strTmp = _strFileName + ".tmp";
+      String strBak = _strFileName + ".bak";
+      bool bChanged = false;
+      if (!LittleFS.exists(_strFileName)) {
+         // interrupted after the old file was moved away, the compacted file is complete if it has no torn tail
+         if (LittleFS.exists(strTmp) && _scan(strTmp) && !_bTorn) bChanged = LittleFS.rename(strTmp, _strFileName);
+         else if (LittleFS.exists(strBak)) bChanged = LittleFS.rename(strBak, _strFileName);
+      }
+      if (LittleFS.exists(strTmp)) bChanged = LittleFS.remove(strTmp) || bChanged;
+      if (LittleFS.exists(strBak)) bChanged = LittleFS.remove(strBak) || bChanged;
+      if (bChanged && _funcChanged) {
+         _funcChanged(_strFileName.c_str());
+         _funcChanged(strTmp.c_str());
+         _funcChanged(strBak.c_str());
+      }
+   }
+#endif
+
+   /// appends a record for the key
+   bool _write(const char* szKey, uint8_t nType, const void* pValue, uint16_t nValueLen) {
+      if (!_bReady || !szKey) return false;
+      size_t nKeyLen = strlen(szKey);
+      if (nKeyLen == 0 || nKeyLen > _nMAX_KEY || nValueLen > _nMAX_VALUE) return false;
+
+      // a torn tail must not be followed by new records, remove garbage before the file grows too much
+      if (_bTorn || (_nFileSize > _nCompactSize && _nLiveSize < _nFileSize / 2)) {
+         if (!compact()) return false;
+      }
+
+      size_t nSize = _getRecordSize(nKeyLen, nValueLen);
+      _aBuf[0] = _nMAGIC;
+      _aBuf[1] = nType;
+      _aBuf[2] = (uint8_t)nKeyLen;
+      _aBuf[3] = nValueLen & 0xFF;
+      _aBuf[4] = nValueLen >> 8;
+      memcpy(_aBuf + _nHEADER_SIZE, szKey, nKeyLen);
+      if (nValueLen) memcpy(_aBuf + _nHEADER_SIZE + nKeyLen, pValue, nValueLen);
+      uint32_t nCrc = CxCrc32::of(_aBuf, nSize - _nCRC_SIZE);
+      memcpy(_aBuf + nSize - _nCRC_SIZE, &nCrc, _nCRC_SIZE);
+
+#ifdef ARDUINO
+      File file = LittleFS.open(_strFileName, "a");
+      if (!file) return false;
+      bool bResult = (file.write(_aBuf, nSize) == nSize);
+      file.close();
+      if (!bResult) {
+         _bTorn = true; // the tail is unknown, compact before the next write
+         return false;
+      }
+      _nWrites++;
+      // the record of an existing key is superseded, its key is compared in the file
+      File fileIndex;
+      if (_mapIndex.count(_getId(szKey, nKeyLen))) fileIndex = LittleFS.open(_strFileName, "r");
+      _index(fileIndex, _nFileSize, nSize);
+      if (fileIndex) fileIndex.close();
+      _nFileSize += nSize;
+      if (_funcChanged) _funcChanged(_strFileName.c_str());
+      return true;
+#else
+      return false;
+#endif
+   }
+
+   /// reads the record of the key into the buffer, returns the index entry or nullptr
+   const Entry* _read(const char* szKey) {
+      if (!_bReady || !szKey) return nullptr;
+      size_t nKeyLen = strlen(szKey);
+      if (nKeyLen == 0 || nKeyLen > _nMAX_KEY || !_mapIndex.count(_getId(szKey, nKeyLen))) return nullptr;
+
+#ifdef ARDUINO
+      File file = LittleFS.open(_strFileName, "r");
+      if (!file) return nullptr;
+      auto it = _find(file, szKey, (uint8_t)nKeyLen);
+      size_t nSize = (it != _mapIndex.end()) ? _readRecord(file, it->second.nOffset) : 0;
+      file.close();
+      return nSize ? &it->second : nullptr;
+#else
+      return nullptr;
+#endif
+   }
+
+   /// value of the record in the buffer
+   const uint8_t* _getValue() const {return _aBuf + _nHEADER_SIZE + _aBuf[2];}
+
+   /// string value of the record in the buffer, terminated in the given buffer (size _nMAX_VALUE + 1)
+   const char* _getValueStr(const Entry* pEntry, char* szValue) const {
+      memcpy(szValue, _getValue(), pEntry->nLength);
+      szValue[pEntry->nLength] = '\0';
+      return szValue;
+   }
+
+public:
+   CxKvStore(const CxKvStore&) = delete;
+   CxKvStore& operator=(const CxKvStore&) = delete;
+
+   static CxKvStore& getInstance() {
+      static CxKvStore instance;
+      return instance;
+   }
+
+   /// scans the store file and builds the index, the file system must be mounted
+   bool begin(const char* szFileName = nullptr) {
+      if (szFileName) _strFileName = szFileName;
+#ifdef ARDUINO
+      _recover();
+      _scan();
+      _bReady = true;
+#endif
+      return _bReady;
+   }
+
+   void end() {
+      _bReady = false;
+      _mapIndex.clear();
+   }
+
+   bool isReady() const {return _bReady;}
+
+   /// writes the latest records of all keys to a new file, which replaces the store file
+   bool compact() {
+      if (!_bReady) return false;
+#ifdef ARDUINO
+      String strTmp = _strFileName + ".tmp";
+      File fileIn = LittleFS.open(_strFileName, "r");
+      File fileOut = LittleFS.open(strTmp, "w");
+      if (!fileOut) {
+         if (fileIn) fileIn.close();
+         return false;
+      }
+
+      bool bResult = true;
+      if (fileIn) {
+         for (auto& entry : _mapIndex) {
+            size_t nSize = _readRecord(fileIn, entry.second.nOffset);
+            if (!nSize) continue; // lost, e.g. file changed by others
+            if (fileOut.write(_aBuf, nSize) != nSize) {
+               bResult = false;
+               break;
+            }
+         }
+         fileIn.close();
+      }
+      fileOut.close();
+
+      if (bResult) bResult = _replace(strTmp);
+      if (!bResult) LittleFS.remove(strTmp);
+      else _nCompactions++;
+      _scan(); // offsets of the compacted or the unchanged file
+      if (_funcChanged) {
+         _funcChanged(_strFileName.c_str());
+         _funcChanged(strTmp.c_str());
+      }
+      return bResult && !_bTorn;
+#else
+      return false;
+#endif
+   }
+
+   // unchanged values are not written again
+   bool setInt(const char* szKey, int32_t nValue) {
+      const Entry* pEntry = _read(szKey);
+      if (pEntry && pEntry->nType == typeInt && memcmp(_getValue(), &nValue, sizeof(nValue)) == 0) return true;
+      return _write(szKey, typeInt, &nValue, sizeof(nValue));
+   }
+   bool setFloat(const char* szKey, float fValue) {
+      const Entry* pEntry = _read(szKey);
+      if (pEntry && pEntry->nType == typeFloat && memcmp(_getValue(), &fValue, sizeof(fValue)) == 0) return true;
+      return _write(szKey, typeFloat, &fValue, sizeof(fValue));
+   }
+   bool setBool(const char* szKey, bool bValue) {
+      uint8_t n = bValue ? 1 : 0;
+      const Entry* pEntry = _read(szKey);
+      if (pEntry && pEntry->nType == typeBool && _getValue()[0] == n) return true;
+      return _write(szKey, typeBool, &n, 1);
+   }
+   bool setStr(const char* szKey, const char* szValue) {
+      if (!szValue) szValue = "";
+      uint16_t nLen = (uint16_t)std::min(strlen(szValue), (size_t)_nMAX_VALUE);
+      const Entry* pEntry = _read(szKey);
+      if (pEntry && pEntry->nType == typeStr && pEntry->nLength == nLen && memcmp(_getValue(), szValue, nLen) == 0) return true;
+      return _write(szKey, typeStr, szValue, nLen);
+   }
+   bool remove(const char* szKey) {
+      if (!_read(szKey)) return true;
+      return _write(szKey, typeDeleted, nullptr, 0);
+   }
+
+   /// type of the key, typeDeleted if not existing
+   uint8_t getType(const char* szKey) {
+      const Entry* pEntry = _read(szKey);
+      return pEntry ? pEntry->nType : typeDeleted;
+   }
+   bool exists(const char* szKey) {return getType(szKey) != typeDeleted;}
+
+   /// typed values of the key, strings are parsed (older versions stored all settings as strings, e.g. "60000", "true")
+   int32_t getInt(const char* szKey, int32_t nDefault) {
+      const Entry* pEntry = _read(szKey);
+      if (!pEntry) return nDefault;
+      switch (pEntry->nType) {
+         case typeInt: {int32_t n; memcpy(&n, _getValue(), sizeof(n)); return n;}
+         case typeFloat: {float f; memcpy(&f, _getValue(), sizeof(f)); return (int32_t)f;}
+         case typeBool: return _getValue()[0];
+         case typeStr: {char sz[_nMAX_VALUE + 1]; return (int32_t)atol(_getValueStr(pEntry, sz));}
+         default: return nDefault;
+      }
+   }
+   float getFloat(const char* szKey, float fDefault) {
+      const Entry* pEntry = _read(szKey);
+      if (!pEntry) return fDefault;
+      switch (pEntry->nType) {
+         case typeFloat: {float f; memcpy(&f, _getValue(), sizeof(f)); return f;}
+         case typeInt: {int32_t n; memcpy(&n, _getValue(), sizeof(n)); return (float)n;}
+         case typeBool: return _getValue()[0];
+         case typeStr: {char sz[_nMAX_VALUE + 1]; return (float)atof(_getValueStr(pEntry, sz));}
+         default: return fDefault;
+      }
+   }
+   bool getBool(const char* szKey, bool bDefault) {
+      const Entry* pEntry = _read(szKey);
+      if (!pEntry) return bDefault;
+      switch (pEntry->nType) {
+         case typeBool: return _getValue()[0] != 0;
+         case typeInt: {int32_t n; memcpy(&n, _getValue(), sizeof(n)); return n != 0;}
+         case typeFloat: {float f; memcpy(&f, _getValue(), sizeof(f)); return f != 0;}
+         case typeStr: {char sz[_nMAX_VALUE + 1]; _getValueStr(pEntry, sz); return strcasecmp(sz, "true") == 0 || atol(sz) != 0;}
+         default: return bDefault;
+      }
+   }
+   /// value of the key as string, numbers are converted
+   String getStr(const char* szKey, const char* szDefault) {
+      const Entry* pEntry = _read(szKey);
+      if (!pEntry) return szDefault ? String(szDefault) : String();
+      const uint8_t* p = _getValue();
+      switch (pEntry->nType) {
+         case typeStr: {
+            String str;
+            str.reserve(pEntry->nLength);
+            for (uint16_t i = 0; i < pEntry->nLength; i++) str += (char)p[i];
+            return str;
+         }
+         case typeInt: {int32_t n; memcpy(&n, p, sizeof(n)); return String(n);}
+         case typeFloat: {float f; memcpy(&f, p, sizeof(f)); return String(f, 6);}
+         case typeBool: return p[0] ? "true" : "false";
+         default: return szDefault ? String(szDefault) : String();
+      }
+   }
+
+   /// calls the callback with the key of each record, the key is valid during the call only
+   void forEach(std::function<void(const char* szKey, uint8_t nType)> cb) {
+      if (!_bReady || !cb) return;
+#ifdef ARDUINO
+      File file = LittleFS.open(_strFileName, "r");
+      if (!file) return;
+      for (auto& entry : _mapIndex) {
+         if (!_readRecord(file, entry.second.nOffset)) continue;
+         char szKey[_nMAX_KEY + 1];
+         memcpy(szKey, _aBuf + _nHEADER_SIZE, _aBuf[2]);
+         szKey[_aBuf[2]] = '\0';
+         cb(szKey, entry.second.nType);
+      }
+      file.close();
+#endif
+   }
+
+   /// key of a setting: <group>.<name>, or <name> without group. False, if it doesn't fit the buffer or the key length.
+   static bool getSettingKey(char* szKey, size_t nSize, const char* szName, const char* szGroup) {
+      if (!szName || !*szName) return false;
+      int n = (szGroup && *szGroup) ? snprintf(szKey, nSize, "%s.%s", szGroup, szName) : snprintf(szKey, nSize, "%s", szName);
+      return n > 0 && (size_t)n < nSize && n <= _nMAX_KEY;
+   }
+
+   /// the settings of the console are stored in this store
+   void setImplementation(CxPersistentBase& impl) {
+      impl.setLoadStrFunc([this](const char* szName, const char* szDefaultValue, const char* szGroup) {
+         char szKey[_nMAX_KEY + 1];
+         if (!getSettingKey(szKey, sizeof(szKey), szName, szGroup)) return szDefaultValue ? String(szDefaultValue) : String();
+         return this->getStr(szKey, szDefaultValue);
+      });
+      impl.setLoadIntFunc([this](const char* szName, int32_t nDefaultValue, const char* szGroup) {
+         char szKey[_nMAX_KEY + 1];
+         if (!getSettingKey(szKey, sizeof(szKey), szName, szGroup)) return nDefaultValue;
+         return this->getInt(szKey, nDefaultValue);
+      });
+      impl.setSaveStrFunc([this](const char* szName, const char* szValue, const char* szComment, const char* szGroup) {
+         char szKey[_nMAX_KEY + 1];
+         if (!getSettingKey(szKey, sizeof(szKey), szName, szGroup)) return false;
+         return this->setStr(szKey, szValue);
+      });
+      impl.setSaveIntFunc([this](const char* szName, int32_t nValue, const char* szComment, const char* szGroup) {
+         char szKey[_nMAX_KEY + 1];
+         if (!getSettingKey(szKey, sizeof(szKey), szName, szGroup)) return false;
+         return this->setInt(szKey, nValue);
+      });
+   }
+
+   /**
+    * @brief Imports a setting of the settings file (a JSON variant), a key already in the store is kept.
+    * @details The value keeps its JSON type. Strings are not converted, also if they are numbers (e.g. of older
+    * versions or a password "007"), the getters parse them.
+    * @return false, if the setting can't be stored (e.g. arrays, too long keys or strings)
+    */
+   template <class TVariant> bool importSetting(const char* szGroup, const char* szName, const TVariant& var) {
+      char szKey[_nMAX_KEY + 1];
+      if (!getSettingKey(szKey, sizeof(szKey), szName, szGroup)) return false;
+      if (exists(szKey)) return true;
+      if (var.template is<bool>()) return setBool(szKey, var.template as<bool>());
+      if (var.template is<int32_t>()) return setInt(szKey, var.template as<int32_t>());
+      if (var.template is<float>()) return setFloat(szKey, var.template as<float>());
+      if (var.template is<const char*>() && strlen(var.template as<const char*>()) <= _nMAX_VALUE) return setStr(szKey, var.template as<const char*>());
+      return false;
+   }
+
+   static const char* getTypeName(uint8_t nType) {
+      switch (nType) {
+         case typeInt: return "int";
+         case typeFloat: return "float";
+         case typeBool: return "bool";
+         case typeStr: return "str";
+         default: return "-";
+      }
+   }
+
+   size_t getKeys() const {return _mapIndex.size();}
+   uint32_t getFileSize() const {return _nFileSize;}
+   uint32_t getLiveSize() const {return _nLiveSize;}
+   uint32_t getWrites() const {return _nWrites;}
+   uint32_t getCompactions() const {return _nCompactions;}
+   bool isTorn() const {return _bTorn;}
+   void setCompactSize(uint32_t set) {_nCompactSize = set;}
+   /// sets the function called with the path of the store file after it was written (e.g. to update a file index)
+   void setFuncChanged(std::function<void(const char*)> f) {_funcChanged = f;}
+   uint32_t getCompactSize() const {return _nCompactSize;}
+};
+
+#endif /* CxKvStore_hpp */
@@ -0,0 +1,241 @@
+//
+//  CxLogFile.hpp
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+
+#ifndef CxLogFile_hpp
+#define CxLogFile_hpp
+
+#include "defines.h"
+#include <functional>
+#include <memory>
+
+#ifdef ARDUINO
+#include <FS.h>
+#ifdef ESP32
+#include "LITTLEFS.h"
+#define LittleFS LITTLEFS
+#else
+#include <LittleFS.h>
+#endif /* ESP32*/
+#endif /* ARDUINO */
+
+/**
+ * @brief Rotating log file (<path>.0 ... <path>.<count-1>) with a RAM buffer
+ * @details Log lines are collected in RAM and appended to the file in whole flash pages. The rest is written,
+ * when the flush period elapsed or a line with a severity at or above the flush level (error, warning) is
+ * added, e.g. the "reboot..." warning. When the current file exceeds the max. size, the files are rotated.
+ */
+class CxLogFile {
+   static constexpr size_t _nPAGE_SIZE = 256;           ///< flash page (program) size of LittleFS
+   static constexpr size_t _nBUF_SIZE = 2 * _nPAGE_SIZE;
+   
+   std::unique_ptr<char[]> _pBuf;
+   size_t   _nLen = 0;
+   bool     _bBusy = false;                 ///< prevents recursion, if writing the file logs an error
+   
+   String   _strPath = "/log";
+   uint32_t _nMaxSize = 16384;              ///< rotate the file at this size
+   uint8_t  _nCount = 3;                    ///< number of files
+   size_t   _nFileSize = 0;                 ///< size of the current file
+   
+   uint8_t  _nFlushLevel = LOGLEVEL_WARN;   ///< lines up to this level are written immediately
+   uint32_t _nFlushPeriod = 60000;          ///< max. time lines are kept in RAM (ms)
+   uint32_t _nFirst = 0;                    ///< time of the oldest line in RAM
+   
+   uint32_t _nWrites = 0;                   ///< flash writes in total
+   uint32_t _nWritesHour = 0;               ///< flash writes in the actual hour
+   uint32_t _nWritesLastHour = 0;           ///< flash writes in the last hour
+   uint32_t _nHourStart = 0;
+   
+   std::function<void(const char*)> _funcChanged;   ///< called with the path of a changed file
+   
+   String _getFile(uint8_t n) const {
+      String str = _strPath;
+      str += '.';
+      str += n;
+      return str;
+   }
+   
+   /// level of a log line "<time> [<c>] <message>"
+   static uint8_t _getLevel(const char* sz) {
+      const char* p = strchr(sz, '[');
+      switch (p ? p[1] : 'I') {
+         case 'E': return LOGLEVEL_ERROR;
+         case 'W': return LOGLEVEL_WARN;
+         case 'D': return LOGLEVEL_DEBUG;
+         case 'X': return LOGLEVEL_DEBUG_EXT;
+         default: return LOGLEVEL_INFO;
+      }
+   }
+   
+   void _write(size_t nLength) {
+#ifdef ARDUINO
+      File file = LittleFS.open(_getFile(0).c_str(), "a");
+      if (file) {
+         file.write((const uint8_t*)_pBuf.get(), nLength);
+         _nFileSize = file.size();
+         file.close();
+         _nWrites++;
+         _nWritesHour++;
+         if (_funcChanged) _funcChanged(_getFile(0).c_str());
+      }
+#endif
+      // keep the rest
+      memmove(_pBuf.get(), _pBuf.get() + nLength, _nLen - nLength);
+      _nLen -= nLength;
+      
+      if (_nFileSize >= _nMaxSize) rotate();
+   }
+   
+public:
+   bool begin() {
+      if (!_pBuf) _pBuf.reset(new (std::nothrow) char[_nBUF_SIZE]);
+      if (!_pBuf) return false;
+      _nLen = 0;
+      _nFileSize = 0;
+#ifdef ARDUINO
+      File file = LittleFS.open(_getFile(0).c_str(), "r");
+      if (file) {
+         _nFileSize = file.size();
+         file.close();
+      }
+#endif
+      _nHourStart = millis();
+      return true;
+   }
+   
+   void end() {
+      flush();
+      _pBuf.reset();
+   }
+   
+   bool isEnabled() const {return (bool)_pBuf;}
+   
+   /**
+    * @brief Adds a log line
+    */
+   void add(const char* sz) {
+      if (!_pBuf || !sz || _bBusy) return;
+      _bBusy = true;
+      
+      uint8_t nLevel = _getLevel(sz);
+      if (!_nLen) _nFirst = millis();
+      
+      // line and '\n'
+      size_t n = strlen(sz) + 1;
+      while (n) {
+         size_t nCopy = std::min(n, _nBUF_SIZE - _nLen);
+         if (n == nCopy) {
+            memcpy(_pBuf.get() + _nLen, sz, nCopy - 1);
+            _pBuf[_nLen + nCopy - 1] = '\n';
+         } else {
+            memcpy(_pBuf.get() + _nLen, sz, nCopy);
+         }
+         _nLen += nCopy;
+         sz += nCopy;
+         n -= nCopy;
+         // write the full pages
+         if (_nLen >= _nPAGE_SIZE) _write(_nLen - (_nLen % _nPAGE_SIZE));
+      }
+      
+      if (nLevel <= _nFlushLevel) _write(_nLen);
+      
+      _bBusy = false;
+   }
+   
+   /// writes all lines kept in RAM
+   void flush() {
+      if (_pBuf && _nLen && !_bBusy) {
+         _bBusy = true;
+         _write(_nLen);
+         _bBusy = false;
+      }
+   }
+   
+   void loop() {
+      if (_nLen && (millis() - _nFirst) >= _nFlushPeriod) flush();
+      if ((millis() - _nHourStart) >= 3600000) {
+         _nHourStart = millis();
+         _nWritesLastHour = _nWritesHour;
+         _nWritesHour = 0;
+      }
+   }
+   
+   /**
+    * @brief Starts a new file, the oldest one is removed
+    */
+   void rotate() {
+#ifdef ARDUINO
+      LittleFS.remove(_getFile(_nCount - 1).c_str());
+      for (int i = _nCount - 2; i >= 0; i--) {
+         LittleFS.rename(_getFile(i).c_str(), _getFile(i + 1).c_str());
+      }
+      for (uint8_t i = 0; _funcChanged && i < _nCount; i++) _funcChanged(_getFile(i).c_str());
+#endif
+      _nFileSize = 0;
+   }
+   
+   /**
+    * @brief Prints the last lines of the log (file and RAM)
+    * @details Only the end of the file is read, backwards in pages until the number of lines is found.
+    */
+   void tail(Print& stream, uint32_t nLines) {
+#ifdef ARDUINO
+      char buf[_nPAGE_SIZE];
+      
+      // lines in RAM are not yet in the file
+      uint32_t nRam = 0;
+      for (size_t i = 0; _pBuf && i < _nLen; i++) if (_pBuf[i] == '\n') nRam++;
+      
+      File file = LittleFS.open(_getFile(0).c_str(), "r");
+      if (file && nLines > nRam) {
+         uint32_t nFind = nLines - nRam + 1; // the newline before the first line
+         size_t nPos = file.size();
+         size_t nStart = 0;
+         while (nPos > 0 && nFind) {
+            size_t nRead = std::min(nPos, sizeof(buf));
+            nPos -= nRead;
+            file.seek(nPos);
+            file.read((uint8_t*)buf, nRead);
+            for (size_t i = nRead; i > 0 && nFind; i--) {
+               if (buf[i - 1] == '\n' && --nFind == 0) nStart = nPos + i;
+            }
+         }
+         file.seek(nStart);
+         size_t n;
+         while ((n = file.read((uint8_t*)buf, sizeof(buf))) > 0) {
+            stream.write((const uint8_t*)buf, n);
+         }
+      }
+      if (file) file.close();
+      
+      // skip the lines in RAM exceeding the requested number
+      size_t i = 0;
+      while (nRam > nLines && i < _nLen) {
+         if (_pBuf[i++] == '\n') nRam--;
+      }
+      if (_pBuf && _nLen > i) stream.write((const uint8_t*)_pBuf.get() + i, _nLen - i);
+#endif
+   }
+   
+   void setPath(const char* sz) {if (sz && sz[0]) _strPath = sz;}
+   const char* getPath() {return _strPath.c_str();}
+   void setMaxSize(uint32_t set) {_nMaxSize = std::max(set, (uint32_t)_nPAGE_SIZE);}
+   uint32_t getMaxSize() {return _nMaxSize;}
+   void setCount(uint8_t set) {_nCount = std::max(set, (uint8_t)1);}
+   uint8_t getCount() {return _nCount;}
+   void setFlushPeriod(uint32_t set) {_nFlushPeriod = set;}
+   uint32_t getFlushPeriod() {return _nFlushPeriod;}
+   size_t getFileSize() {return _nFileSize;}
+   size_t getPending() {return _nLen;}
+   uint32_t getWrites() {return _nWrites;}
+   /// flash writes in the last hour, the actual hour until the first hour is completed
+   uint32_t getWritesPerHour() {return _nWritesLastHour ? _nWritesLastHour : _nWritesHour;}
+   void setFuncChanged(std::function<void(const char*)> f) {_funcChanged = f;}
+};
+
+#endif /* CxLogFile_hpp */
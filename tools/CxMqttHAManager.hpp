@@ -29,8 +29,9 @@
 // How They Work Together
 // 1. CxMqttHADevice creates and manages multiple CxMqttHABase entities.
 // 2. CxMqttHADevice::addItem() adds entities (e.g., sensors, buttons) to _vecItems.
-// 3. CxMqttHADevice::regItems() registers/deregisters all entities with HA.
-// 4. CxMqttHADevice::publishAvailabilityAllItems() updates availability for all entities.
+// 3. CxMqttHADevice::regItems() prepares the topics of all entities and registers/deregisters them with HA.
+//    The registration is spread over several loop iterations by CxMqttHADevice::loopDiscovery().
+// 4. CxMqttHADevice::publishAvailabilityAllItems() updates availability for all registered entities.
 //
 // Suggested Improvements
 //
@@ -56,8 +57,10 @@
 #define CxMqttHA_hpp
 
 #include "CxMqttManager.hpp"
+#include "CxHash.hpp"
 #include "espmath.h"
 #include "ArduinoJson.h"
+#include <inttypes.h>
 
 // Forward declaration for CxMqttHADevice
 class CxMqttHADevice;
@@ -392,6 +395,127 @@ public:
    bool isRetainedCmd() const {return _bRetainedCmd;}
 
    bool isAction() const {return (__szAction != nullptr);}
+   
+protected:
+   //--------------------------------------------------
+   // State templates
+   //--------------------------------------------------
+   
+   static constexpr size_t _nSTATE_MSG_SIZE = 256;
+   static constexpr size_t _nTOPIC_BASE_SIZE = 126;   ///< max. topic base of an entity incl. terminating zero
+   
+   /**
+    * @brief Reusable buffer for state and attribute messages
+    * @details The messages are formatted and published synchronously, one buffer serves all entities.
+    */
+   static char* _getStateBuffer() {
+      static char szState[_nSTATE_MSG_SIZE];
+      return szState;
+   }
+   
+   /**
+    * @brief Get a topic of the entity (<topic base>/<szSub>) in a reusable buffer
+    * @details The buffer fits the max. topic base and the sub topics ("state", "attributes"). A longer topic
+    * is not truncated, which would publish to another topic, but rejected.
+    * @return Topic or nullptr, if it does not fit the buffer
+    */
+   const char* _getTopic(const char* szSub) const {
+      static char szTopic[_nTOPIC_BASE_SIZE + 16];
+      size_t n = (size_t)snprintf(szTopic, sizeof(szTopic), "%s/%s", getTopicBase(), szSub);
+      if (n >= sizeof(szTopic)) {
+         __console.error(F("MQTTHA: topic %s/%s is too long"), getTopicBase(), szSub);
+         return nullptr;
+      }
+      return szTopic;
+   }
+   
+   /**
+    * @brief Append a string to the state buffer, optionally escaped as JSON string content
+    * @return New length, which exceeds the buffer size if the string did not fit
+    */
+   static size_t _appendJson(char* p, size_t n, const char* sz, bool bEscape) {
+      auto put = [p, &n](char c) {if (n + 1 < _nSTATE_MSG_SIZE) p[n] = c; n++;};
+      for (; sz && *sz; sz++) {
+         char c = *sz;
+         if (bEscape && (c == '"' || c == '\\')) {
+            put('\\');
+            put(c);
+         } else if (bEscape && (uint8_t)c < 0x20) {
+            char szEsc[7];
+            snprintf(szEsc, sizeof(szEsc), "\\u%04x", (uint8_t)c);
+            for (char* e = szEsc; *e; e++) put(*e);
+         } else {
+            put(c);
+         }
+      }
+      if (n < _nSTATE_MSG_SIZE) p[n] = '\0';
+      return n;
+   }
+   
+   /**
+    * @brief Format the state message {"value":<value>,"state":"ON|OFF"} and publish it
+    * @param szValue Value, JSON formatted number/null or plain string
+    * @param bQuote Value is a string
+    */
+   void _publishStateValue(const char* szValue, bool bQuote) {
+      char* szState = _getStateBuffer();
+      size_t n = 0;
+      n = _appendJson(szState, n, "{\"value\":", false);
+      if (bQuote) n = _appendJson(szState, n, "\"", false);
+      n = _appendJson(szState, n, szValue, bQuote);
+      if (bQuote) n = _appendJson(szState, n, "\"", false);
+      n = _appendJson(szState, n, getState() ? ",\"state\":\"ON\"}" : ",\"state\":\"OFF\"}", false);
+      
+      if (n < _nSTATE_MSG_SIZE) {
+         _publishStateMsg(szState, n, 0);
+      } else {
+         // too large for the template, e.g. a long text
+         DynamicJsonDocument doc(256 + strlen(szValue));
+         doc["value"] = szValue;
+         publishState(doc);
+      }
+   }
+   
+   /**
+    * @brief Publish a formatted state message in the state topic or add it to the aggregated device state
+    * @param nHeap Temporary heap used to build the message (statistics)
+    */
+   void _publishStateMsg(const char* szState, size_t nLength, size_t nHeap) {
+      CxMqttHABase* pDev = (CxMqttHABase*)__pDev;
+      
+      // in aggregation mode the device collects the state and publishes it with the states of the other entities
+      if (isAggregated() && pDev->aggregateState(getName(), szState, nLength, isRetained())) {
+         pDev->countState(0, nHeap);
+         if (!isAvailable()) publishAvailability(true);
+         return;
+      }
+      
+      const char* szTopic = _getTopic("state");
+      if (!szTopic) return;
+      if (publish(szTopic, szState, isRetained()) && !isAvailable()) {
+         // every published state should make the related entity available automatically.
+         publishAvailability(true);
+      }
+      if (pDev) pDev->countState(1, nHeap);
+   }
+   
+public:
+   //--------------------------------------------------
+   // Device state aggregation (implemented by CxMqttHADevice)
+   //--------------------------------------------------
+   
+   virtual bool isStateAggregation() const {return false;}
+   virtual bool aggregateState(const char* szName, const char* szState, size_t nLength, bool bRetain) {return false;}
+   virtual void countState(uint32_t nMsgs, size_t nHeap) {}
+   
+   /**
+    * @brief Check if the state of the entity is published in the aggregated device state
+    * @details Actions (events) are always published in their own state topic.
+    */
+   bool isAggregated() const {
+      return __pDev && (CxMqttHABase*)__pDev != this && !isAction() && ((CxMqttHABase*)__pDev)->isStateAggregation();
+   }
+   
    const char* getDeviceId() const {
       if (__pDev) {
          return ((CxMqttHABase*)__pDev)->getId();
@@ -447,14 +571,14 @@ public:
     * @param doc JSON document to populate
     */
    void addJsonConfigBase(JsonDocument &doc) {
-      static char szTopicBase[126];
+      static char szTopicBase[_nTOPIC_BASE_SIZE];
       snprintf(szTopicBase, sizeof(szTopicBase), "%s/%s", getRootPath(), getTopicBase());
       doc["~"] = szTopicBase;
       doc[F("name")] = getFriendlyName();
       doc[F("uniq_id")] = getId();
       doc[F("obj_id")] = getId(); // pre-defines the entity id in HA
       doc[F("stat_t")] = F("~/state");
-      doc[F("val_tpl")] = F("{{ value_json.value }}");
+      doc[F("val_tpl")] = F("{{value_json.value}}");
       
       // two conditions for the availability: device and sensor must be online
       if (__pDev) {
@@ -477,9 +601,9 @@ public:
       
       if (__bCmd) {
          doc[F("cmd_t")] = F("~/cmd");
-         doc[F("retain")] = isRetainedCmd();
+         doc[F("ret")] = isRetainedCmd();
          doc[F("qos")] = 1;
-         doc[F("stat_val_tpl")] = F("{{ value_json.state }}");
+         doc[F("stat_val_tpl")] = F("{{value_json.state}}");
          doc[F("en")] = isEnabledByDefault();
       }
       doc[F("json_attr_t")] = F("~/attributes");
@@ -504,15 +628,13 @@ public:
       doc["~"] = getTopicBase();
       doc[F("atype")] = F("trigger");
       doc[F("type")] = F("action");
-      doc[F("topic")] = F("~/state");
-      doc[F("val_tpl")] = F("{{ value_json.value }}");
+      doc[F("t")] = F("~/state");
+      doc[F("val_tpl")] = F("{{value_json.value}}");
       
 
    }
    
-   void getConfigPayload(String& str) {
-      
-      DynamicJsonDocument doc(1024);
+   void getConfigPayload(JsonDocument& doc) {
       
       // add the base config elements
       addJsonConfigBase(doc);
@@ -523,20 +645,44 @@ public:
       // add device config elements from the linked device
       if (__pDev) ((CxMqttHABase*)__pDev)->addJsonConfig(doc);
       
-#ifdef ARDUINO
-      serializeJsonPretty(doc, str);
-#else
-      char szJson[1024];
-      serializeJsonPretty(doc, szJson, sizeof(szJson));
-      str = szJson;
-#endif
+      // the state is picked from the aggregated device state
+      if (isAggregated() && doc[F("stat_t")] == "~/state") {
+         addJsonConfigAggregated(doc);
+      }
+   }
+   
+   /**
+    * @brief Redirect the state topic and templates to the aggregated device state
+    * @details Entities not contained in an aggregated message keep their current state (this.state).
+    * @param doc JSON document to populate
+    */
+   void addJsonConfigAggregated(JsonDocument& doc) {
+      String str;
+      str.reserve(128);
+      
+      str = getRootPath();
+      str += '/';
+      str += ((CxMqttHABase*)__pDev)->getTopicBase();
+      str += F("/state");
+      doc[F("stat_t")] = str;
       
+      const char* aszTpl[][2] = {{"val_tpl", "value"}, {"stat_val_tpl", "state"}};
+      for (auto& tpl : aszTpl) {
+         if (doc.containsKey(tpl[0])) {
+            str = F("{{value_json['");
+            str += getName();
+            str += F("'].");
+            str += tpl[1];
+            str += F(" if '");
+            str += getName();
+            str += F("' in value_json else this.state}}");
+            doc[tpl[0]] = str;
+         }
+      }
    }
    
-   void getActionPayload(String& str) {
+   void getActionPayload(JsonDocument& doc) {
       
-      DynamicJsonDocument doc(1024);
-
       // add the base config elements
       addJsonActionBase(doc);
       
@@ -545,25 +691,65 @@ public:
             
       // add device config elements from the linked device
       if (__pDev) ((CxMqttHABase*)__pDev)->addJsonConfig(doc);
-      
-#ifdef ARDUINO
-      serializeJsonPretty(doc, str);
-#else
-      char szJson[1024];
-      serializeJsonPretty(doc, szJson, sizeof(szJson));
-      str = szJson;
-#endif
-
    }
    
-   void regDiscovery(bool bEnable) {
-      String strPayload;
-      strPayload.reserve(1024);
+   /**
+    * @brief Publish a JSON document (compact)
+    * @details The document is serialized directly into the network client, no payload string is built and the
+    * MQTT client buffer does not need to fit the payload.
+    * @return Number of payload bytes published, 0 on failure
+    */
+   size_t publishJson(const char* topic, const JsonDocument& doc, bool retained = false) {
+      size_t nLength = measureJson(doc);
+      return publish(topic, nLength, [&doc](Print& p) {return serializeJson(doc, p);}, retained) ? nLength : 0;
+   }
+   
+   /**
+    * @brief Result of a discovery registration
+    */
+   struct DiscoveryResult {
+      uint32_t nHash = 0;      ///< in: hash of the last published config (0: unknown), out: hash of the actual config
+      size_t nBytes = 0;       ///< discovery payload bytes published
+      size_t nHeapPeak = 0;    ///< heap in bytes used at the peak while the payloads were built
+      bool bSkipped = false;   ///< config is unchanged and was not published again
+   };
+   
+   /**
+    * @brief Register/unregister the entity at the HA discovery
+    * @details The discovery payloads are hashed when they are generated. If the hash matches the hash of the
+    * last published config (given in pResult), the retained config on the broker is still valid and is not
+    * published again.
+    * @param bEnable True to register, false to unregister
+    * @param pResult Optional, hash of the last published config and statistics of the registration
+    * @return False, if the config could not be published (e.g. connection lost)
+    */
+   bool regDiscovery(bool bEnable, DiscoveryResult* pResult = nullptr) {
+      DiscoveryResult result;
 
       if (bEnable) {
-         getConfigPayload(strPayload);
+         size_t nHeap = g_Heap.available(true);
+         CxHash hash;
          
-         publish(getTopicHADiscovery(), strPayload.c_str(), true); // set retain flag
+         // the action payload is part of the hash, it is built twice if changed to avoid two documents at the same time
+         if (isAction()) {
+            DynamicJsonDocument doc(1024);
+            getActionPayload(doc);
+            serializeJson(doc, hash);
+         }
+         {
+            DynamicJsonDocument doc(1024);
+            getConfigPayload(doc);
+            serializeJson(doc, hash);
+            result.nHeapPeak = nHeap - std::min(nHeap, g_Heap.available(true));
+            result.nHash = hash.get();
+            
+            if (pResult && pResult->nHash && pResult->nHash == result.nHash) {
+               result.bSkipped = true;
+            } else {
+               result.nBytes = publishJson(getTopicHADiscovery(), doc, true); // set retain flag
+               if (!result.nBytes) return false; // not published (e.g. connection lost), try again later
+            }
+         }
          
          if (__bCmd) {
             subscribeCmd();
@@ -573,9 +759,10 @@ public:
             subscribe();
          }
          
-         if (isAction()) {
-            getActionPayload(strPayload);
-            publish(getTopicHAAction(), strPayload.c_str(), true);
+         if (isAction() && !result.bSkipped) {
+            DynamicJsonDocument doc(1024);
+            getActionPayload(doc);
+            result.nBytes += publishJson(getTopicHAAction(), doc, true);
          }
          
          publishAvailability();
@@ -591,22 +778,39 @@ public:
          }
          if (isAction()) {publish(getTopicHAAction(), "", true);}
       }
+      if (pResult) *pResult = result;
+      return true;
    }
    
    //--------------------------------------------------
    // MQTT Operations
    //--------------------------------------------------
 
+   /**
+    * @brief Publish entity state (numeric)
+    * @param fValue New value, formatted with a fixed precision
+    * @param prec Number of decimals
+    */
    void publishState(double fValue, uint8_t prec = 2) {
-      DynamicJsonDocument doc(256);
-      doc["value"] = roundToPrecision(fValue, prec);
-      publishState(doc);
+      char szValue[32];
+      if (std::isnan(fValue) || std::isinf(fValue)) {
+         strcpy(szValue, "null");
+      } else {
+         snprintf(szValue, sizeof(szValue), "%.*f", prec, fValue);
+      }
+      _publishStateValue(szValue, false);
    }
-      
+   
+   /**
+    * @brief Publish entity state (string)
+    * @param szValue New value
+    */
    void publishState(const char* szValue) {
-      DynamicJsonDocument doc(256);
-      doc["value"] = szValue;
-      publishState(doc);
+      if (szValue) {
+         _publishStateValue(szValue, true);
+      } else {
+         _publishStateValue("null", false);
+      }
    }
    
    /**
@@ -614,11 +818,8 @@ public:
     * @param bState New state value
     */
    void publishState(bool bState) {
-      DynamicJsonDocument doc(256);
       _bState = bState;
-      
-      doc["value"] = _bState ? "ON" : "OFF";;
-      publishState(doc);
+      _publishStateValue(_bState ? "ON" : "OFF", true);
    }
 
    /**
@@ -626,17 +827,21 @@ public:
     * @param doc JSON document containing state data
     */
    void publishState(JsonDocument& doc) {
-      String strTopic;
-      String strPayload;
-      
       doc["state"] = getState() ? "ON" : "OFF";
-      serializeJson(doc, strPayload);
-      strTopic = getTopicBase();
-      strTopic += "/state";
-            
-      if (publish(strTopic.c_str(), strPayload.c_str(), isRetained()) && !isAvailable()) {
-         // every published state should make the related entity available automatically.
-         publishAvailability(true);
+      
+      char* szState = _getStateBuffer();
+      size_t nLength = measureJson(doc);
+      if (nLength < _nSTATE_MSG_SIZE) {
+         serializeJson(doc, szState, _nSTATE_MSG_SIZE);
+         _publishStateMsg(szState, nLength, doc.capacity());
+         return;
+      }
+      
+      // too large for the state buffer, stream it
+      const char* szTopic = _getTopic("state");
+      if (szTopic && publishJson(szTopic, doc, isRetained())) {
+         if (!isAvailable()) publishAvailability(true);
+         if (__pDev) ((CxMqttHABase*)__pDev)->countState(1, doc.capacity());
       }
    }
 
@@ -662,20 +867,37 @@ public:
    }
    
    void publishAttributes(const char* szJsonAttr) {
-      String strTopic;
-      
-      strTopic = getTopicBase();
-      strTopic += "/attributes";
-      
-      if (publish(strTopic.c_str(), szJsonAttr, isRetained()) && !isAvailable()) {
+      const char* szTopic = _getTopic("attributes");
+      if (szTopic && publish(szTopic, szJsonAttr, isRetained()) && !isAvailable()) {
          publishAvailability(true);
       };
    }
    
+   /**
+    * @brief Publish a single attribute {"<key>":"<value>"}
+    */
+   void publishAttributes(const char* szKey, const char* szValue) {
+      char* szAttr = _getStateBuffer();
+      size_t n = 0;
+      n = _appendJson(szAttr, n, "{\"", false);
+      n = _appendJson(szAttr, n, szKey, true);
+      n = _appendJson(szAttr, n, "\":\"", false);
+      n = _appendJson(szAttr, n, szValue, true);
+      n = _appendJson(szAttr, n, "\"}", false);
+      if (n < _nSTATE_MSG_SIZE) {
+         publishAttributes(szAttr);
+      } else {
+         DynamicJsonDocument doc(256 + strlen(szValue));
+         doc[szKey] = szValue;
+         publishAttributes(doc);
+      }
+   }
+   
    void publishAttributes(JsonDocument &doc) {
-      String strJsonAttributes;
-      serializeJson(doc, strJsonAttributes);
-      publishAttributes(strJsonAttributes.c_str());
+      const char* szTopic = _getTopic("attributes");
+      if (szTopic && publishJson(szTopic, doc, isRetained()) && !isAvailable()) {
+         publishAvailability(true);
+      }
    }
    
    /**
@@ -749,6 +971,61 @@ private:
    const char* _szUrl;             ///< Product URL
    typedef std::vector<CxMqttHABase*> _t_vecItems;
    _t_vecItems _vecItems;          ///< Managed entities
+   size_t _nDiscoveryHeapPeak = 0; ///< Peak heap usage of the last discovery registration
+   
+   // incremental discovery
+   bool     _bDiscoveryPending = false; ///< Discovery is in progress
+   size_t   _iDiscoveryItem = 0;        ///< Next item to be registered
+   uint32_t _nDiscoveryBudget = 1024;   ///< Max. bytes published per loop iteration (at least one item)
+   uint32_t _nDiscoveryBytes = 0;       ///< Bytes published by the last/current discovery
+   uint32_t _nDiscoveryStart = 0;       ///< Start time of the discovery (ms)
+   uint32_t _nDiscoveryTime = 0;        ///< Time needed to complete the last discovery (ms)
+   uint32_t _nDiscoverySkipped = 0;     ///< Items of the last/current discovery skipped as unchanged
+   
+   // hashes of the published discovery configs (key: hash of the discovery topic)
+   std::map<uint32_t, uint32_t> _mapDiscoveryHash;
+   bool _bDiscoveryHashChanged = false; ///< hash table differs from the persisted one
+   
+   // device state aggregation, the states of the entities are collected in one JSON object {"<name>":{...},...}
+   static constexpr size_t _nSTATE_BUF_SIZE = 512;
+   std::unique_ptr<char[]> _pStateBuf;  ///< aggregated state (allocated once, when aggregation is enabled)
+   size_t   _nStateLen = 0;             ///< length of the aggregated state
+   uint32_t _nStateWindow = 100;        ///< time window to collect the states (ms)
+   uint32_t _nStateWindowStart = 0;     ///< time the first state of the window was collected
+   bool     _bStateRetain = false;      ///< retain the aggregated state, if one of the states is retained
+   
+   // state statistics, per minute
+   uint32_t _nStatePeriodStart = 0;     ///< start of the actual minute
+   uint32_t _nStateMsgs = 0;            ///< state messages in the actual minute
+   uint32_t _nStateHeap = 0;            ///< temporary heap allocated for states in the actual minute
+   uint32_t _nStateMsgsPerMin = 0;      ///< state messages in the last minute
+   uint32_t _nStateHeapPerMin = 0;      ///< temporary heap allocated for states in the last minute
+   
+   /**
+    * @brief Check if the state of an entity is already contained in the aggregated state
+    */
+   bool _hasState(const char* szName) {
+      // search for "<name>": within the collected states only
+      size_t nLen = strlen(szName);
+      const char* p = _pStateBuf.get();
+      for (size_t i = 0; i + nLen + 3 <= _nStateLen; i++) {
+         if (p[i] == '"' && p[i + nLen + 1] == '"' && p[i + nLen + 2] == ':' && memcmp(p + i + 1, szName, nLen) == 0) return true;
+      }
+      return false;
+   }
+   
+   /**
+    * @brief Prepare an entity for the registration (topic base, device link, discovery topic)
+    * @param item Entity to prepare
+    */
+   void _prepareItem(CxMqttHABase* item) {
+      // the device defines the topic base by dedault
+      char szTopicBase[_nTOPIC_BASE_SIZE];
+      snprintf(szTopicBase, sizeof(szTopicBase), "%s/%s", getTopicBase(), item->getName());
+      item->setTopicBase(szTopicBase);
+      item->setDev(this);
+      item->setDiscoveryTopic();
+   }
    
    ~CxMqttHADevice() {
       for (auto item : _vecItems) {
@@ -824,6 +1101,9 @@ public:
       {
          if ((*it) == item) {
             _CONSOLE_DEBUG("delete item %s from HA", item->getFriendlyName());
+            flushState(); // the aggregated state might contain the item
+            // keep the position of a pending discovery
+            if ((size_t)(it - _vecItems.begin()) < _iDiscoveryItem) _iDiscoveryItem--;
             _vecItems.erase(it);
             //delete item;
             break;
@@ -834,35 +1114,243 @@ public:
    
    /**
     * @brief Register/deregister all entities
+    * @details The entities are prepared (topics) immediately. The registration is done incrementally by
+    * loopDiscovery() to avoid a burst of discovery messages, which would stall the loop. The deregistration
+    * is done immediately.
+    * Configs which are unchanged since they were published the last time (same hash) are not published again,
+    * unless bForce is set.
     * @param bEnable True to register, false to deregister
+    * @param bForce True to publish all configs, regardless of their hash
     */
-   void regItems(bool bEnable = true) {
-      _t_vecItems::iterator it = _vecItems.begin();
-      
+   void regItems(bool bEnable = true, bool bForce = false) {
       _CONSOLE_DEBUG("%s %d items to HA", bEnable?"register":"unregister", _vecItems.size());
+      
+      // the topics are needed right away, e.g. for states published before the discovery reached the item
+      for (auto item : _vecItems) {
+         if (item != this) _prepareItem(item);
+      }
+      
+      if (bForce || !bEnable) {
+         // forget the published configs, all of them will be (re-)published or removed
+         if (_mapDiscoveryHash.size()) _bDiscoveryHashChanged = true;
+         _mapDiscoveryHash.clear();
+      }
+      
+      if (bEnable) {
+         _nDiscoveryHeapPeak = 0;
+         _nDiscoverySkipped = 0;
+         _nDiscoveryBytes = 0;
+         _nDiscoveryTime = 0;
+         _nDiscoveryStart = (uint32_t)millis();
+         _iDiscoveryItem = 0;
+         _bDiscoveryPending = true;
+         return;
+      }
+      
+      _bDiscoveryPending = false;
+      
+      for (auto item : _vecItems) {
+         if (item != this) item->regDiscovery(false);
+      }
+   }
+   
+   /**
+    * @brief Continue a pending discovery
+    * @details Registers the next items until the byte budget for this call is used up, but at least one item.
+    * If the MQTT connection is lost, the discovery pauses and resumes with the same item after the reconnect.
+    * @return True, if the discovery is still pending
+    */
+   bool loopDiscovery() {
+      if (!_bDiscoveryPending) return false;
+      if (!CxMqttManager::getInstance().isConnected()) return true; // resume after reconnect
+      
+      uint32_t nBytes = 0;
+      
+      while (_iDiscoveryItem < _vecItems.size() && nBytes < _nDiscoveryBudget) {
+         CxMqttHABase* item = _vecItems[_iDiscoveryItem];
+         if (item != this) {
+            _prepareItem(item);
             
-      while(it != _vecItems.end())
-      {
-         if ((*it) != this) {
-            // the device defines the topic base by dedault
-            char szTopicBase[126];
-            snprintf(szTopicBase, sizeof(szTopicBase), "%s/%s", getTopicBase(), (*it)->getName());
-            (*it)->setTopicBase(szTopicBase);
-            (*it)->setDev(this);
-            (*it)->setDiscoveryTopic();
+            uint32_t nKey = CxHash::of(item->getTopicHADiscovery());
+            DiscoveryResult result;
+            auto itHash = _mapDiscoveryHash.find(nKey);
+            if (itHash != _mapDiscoveryHash.end()) result.nHash = itHash->second;
+            
+            if (!item->regDiscovery(true, &result)) return true; // not published, try the same item again in the next iteration
             
-            (*it)->regDiscovery(bEnable);
+            if (result.bSkipped) {
+               _nDiscoverySkipped++;
+            } else {
+               _mapDiscoveryHash[nKey] = result.nHash;
+               _bDiscoveryHashChanged = true;
+            }
+            
+            nBytes += result.nBytes;
+            if (result.nHeapPeak > _nDiscoveryHeapPeak) _nDiscoveryHeapPeak = result.nHeapPeak;
             
-            if (bEnable) {
-               if (_cbOnEnable) {
-                  _cbOnEnable();
-               }
+            if (_cbOnEnable) {
+               _cbOnEnable();
             }
          }
-         it++;
+         _iDiscoveryItem++;
       }
+      _nDiscoveryBytes += nBytes;
+      
+      if (_iDiscoveryItem >= _vecItems.size()) {
+         _bDiscoveryPending = false;
+         _nDiscoveryTime = (uint32_t)millis() - _nDiscoveryStart;
+         _CONSOLE_INFO(F("HA discovery done: %" PRIu32 " items (%" PRIu32 " unchanged), %" PRIu32 " bytes, %" PRIu32 " ms, peak heap %" PRIu32 " bytes"), (uint32_t)_vecItems.size(), _nDiscoverySkipped, _nDiscoveryBytes, _nDiscoveryTime, (uint32_t)_nDiscoveryHeapPeak);
+      }
+      return _bDiscoveryPending;
    }
    
+   bool isDiscoveryPending() {return _bDiscoveryPending;}
+   
+   /**
+    * @brief Set the max. number of bytes published per loop iteration during discovery
+    * @param set Budget in bytes. At least one item is registered per iteration.
+    */
+   void setDiscoveryBudget(uint32_t set) {_nDiscoveryBudget = set;}
+   uint32_t getDiscoveryBudget() {return _nDiscoveryBudget;}
+   uint32_t getDiscoveryBytes() {return _nDiscoveryBytes;}
+   uint32_t getDiscoveryTime() {return _nDiscoveryTime;}
+   uint32_t getDiscoverySkipped() {return _nDiscoverySkipped;}
+   
+   /**
+    * @brief Save the hashes of the published discovery configs
+    * @param stream Stream to write the binary table to (pairs of key and hash)
+    * @return Number of entries written
+    */
+   size_t saveDiscoveryHashes(Print& stream) {
+      size_t n = 0;
+      for (const auto& entry : _mapDiscoveryHash) {
+         stream.write((const uint8_t*)&entry.first, sizeof(entry.first));
+         stream.write((const uint8_t*)&entry.second, sizeof(entry.second));
+         n++;
+      }
+      _bDiscoveryHashChanged = false;
+      return n;
+   }
+   
+   /**
+    * @brief Load the hashes of the published discovery configs
+    * @param stream Stream to read the binary table from (pairs of key and hash)
+    * @return Number of entries read
+    */
+   size_t loadDiscoveryHashes(Stream& stream) {
+      size_t n = 0;
+      uint32_t aEntry[2];
+      _mapDiscoveryHash.clear();
+      while (stream.readBytes((char*)aEntry, sizeof(aEntry)) == sizeof(aEntry)) {
+         _mapDiscoveryHash[aEntry[0]] = aEntry[1];
+         n++;
+      }
+      _bDiscoveryHashChanged = false;
+      return n;
+   }
+   
+   bool isDiscoveryHashChanged() {return _bDiscoveryHashChanged;}
+   void setDiscoveryHashChanged(bool set) {_bDiscoveryHashChanged = set;}
+   
+   /**
+    * @brief Enable/disable the aggregation of the entity states in one device state topic
+    * @details States collected within the time window are merged into one JSON object and published in
+    * <device topic>/state. The discovery configs pick the values with a template, i.e. the entities must be
+    * registered again after changing the mode.
+    * @param bEnable True to aggregate the states
+    * @param nWindow Time window to collect the states (ms)
+    */
+   void setStateAggregation(bool bEnable, uint32_t nWindow = 100) {
+      flushState();
+      _nStateWindow = nWindow;
+      if (bEnable && !_pStateBuf) {
+         _pStateBuf.reset(new char[_nSTATE_BUF_SIZE]);
+         _pStateBuf[0] = '\0';
+      } else if (!bEnable) {
+         _pStateBuf.reset();
+      }
+   }
+   bool isStateAggregation() const override {return (bool)_pStateBuf;}
+   uint32_t getStateWindow() {return _nStateWindow;}
+   
+   /**
+    * @brief Add the state of an entity to the aggregated device state
+    * @param szName Entity name (key in the aggregated state)
+    * @param szState State of the entity (JSON)
+    * @param nLength Length of the state
+    * @param bRetain Retain flag of the entity
+    * @return False, if the state can't be aggregated and must be published by the entity
+    */
+   bool aggregateState(const char* szName, const char* szState, size_t nLength, bool bRetain) override {
+      if (!_pStateBuf || !szName || !szState) return false;
+      
+      // '{' or ',' + "<name>": + state + '}' + '\0'
+      size_t nNeed = 1 + strlen(szName) + 3 + nLength + 2;
+      if (nNeed > _nSTATE_BUF_SIZE) return false;
+      
+      // a second state of the same entity or no space left, publish the collected states first
+      if (_nStateLen && (_nStateLen + nNeed > _nSTATE_BUF_SIZE || _hasState(szName))) flushState();
+      
+      char* p = _pStateBuf.get();
+      if (!_nStateLen) {
+         p[_nStateLen++] = '{';
+         _nStateWindowStart = millis();
+      } else {
+         p[_nStateLen++] = ',';
+      }
+      _nStateLen += snprintf(p + _nStateLen, _nSTATE_BUF_SIZE - _nStateLen, "\"%s\":", szName);
+      memcpy(p + _nStateLen, szState, nLength);
+      _nStateLen += nLength;
+      p[_nStateLen] = '\0';
+      _bStateRetain |= bRetain;
+      return true;
+   }
+   
+   /**
+    * @brief Publish the collected states
+    */
+   void flushState() {
+      if (!_pStateBuf || !_nStateLen) return;
+      
+      _pStateBuf[_nStateLen++] = '}';
+      _pStateBuf[_nStateLen] = '\0';
+      
+      const char* szTopic = _getTopic("state");
+      if (szTopic) {
+         publish(szTopic, _pStateBuf.get(), _bStateRetain);
+         countState(1, 0);
+      }
+      
+      _nStateLen = 0;
+      _bStateRetain = false;
+   }
+   
+   /**
+    * @brief Publish the collected states at the end of the time window, update the statistics
+    */
+   void loopState() {
+      if (_nStateLen && (millis() - _nStateWindowStart) >= _nStateWindow) {
+         flushState();
+      }
+      if ((millis() - _nStatePeriodStart) >= 60000) {
+         _nStatePeriodStart = millis();
+         _nStateMsgsPerMin = _nStateMsgs;
+         _nStateHeapPerMin = _nStateHeap;
+         _nStateMsgs = 0;
+         _nStateHeap = 0;
+      }
+   }
+   
+   void countState(uint32_t nMsgs, size_t nHeap) override {_nStateMsgs += nMsgs; _nStateHeap += nHeap;}
+   uint32_t getStateMsgsPerMin() {return _nStateMsgsPerMin;}
+   uint32_t getStateHeapPerMin() {return _nStateHeapPerMin;}
+   
+   /**
+    * @brief Peak heap usage of the last discovery registration
+    * @return Heap in bytes
+    */
+   size_t getDiscoveryHeapPeak() {return _nDiscoveryHeapPeak;}
+   
    /**
     * @brief Find entity by name
     * @param szName Entity name
@@ -882,13 +1370,15 @@ public:
    }
 
    
+   /**
+    * @brief Publish the availability of all entities
+    * @details Entities, which are not registered yet by a pending discovery, are skipped. They publish their
+    * availability after their discovery config was sent.
+    */
    void publishAvailabilityAllItems() {
-      _t_vecItems::iterator it = _vecItems.begin();
-      
-      while(it != _vecItems.end())
-      {
-         (*it)->publishAvailability();
-         it++;
+      for (size_t i = 0; i < _vecItems.size(); i++) {
+         if (_bDiscoveryPending && i >= _iDiscoveryItem) break;
+         _vecItems[i]->publishAvailability();
       }
       publishAvailability(); // including me
    }
@@ -908,7 +1398,7 @@ public:
    void addJsonAction(JsonDocument& doc) const {}
    
    void printList(Stream& stream) {
-      CxTablePrinter table(stream);
+      CxTablePrinter table(stream, __console.getTableFormat());
       
       std::vector<String> vHeadLine = {F("Nr"),F("Name"),F("Friendly Name"),F("Type"), F("Available"),F("Retained"),F("Topic Base"), F("Has Cb"), F("/cmd"), F("Variable")};
       std::vector<uint8_t> vWidths =  {  3,  20,  20,  10,   9,   8,  30, 6, 4, 12};
@@ -925,6 +1415,15 @@ public:
          it++;
          n++;
       }
+      
+      // the discovery statistics as free text only, json and kv carry the table alone
+      if (!table.isText()) return;
+      stream.println();
+      if (_bDiscoveryPending) {
+         stream.printf("Discovery: pending (%" PRIu32 "/%" PRIu32 " items, %" PRIu32 " bytes sent)\n", (uint32_t)_iDiscoveryItem, (uint32_t)_vecItems.size(), _nDiscoveryBytes);
+      } else {
+         stream.printf("Discovery: %" PRIu32 " bytes sent in %" PRIu32 " ms, %" PRIu32 " unchanged, peak heap %" PRIu32 " bytes, budget %" PRIu32 " bytes/loop\n", _nDiscoveryBytes, _nDiscoveryTime, _nDiscoverySkipped, (uint32_t)_nDiscoveryHeapPeak, _nDiscoveryBudget);
+      }
    }
       
 };
@@ -1006,8 +1505,8 @@ public:
    
    void addJsonAction(JsonDocument& doc) const {
       // TODO: if more than one action is defined in a device, than the subtype need to be different from each other!
-      doc[F("subtype")] = F("single");
-      doc[F("payload")] = F("single");
+      doc[F("stype")] = F("single");
+      doc[F("pl")] = F("single");
       
    }
    
@@ -1350,7 +1849,7 @@ public:
    //void publishState() {CxMqttHABase::publishState(getOptionStr().c_str());}
       
    void addJsonConfig(JsonDocument &doc) const override {
-      JsonArray arr = doc.createNestedArray("options");
+      JsonArray arr = doc.createNestedArray(F("ops"));
       for (const auto& option : _vOptions) {
          arr.add(option.c_str());
       }
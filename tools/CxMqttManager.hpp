@@ -13,6 +13,8 @@
  * - Handles message publishing, including retained messages and last will messages.
  * - Supports relative and absolute topic paths for flexible topic management.
  * - Provides configurable MQTT server settings (address, port, QoS, buffer size).
+ * - Streams payloads larger than the client buffer directly into the network client,
+ *   so the buffer only needs to fit the incoming messages.
  * - Implements a structured callback mechanism to handle incoming messages efficiently.
  *
  * ## Usage:
@@ -77,6 +79,7 @@
 
 #include <map>
 #include <functional>
+#include <inttypes.h>
 #ifdef ARDUINO
 #include <PubSubClient.h>
 #endif
@@ -87,6 +90,93 @@
 #error "ESP_CONSOLE_NOWIFI was defined. MQTT requires a network to work!"
 #endif
 
+/**
+ * @class CxMqttPublishStream
+ * @brief Print adapter for streamed MQTT publishing (begin, chunked write, end).
+ *
+ * The payload length has to be announced with begin(). Written bytes are collected in a
+ * small chunk buffer and forwarded to the PubSubClient, which passes them directly to the
+ * network client. Payloads larger than the PubSubClient buffer, e.g. serialized JSON
+ * documents, can be published this way without building them in RAM first.
+ */
+class CxMqttPublishStream : public Print {
+private:
+   static constexpr uint16_t _nCHUNK_SIZE = 128;
+
+   PubSubClient& _client;
+   uint8_t  _aChunk[_nCHUNK_SIZE];
+   uint16_t _nFill;             ///< bytes in the chunk buffer
+   size_t   _nLength;           ///< announced payload length
+   size_t   _nWritten;          ///< payload bytes accepted since begin()
+   bool     _bActive;
+
+   bool _flushChunk() {
+      if (_nFill == 0) return true;
+      size_t n = _client.write(_aChunk, _nFill);
+      bool bResult = (n == _nFill);
+      _nFill = 0;
+      return bResult;
+   }
+
+public:
+   explicit CxMqttPublishStream(PubSubClient& client) : _client(client), _nFill(0), _nLength(0), _nWritten(0), _bActive(false) {}
+
+   /**
+    * @brief Starts a streamed publish.
+    * @param topic The absolute topic (already resolved).
+    * @param nLength The exact length of the payload, which will be written.
+    * @param retain Whether the message should be retained.
+    * @return True if the header was sent successfully.
+    */
+   bool begin(const char* topic, size_t nLength, bool retain) {
+      if (_bActive || !topic) return false;
+      _nFill = 0;
+      _nWritten = 0;
+      _nLength = nLength;
+      _bActive = _client.beginPublish(topic, (unsigned int)nLength, retain);
+      return _bActive;
+   }
+
+   virtual size_t write(uint8_t c) override {
+      return write(&c, 1);
+   }
+
+   virtual size_t write(const uint8_t *buffer, size_t size) override {
+      if (!_bActive || !buffer) return 0;
+
+      // never send more than announced, the broker would misinterpret the remaining bytes
+      if (_nWritten + size > _nLength) size = _nLength - _nWritten;
+
+      size_t nDone = 0;
+      while (nDone < size) {
+         size_t n = std::min((size_t)(_nCHUNK_SIZE - _nFill), size - nDone);
+         memcpy(_aChunk + _nFill, buffer + nDone, n);
+         _nFill += n;
+         nDone += n;
+         if (_nFill == _nCHUNK_SIZE && !_flushChunk()) {
+            _bActive = false; // connection is broken, abort
+            break;
+         }
+      }
+      _nWritten += nDone;
+      return nDone;
+   }
+
+   /**
+    * @brief Completes a streamed publish.
+    * @return True if the full announced payload was sent.
+    */
+   bool end() {
+      if (!_bActive) return false;
+      bool bResult = _flushChunk() && (_nWritten == _nLength);
+      _bActive = false;
+      return (_client.endPublish() > 0) && bResult;
+   }
+
+   bool isActive() {return _bActive;}
+   size_t getWritten() {return _nWritten;}
+};
+
 /**
  * @class MQTTManager
  * @brief A class to manage MQTT connections and topic subscriptions using PubSubClient.
@@ -112,6 +202,7 @@ private:
    bool         _bIsInitialized; ///< the mqtt manager is ready to use
    WiFiClient   _wifiClient;    ///< WiFi client for underlying network communication.
    PubSubClient _mqttClient;    ///< MQTT client using the WiFi client.
+   CxMqttPublishStream _publishStream; ///< streamed publishing of large payloads
    String       _strClientId;   ///< Client ID for the MQTT connection
    
    std::map<const char*, std::pair<int, tCallback>, std::less<>> _mapTopicCallbacks; ///< Map of topics and their respective callback functions.
@@ -129,6 +220,8 @@ private:
    String   _strWillMessage;
    bool     _bWill;
    uint32_t _nConnectCntr;
+   uint32_t _nStreamedCntr;              ///< number of streamed publishes
+   String   _strTopicBuf;                ///< reused buffer for resolved publish topics (keeps its capacity)
    
    /**
     * @brief Generates a randomized client ID for the MQTT connection.
@@ -140,6 +233,34 @@ private:
       return clientId;
    }
    
+   /**
+    * @brief Resolves a topic to the absolute topic used on the broker.
+    * A topic starting with '/' is absolute, otherwise it is relative to the root path.
+    * @param topic The topic path.
+    * @param strTopic Storage for the resolved topic, if it has to be built.
+    * @return The resolved topic as a C-string.
+    */
+   const char* _resolveTopic(const char* topic, String& strTopic) {
+      if (topic && topic[0] == '/' && topic[1]) {
+         return topic+1;
+      } else if (topic && topic[0]){
+         strTopic.reserve(_strRootPath.length() + strlen(topic) + 2); // no reallocation, if the storage is reused
+         strTopic = _strRootPath;
+         strTopic += '/';
+         strTopic += topic;
+         return strTopic.c_str();
+      } else {
+         return _strRootPath.c_str();
+      }
+   }
+   
+   /**
+    * @brief Checks if a message fits into the PubSubClient buffer (fixed header, topic length field, topic and payload).
+    */
+   bool _fitsBuffer(const char* topic, size_t nLength) {
+      return (5 + 2 + strlen(topic) + nLength) <= _nBufferSize;
+   }
+   
    /**
     * @brief Resubscribes to all previously subscribed topics.
     */
@@ -168,8 +289,8 @@ public:
     *
     * Fix: Explicitly initialize _mqttClient only when begin() is called.
     */
-   CxMqttManager() : _mqttClient(_wifiClient), _nPort(1883), _nQoS(0), _nLastReconnectAttempt(0),
-   _nBufferSize(128), _bReconnect(true), _strWillMessage(F("offline")), _bWill(false), _nConnectCntr(0), _bIsInitialized(true) {
+   CxMqttManager() : _mqttClient(_wifiClient), _publishStream(_mqttClient), _nPort(1883), _nQoS(0), _nLastReconnectAttempt(0),
+   _nBufferSize(128), _bReconnect(true), _strWillMessage(F("offline")), _bWill(false), _nConnectCntr(0), _nStreamedCntr(0), _bIsInitialized(true) {
       _strClientId = _generateClientId();
    }
    
@@ -407,7 +528,6 @@ public:
       if (_bReconnect && !_mqttClient.connected()) {
          uint32_t now = (uint32_t)millis();
          if (now - _nLastReconnectAttempt > 60000) {
-            _nLastReconnectAttempt = now;
             connect();
          }
       } else {
@@ -428,6 +548,8 @@ public:
     * @return True if the connection is successful, otherwise false.
     */
    bool connect() {
+      CxESPBootPhase phase("mqtt");
+      _nLastReconnectAttempt = (uint32_t)millis(); // the next reconnect attempt is due a minute after any attempt
       bool bConnected = false;
       if (_bWill) {
          // set retained last will topic with message and QoS=1
@@ -460,19 +582,70 @@ public:
    bool publish(const char* topic, const char* payload, bool retain = false) {
       if (!payload) return false;
       
-      // is topic given as an absolute path (indicated with a starting '/'), than ignore the root path.
-      
       _CONSOLE_DEBUG_EXT(DEBUG_FLAG_MQTT_PUBLISH, F("MQTT: publish to %s %s retain = %d "), topic, payload, retain);
 
-      if (topic && topic[0] == '/' && topic[1]) {
-         return _mqttClient.publish(topic+1, payload, retain);
-      } else if (topic && topic[0]){
-         return _mqttClient.publish((_strRootPath + '/' + topic).c_str(), payload, retain);
-      } else {
-         return _mqttClient.publish(_strRootPath.c_str(), payload, retain);
+      const char* szTopic = _resolveTopic(topic, _strTopicBuf);
+      size_t nLength = strlen(payload);
+
+      if (_fitsBuffer(szTopic, nLength)) {
+         return _mqttClient.publish(szTopic, payload, retain);
       }
+      
+      // payload exceeds the client buffer, stream it instead of failing
+      if (!_publishStream.begin(szTopic, nLength, retain)) return false;
+      _publishStream.write((const uint8_t*)payload, nLength);
+      return endPublish();
    }
    
+   /**
+    * @brief Starts a streamed publish. The payload is written to getPublishStream() and
+    * the publish is completed with endPublish().
+    * @param topic The topic path (relative or absolute).
+    * @param nLength The exact length of the payload.
+    * @param retain Whether the message should be retained.
+    * @return True if the publish could be started.
+    */
+   bool beginPublish(const char* topic, size_t nLength, bool retain = false) {
+      if (!isConnected()) return false;
+      
+      return _publishStream.begin(_resolveTopic(topic, _strTopicBuf), nLength, retain);
+   }
+   
+   /**
+    * @brief Stream to write the payload of a streamed publish to.
+    */
+   Print& getPublishStream() {return _publishStream;}
+   
+   /**
+    * @brief Completes a streamed publish.
+    * @return True if the full announced payload was sent.
+    */
+   bool endPublish() {
+      bool bResult = _publishStream.end();
+      if (bResult) _nStreamedCntr++;
+      return bResult;
+   }
+   
+   /**
+    * @brief Publishes a payload of known length, which is written by a callback directly into the network client.
+    * @param topic The topic path.
+    * @param nLength The exact length of the payload.
+    * @param writer Callback writing the payload to the given Print stream.
+    * @param retain Whether the message should be retained.
+    * @return True if the message is published successfully, otherwise false.
+    */
+   bool publish(const char* topic, size_t nLength, std::function<size_t(Print&)> writer, bool retain = false) {
+      if (!writer) return false;
+      
+      _CONSOLE_DEBUG_EXT(DEBUG_FLAG_MQTT_PUBLISH, F("MQTT: stream %" PRIu32 " bytes to %s retain = %d "), (uint32_t)nLength, topic, retain);
+      
+      if (!beginPublish(topic, nLength, retain)) return false;
+      writer(_publishStream);
+      return endPublish();
+   }
+   
+   uint32_t getStreamedCntr() {return _nStreamedCntr;}
+   
    /**
     * @brief Subscribes to a topic with a callback function.
     * @param topic The topic to subscribe to.
@@ -558,7 +731,7 @@ public:
 #endif
    
    void printSubscribtion(Stream& stream) {
-      CxTablePrinter table(stream, "Subscribtions");
+      CxTablePrinter table(stream, __console.getTableFormat(), "Subscribtions");
       
       table.printHeader({F("Variable"), F("Topic"), F("Relative"), F("Command")}, {10, 30, 8, 30});
       
@@ -707,6 +880,13 @@ public:
          return false;
       }
    }
+   bool publish(const char* topic, size_t nLength, std::function<size_t(Print&)> writer, bool retained = false) { ///< Streams a payload of known length to a specific topic.
+      if (_mqttManager.isIntitialized() && _mqttManager.isConnected()) {
+         return _mqttManager.publish(topic, nLength, writer, retained);
+      } else {
+         return false;
+      }
+   }
    
    void subscribe() { ///< Subscribes to the topic (if a callback is set).
       if (! _cb) {
@@ -0,0 +1,256 @@
+//
+//  CxOutputQueue.hpp
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+
+#ifndef CxOutputQueue_hpp
+#define CxOutputQueue_hpp
+
+#include <functional>
+
+#ifdef ESP32
+#include <lwip/sockets.h>
+#endif
+
+/**
+ * @brief Bounded output queue of a console session
+ * @details The output is appended to the queue and sent from loop(), as far as the stream accepts data
+ * without blocking (availableForWrite() or the space function, see setFuncSpace()). The space of the
+ * stream is queried once per drain: in loop() and by a write, which doesn't fit the queue. If the stream
+ * can't take it either, a log line is dropped as a whole, other output (e.g. of commands) waits until the
+ * stream took the queued data. A log line is marked by LogScope with its length, so that it is
+ * sent or dropped completely, even if it arrives in parts (e.g. between the ESC sequences removed by the
+ * filter in front). Streams which don't report their free space are written blocking, until they report
+ * free space once. Reading is passed through to the wrapped stream.
+ *
+ * Counters: deferred bytes (waited in the queue, as the stream was full when it was drained), dropped bytes
+ * (log), time blocked (total and worst case of a single write).
+ */
+class CxOutputQueue : public Stream {
+public:
+   /// bytes the stream takes now without blocking
+   using funcSpace_t = std::function<int()>;
+
+private:
+   /// log line in output, see LogScope
+   struct LogLine_t {
+      bool     bLog = false;
+      size_t   nLen = 0;
+      uint32_t nSeq = 0;      ///< changes with each log line
+   };
+
+   Stream*  _pStream;
+   funcSpace_t _funcSpace;
+   uint8_t* _pBuffer = nullptr;
+   uint16_t _nSize;
+   uint16_t _nHead = 0;
+   uint16_t _nCount = 0;
+   bool     _bReportsSpace = false;  ///< the stream reported free space at least once
+   uint32_t _nLogSeq = 0;            ///< log line, the drop decision was made for
+   bool     _bDropLog = false;       ///< the log line is dropped
+
+   uint16_t _nWaiting = 0;           ///< queued bytes, which found the stream full (counted as deferred)
+   uint32_t _nDeferred = 0;
+   uint32_t _nDropped = 0;
+   uint32_t _nBlockedMs = 0;
+   uint32_t _nMaxBlockedMs = 0;
+
+   static LogLine_t& _logLine() {
+      static LogLine_t line;
+      return line;
+   }
+
+   /// free space of the stream, 0 if unknown
+   size_t _space() {
+      int n = _funcSpace ? _funcSpace() : _pStream->availableForWrite();
+      if (n > 0) _bReportsSpace = true;
+      return (n > 0) ? (size_t)n : 0;
+   }
+
+   /**
+    * @brief Sends queued data, as much as the stream takes without blocking (or all, if bBlock)
+    * @details The space of the stream is queried once. A stream, which never reported free space, is written
+    * blocking.
+    * @return Space of the stream left after sending (non-blocking)
+    */
+   size_t _drain(bool bBlock) {
+      size_t nSpace = 0;
+      if (!bBlock) {
+         nSpace = _space();
+         if (!_bReportsSpace) bBlock = true;
+      }
+      while (_nCount) {
+         size_t n = std::min((size_t)_nCount, (size_t)(_nSize - _nHead)); // contiguous part
+         if (!bBlock) {
+            n = std::min(n, nSpace);
+            if (!n) return _defer();
+         }
+         n = _pStream->write(_pBuffer + _nHead, n);
+         if (!n && !bBlock) return _defer();
+         if (!n) {
+            // stream doesn't take data (e.g. client gone), discard the queue
+            _nCount = 0;
+            _nHead = 0;
+            _nWaiting = 0;
+            return 0;
+         }
+         if (!bBlock) nSpace -= std::min(n, nSpace);
+         _nHead = (_nHead + n) % _nSize;
+         _nCount -= n;
+         _nWaiting -= std::min((uint16_t)n, _nWaiting);
+      }
+      _nHead = 0;
+      return bBlock ? 0 : nSpace;
+   }
+
+   /// the stream is full, the queued bytes wait for the next drain (each byte is counted once)
+   size_t _defer() {
+      _nDeferred += _nCount - _nWaiting;
+      _nWaiting = _nCount;
+      return 0;
+   }
+
+   void _enqueue(const uint8_t* buffer, size_t size) {
+      for (size_t i = 0; i < size; i++) {
+         _pBuffer[(_nHead + _nCount) % _nSize] = buffer[i];
+         _nCount++;
+      }
+   }
+
+   /// blocking write (queued data first), the time is measured as stall of the loop
+   size_t _writeBlocking(const uint8_t* buffer, size_t size) {
+      uint32_t nStart = (uint32_t)millis();
+      _drain(true);
+      size_t n = _pStream->write(buffer, size);
+      uint32_t nTime = (uint32_t)millis() - nStart;
+      _nBlockedMs += nTime;
+      if (nTime > _nMaxBlockedMs) _nMaxBlockedMs = nTime;
+      return n;
+   }
+
+public:
+   CxOutputQueue(Stream* pStream, uint16_t nSize) : _pStream(pStream), _nSize(nSize) {
+      if (_nSize) _pBuffer = new uint8_t[_nSize];
+      if (!_pBuffer) _nSize = 0;
+   }
+   ~CxOutputQueue() {delete[] _pBuffer;}
+
+   CxOutputQueue(const CxOutputQueue&) = delete;
+   CxOutputQueue& operator=(const CxOutputQueue&) = delete;
+
+   /// marks the output within the scope as a log line of nLen bytes (dropped first, as a whole)
+   class LogScope {
+      bool   _bPrev;
+      size_t _nPrevLen;
+   public:
+      explicit LogScope(size_t nLen) : _bPrev(_logLine().bLog), _nPrevLen(_logLine().nLen) {
+         _logLine().bLog = true;
+         _logLine().nLen = nLen;
+         _logLine().nSeq++;
+      }
+      ~LogScope() {
+         _logLine().bLog = _bPrev;
+         _logLine().nLen = _nPrevLen;
+      }
+   };
+
+   virtual size_t write(uint8_t c) override {return write(&c, 1);}
+
+   virtual size_t write(const uint8_t* buffer, size_t size) override {
+      if (!_pStream) return 0;
+      if (!size) return 0;
+
+      const LogLine_t& line = _logLine();
+      if (line.bLog && line.nSeq == _nLogSeq && _bDropLog) {
+         // the rest of a log line, which didn't fit
+         _nDropped += size;
+         return size;
+      }
+
+      if (!_nSize) return _pStream->write(buffer, size);
+
+      // the output is appended, the queue is drained by the loop or, if it doesn't fit, once here
+      bool bNewLog = line.bLog && line.nSeq != _nLogSeq;
+      size_t nFree = _nSize - _nCount;
+      size_t nSpace = 0; // bytes the stream takes now, known after a drain
+      if (size > nFree || (bNewLog && line.nLen > nFree)) {
+         nSpace = _drain(false);
+         nFree = _nSize - _nCount;
+      }
+
+      if (bNewLog) {
+         // the first part of a log line decides for the whole line, don't block the loop for it
+         _nLogSeq = line.nSeq;
+         _bDropLog = _bReportsSpace && (line.nLen > nSpace + nFree);
+      }
+      if (line.bLog && _bReportsSpace && (_bDropLog || size > nSpace + nFree)) {
+         _nDropped += size;
+         _bDropLog = true;
+         return size;
+      }
+
+      if (size <= nFree) {
+         _enqueue(buffer, size);
+         return size;
+      }
+
+      // send what the stream takes now (the queue is empty then), queue what fits, block for the rest
+      size_t nSent = (!_nCount && nSpace) ? _pStream->write(buffer, std::min(size, nSpace)) : 0;
+      size_t nQueue = std::min(size - nSent, nFree);
+      _enqueue(buffer + nSent, nQueue);
+      if (nSent + nQueue < size) _writeBlocking(buffer + nSent + nQueue, size - nSent - nQueue);
+      return size;
+   }
+
+   /// sends queued data without blocking, to be called by the loop
+   void loop() {
+      if (_nCount) _drain(false);
+   }
+
+   /// blocks until all queued data is sent
+   virtual void flush() override {
+      if (_nCount) {
+         uint32_t nStart = (uint32_t)millis();
+         _drain(true);
+         _nBlockedMs += (uint32_t)millis() - nStart;
+      }
+      if (_pStream) _pStream->flush();
+   }
+
+   virtual int available() override {return _pStream ? _pStream->available() : 0;}
+   virtual int read() override {return _pStream ? _pStream->read() : -1;}
+   virtual int peek() override {return _pStream ? _pStream->peek() : -1;}
+   virtual int availableForWrite() override {return _nSize - _nCount;}
+
+   /// for streams, which don't report their free space with availableForWrite()
+   void setFuncSpace(funcSpace_t f) {_funcSpace = f;}
+
+#ifdef ESP32
+   static constexpr int _nSOCKET_SPACE = 1024;
+
+   /// space function of a socket: the WiFiClient of the ESP32 reports no free space and its write() waits up to
+   /// seconds for a full send buffer. lwIP reports the socket writable above the low water mark of the send
+   /// buffer, a part below a segment is taken then without waiting.
+   static int socketSpace(int fd) {
+      if (fd < 0) return 0;
+      fd_set set;
+      FD_ZERO(&set);
+      FD_SET(fd, &set);
+      struct timeval tv = {0, 0};
+      return (select(fd + 1, nullptr, &set, nullptr, &tv) > 0) ? _nSOCKET_SPACE : 0;
+   }
+#endif
+
+   Stream* getStream() {return _pStream;}
+   uint16_t getSize() {return _nSize;}
+   uint16_t getQueued() {return _nCount;}
+   uint32_t getDeferred() {return _nDeferred;}
+   uint32_t getDropped() {return _nDropped;}
+   uint32_t getBlockedMs() {return _nBlockedMs;}
+   uint32_t getMaxBlockedMs() {return _nMaxBlockedMs;}
+};
+
+#endif /* CxOutputQueue_hpp */
@@ -3,6 +3,9 @@
 
 #define JSON_MAX_SIZE 1024 // Maximum size for JSON document
 
+#include "ArduinoJson.h"
+#include <functional>
+
 #ifdef ARDUINO
 #include <FS.h>
 #ifdef ESP32
@@ -23,11 +26,15 @@ struct FSInfo {
 #endif /* ARDUINO */
 
 /// \class CxPersistentImpl
-/// \brief A singleton class for managing persistent settings stored in a JSON file using LittleFS.
+/// \brief A singleton class for reading the settings file (JSON) of former versions using LittleFS.
+/// \details The settings are kept in the key-value store (CxKvStore). The settings file is read once to import its
+/// settings (see CxCapabilityFS) and removed after. Former versions stored all values as strings.
 class CxPersistentImpl {
 private:
    String _strFileName;
    
+   std::function<void(const char*)> _funcChanged; ///< called with the path of a changed file
+   
    /// \brief Private constructor to enforce the Singleton pattern.
    CxPersistentImpl() : _strFileName("/settings.json") {}
    
@@ -46,21 +53,6 @@ private:
 #endif
    }
    
-   /// \brief Saves the JSON document to the file.
-   bool saveJson(const DynamicJsonDocument& doc) {
-#ifdef ARDUINO
-      File file = LittleFS.open(_strFileName, "w");
-      if (!file) {
-         return false;
-      }
-      serializeJson(doc, file);
-      file.close();
-      return true;
-#else
-      return false; // Not implemented for non-ARDUINO platforms
-#endif
-   }
-   
 public:
    /// \brief Deleted copy constructor and assignment operator to prevent copying.
    CxPersistentImpl(const CxPersistentImpl&) = delete;
@@ -72,107 +64,37 @@ public:
       return instance;
    }
    
-   void setImplementation(CxPersistentBase& impl) {
-      impl.setLoadStrFunc([this](const char* szName, const char* szDefaultValue, const char* szGroup) {
-         return this->loadSettingStr(szName, szDefaultValue, szGroup);
-      });
-      impl.setLoadIntFunc([this](const char* szName, int32_t nDefaultValue, const char* szGroup) {
-         return this->loadSettingInt(szName, nDefaultValue, szGroup);
-      });
-      impl.setSaveStrFunc([this](const char* szName, const char* szValue, const char* szComment, const char* szGroup) {
-         return this->saveSettingStr(szName, szValue, szComment, szGroup);
-      });
-      impl.setSaveIntFunc([this](const char* szName, int32_t nValue, const char* szComment, const char* szGroup) {
-         return this->saveSettingInt(szName, nValue, szComment, szGroup);
-      });
-   }
+   /// \brief Sets the file name of the settings file.
+   void setFileName(const char* szFileName) {_strFileName = szFileName;}
    
-   /// \brief Sets the file name for storing settings.
-   void setFileName(const char* szFileName) {
-      _strFileName = szFileName;
-   }
-   
-   /// \brief Saves a string setting to the JSON file.
-   bool saveSettingStr(const char* szName, const char* szValue, const char* szComment = "", const char* szGroup = "") {
+   /// \brief Calls the callback for each setting of the file, the group is "" for settings without group.
+   void forEach(std::function<void(const char* szGroup, const char* szName, JsonVariant var)> cb) {
       DynamicJsonDocument doc(JSON_MAX_SIZE);
-      if (!loadJson(doc)) {
-         doc.clear(); // Start with an empty document if loading fails
-      }
-      JsonObject target;
-      if (strlen(szGroup) > 0) {
-         JsonObject group = doc[szGroup];
-         if (!group) {
-            group = doc.createNestedObject(szGroup);
+      if (!cb || !loadJson(doc) || !doc.is<JsonObject>()) return;
+      for (JsonPair pair : doc.as<JsonObject>()) {
+         if (pair.value().is<JsonObject>()) {
+            for (JsonPair setting : pair.value().as<JsonObject>()) {
+               cb(pair.key().c_str(), setting.key().c_str(), setting.value());
+            }
+         } else {
+            cb("", pair.key().c_str(), pair.value());
          }
-         target = group;
-      } else {
-         target = doc.as<JsonObject>();
-      }
-      
-      target[szName] = szValue;
-      
-      return saveJson(doc);
-   }
-   
-   
-   /// \brief Saves an integer setting to the JSON file.
-   bool saveSettingInt(const char* szName, int32_t nValue, const char* szComment = "", const char* szGroup = "") {
-      // TODO: save as integer value, not as a string
-      char szValue[12];
-      
-      snprintf(szValue, sizeof(szValue), "%d", nValue);
-      return saveSettingStr(szName, szValue, szComment, szGroup);
-   }
-   
-   /// \brief Saves a float setting to the JSON file.
-   bool saveSettingFloat(const char* szName, float fValue, const char* szComment = "", const char* szGroup = "") {
-      // TODO: save as float value, not as a string
-
-      char szValue[16];
-      
-      snprintf(szValue, sizeof(szValue), "%.6f", fValue);
-      return saveSettingStr(szName, szValue, szComment, szGroup);
-   }
-   
-   /// \brief Saves a boolean setting to the JSON file.
-   bool saveSettingBool(const char* szName, bool bValue, const char* szComment = "", const char* szGroup = "") {
-      // TODO: save as bool value, not as a string
-      return saveSettingStr(szName, bValue ? "true" : "false", szComment, szGroup);
-   }
-   
-   /// \brief Loads a string setting from the JSON file.
-   String loadSettingStr(const char* szName, const char* szDefaultValue, const char* szGroup = "") {
-      DynamicJsonDocument doc(JSON_MAX_SIZE);
-      if (!loadJson(doc)) {
-         return String(szDefaultValue);
-      }
-      
-      JsonObject group = strlen(szGroup) > 0 ? doc[szGroup].as<JsonObject>() : doc.as<JsonObject>();
-      if (group && group.containsKey(szName)) {
-         return String(group[szName].as<const char*>());
       }
-      
-      return String(szDefaultValue);
    }
    
-   /// \brief Loads an integer setting from the JSON file.
-   int32_t loadSettingInt(const char* szName, int32_t nDefaultValue, const char* szGroup = "") {
-      String value = loadSettingStr(szName, String(nDefaultValue).c_str(), szGroup);
-      return value.toInt();
-   }
-   
-   /// \brief Loads a float setting from the JSON file.
-   float loadSettingFloat(const char* szName, float fDefaultValue, const char* szGroup = "") {
-      String value = loadSettingStr(szName, String(fDefaultValue, 6).c_str(), szGroup);
-      return value.toFloat();
+   /// \brief Removes the settings file, e.g. after the settings were moved to another store.
+   bool removeFile() {
+#ifdef ARDUINO
+      bool bResult = !LittleFS.exists(_strFileName) || LittleFS.remove(_strFileName);
+      if (_funcChanged) _funcChanged(_strFileName.c_str());
+      return bResult;
+#else
+      return false;
+#endif
    }
    
-   /// \brief Loads a boolean setting from the JSON file.
-   bool loadSettingBool(const char* szName, bool bDefaultValue, const char* szGroup = "") {
-      String value = loadSettingStr(szName, bDefaultValue ? "true" : "false", szGroup);
-      return value.equalsIgnoreCase("true");
-   }
+   /// \brief Sets the function called with the path of a file changed by the settings (e.g. to update a file index).
+   void setFuncChanged(std::function<void(const char*)> f) {_funcChanged = f;}
 };
 
 #endif // CX_PERSISTENT_IMPL_H
-
@@ -69,36 +69,19 @@ public:
       _timerOff.loop();
    }
 
-   virtual const std::vector<String> getHeadLine(bool bDefault = true) override {
-      if (bDefault) {
-         return CxGPIODevice::getHeadLine();
-      } else {
-         std::vector<String> headLine = CxGPIODevice::getHeadLine();
-         headLine.push_back(F("Off-timer"));
-         headLine.push_back(F("Default-on"));
-         return headLine;
-      }
-   };
-   
-   virtual const std::vector<uint8_t> getWidths(bool bDefault = true) override {
-      if (bDefault) {
-         return CxGPIODevice::getWidths();
-      } else {
-         std::vector<uint8_t> widths = CxGPIODevice::getWidths();
-         widths.push_back(10); // off-timer
-         widths.push_back(10); // default-on
-         return widths;
+   virtual void addColumns(CxTablePrinter& table, bool bDefault = true) override {
+      CxGPIODevice::addColumns(table);
+      if (!bDefault) {
+         table.addColumn(F("Off-timer"), 10);
+         table.addColumn(F("Default-on"), 10);
       }
-   };
+   }
    
-   virtual const std::vector<String> getData(bool bDefault = true) override {
-      if (bDefault) {
-         return CxGPIODevice::getData();
-      } else {
-         std::vector<String> data = CxGPIODevice::getData();
-         data.push_back(String(_timerOff.getPeriod()));
-         data.push_back(isDefaultOn() ? "yes" : "no");
-         return data;
+   virtual void printCells(CxTablePrinter& table, bool bDefault = true) override {
+      CxGPIODevice::printCells(table);
+      if (!bDefault) {
+         table.cell(_timerOff.getPeriod());
+         table.cell(isDefaultOn());
       }
    }
 
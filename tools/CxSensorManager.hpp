@@ -510,13 +510,19 @@ public:
     * @brief Print a list of all sensors to the console.
     */
    void printList() {
-      CxTablePrinter table(*__console.getStream());
+      CxTablePrinter table(*__console.getStream(), __console.getTableFormat());
       
-      table.printHeader({F("Id"), F("Name"), F("Type"), F("Model"), F("Value"), F("Unit")}, {2,11,15,8,8,8});
+      table.printHeader({{F("Id"), 2}, {F("Name"), 11}, {F("Type"), 15}, {F("Model"), 8}, {F("Value"), 8}, {F("Unit"), 8}});
 
       /// iterate over all sensors and print formated sensor information
       for (const auto& [nId, pSensor] : _mapSensors) {
-         table.printRow({String(nId).c_str(), pSensor->getName(), pSensor->getTypeSz(), pSensor->getModel() , String(pSensor->getFloatValue()).c_str(), pSensor->getUnit()});
+         table.cell(nId);
+         table.cell(pSensor->getName());
+         table.cell(pSensor->getTypeSz());
+         table.cell(pSensor->getModel());
+         table.cell(pSensor->getFloatValue());
+         table.cell(pSensor->getUnit());
+         table.endRow();
       }
    }
    
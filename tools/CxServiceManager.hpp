@@ -0,0 +1,201 @@
+//
+//  CxServiceManager.hpp
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+
+#ifndef CxServiceManager_hpp
+#define CxServiceManager_hpp
+
+#include <inttypes.h>
+#include <vector>
+#include <functional>
+
+/**
+ * @brief Starts services as soon as the services they depend on are ready
+ * @details A service is registered with its dependencies and functions to check, if it is enabled and ready.
+ * The optional start function is called, when all dependencies are ready. It must not block, the
+ * service is polled with the ready function in the loop. If a service isn't ready after the retry
+ * period, it is started again. A service without a start function is only observed, e.g. if it
+ * reconnects by itself. If a dependency gets lost, the service waits for it again.
+ * The time to ready (since boot) and the start duration are kept for each service.
+ *
+ * Example:
+ * ```cpp
+ * CxServiceManager::getInstance().addService("ntp", {"wifi"},
+ *    [](){ return ntp.isSynced(); },          // ready
+ *    [](){ ntp.sync(); },                     // start
+ *    [](){ return ntp.hasServer(); });        // enabled
+ * ```
+ */
+class CxServiceManager {
+public:
+   enum class e_state : uint8_t {off, waiting, starting, ready};
+
+   struct Service {
+      const char* szName;
+      std::vector<const char*> vDeps;
+      std::function<bool()> fnReady;
+      std::function<void()> fnStart;      ///< optional, started elsewhere (e.g. by a batch command), if not set
+      std::function<bool()> fnEnabled;    ///< optional, always enabled, if not set
+      e_state  state = e_state::waiting;
+      uint32_t nStart = 0;                ///< time of the (last) start (ms)
+      uint32_t nTimeToReady = 0;          ///< first time ready since boot (ms), 0 if never
+      uint32_t nStartDuration = 0;        ///< last duration from start to ready (ms)
+      uint32_t nStarts = 0;
+   };
+
+private:
+   CxESPConsoleMaster& __console = CxESPConsoleMaster::getInstance();
+   
+   std::vector<Service> _vServices;
+   uint32_t _nRetry = 30000;              ///< restart a service, if not ready after this time (ms)
+
+   CxServiceManager() = default;
+
+   Service* _find(const char* szName) {
+      if (!szName) return nullptr;
+      for (auto& service : _vServices) {
+         if (strcmp(service.szName, szName) == 0) return &service;
+      }
+      return nullptr;
+   }
+
+   bool _isDepsReady(const Service& service) {
+      for (const char* szDep : service.vDeps) {
+         if (!isReady(szDep)) return false;
+      }
+      return true;
+   }
+
+   void _start(Service& service) {
+      service.state = e_state::starting;
+      service.nStart = (uint32_t)millis();
+      if (service.fnStart) {
+         service.nStarts++;
+         service.fnStart();
+      }
+   }
+
+public:
+   CxServiceManager(const CxServiceManager&) = delete;
+   CxServiceManager& operator=(const CxServiceManager&) = delete;
+
+   static CxServiceManager& getInstance() {
+      static CxServiceManager instance;
+      return instance;
+   }
+
+   /**
+    * @brief Registers a service, a service registered again replaces the former one
+    * @param szName Name of the service (static string)
+    * @param vDeps Names of the services it depends on
+    */
+   void addService(const char* szName, std::vector<const char*> vDeps, std::function<bool()> fnReady, std::function<void()> fnStart = nullptr, std::function<bool()> fnEnabled = nullptr) {
+      if (!szName || !fnReady) return;
+      Service* pService = _find(szName);
+      if (!pService) {
+         _vServices.emplace_back();
+         pService = &_vServices.back();
+      }
+      pService->szName = szName;
+      pService->vDeps = std::move(vDeps);
+      pService->fnReady = fnReady;
+      pService->fnStart = fnStart;
+      pService->fnEnabled = fnEnabled;
+      pService->state = e_state::waiting;
+   }
+
+   void removeService(const char* szName) {
+      for (auto it = _vServices.begin(); it != _vServices.end(); ++it) {
+         if (strcmp(it->szName, szName) == 0) {
+            _vServices.erase(it);
+            return;
+         }
+      }
+   }
+
+   /// true, if the service is ready. Unknown services are considered as not ready.
+   bool isReady(const char* szName) {
+      Service* pService = _find(szName);
+      return pService && pService->state == e_state::ready;
+   }
+
+   void loop() {
+      for (auto& service : _vServices) {
+         if (service.fnEnabled && !service.fnEnabled()) {
+            service.state = e_state::off;
+            continue;
+         }
+
+         bool bReady = service.fnReady();
+         bool bDeps = _isDepsReady(service);
+
+         switch (service.state) {
+            case e_state::off:
+            case e_state::waiting:
+               if (bReady) {
+                  // started elsewhere
+                  service.nStart = (uint32_t)millis();
+                  service.state = e_state::starting;
+               } else if (bDeps) {
+                  _start(service);
+               }
+               break;
+            case e_state::starting:
+               if (!bDeps && !bReady) {
+                  service.state = e_state::waiting;
+               } else if (bReady) {
+                  uint32_t now = (uint32_t)millis();
+                  service.state = e_state::ready;
+                  service.nStartDuration = now - service.nStart;
+                  if (!service.nTimeToReady) {
+                     service.nTimeToReady = now ? now : 1;
+                     char szPhase[CxESPBootProfiler::_nMAX_NAME];
+                     snprintf(szPhase, sizeof(szPhase), "svc:%s", service.szName);
+                     g_Boot.add(szPhase, service.nStart * 1000, service.nStartDuration * 1000);
+                  }
+                  _CONSOLE_INFO(F("service %s ready after %" PRIu32 " ms"), service.szName, service.nStartDuration);
+               } else if ((uint32_t)millis() - service.nStart >= _nRetry) {
+                  _start(service);
+               }
+               break;
+            case e_state::ready:
+               if (!bReady) {
+                  _CONSOLE_INFO(F("service %s lost"), service.szName);
+                  service.state = e_state::waiting;
+               }
+               break;
+         }
+      }
+   }
+
+   static const char* getStateName(e_state state) {
+      switch (state) {
+         case e_state::off: return "off";
+         case e_state::waiting: return "waiting";
+         case e_state::starting: return "starting";
+         case e_state::ready: return "ready";
+      }
+      return "";
+   }
+
+   void print(Stream& stream) {
+      stream.println(F(ESC_ATTR_BOLD "Service   State     Ready ms  Start ms  Starts  Depends on" ESC_ATTR_RESET));
+      for (auto& service : _vServices) {
+         stream.printf("%-9s %-9s %8" PRIu32 "  %8" PRIu32 "  %6" PRIu32 " ", service.szName, getStateName(service.state), service.nTimeToReady, service.nStartDuration, service.nStarts);
+         for (const char* szDep : service.vDeps) {
+            stream.print(' ');
+            stream.print(szDep);
+         }
+         stream.println();
+      }
+   }
+
+   const std::vector<Service>& getServices() {return _vServices;}
+   void setRetry(uint32_t set) {_nRetry = set;}
+};
+
+#endif /* CxServiceManager_hpp */
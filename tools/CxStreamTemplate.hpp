@@ -0,0 +1,104 @@
+//
+//  CxStreamTemplate.hpp
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+
+#ifndef CxStreamTemplate_hpp
+#define CxStreamTemplate_hpp
+
+#include <functional>
+
+/**
+ * @brief Renders a template from PROGMEM to a Print, placeholders '{{name}}' are replaced by a callback
+ * @details The template is streamed, the page is never built in RAM. The callback prints the value of the
+ * placeholder to the output. Unknown placeholders are printed empty.
+ *
+ * Example:
+ * ```cpp
+ * CxStreamTemplate::render(html_data_js, sizeof(html_data_js), out, [](const char* szName, Print& out) {
+ *    if (strcmp(szName, "hostname") == 0) out.print(hostname);
+ * });
+ * ```
+ */
+class CxStreamTemplate {
+public:
+   static constexpr uint8_t _nMAX_NAME = 24;
+
+   typedef std::function<void(const char* szName, Print& out)> cb_t;
+
+   static void render(const uint8_t* pTemplate, size_t nLength, Print& out, cb_t cb) {
+      size_t i = 0;
+      while (i < nLength) {
+         char c = (char)pgm_read_byte(pTemplate + i);
+         if (c == '{' && i + 1 < nLength && (char)pgm_read_byte(pTemplate + i + 1) == '{') {
+            char szName[_nMAX_NAME];
+            uint8_t n = 0;
+            size_t j = i + 2;
+            // read the name until '}}'
+            while (j + 1 < nLength && !((char)pgm_read_byte(pTemplate + j) == '}' && (char)pgm_read_byte(pTemplate + j + 1) == '}')) {
+               if (n < sizeof(szName) - 1) szName[n++] = (char)pgm_read_byte(pTemplate + j);
+               j++;
+            }
+            if (j + 1 < nLength) {
+               szName[n] = '\0';
+               if (cb) cb(szName, out);
+               i = j + 2;
+               continue;
+            }
+         }
+         out.write((uint8_t)c);
+         i++;
+      }
+   }
+
+   /// prints a string as content of a json/javascript string, quotes and control characters are escaped
+   static void printJsonString(Print& out, const char* sz) {
+      if (!sz) return;
+      for (; *sz; sz++) {
+         char c = *sz;
+         if (c == '"' || c == '\\') {
+            out.write('\\');
+            out.write((uint8_t)c);
+         } else if ((uint8_t)c < 0x20) {
+            out.printf("\\u%04x", (uint8_t)c);
+         } else {
+            out.write((uint8_t)c);
+         }
+      }
+   }
+};
+
+/**
+ * @brief Print adapter collecting the output in a small buffer and passing it in chunks to a sink
+ * @details Used to stream rendered content into a chunked http response.
+ */
+class CxChunkedPrint : public Print {
+public:
+   typedef std::function<void(const char* buf, size_t len)> sink_t;
+
+private:
+   static constexpr size_t _nBUFSIZE = 256;
+   char   _buf[_nBUFSIZE];
+   size_t _nLen = 0;
+   sink_t _sink;
+
+public:
+   explicit CxChunkedPrint(sink_t sink) : _sink(sink) {}
+   ~CxChunkedPrint() {flush();}
+
+   virtual size_t write(uint8_t c) override {
+      _buf[_nLen++] = (char)c;
+      if (_nLen >= sizeof(_buf)) flush();
+      return 1;
+   }
+
+   virtual void flush() override {
+      if (_nLen && _sink) _sink(_buf, _nLen);
+      _nLen = 0;
+   }
+};
+
+#endif /* CxStreamTemplate_hpp */
@@ -2,38 +2,251 @@
 #define CxTablePrinter_hpp
 
 #include <vector>
+#include <initializer_list>
+#include <cmath>
 
+/**
+ * @brief Prints tables for humans or records for machines
+ * @details The output format is given by the session (see CxESPConsole::getTableFormat()). In the text format, a table with
+ * header, aligned columns and ESC attributes is printed. In the json format, the rows are streamed as
+ * array of objects, in the kv format as one line of key=value pairs per row. The keys are taken from the
+ * titles (lower case, non alphanumeric characters replaced by '_'). Numeric values are not quoted in json.
+ *
+ * The columns are defined once, the cells are written directly from strings (RAM or flash) and numbers
+ * to the stream, padded and truncated to the column width. Printing a row doesn't allocate heap.
+ *
+ * Example:
+ * ```cpp
+ * CxTablePrinter table(stream, __console.getTableFormat());
+ * table.printHeader({{F("Id"), 3}, {F("Name"), 10}});
+ * table.cell(1); table.cell(F("led")); table.endRow();
+ * table.printFooter();
+ * ```
+ * The former interface with vectors of Strings (printHeader(titles, widths), printRow(values)) is still
+ * supported.
+ */
 class CxTablePrinter {
+public:
+   enum class e_format : uint8_t {text, json, kv};
+
+   static constexpr uint8_t _nMAX_COLUMNS = 16;
+
+   struct Column {
+      const char* szTitle;   ///< static string, RAM or flash
+      uint8_t nWidth;        ///< 0: not aligned
+      
+      Column() : szTitle(nullptr), nWidth(0) {}
+      Column(const char* sz, uint8_t n) : szTitle(sz), nWidth(n) {}
+      Column(const __FlashStringHelper* f, uint8_t n) : szTitle(reinterpret_cast<const char*>(f)), nWidth(n) {}
+   };
+
 private:
-   std::vector<uint8_t> _vColumnWidths;
+   Column _aColumns[_nMAX_COLUMNS];
+   uint8_t _nColumns = 0;
+   std::vector<String> _vTitles; ///< copy of the titles given as Strings
+   bool _bOpen = false;          ///< json array started
    uint8_t _nCurrentColumn = 0;
    Stream& _output; // Reference to a Stream object
+   e_format _eFormat;
    const char* _szName;
    uint16_t _nLines;
-   
-   // Helper to truncate strings
-   String truncateString(const String& str, uint8_t width) {
-      if (str.length() > width) {
-         return str.substring(0, width - 3) + "...";
+
+   /// strings are read byte-wise with pgm_read_byte, which works for flash and RAM
+   static size_t _length(const char* sz) {
+      size_t n = 0;
+      if (sz) while (pgm_read_byte(sz + n)) n++;
+      return n;
+   }
+
+   /// prints the string padded or truncated ("...") to the width, width 0 prints it as is
+   void _printText(const char* sz, uint8_t nWidth) {
+      size_t nLen = _length(sz);
+      size_t nPrint = nLen;
+      bool bTruncate = (nWidth && nLen > nWidth);
+      if (bTruncate) nPrint = (nWidth > 3) ? nWidth - 3 : 0;
+      for (size_t i = 0; i < nPrint; i++) _output.write((uint8_t)pgm_read_byte(sz + i));
+      if (bTruncate) {
+         _output.print(F("..."));
+      } else {
+         for (size_t i = nLen; i < nWidth; i++) _output.write(' ');
+      }
+   }
+
+   void _printKey(uint8_t nCol) {
+      if (nCol < _nColumns && _aColumns[nCol].szTitle) {
+         const char* sz = _aColumns[nCol].szTitle;
+         char c;
+         while ((c = (char)pgm_read_byte(sz++))) {
+            _output.write(isalnum(c) ? (char)tolower(c) : '_');
+         }
+      } else {
+         _output.print('c');
+         _output.print(nCol);
       }
-      return str;
    }
 
-   
+   /// true, if the string is a valid json number
+   static bool _isNumber(const char* sz) {
+      if (!sz) return false;
+      char c = (char)pgm_read_byte(sz);
+      if (c == '-') c = (char)pgm_read_byte(++sz);
+      if (!isdigit(c)) return false;
+      if (c == '0' && isdigit(pgm_read_byte(sz + 1))) return false; // leading zero
+      while (isdigit(c)) c = (char)pgm_read_byte(++sz);
+      if (c == '.') {
+         c = (char)pgm_read_byte(++sz);
+         if (!isdigit(c)) return false;
+         while (isdigit(c)) c = (char)pgm_read_byte(++sz);
+      }
+      if (c == 'e' || c == 'E') {
+         c = (char)pgm_read_byte(++sz);
+         if (c == '-' || c == '+') c = (char)pgm_read_byte(++sz);
+         if (!isdigit(c)) return false;
+         while (isdigit(c)) c = (char)pgm_read_byte(++sz);
+      }
+      return c == '\0';
+   }
+
+   void _printJsonString(const char* sz) {
+      _output.print('"');
+      for (char c; sz && (c = (char)pgm_read_byte(sz)); sz++) {
+         if (c == 0x1B) {
+            // skip ESC sequences (e.g. colors)
+            if (pgm_read_byte(sz + 1) == '[') {
+               sz += 2;
+               while ((c = (char)pgm_read_byte(sz)) && !(c >= 0x40 && c <= 0x7E)) sz++;
+               if (!c) break;
+            }
+            continue;
+         }
+         if (c == '"' || c == '\\') _output.print('\\');
+         if ((uint8_t)c >= 0x20) _output.print(c);
+      }
+      _output.print('"');
+   }
+
+   static bool _needsQuotes(const char* sz) {
+      if (!sz || !pgm_read_byte(sz)) return true;
+      for (char c; (c = (char)pgm_read_byte(sz)); sz++) {
+         if (c == ' ' || c == '"' || c == '=' || c == 0x1B) return true;
+      }
+      return false;
+   }
+
+   /// starts the next cell: delimiter, row start or key
+   void _beginCell() {
+      switch (_eFormat) {
+         case e_format::text:
+            if (_nCurrentColumn > 0) _output.print(F(ESC_ATTR_BOLD " | " ESC_ATTR_RESET));
+            break;
+         case e_format::json:
+            if (_nCurrentColumn == 0) {
+               _output.print(_bOpen ? ",{" : "[{");
+               _bOpen = true;
+            } else {
+               _output.print(',');
+            }
+            _output.print('"');
+            _printKey(_nCurrentColumn);
+            _output.print(F("\":"));
+            break;
+         case e_format::kv:
+            if (_nCurrentColumn > 0) _output.print(' ');
+            _printKey(_nCurrentColumn);
+            _output.print('=');
+            break;
+      }
+   }
+
+   uint8_t _getWidth() {
+      return (_nCurrentColumn < _nColumns) ? _aColumns[_nCurrentColumn].nWidth : 0;
+   }
+
+   /// writes a cell, bNumber: value is a number (not quoted)
+   void _cell(const char* sz, bool bNumber) {
+      _beginCell();
+      switch (_eFormat) {
+         case e_format::text:
+            _printText(sz, _getWidth());
+            break;
+         case e_format::json:
+            if (bNumber) {
+               _printText(sz, 0);
+            } else {
+               _printJsonString(sz);
+            }
+            break;
+         case e_format::kv:
+            if (!bNumber && _needsQuotes(sz)) {
+               _printJsonString(sz);
+            } else {
+               _printText(sz, 0);
+            }
+            break;
+      }
+      _nCurrentColumn++;
+   }
+
+   /// terminates the json array, an empty table results in []
+   void _close() {
+      if (_eFormat != e_format::json) return;
+      if (!_bOpen && !_nColumns) return;  // nothing printed (e.g. no header)
+      _output.println(_bOpen ? "]" : "[]");
+      _bOpen = false;
+      _nColumns = 0;
+   }
+
 public:
    // Constructor accepting a Stream reference
-   CxTablePrinter(Stream& stream, const char* name = nullptr) : _output(stream), _szName(name), _nLines(0) {}
-   
-   void printHeader(const std::vector<String>& titles, const std::vector<uint8_t>& widths) {
-      _vColumnWidths = widths; // Store the widths
+   CxTablePrinter(Stream& stream, const char* name = nullptr) : _output(stream), _eFormat(e_format::text), _szName(name), _nLines(0) {}
+   CxTablePrinter(Stream& stream, e_format fmt, const char* name = nullptr) : _output(stream), _eFormat(fmt), _szName(name), _nLines(0) {}
+   ~CxTablePrinter() {_close();}
+
+   e_format getFormat() {return _eFormat;}
+   bool isText() {return _eFormat == e_format::text;}
+
+   static const char* getFormatName(e_format fmt) {
+      switch (fmt) {
+         case e_format::json: return "json";
+         case e_format::kv: return "kv";
+         default: return "text";
+      }
+   }
+
+   /// format by name (text, json, kv), false if unknown
+   static bool parseFormat(const char* sz, e_format& fmt) {
+      if (!sz) return false;
+      if (strcmp(sz, "text") == 0) {fmt = e_format::text;}
+      else if (strcmp(sz, "json") == 0) {fmt = e_format::json;}
+      else if (strcmp(sz, "kv") == 0) {fmt = e_format::kv;}
+      else return false;
+      return true;
+   }
+
+   /// adds a column, the title must be a static string (the pointer is kept)
+   void addColumn(const char* szTitle, uint8_t nWidth) {
+      if (_nColumns < _nMAX_COLUMNS) _aColumns[_nColumns++] = Column(szTitle, nWidth);
+   }
+   void addColumn(const __FlashStringHelper* title, uint8_t nWidth) {
+      addColumn(reinterpret_cast<const char*>(title), nWidth);
+   }
+
+   void printHeader(std::initializer_list<Column> columns) {
+      for (const auto& column : columns) addColumn(column.szTitle, column.nWidth);
+      printHeader();
+   }
+
+   /// prints the header of the columns added before
+   void printHeader() {
+      if (!isText()) return;
       _output.print(ESC_ATTR_BOLD);
       printLine(false);
 #ifndef MINIMAL_COMMAND_SET
       // print centered name of the table, if given
       if (_szName) {
          uint16_t nLen = 0;
-         for (auto& w : widths) {
-            nLen += w;
+         for (uint8_t i = 0; i < _nColumns; i++) {
+            nLen += _aColumns[i].nWidth;
          }
          nLen /= 2;
          nLen -= strlen(_szName)/2;
@@ -42,47 +255,105 @@ public:
          printLine(false);
       }
 #endif
-      
-      for (size_t i = 0; i < titles.size(); i++) {
+
+      for (uint8_t i = 0; i < _nColumns; i++) {
          if (i > 0) {
             _output.print(" | ");
          }
-         String truncated = truncateString(titles[i], widths[i]);
-         _output.printf("%-*s", widths[i], truncated.c_str());
+         _printText(_aColumns[i].szTitle, _aColumns[i].nWidth);
       }
       _output.println();
       printLine();
       _output.print(ESC_ATTR_RESET);
    }
 
+   /// columns beyond _nMAX_COLUMNS are dropped, the text format reports them
+   void printHeader(const std::vector<String>& titles, const std::vector<uint8_t>& widths) {
+      size_t nTitles = titles.size();
+      if (nTitles > _nMAX_COLUMNS) {
+         if (isText()) {
+            _output.print(F("### table: "));
+            _output.print((unsigned int)nTitles);
+            _output.print(F(" columns, max. "));
+            _output.println(_nMAX_COLUMNS);
+         }
+         nTitles = _nMAX_COLUMNS;
+      }
+      _vTitles.assign(titles.begin(), titles.begin() + nTitles); // keep the titles, the columns point to them
+      _nColumns = 0;
+      for (size_t i = 0; i < _vTitles.size(); i++) {
+         addColumn(_vTitles[i].c_str(), (i < widths.size()) ? widths[i] : 0);
+      }
+      printHeader();
+   }
+
    void printLine(bool bDelimiter = true) {
+      if (!isText()) return;
 #ifndef MINIMAL_COMMAND_SET
-      for (size_t i = 0; i < _vColumnWidths.size(); i++) {
+      for (uint8_t i = 0; i < _nColumns; i++) {
          if (i > 0) {
             _output.print(bDelimiter?"-+-":"---");
          }
-         for (uint8_t j = 0; j < _vColumnWidths[i]; j++) {
+         for (uint8_t j = 0; j < _aColumns[i].nWidth; j++) {
             _output.print('-');
          }
       }
       _output.println();
 #endif
    }
-   
-   void printRow(const std::vector<String>& values) {
-      for (size_t i = 0; i < values.size(); i++) {
-         if (i > 0) {
-            _output.print(ESC_ATTR_BOLD " | " ESC_ATTR_RESET);
-         }
-         String truncated = truncateString(values[i], _vColumnWidths[i]);
-         _output.printf("%-*s", _vColumnWidths[i], truncated.c_str());
+
+   /// cells of the current row, strings can be in RAM or flash
+   void cell(const char* sz) {_cell(sz ? sz : "", _isNumber(sz) && !isText());}
+   void cell(const __FlashStringHelper* f) {cell(reinterpret_cast<const char*>(f));}
+   void cell(const String& str) {cell(str.c_str());}
+   void cell(int n) {cell((long)n);}
+   void cell(unsigned int n) {cell((unsigned long)n);}
+   void cell(long n) {
+      char buf[12];
+      snprintf(buf, sizeof(buf), "%ld", n);
+      _cell(buf, true);
+   }
+   void cell(unsigned long n) {
+      char buf[12];
+      snprintf(buf, sizeof(buf), "%lu", n);
+      _cell(buf, true);
+   }
+   /// NaN and infinity are no json numbers, printed as null (json) or '-'
+   void cell(double f, uint8_t nPrec = 2) {
+      if (std::isnan(f) || std::isinf(f)) {
+         _cell((_eFormat == e_format::json) ? "null" : "-", true);
+         return;
+      }
+      char buf[24];
+      snprintf(buf, sizeof(buf), "%.*f", nPrec, f);
+      _cell(buf, true);
+   }
+   void cell(bool b) {cell(b ? "yes" : "no");}
+
+   /// completes the current row
+   void endRow() {
+      if (_eFormat == e_format::json) {
+         if (_nCurrentColumn) _output.print('}');
+      } else {
+         _output.println();
       }
-      _output.println();
       _nCurrentColumn = 0; // Reset for the next row
       _nLines++;
    }
-   
+
+   void printRow(const std::vector<String>& values) {
+      for (const auto& value : values) {
+         if (_nCurrentColumn >= _nMAX_COLUMNS) break;
+         cell(value.c_str());
+      }
+      endRow();
+   }
+
    void printFooter() {
+      if (!isText()) {
+         _close();
+         return;
+      }
 #ifndef MINIMAL_COMMAND_SET
       _output.print(ESC_ATTR_BOLD);
       printLine(false);
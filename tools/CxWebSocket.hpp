@@ -0,0 +1,259 @@
+//
+//  CxWebSocket.hpp
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+
+#ifndef CxWebSocket_hpp
+#define CxWebSocket_hpp
+
+#include "CxHash.hpp"
+
+/**
+ * @brief Server side WebSocket (RFC 6455) connection as Stream
+ * @details The payload of incoming text and binary frames is read as stream, pings are answered, a close
+ * frame ends the connection. The output is collected and sent as binary frames in large chunks, when the
+ * buffer is full or with flush(), instead of a frame per write. The frames are parsed byte-wise from the
+ * available data, reading never blocks. Control frames (ping, close) can come between the frames of a
+ * fragmented message, their opcode is kept apart from the opcode of the message.
+ *
+ * The handshake (HTTP upgrade request) is done by the server, see getAcceptKey().
+ */
+class CxWebSocketStream : public Stream {
+public:
+   static constexpr uint16_t _nTX_SIZE = 1024;   ///< max. payload of an output frame
+   static constexpr uint16_t _nRX_SIZE = 256;    ///< input buffer
+
+private:
+   enum e_opcode : uint8_t {opCont = 0x0, opText = 0x1, opBinary = 0x2, opClose = 0x8, opPing = 0x9, opPong = 0xA};
+   enum e_state : uint8_t {stHeader, stLength, stExtLength, stMask, stPayload};
+
+   Client& _client;
+   bool _bClosed = false;
+
+   // frame parser
+   e_state  _state = stHeader;
+   uint8_t  _nOpcode = 0;      ///< opcode of the data message
+   uint8_t  _nCtrlOpcode = 0;  ///< opcode of the control frame in process, 0 for a data frame
+   uint8_t  _nExtLength = 0;   ///< bytes of the extended length left
+   uint8_t  _aMask[4];
+   uint8_t  _nMask = 0;        ///< bytes of the mask received
+   uint64_t _nPayload = 0;     ///< bytes of the payload left
+   uint32_t _nPayloadPos = 0;
+   uint8_t  _aCtrl[125];       ///< payload of control frames
+   uint8_t  _nCtrl = 0;
+
+   // input ring buffer
+   uint8_t  _aRx[_nRX_SIZE];
+   uint16_t _nRxHead = 0;
+   uint16_t _nRxCount = 0;
+
+   // output buffer
+   uint8_t  _aTx[_nTX_SIZE];
+   uint16_t _nTx = 0;
+
+   /// statistics
+   uint32_t _nFramesOut = 0;
+   uint32_t _nBytesOut = 0;
+   uint32_t _nBytesIn = 0;
+
+   void _sendFrame(uint8_t nOpcode, const uint8_t* pData, size_t nLen) {
+      if (_bClosed && nOpcode != opClose) return;
+      uint8_t aHeader[4];
+      uint8_t nHeader = 2;
+      aHeader[0] = 0x80 | nOpcode; // FIN
+      if (nLen < 126) {
+         aHeader[1] = (uint8_t)nLen;
+      } else {
+         aHeader[1] = 126;
+         aHeader[2] = (uint8_t)(nLen >> 8);
+         aHeader[3] = (uint8_t)nLen;
+         nHeader = 4;
+      }
+      _client.write(aHeader, nHeader);
+      if (nLen) _client.write(pData, nLen);
+   }
+
+   void _onControl() {
+      if (_nCtrlOpcode == opPing) {
+         _sendFrame(opPong, _aCtrl, _nCtrl);
+      } else if (_nCtrlOpcode == opClose) {
+         flush();
+         _sendFrame(opClose, _aCtrl, (_nCtrl >= 2) ? 2 : 0); // echo the status code
+         _bClosed = true;
+      }
+      _nCtrl = 0;
+   }
+
+   void _onPayload(uint8_t c) {
+      if (_nCtrlOpcode) {
+         if (_nCtrl < sizeof(_aCtrl)) _aCtrl[_nCtrl++] = c;
+      } else {
+         // _poll() reads only, if there is room in the input buffer
+         _aRx[(_nRxHead + _nRxCount) % _nRX_SIZE] = c;
+         _nRxCount++;
+         _nBytesIn++;
+      }
+
+      if (--_nPayload == 0) {
+         if (_nCtrlOpcode) _onControl();
+         _state = stHeader;
+      }
+   }
+
+   /// parses the available frame bytes as long as there is room in the input buffer
+   void _poll() {
+      while (!_bClosed && _nRxCount < _nRX_SIZE && _client.available()) {
+         int n = _client.read();
+         if (n < 0) break;
+         uint8_t c = (uint8_t)n;
+         switch (_state) {
+            case stHeader:
+               // continuation frames keep the opcode of the message, control frames don't change it
+               if (c & 0x8) {
+                  _nCtrlOpcode = c & 0x0F;
+               } else {
+                  _nCtrlOpcode = 0;
+                  if ((c & 0x0F) != opCont) _nOpcode = c & 0x0F;
+               }
+               _state = stLength;
+               break;
+            case stLength:
+               if (!(c & 0x80)) {
+                  // frames of a client must be masked
+                  close(1002);
+                  return;
+               }
+               _nPayload = c & 0x7F;
+               _nMask = 0;
+               _nPayloadPos = 0;
+               if (_nPayload == 126) {
+                  _nExtLength = 2;
+                  _nPayload = 0;
+                  _state = stExtLength;
+               } else if (_nPayload == 127) {
+                  _nExtLength = 8;
+                  _nPayload = 0;
+                  _state = stExtLength;
+               } else {
+                  _state = stMask;
+               }
+               break;
+            case stExtLength:
+               _nPayload = (_nPayload << 8) | c;
+               if (--_nExtLength == 0) _state = stMask;
+               break;
+            case stMask:
+               _aMask[_nMask++] = c;
+               if (_nMask == 4) {
+                  if (_nPayload) {
+                     _state = stPayload;
+                  } else {
+                     if (_nCtrlOpcode) _onControl();
+                     _state = stHeader;
+                  }
+               }
+               break;
+            case stPayload:
+               _onPayload(c ^ _aMask[_nPayloadPos++ % 4]);
+               break;
+         }
+      }
+   }
+
+public:
+   explicit CxWebSocketStream(Client& client) : _client(client) {}
+
+   /// Sec-WebSocket-Accept for the Sec-WebSocket-Key of the upgrade request
+   static String getAcceptKey(const char* szKey) {
+      static const char* szB64 = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+      CxSha1 sha;
+      sha.print(szKey);
+      sha.print(F("258EAFA5-E914-47DA-95CA-C5AB0DC85B11"));
+      uint8_t aDigest[21];
+      sha.get(aDigest);
+      aDigest[20] = 0;
+
+      String strResult;
+      strResult.reserve(28);
+      for (uint8_t i = 0; i < 21; i += 3) {
+         uint32_t n = ((uint32_t)aDigest[i] << 16) | ((uint32_t)aDigest[i + 1] << 8) | aDigest[i + 2];
+         strResult += szB64[(n >> 18) & 0x3F];
+         strResult += szB64[(n >> 12) & 0x3F];
+         strResult += (i + 1 < 20) ? szB64[(n >> 6) & 0x3F] : '=';
+         strResult += (i + 2 < 20) ? szB64[n & 0x3F] : '=';
+      }
+      return strResult;
+   }
+
+   virtual size_t write(uint8_t c) override {
+      if (_bClosed) return 0;
+      if (_nTx == _nTX_SIZE) flush();
+      _aTx[_nTx++] = c;
+      return 1;
+   }
+
+   virtual size_t write(const uint8_t* buffer, size_t size) override {
+      if (_bClosed) return 0;
+      size_t nDone = 0;
+      while (nDone < size) {
+         if (_nTx == _nTX_SIZE) flush();
+         size_t n = std::min((size_t)(_nTX_SIZE - _nTx), size - nDone);
+         memcpy(_aTx + _nTx, buffer + nDone, n);
+         _nTx += n;
+         nDone += n;
+      }
+      return size;
+   }
+
+   /// sends the collected output as one binary frame
+   virtual void flush() override {
+      if (!_nTx) return;
+      _sendFrame(opBinary, _aTx, _nTx);
+      _nFramesOut++;
+      _nBytesOut += _nTx;
+      _nTx = 0;
+   }
+
+   virtual int available() override {
+      _poll();
+      return _nRxCount;
+   }
+
+   virtual int read() override {
+      _poll();
+      if (!_nRxCount) return -1;
+      uint8_t c = _aRx[_nRxHead];
+      _nRxHead = (_nRxHead + 1) % _nRX_SIZE;
+      _nRxCount--;
+      return c;
+   }
+
+   virtual int peek() override {
+      _poll();
+      return _nRxCount ? _aRx[_nRxHead] : -1;
+   }
+
+   void loop() {
+      _poll();
+      flush();
+   }
+
+   void close(uint16_t nCode = 1000) {
+      if (_bClosed) return;
+      flush();
+      uint8_t aCode[2] = {(uint8_t)(nCode >> 8), (uint8_t)nCode};
+      _sendFrame(opClose, aCode, 2);
+      _bClosed = true;
+   }
+
+   bool connected() {return !_bClosed && _client.connected();}
+
+   uint32_t getFramesOut() {return _nFramesOut;}
+   uint32_t getBytesOut() {return _nBytesOut;}
+   uint32_t getBytesIn() {return _nBytesIn;}
+};
+
+#endif /* CxWebSocket_hpp */
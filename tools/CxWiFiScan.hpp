@@ -0,0 +1,145 @@
+//
+//  CxWiFiScan.hpp
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+
+#ifndef CxWiFiScan_hpp
+#define CxWiFiScan_hpp
+
+#include "esphw.h"
+#include <inttypes.h>
+#include <vector>
+#include <algorithm>
+
+/**
+ * @brief Asynchronous wifi scan with cached results
+ * @details start() triggers a scan in the background, loop() collects the results when the scan is complete.
+ * The results are deduplicated per ssid (the strongest access point is kept) and sorted by the signal
+ * strength. They are valid for the max. age, refresh() starts a new scan only if they are outdated.
+ * The scan never blocks the loop.
+ */
+class CxWiFiScan {
+public:
+   struct Network {
+      String   strSSID;
+      int8_t   nRSSI;
+      uint8_t  nChannel;
+      uint8_t  bssid[6];
+      bool     bOpen;
+   };
+
+private:
+   std::vector<Network> _vNetworks;
+   bool     _bScanning = false;
+   bool     _bValid = false;
+   uint32_t _nScanTime = 0;      ///< time of the last completed scan (ms)
+   uint32_t _nDuration = 0;      ///< duration of the last scan (ms)
+   uint32_t _nStart = 0;
+   uint32_t _nMaxAge = 60000;    ///< results are valid for (ms)
+
+   CxWiFiScan() = default;
+
+   void _collect(int n) {
+#if defined(ARDUINO) && !defined(ESP_CONSOLE_NOWIFI)
+      _vNetworks.clear();
+      _vNetworks.reserve(n);
+      for (int i = 0; i < n; i++) {
+         String strSSID = WiFi.SSID(i);
+         if (!strSSID.length()) continue; // hidden network
+         int8_t nRSSI = (int8_t)WiFi.RSSI(i);
+         auto it = std::find_if(_vNetworks.begin(), _vNetworks.end(), [&strSSID](const Network& network) {return network.strSSID == strSSID;});
+         if (it != _vNetworks.end()) {
+            if (it->nRSSI >= nRSSI) continue;
+         } else {
+            _vNetworks.emplace_back();
+            it = _vNetworks.end() - 1;
+         }
+         it->strSSID = strSSID;
+         it->nRSSI = nRSSI;
+         it->nChannel = (uint8_t)WiFi.channel(i);
+         uint8_t* bssid = WiFi.BSSID(i);
+         if (bssid) memcpy(it->bssid, bssid, sizeof(it->bssid));
+#ifdef ESP32
+         it->bOpen = (WiFi.encryptionType(i) == WIFI_AUTH_OPEN);
+#else
+         it->bOpen = (WiFi.encryptionType(i) == ENC_TYPE_NONE);
+#endif
+      }
+      std::sort(_vNetworks.begin(), _vNetworks.end(), [](const Network& a, const Network& b) {return a.nRSSI > b.nRSSI;});
+      WiFi.scanDelete();
+#endif
+   }
+
+public:
+   CxWiFiScan(const CxWiFiScan&) = delete;
+   CxWiFiScan& operator=(const CxWiFiScan&) = delete;
+
+   static CxWiFiScan& getInstance() {
+      static CxWiFiScan instance;
+      return instance;
+   }
+
+   /// starts a scan in the background, if not already running
+   void start() {
+      if (_bScanning) return;
+#if defined(ARDUINO) && !defined(ESP_CONSOLE_NOWIFI)
+      _nStart = (uint32_t)millis();
+      _bScanning = (WiFi.scanNetworks(true) == WIFI_SCAN_RUNNING);
+#endif
+   }
+
+   /// starts a scan, if the results are outdated
+   void refresh() {
+      if (!isValid()) start();
+   }
+
+   void loop() {
+      if (!_bScanning) return;
+#if defined(ARDUINO) && !defined(ESP_CONSOLE_NOWIFI)
+      int n = WiFi.scanComplete();
+      if (n == WIFI_SCAN_RUNNING) return;
+      _bScanning = false;
+      if (n >= 0) {
+         _collect(n);
+         _nScanTime = (uint32_t)millis();
+         _nDuration = _nScanTime - _nStart;
+         _bValid = true;
+      }
+#endif
+   }
+
+   bool isScanning() {return _bScanning;}
+   bool isValid() {return _bValid && ((uint32_t)millis() - _nScanTime) < _nMaxAge;}
+   uint32_t getAge() {return _bValid ? (uint32_t)millis() - _nScanTime : 0;}
+
+   void setMaxAge(uint32_t set) {_nMaxAge = set;}
+   uint32_t getMaxAge() {return _nMaxAge;}
+
+   const std::vector<Network>& getNetworks() {return _vNetworks;}
+
+   /// the strongest access point of the ssid from valid results, nullptr if not found
+   const Network* find(const char* szSSID) {
+      if (!szSSID || !isValid()) return nullptr;
+      for (const auto& network : _vNetworks) {
+         if (network.strSSID == szSSID) return &network;
+      }
+      return nullptr;
+   }
+
+   void print(Stream& stream) {
+      if (!_bValid) {
+         stream.println(_bScanning ? F("scanning...") : F("no scan results"));
+         return;
+      }
+      stream.printf("%u networks found %" PRIu32 " s ago (scan %" PRIu32 " ms)%s\n", (unsigned int)_vNetworks.size(), getAge() / 1000, _nDuration, _bScanning ? ", scanning..." : "");
+      uint8_t i = 0;
+      for (const auto& network : _vNetworks) {
+         stream.printf("%2u: %-32s %4d dBm  ch %2u %s\n", ++i, network.strSSID.c_str(), network.nRSSI, network.nChannel, network.bOpen ? " " : "*");
+      }
+   }
+};
+
+#endif /* CxWiFiScan_hpp */
@@ -0,0 +1,251 @@
+//
+//  CxWiFiStation.hpp
+//  xESP
+//
+//  Created by ocfu on 17.10.26.
+//  Copyright © 2026 ocfu. All rights reserved.
+//
+
+#ifndef CxWiFiStation_hpp
+#define CxWiFiStation_hpp
+
+#include "esphw.h"
+#include "CxHash.hpp"
+#include <inttypes.h>
+#include "CxWiFiScan.hpp"
+
+/**
+ * @brief Non-blocking wifi station with fast reconnect
+ * @details The bssid and channel of the last connection are kept in the eeprom (see WiFiCache_t). A connect
+ * first tries the cached access point directly, which skips the scan. If this doesn't succeed within
+ * a short time, it falls back to a regular connect with scan. An optional static ip configuration
+ * skips the DHCP as well, it is bound to the network it was set for (other networks use DHCP). Without a cached access point, the strongest one from recent scan results
+ * (see CxWiFiScan) is used for the fast connect.
+ * begin() only starts the connection, loop() completes it. The state tells, if the connection is still
+ * pending, established or failed. Each phase (fast, scan) has the full timeout. New credentials are kept in
+ * RAM and saved to the eeprom only, when the connection is established.
+ * A connection lost later is reconnected by the SDK (auto reconnect), loop() observes it: the state is
+ * 'lost' until the SDK reconnects, then the access point is cached again (e.g. after roaming).
+ * The connect times (last, average, worst) are kept for diagnostics.
+ */
+class CxWiFiStation {
+public:
+   enum class e_state : uint8_t {idle, fast, scan, connected, lost, failed};
+
+private:
+   CxESPConsoleMaster& __console = CxESPConsoleMaster::getInstance();
+
+   static constexpr uint32_t _nFAST_TIMEOUT = 3000;   ///< fall back to scan after (ms)
+   static constexpr uint32_t _nTIMEOUT = 10000;       ///< connect fails after (ms)
+
+   e_state  _state = e_state::idle;
+   String   _strSSID;
+   String   _strPassword;
+   uint32_t _nStart = 0;           ///< start of the connect (ms)
+   uint32_t _nPhaseStart = 0;      ///< start of the current phase (fast, scan)
+   bool     _bFast = true;         ///< fast connect enabled
+   bool     _bSave = false;        ///< save the credentials, when connected
+
+   /// connect metrics (ms)
+   uint32_t _nLast = 0;
+   uint32_t _nWorst = 0;
+   uint32_t _nSum = 0;
+   uint32_t _nCount = 0;
+   uint32_t _nFastHits = 0;
+   uint32_t _nFastMisses = 0;
+   uint32_t _nFails = 0;
+   uint32_t _nReconnects = 0;      ///< reconnects by the SDK
+
+   CxWiFiStation() = default;
+
+   void _onConnected() {
+      uint32_t nTime = (uint32_t)millis() - _nStart;
+      _nLast = nTime;
+      _nSum += nTime;
+      _nCount++;
+      if (nTime > _nWorst) _nWorst = nTime;
+      if (_state == e_state::fast) _nFastHits++;
+      if (_state == e_state::lost || _state == e_state::failed) _nReconnects++;
+      _state = e_state::connected;
+      _CONSOLE_INFO(F("wifi connected in %" PRIu32 " ms"), nTime);
+
+#ifdef ARDUINO
+      if (_bSave) {
+         _bSave = false;
+         ::writeSSID(_strSSID.c_str());
+         ::writePassword(_strPassword.c_str());
+         _CONSOLE_INFO(F("wifi credentials saved"));
+      }
+      
+      // remember the access point for the next connect, written only if changed
+      WiFiCache_t cache;
+      ::readWiFiCache(cache);
+      uint32_t nHash = CxHash::of(_strSSID.c_str());
+      uint8_t* bssid = WiFi.BSSID();
+      uint8_t nChannel = (uint8_t)WiFi.channel();
+      if (bssid && (!cache.isValid() || cache._nSSIDHash != nHash || cache._nChannel != nChannel || memcmp(cache._bssid, bssid, sizeof(cache._bssid)) != 0)) {
+         cache._nSSIDHash = nHash;
+         cache._nChannel = nChannel;
+         memcpy(cache._bssid, bssid, sizeof(cache._bssid));
+         ::writeWiFiCache(cache);
+      }
+#endif
+   }
+
+public:
+   CxWiFiStation(const CxWiFiStation&) = delete;
+   CxWiFiStation& operator=(const CxWiFiStation&) = delete;
+
+   static CxWiFiStation& getInstance() {
+      static CxWiFiStation instance;
+      return instance;
+   }
+
+   /**
+    * @brief Starts connecting to the access point, returns immediately
+    * @param bSave Save the credentials, when connected (e.g. new ones from the captive portal)
+    */
+   void begin(const char* szSSID, const char* szPassword, bool bSave = false) {
+      _strSSID = szSSID ? szSSID : "";
+      _strPassword = szPassword ? szPassword : "";
+      _bSave = bSave;
+      _nStart = (uint32_t)millis();
+      _nPhaseStart = _nStart;
+
+#ifdef ARDUINO
+      WiFiCache_t cache;
+      ::readWiFiCache(cache);
+
+      // the static ip configuration belongs to the network it was set for, others use DHCP
+      if (cache.isValid() && cache._bStatic && cache._nStaticSSIDHash == CxHash::of(_strSSID.c_str())) {
+         WiFi.config(IPAddress(cache._nIP), IPAddress(cache._nGateway), IPAddress(cache._nMask), IPAddress(cache._nDNS));
+      } else {
+         WiFi.config(IPAddress((uint32_t)0), IPAddress((uint32_t)0), IPAddress((uint32_t)0)); // DHCP
+      }
+
+      const CxWiFiScan::Network* pNetwork = CxWiFiScan::getInstance().find(_strSSID.c_str());
+      
+      if (_bFast && cache.isValid() && cache._nChannel && cache._nSSIDHash == CxHash::of(_strSSID.c_str())) {
+         _state = e_state::fast;
+         WiFi.begin(_strSSID.c_str(), _strPassword.c_str(), cache._nChannel, cache._bssid);
+      } else if (_bFast && pNetwork) {
+         _state = e_state::fast;
+         WiFi.begin(_strSSID.c_str(), _strPassword.c_str(), pNetwork->nChannel, pNetwork->bssid);
+      } else {
+         _state = e_state::scan;
+         WiFi.begin(_strSSID.c_str(), _strPassword.c_str());
+      }
+#else
+      _state = e_state::failed;
+#endif
+   }
+
+   void end() {
+      _state = e_state::idle;
+      _bSave = false;
+   }
+
+   /// completes a pending connect and observes the connection
+   void loop() {
+      if (_state == e_state::idle) return;
+#ifdef ARDUINO
+      bool bConnected = (WiFi.status() == WL_CONNECTED);
+      if (_state == e_state::connected) {
+         if (!bConnected) {
+            // reconnected by the SDK (auto reconnect), a failed connect might be completed by it as well
+            _CONSOLE_INFO(F("wifi connection lost"));
+            _state = e_state::lost;
+            _nStart = (uint32_t)millis();
+         }
+         return;
+      }
+      if (bConnected) {
+         _onConnected();
+         return;
+      }
+      if (!isConnecting()) return;
+      uint32_t nElapsed = (uint32_t)millis() - _nPhaseStart;
+      if (_state == e_state::fast && nElapsed > _nFAST_TIMEOUT) {
+         // the access point might have changed (channel, roaming), scan for it with the full timeout
+         _CONSOLE_INFO(F("wifi fast connect failed, scanning"));
+         _nFastMisses++;
+         _state = e_state::scan;
+         _nPhaseStart = (uint32_t)millis();
+         WiFi.disconnect();
+         WiFi.begin(_strSSID.c_str(), _strPassword.c_str());
+      } else if (nElapsed > _nTIMEOUT) {
+         _nFails++;
+         _state = e_state::failed;
+         _bSave = false; // the credentials are not saved, the next connect uses the saved ones
+      }
+#endif
+   }
+
+   e_state getState() {return _state;}
+   bool isConnecting() {return _state == e_state::fast || _state == e_state::scan;}
+
+   void setFast(bool set) {_bFast = set;}
+   bool isFast() {return _bFast;}
+
+   /// forgets the cached access point, the next connect scans
+   void clearCache() {
+      WiFiCache_t cache;
+      ::readWiFiCache(cache);
+      cache._nSSIDHash = 0;
+      cache._nChannel = 0;
+      memset(cache._bssid, 0, sizeof(cache._bssid));
+      ::writeWiFiCache(cache);
+   }
+
+   /**
+    * @brief Sets a static ip configuration for a network, all 0 switches back to DHCP. Used with the next connect.
+    * @param szSSID Network the configuration belongs to, default the one of the last begin() or the saved one
+    */
+   void setStaticIP(uint32_t nIP, uint32_t nGateway, uint32_t nMask, uint32_t nDNS, const char* szSSID = nullptr) {
+      char szSaved[21] = {};
+      if (!szSSID) szSSID = _strSSID.c_str();
+      if (!*szSSID && ::readSSID(szSaved, sizeof(szSaved))) szSSID = szSaved;
+
+      WiFiCache_t cache;
+      ::readWiFiCache(cache);
+      cache._bStatic = (nIP != 0);
+      cache._nStaticSSIDHash = (nIP != 0) ? CxHash::of(szSSID) : 0;
+      cache._nIP = nIP;
+      cache._nGateway = nGateway;
+      cache._nMask = nMask;
+      cache._nDNS = nDNS ? nDNS : nGateway;
+      ::writeWiFiCache(cache);
+   }
+
+   uint32_t getLast() {return _nLast;}
+   uint32_t getWorst() {return _nWorst;}
+   uint32_t getAverage() {return _nCount ? _nSum / _nCount : 0;}
+   uint32_t getCount() {return _nCount;}
+   uint32_t getReconnects() {return _nReconnects;}
+   uint32_t getFastHits() {return _nFastHits;}
+   uint32_t getFastMisses() {return _nFastMisses;}
+   uint32_t getFails() {return _nFails;}
+
+   void printInfo(Stream& stream) {
+      WiFiCache_t cache;
+      ::readWiFiCache(cache);
+      stream.printf(ESC_ATTR_BOLD "Fast connect: " ESC_ATTR_RESET "%s, hits %" PRIu32 ", misses %" PRIu32 "\n", _bFast ? "on" : "off", _nFastHits, _nFastMisses);
+      if (cache.isValid() && cache._nChannel) {
+         stream.printf(ESC_ATTR_BOLD "Cached AP:    " ESC_ATTR_RESET "%02X:%02X:%02X:%02X:%02X:%02X, channel %u\n", cache._bssid[0], cache._bssid[1], cache._bssid[2], cache._bssid[3], cache._bssid[4], cache._bssid[5], cache._nChannel);
+      } else {
+         stream.println(F(ESC_ATTR_BOLD "Cached AP:    " ESC_ATTR_RESET "-"));
+      }
+      if (cache.isValid() && cache._bStatic) {
+         stream.printf(ESC_ATTR_BOLD "Static IP:    " ESC_ATTR_RESET "%s", IPAddress(cache._nIP).toString().c_str());
+         stream.printf(" gw %s", IPAddress(cache._nGateway).toString().c_str());
+         stream.printf(" mask %s", IPAddress(cache._nMask).toString().c_str());
+         stream.printf(" dns %s", IPAddress(cache._nDNS).toString().c_str());
+         stream.println((cache._nStaticSSIDHash == CxHash::of(_strSSID.c_str())) ? "" : " (other network)");
+      } else {
+         stream.println(F(ESC_ATTR_BOLD "Static IP:    " ESC_ATTR_RESET "- (DHCP)"));
+      }
+      stream.printf(ESC_ATTR_BOLD "Connect ms:   " ESC_ATTR_RESET "last %" PRIu32 ", avg %" PRIu32 ", worst %" PRIu32 " (%" PRIu32 " connects, %" PRIu32 " failed, %" PRIu32 " auto reconnects)\n", _nLast, getAverage(), _nWorst, _nCount, _nFails, _nReconnects);
+   }
+};
+
+#endif /* CxWiFiStation_hpp */